@@ -2,7 +2,9 @@
 DCLXVI_VER=20130411
 DCLXVI_PKG=dclxvi-$(DCLXVI_VER).tar.bz2
 DCLXVI_DIR=$(TOPDIR)/ext/dclxvi-$(DCLXVI_VER)
-DCLXVI_INC=-I$(DCLXVI_DIR)
+#libdclxvi.a only contains the qhasm versions of the Fp2 arithmetic, so its
+#headers need QHASM defined to name them
+DCLXVI_INC=-I$(DCLXVI_DIR) -DQHASM
 DCLXVI_LIB=$(DCLXVI_DIR)/libdclxvi.a
 #DCLXVI_LIB=$(DCLXVI_DIR)/asfunctions.a
 DCLXVI_LIB_FLG=-L$(DCLXVI_DIR) -ldclxvi -lm
@@ -10,17 +10,24 @@
 #include <iostream>
 
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include <algorithms/BilinearMapKey.hpp>
 
 #include <bilinear/G.hpp>
 #include <bilinear/GT.hpp>
+#include <bilinear/GroupElement.hpp>
+#include <bilinear/PairingBackend.hpp>
 #include <bilinear/Scalar.hpp>
 
+#include <utils/MemoryAccounting.hpp>
 #include <utils/ThreadPool.hpp>
 
 extern "C" {
+//The multiscalar headers don't include the point types they use
+#include <curvepoint_fp.h>
+#include <twistpoint_fp2.h>
 #include <curvepoint_fp_multiscalar.h>
 #include <twistpoint_fp2_multiscalar.h>
 }
@@ -47,6 +54,33 @@ namespace BilinearMapAccumulator {
 void genKey(const std::vector<std::vector<std::reference_wrapper<Scalar>>>& sets,
             const unsigned int maxPkSize, BilinearMapKey& key, ThreadPool& threadPool);
 
+/**
+ * Generates a key pair whose public key has the given number of powers of s
+ * in each group, rather than the same number in both. Use proverKeySizes or
+ * verifierKeySizes to generate only what a deployment needs.
+ */
+void genKey(const BilinearMapKey::Sizes& sizes, BilinearMapKey& key, ThreadPool& threadPool);
+
+/**
+ * The public-key sizes needed to compute accumulators and witnesses of sets of
+ * up to maxSetSize elements from the public key: powers up to maxSetSize in
+ * the accumulators' group, and up to maxSetSize - 1 in the witnesses' group.
+ * The private-key functions don't use the public key at all.
+ */
+BilinearMapKey::Sizes proverKeySizes(size_t maxSetSize, bool accumulatorInG2 = false);
+
+/**
+ * The public-key sizes needed only to verify witnesses: g^s in the
+ * accumulators' group, and just the generator of the witnesses' group.
+ */
+BilinearMapKey::Sizes verifierKeySizes(bool accumulatorInG2 = false);
+
+/**
+ * The sizes of the group elements the bilinear operations of backend work
+ * with, for MemoryAccounting::estimateMemory.
+ */
+MemoryAccounting::ElementSizes elementSizes(PairingBackend::Type backend, bool accumulatorInG2 = false);
+
 /**
  * Accumulates the given set of Scalars into the given group element,
  * using the given private key.
@@ -55,7 +89,8 @@ void genKey(const std::vector<std::vector<std::reference_wrapper<Scalar>>>& sets
  * @param privKey the private key of this accumulator ("s")
  * @param acc the group element that will be used as the base of
  *        accumulation, and after execution of this function will
- *        contain the accumulated product. Should be an element of G1.
+ *        contain the accumulated product. Should be an element of G1,
+ *        or of G2 to place accumulators in G2 (see AccumulatorInG2).
  */
 void accumulateSet(const std::vector<std::reference_wrapper<Scalar>>& set,
                    const Scalar& privKey, G& acc);
@@ -66,14 +101,24 @@ void accumulateSet(const std::vector<std::reference_wrapper<Scalar>>& set,
  *
  * @param set a vector of Scalars that should be accumulated
  * @param publicKey the public key of this accumulator
- * @param acc the group element that will be used as the base of
- *        accumulation, and after execution of this function will
- *        contain the accumulated product. Should be an element of G1.
+ * @param acc the group element that will contain the accumulated
+ *        product, an element of G1 (or of G2 to place accumulators in G2)
  * @param threadPool the ThreadPool to use for concurrent computation.
  */
 void accumulateSet(const std::vector<std::reference_wrapper<Scalar>>& set,
                    const BilinearMapKey::PublicKey& publicKey, G& acc, ThreadPool& threadPool);
 
+/**
+ * Computes the coefficients of the polynomial (x + e_1)(x + e_2)...(x + e_n)
+ * whose roots are the negated set elements, in order of increasing degree.
+ * These are the coefficients accumulateSetFromCoeffs expects.
+ *
+ * @param roots the set elements e_1 through e_n
+ * @param coeffs a vector to which the n+1 coefficients will be appended
+ */
+void computeCoefficients(const std::vector<std::reference_wrapper<Scalar>>& roots,
+                         std::vector<std::unique_ptr<Scalar>>& coeffs);
+
 /**
  * Computes an accumulator from a set of polynomial coefficients, which
  * represent the set to be accumulated as the product in the exponent of
@@ -89,6 +134,9 @@ void accumulateSet(const std::vector<std::reference_wrapper<Scalar>>& set,
  *        contain the accumulated product
  * @param inG2 true if the target accumulator acc is in G2, false if it
  *        is in G1. (Sets are accumulated in G1, witnesses in G2).
+ *        Unlike the other functions, this leaves acc un-normalized (see
+ *        G::normalize), so that callers building many accumulators can
+ *        normalize them all at once.
  * @param threadPool the ThreadPool to use for concurrent computation.
  */
 void accumulateSetFromCoeffs(const std::vector<std::unique_ptr<Scalar>>& coeffs,
@@ -99,11 +147,13 @@ void accumulateSetFromCoeffs(const std::vector<std::unique_ptr<Scalar>>& coeffs,
  * respect to the entire set), placing the results in the given vector
  * in the same order. The results vector must be initialized to the same
  * size as the input vector before calling this method, and contain
- * pointers to (default-constructed) elements of G2.
+ * pointers to (default-constructed) elements of G2, or of G1 if the
+ * accumulators are in G2.
  *
  * @param set a vector of Scalars whose witnesses should be computed
  * @param privKey the private key of this accumulator ("s")
- * @param base the element of G2 that will be used as the base of accumulation
+ * @param base the element of G2 (or G1) that will be used as the base of
+ *        accumulation
  * @param witnesses the witnesses of the elements in set, where the ith
  *        witness in this vector is a witness for the ith element in set
  * @param threadPool the ThreadPool to use for concurrent computation.
@@ -117,7 +167,8 @@ void witnessesForSet(const std::vector<std::reference_wrapper<Scalar>>& set,
  * respsect to the entire set) using only the public key information,
  * placing the results in the given vector. The results vector must be
  * initialized to the same size as the input vector before calling this
- * method, and contain pointers to (default-constructed) elements of G2.
+ * method, and contain pointers to (default-constructed) elements of G2, or
+ * of G1 to compute witnesses for accumulators in G2.
  *
  * @param set a vector of Scalars whose witnesses should be computed
  * @param publicKey the public key of this accumulator
@@ -149,7 +200,8 @@ void pairing(GT& result, const G& g1Element, const G& g2Element);
  * @param element a Scalar that may have been previously accumulated
  *        with {@code accumulator}
  * @param witness an element of group G2 that is a witness for {@code
- *        element}'s membership in the set
+ *        element}'s membership in the set (or of G1, if the accumulator
+ *        is in G2)
  * @param accumulator an accumulator representing the set that {@code
  *        element} should be a member of
  * @param publicKey the public key for the accumulator
@@ -158,6 +210,137 @@ void pairing(GT& result, const G& g1Element, const G& g2Element);
  */
 bool verify(const Scalar& element, const G& witness, const G& accumulator, BilinearMapKey::PublicKey& publicKey);
 
+/*---------------------------------Typed API----------------------------------*/
+/*
+ * The same algorithms on the value types from bilinear/GroupElement.hpp, for
+ * either DCLXVIBackend or Mont64Backend. Sets, keys and witnesses are held by
+ * value in contiguous vectors, so there are no per-element allocations or
+ * virtual calls. The functions above convert their arguments and call these.
+ * Group elements are returned normalized, except by accumulateSetFromCoeffs.
+ */
+
+/** The public key: element i of each vector is the generator raised to s^i */
+template <typename Backend>
+using PublicKeyValues = std::pair<std::vector<G1<Backend>>, std::vector<G2<Backend>>>;
+
+/*
+ * Which groups the accumulators and witnesses go in. By default
+ * (AccumulatorInG1) sets are accumulated in G1 and witnesses are in G2.
+ * AccumulatorInG2 swaps them, which suits workloads that produce and ship many
+ * more witnesses than accumulators: witnesses then have G1's smaller encoding
+ * and cheaper arithmetic. The cost is accumulating in G2 and one G2
+ * exponentiation per verification. Both placements use the same keys.
+ *
+ * Functions that return accumulators or witnesses computed with the public key
+ * take the placement as a template argument. The private-key functions follow
+ * the group of the base they are given, and verify the types of its arguments.
+ */
+template <typename Backend>
+struct AccumulatorInG1 {
+    typedef G1<Backend> Accumulator;
+    typedef G2<Backend> Witness;
+    static const bool ACCUMULATOR_IN_G2 = false;
+
+    static const std::vector<Accumulator>& accumulatorPowers(const PublicKeyValues<Backend>& publicKey) {
+        return publicKey.first;
+    }
+    static const std::vector<Witness>& witnessPowers(const PublicKeyValues<Backend>& publicKey) {
+        return publicKey.second;
+    }
+    // The pairing of an element of each group, whichever order the groups are in
+    static GTElement<Backend> pairing(const Accumulator& accumulatorSide, const Witness& witnessSide) {
+        return ::pairing(accumulatorSide, witnessSide);
+    }
+};
+
+template <typename Backend>
+struct AccumulatorInG2 {
+    typedef G2<Backend> Accumulator;
+    typedef G1<Backend> Witness;
+    static const bool ACCUMULATOR_IN_G2 = true;
+
+    static const std::vector<Accumulator>& accumulatorPowers(const PublicKeyValues<Backend>& publicKey) {
+        return publicKey.second;
+    }
+    static const std::vector<Witness>& witnessPowers(const PublicKeyValues<Backend>& publicKey) {
+        return publicKey.first;
+    }
+    static GTElement<Backend> pairing(const Accumulator& accumulatorSide, const Witness& witnessSide) {
+        return ::pairing(witnessSide, accumulatorSide);
+    }
+};
+
+/** The placement whose accumulators have type Accumulator, G1<Backend> or G2<Backend> */
+template <typename Backend, typename Accumulator>
+using PlacementOf = typename std::conditional<std::is_same<Accumulator, G2<Backend>>::value,
+                                              AccumulatorInG2<Backend>, AccumulatorInG1<Backend>>::type;
+
+/**
+ * Generates a random secret key s and the public key for sets of up to
+ * size elements.
+ */
+template <typename Backend>
+void genKey(size_t size, Fr<Backend>& secretKey, PublicKeyValues<Backend>& publicKey, ThreadPool& threadPool);
+
+/** Generates a random secret key s and a public key of the given sizes */
+template <typename Backend>
+void genKey(const BilinearMapKey::Sizes& sizes, Fr<Backend>& secretKey, PublicKeyValues<Backend>& publicKey,
+            ThreadPool& threadPool);
+
+/** Drops the powers of publicKey beyond sizes, as BilinearMapKey::trimPublicKey does */
+template <typename Backend>
+void trimKey(PublicKeyValues<Backend>& publicKey, const BilinearMapKey::Sizes& sizes);
+
+/**
+ * Returns base^((e_1 + s)(e_2 + s)...(e_n + s)) for the set elements e_i,
+ * in the group of base
+ */
+template <typename Backend, typename Ops>
+GroupElement<Backend, Ops> accumulateSet(const std::vector<Fr<Backend>>& set, const Fr<Backend>& privKey,
+                                         const GroupElement<Backend, Ops>& base);
+
+/** Returns the accumulator of the set, computed with the public key */
+template <typename Backend, typename Placement = AccumulatorInG1<Backend>>
+typename Placement::Accumulator accumulateSet(const std::vector<Fr<Backend>>& set,
+                                              const PublicKeyValues<Backend>& publicKey, ThreadPool& threadPool);
+
+template <typename Backend>
+void computeCoefficients(const std::vector<Fr<Backend>>& roots, std::vector<Fr<Backend>>& coeffs);
+
+/**
+ * Returns the product of powers[i]^coeffs[i], which is an accumulator when
+ * powers is one half of a public key and coeffs come from computeCoefficients.
+ * Works on either half of the key, and leaves the result in Jacobian form.
+ */
+template <typename Backend, typename Ops>
+GroupElement<Backend, Ops> accumulateSetFromCoeffs(const std::vector<Fr<Backend>>& coeffs,
+                                                   const std::vector<GroupElement<Backend, Ops>>& powers,
+                                                   ThreadPool& threadPool);
+
+/**
+ * Returns the witness of each element of the set, in the same order, in the
+ * group of base
+ */
+template <typename Backend, typename Ops>
+std::vector<GroupElement<Backend, Ops>> witnessesForSet(const std::vector<Fr<Backend>>& set,
+                                                        const Fr<Backend>& privKey,
+                                                        const GroupElement<Backend, Ops>& base,
+                                                        ThreadPool& threadPool);
+
+template <typename Backend, typename Placement = AccumulatorInG1<Backend>>
+std::vector<typename Placement::Witness> witnessesForSet(const std::vector<Fr<Backend>>& set,
+                                                         const PublicKeyValues<Backend>& publicKey,
+                                                         ThreadPool& threadPool);
+
+template <typename Backend>
+bool verify(const Fr<Backend>& element, const G2<Backend>& witness, const G1<Backend>& accumulator,
+            const PublicKeyValues<Backend>& publicKey);
+
+/** Verifies a witness in G1 against an accumulator in G2 */
+template <typename Backend>
+bool verify(const Fr<Backend>& element, const G1<Backend>& witness, const G2<Backend>& accumulator,
+            const PublicKeyValues<Backend>& publicKey);
+
 };  // namespace BilinearMapAccumulator
 
 #endif /* _BILINEAR_MAP_ACCUMULATOR_H_ */
@@ -16,13 +16,39 @@ class BilinearMapKey {
 public:
     //first: a vector of G1 elements. second: a vector of G2 elements.
     typedef std::pair<std::vector<std::unique_ptr<G>>, std::vector<std::unique_ptr<G>>> PublicKey;
+    /**
+     * The highest power of s in each half of a public key, which holds g^(s^0)
+     * through g^(s^g1Powers) in G1 and g^(s^0) through g^(s^g2Powers) in G2.
+     * See BilinearMapAccumulator::proverKeySizes and verifierKeySizes.
+     */
+    struct Sizes {
+        size_t g1Powers;
+        size_t g2Powers;
+    };
     BilinearMapKey();
     ~BilinearMapKey();
     Scalar& getSecretKey() const;
     PublicKey& getPublicKey() const;
+    Sizes getPublicKeySizes() const;
+    /**
+     * Drops the powers of the public key beyond sizes, so that a smaller key
+     * (such as a verifier key) can be derived from a full one without
+     * generating it again. Halves that are already small enough are kept.
+     */
+    void trimPublicKey(const Sizes& sizes);
     void readSkFromFile(const char* fName);
     void writeSkToFile(const char* fName) const;
-    void readPkFromFile(const char* fName);
+    /**
+     * Public key files hold the backend of the elements and the number of
+     * elements in each half, followed by the halves. Files in the older
+     * layouts, a single count or two counts without a backend, still load as
+     * DCLXVI keys.
+     *
+     * @return false, leaving the key unchanged, if the file was written for a
+     * backend other than PairingBackend::getDefault(), is shorter than its
+     * header says, or holds an encoding that isn't a point of its group
+     */
+    bool readPkFromFile(const char* fName);
     void writePkToFile(const char* fName) const;
 
 private:
@@ -1,6 +1,8 @@
 #ifndef ORACLEPRIMEREP_H
 #define ORACLEPRIMEREP_H
 
+#include <vector>
+
 #include <algorithms/PrimeRepGenerator.hpp>
 #include <flint/BigInt.hpp>
 
@@ -15,8 +17,27 @@ public:
     ~OraclePrimeRep();
 
     void genRepresentative(const flint::BigInt& element, flint::BigInt& representative);
+    /** The hint is the distance from the padded hash to the representative */
+    void genRepresentativeWithHint(const flint::BigInt& element, flint::BigInt& representative, uint32_t& hint);
+    /**
+     * Accepts a hint less than 2^PADDING_LENGTH that leads to a prime. Since
+     * the padded hashes of different elements are 2^PADDING_LENGTH apart,
+     * such a prime can't represent any other element.
+     */
+    bool representativeFromHint(const flint::BigInt& element, uint32_t hint, flint::BigInt& representative);
+    /** Hashes all the elements in one batch (see SHA256::computeDigests) before searching for their primes */
+    void genRepresentatives(const flint::BigInt* elements, flint::BigInt* representatives, uint32_t* hints,
+                            size_t count);
 
 private:
+    /** Sets paddedHash to the salted hash of element with PADDING_LENGTH zero bits appended */
+    void hashElement(const flint::BigInt& element, flint::BigInt& paddedHash);
+    /** Sets bytes to the input hashElement hashes: the element followed by its salt */
+    void saltElement(const flint::BigInt& element, std::vector<unsigned char>& bytes);
+    /** Sets paddedHash to the hash digest with PADDING_LENGTH zero bits appended */
+    void padHash(const unsigned char* digest, flint::BigInt& paddedHash);
+    /** Finds the representative after a padded hash, and its hint */
+    void findRepresentative(const flint::BigInt& paddedHash, flint::BigInt& representative, uint32_t& hint);
     /**
      * The number of random bytes to append to the element before hashing it.
      */
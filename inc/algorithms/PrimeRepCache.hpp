@@ -0,0 +1,134 @@
+/*
+ * PrimeRepCache.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef PRIMEREPCACHE_HPP_
+#define PRIMEREPCACHE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <algorithms/PrimeRepGenerator.hpp>
+#include <algorithms/RSAKey.hpp>
+#include <flint/BigInt.hpp>
+#include <utils/SHA256.hpp>
+
+/**
+ * A PrimeRepGenerator that remembers the representatives another generator
+ * produces, keyed by the SHA-256 hash of the element, so each element's
+ * search for a prime happens once. Wrapping a public key's generator in one
+ * (see attach) makes genRepresentatives and verify use it.
+ *
+ * Entries live in an open-addressed table of fixed capacity that is only
+ * ever inserted into. Lookups take no locks: a writer claims an empty slot
+ * with a compare-and-swap and publishes it once it is filled in, so readers
+ * only see complete entries. Once the table is three-quarters full, new
+ * representatives are no longer remembered.
+ *
+ * The table can be saved to a file, and a saved file can be mapped back in
+ * read-only with open, where lookups read it in place. A table file is not
+ * trusted: anyone who can write it could otherwise make verify accept a
+ * composite or another element's representative. So an entry found in the
+ * file is only used if the wrapped generator recovers the same
+ * representative from the entry's hint (see representativeFromHint), and it
+ * is then copied to memory so the check happens once per element. Entries
+ * without a hint can't be checked this way and are ignored. A file is
+ *
+ *   header  FILE_HEADER_SIZE bytes: the magic "PREP" (4 bytes), the version
+ *           (2), two zero bytes, the number of slots (8, a power of two)
+ *           and the number of entries (8), little-endian
+ *   slots   FILE_SLOT_SIZE bytes each: the element's hash (32), the hint
+ *           (4), the representative's length in bytes (4, 0 for an empty
+ *           slot), and MAX_REPRESENTATIVE_BYTES holding the representative
+ *           big-endian in its first length bytes and zeros after that
+ *
+ * and an entry is in the slot its hash's first 8 bytes (little-endian) pick
+ * or one of those after it, as in memory.
+ */
+class PrimeRepCache : public PrimeRepGenerator {
+public:
+    static const size_t KEY_BYTES = SHA256::DIGEST_LENGTH;
+    /** Longer representatives are passed through without being cached */
+    static const size_t MAX_REPRESENTATIVE_BYTES = 48;
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+    static const uint16_t FILE_VERSION = 1;
+    static const size_t FILE_HEADER_SIZE = 24;
+    static const size_t FILE_SLOT_SIZE = KEY_BYTES + 8 + MAX_REPRESENTATIVE_BYTES;
+
+    /**
+     * @param generator the generator whose representatives are cached
+     * @param capacity the number of slots in the in-memory table, rounded up
+     *        to a power of two; it holds up to three-quarters as many entries
+     */
+    explicit PrimeRepCache(std::unique_ptr<PrimeRepGenerator> generator, size_t capacity = DEFAULT_CAPACITY);
+    ~PrimeRepCache();
+    PrimeRepCache(const PrimeRepCache&) = delete;
+    PrimeRepCache& operator=(const PrimeRepCache&) = delete;
+
+    /**
+     * Replaces the key's generator with a cache around it, unless it
+     * already is one.
+     * @return the key's cache
+     */
+    static PrimeRepCache& attach(RSAKey::PublicKey& publicKey, size_t capacity = DEFAULT_CAPACITY);
+
+    void genRepresentative(const flint::BigInt& element, flint::BigInt& representative);
+    void genRepresentativeWithHint(const flint::BigInt& element, flint::BigInt& representative, uint32_t& hint);
+    /**
+     * Returns the cached representative if there is one, and otherwise asks
+     * the wrapped generator. A representative recovered from a hint is not
+     * cached, since it need not be the one genRepresentative would give.
+     */
+    bool representativeFromHint(const flint::BigInt& element, uint32_t hint, flint::BigInt& representative);
+    /** Looks up all the elements, and passes the ones that aren't cached to the wrapped generator together */
+    void genRepresentatives(const flint::BigInt* elements, flint::BigInt* representatives, uint32_t* hints,
+                            size_t count);
+
+    /**
+     * Looks element up in memory and then in the mapped file, if any. An
+     * entry from the file is checked against the wrapped generator first.
+     * @param hint if not NULL, receives the representative's hint
+     * @return false if the element isn't cached
+     */
+    bool lookup(const flint::BigInt& element, flint::BigInt& representative, uint32_t* hint = NULL) const;
+    /** @return the number of entries in memory, not counting the mapped file */
+    size_t size() const;
+
+    /**
+     * Writes every entry, from memory and from the mapped file, to a new
+     * table file.
+     * @return false if the file couldn't be written
+     */
+    bool save(const char* fileName) const;
+    /**
+     * Maps a table file written by save. A cache maps at most one file, for
+     * its whole lifetime, so lookups running at the same time either see the
+     * whole file or none of it.
+     * @return false if a file is already mapped, or if the file can't be
+     *         read or isn't a valid table
+     */
+    bool open(const char* fileName);
+
+private:
+    struct Slot;
+    struct MappedFile;
+
+    std::unique_ptr<PrimeRepGenerator> generator;
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    //Lookups copy checked entries from the file into the table, so they change it even when const
+    mutable std::atomic<size_t> count;
+    //The mapped file, if any, published once open has checked it
+    std::atomic<const MappedFile*> mapped;
+
+    void insert(const unsigned char* key, const flint::BigInt& representative, uint32_t hint) const;
+    bool lookupMemory(const unsigned char* key, flint::BigInt& representative, uint32_t* hint) const;
+    bool lookupFile(const flint::BigInt& element, const unsigned char* key, flint::BigInt& representative,
+                    uint32_t* hint) const;
+};
+
+#endif /* PRIMEREPCACHE_HPP_ */
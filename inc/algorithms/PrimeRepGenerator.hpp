@@ -1,6 +1,9 @@
 #ifndef PRIMEREPGENERATOR_H
 #define PRIMEREPGENERATOR_H
 
+#include <cstddef>
+#include <cstdint>
+
 #include <flint/BigInt.hpp>
 
 /**
@@ -21,6 +24,38 @@ public:
      *         after running this function
      */
     virtual void genRepresentative(const flint::BigInt& element, flint::BigInt& representative) = 0;
+
+    /** The hint of a representative that can't be recovered from a hint */
+    static const uint32_t NO_HINT = UINT32_MAX;
+    /**
+     * Generates a representative like genRepresentative, and also a small
+     * hint from which representativeFromHint can recover it without
+     * searching. Generators that don't support hints give NO_HINT, which is
+     * what this default does.
+     * @param hint set to the representative's hint, or NO_HINT
+     */
+    virtual void genRepresentativeWithHint(const flint::BigInt& element, flint::BigInt& representative,
+                                           uint32_t& hint);
+    /**
+     * Recovers the representative of element from a hint that
+     * genRepresentativeWithHint gave. Hints come from untrusted parties, so
+     * implementations must check that the result is a prime that could only
+     * represent this element; it may still be a different prime than the
+     * one genRepresentative gives, in which case it won't match anything
+     * that was accumulated. This default supports no hints.
+     * @return false if the hint doesn't lead to a valid representative
+     */
+    virtual bool representativeFromHint(const flint::BigInt& element, uint32_t hint,
+                                        flint::BigInt& representative);
+    /**
+     * Generates the representatives of count elements, and their hints, so
+     * that representatives[i] and hints[i] are what genRepresentativeWithHint
+     * gives for elements[i]. Generators that can share work between
+     * elements, such as hashing them together, override this; the default
+     * generates them one at a time.
+     */
+    virtual void genRepresentatives(const flint::BigInt* elements, flint::BigInt* representatives, uint32_t* hints,
+                                    size_t count);
 };
 
 #endif  // PRIMEREPGENERATOR_H
@@ -0,0 +1,255 @@
+/*
+ * ProofBundle.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef PROOFBUNDLE_HPP_
+#define PROOFBUNDLE_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+
+#include <algorithms/BilinearMapAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+
+#include <bilinear/GroupElement.hpp>
+#include <utils/BinaryIO.hpp>
+
+/*
+ * A wire format for membership proofs: one accumulator and any number of
+ * (element, witness) records proving membership in it, for either kind of
+ * accumulator. A bundle is
+ *
+ *   header       HEADER_SIZE bytes, see below
+ *   accumulator  accumulatorSize bytes, padded to ALIGNMENT
+ *   records      count records of recordSize bytes, each an element padded
+ *                to ALIGNMENT followed by its witness padded to ALIGNMENT
+ *
+ * The header holds, little-endian: the magic "ACCP" (4 bytes), the version
+ * (2), the Scheme (1), a zero byte, the size of the whole bundle (8), count
+ * (8), and accumulatorSize, elementSize, witnessSize and recordSize (4 each).
+ * Since every field starts at a multiple of ALIGNMENT, a bundle in an aligned
+ * buffer (such as an mmap'ed file) has its group elements naturally aligned.
+ *
+ * Bilinear-map bundles hold the accumulator, elements and witnesses in the
+ * encodings of GroupElement::encode and Fr::encode (the same bytes writeToFile
+ * writes), with the accumulator in G1 and witnesses in G2 or, for the
+ * *_ACCUMULATOR_IN_G2 schemes, the other way around. RSA bundles hold big-endian
+ * integers: elements zero-padded to a size chosen by the writer, and the
+ * accumulator and witnesses to the length of the modulus.
+ */
+namespace ProofBundle {
+
+enum Scheme : uint8_t {
+    BILINEAR_DCLXVI = 1,
+    BILINEAR_MONT64 = 2,
+    RSA_ACCUMULATOR = 3,
+    BILINEAR_DCLXVI_ACCUMULATOR_IN_G2 = 4,
+    BILINEAR_MONT64_ACCUMULATOR_IN_G2 = 5
+};
+
+const uint16_t VERSION = 1;
+const size_t HEADER_SIZE = 40;
+const size_t ALIGNMENT = 8;
+
+inline size_t align(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+/** The sizes in a bundle's header, from which every offset follows */
+struct Layout {
+    Scheme scheme;
+    uint64_t count;
+    uint32_t accumulatorSize;
+    uint32_t elementSize;
+    uint32_t witnessSize;
+
+    size_t recordSize() const {
+        return align(elementSize) + align(witnessSize);
+    }
+    size_t recordsOffset() const {
+        return HEADER_SIZE + align(accumulatorSize);
+    }
+    size_t bundleSize() const {
+        return recordsOffset() + count * recordSize();
+    }
+};
+
+template <typename Backend, typename Placement = BilinearMapAccumulator::AccumulatorInG1<Backend>>
+Scheme bilinearScheme() {
+    if(Placement::ACCUMULATOR_IN_G2)
+        return Backend::TYPE == PairingBackend::MONT64 ? BILINEAR_MONT64_ACCUMULATOR_IN_G2
+                                                       : BILINEAR_DCLXVI_ACCUMULATOR_IN_G2;
+    return Backend::TYPE == PairingBackend::MONT64 ? BILINEAR_MONT64 : BILINEAR_DCLXVI;
+}
+
+template <typename Backend, typename Placement = BilinearMapAccumulator::AccumulatorInG1<Backend>>
+Layout bilinearLayout(uint64_t count) {
+    return Layout{bilinearScheme<Backend, Placement>(), count, Placement::Accumulator::ENCODED_SIZE,
+                  Fr<Backend>::ENCODED_SIZE, Placement::Witness::ENCODED_SIZE};
+}
+
+/**
+ * The layout of an RSA bundle for the given modulus, with room for elements
+ * of up to elementSize bytes.
+ */
+Layout rsaLayout(const flint::BigInt& modulus, size_t elementSize, uint64_t count);
+
+/** Writes the header of a bundle with the given layout into out */
+void encodeHeader(std::byte* out, const Layout& layout);
+
+/**
+ * A bundle read in place from a buffer, which must stay valid (and unchanged)
+ * while the view is used. Nothing is copied out of the buffer until a proof
+ * is verified, and then only into values on the stack.
+ */
+class View {
+public:
+    View();
+    /**
+     * Checks that data starts with a complete bundle of a known version and
+     * scheme, and makes this a view of it. The bundle may be followed by
+     * other data: getBundleSize says where the next one would start.
+     * @return false, leaving the view empty, if it doesn't
+     */
+    bool parse(const std::byte* data, size_t size);
+
+    const Layout& getLayout() const {
+        return _layout;
+    }
+    Scheme getScheme() const {
+        return _layout.scheme;
+    }
+    size_t getCount() const {
+        return _layout.count;
+    }
+    size_t getBundleSize() const {
+        return _layout.bundleSize();
+    }
+
+    const std::byte* accumulator() const {
+        return _data + HEADER_SIZE;
+    }
+    const std::byte* element(size_t index) const {
+        return _data + _layout.recordsOffset() + index * _layout.recordSize();
+    }
+    const std::byte* witness(size_t index) const {
+        return element(index) + align(_layout.elementSize);
+    }
+
+private:
+    const std::byte* _data;
+    Layout _layout;
+};
+
+/**
+ * Writes a bundle to a BufferedWriter one proof at a time, so a bundle of any
+ * size can be streamed out without holding it in memory. The number of proofs
+ * is fixed when the bundle is started, since it is part of the header.
+ */
+class Writer {
+public:
+    /**
+     * Starts a bilinear-map bundle for count proofs about accumulator, which
+     * may be in either G1 or G2
+     */
+    template <typename Backend, typename Ops>
+    Writer(BufferedWriter& out, GroupElement<Backend, Ops> accumulator, uint64_t count)
+            : Writer(out, bilinearLayout<Backend, BilinearMapAccumulator::PlacementOf<Backend, GroupElement<Backend, Ops>>>(
+                                  count)) {
+        GroupElement<Backend, Ops>::encode(reserve(align(_layout.accumulatorSize)), &accumulator, 1);
+    }
+    /** Starts an RSA bundle for count proofs, with elements of up to elementSize bytes */
+    Writer(BufferedWriter& out, const flint::BigMod& accumulator, size_t elementSize, uint64_t count);
+
+    template <typename Backend, typename Ops>
+    void add(const Fr<Backend>& element, GroupElement<Backend, Ops> witness) {
+        add(&element, &witness, 1);
+    }
+    /** Adds count proofs at once, normalizing the witnesses with one inversion */
+    template <typename Backend, typename Ops>
+    void add(const Fr<Backend>* elements, GroupElement<Backend, Ops>* witnesses, size_t count) {
+        typedef GroupElement<Backend, Ops> Witness;
+        //Witnesses in G1 are for accumulators in G2
+        typedef typename std::conditional<std::is_same<Witness, G1<Backend>>::value,
+                                          BilinearMapAccumulator::AccumulatorInG2<Backend>,
+                                          BilinearMapAccumulator::AccumulatorInG1<Backend>>::type Placement;
+        checkScheme(bilinearScheme<Backend, Placement>(), count);
+        Witness::batchNormalize(witnesses, count);
+        for(size_t i = 0; i < count; i++) {
+            std::byte* record = reserve(_layout.recordSize());
+            Fr<Backend>::encode(record, elements + i, 1);
+            Witness::encode(record + align(_layout.elementSize), witnesses + i, 1);
+        }
+    }
+    template <typename Backend, typename Ops>
+    void add(const std::vector<Fr<Backend>>& elements, std::vector<GroupElement<Backend, Ops>>& witnesses) {
+        add(elements.data(), witnesses.data(), std::min(elements.size(), witnesses.size()));
+    }
+    /** Adds an RSA proof; throws std::length_error if element is too long for the bundle */
+    void add(const flint::BigInt& element, const flint::BigMod& witness);
+
+    /**
+     * Flushes the writer.
+     * @return false if the wrong number of proofs were added or a write failed
+     */
+    bool finish();
+
+private:
+    Writer(BufferedWriter& out, const Layout& layout);
+    //Reserves size bytes of output, zeroed so that padding is deterministic
+    std::byte* reserve(size_t size);
+    //Throws std::logic_error if the bundle is of another scheme or would get too many proofs
+    void checkScheme(Scheme scheme, size_t count);
+
+    BufferedWriter& _out;
+    Layout _layout;
+    uint64_t _written;
+};
+
+/*
+ * Verification takes the accumulator the caller trusts, such as one it
+ * computed or got signed from the owner of the set, since anyone can make
+ * records that check out against an accumulator of their own choosing. The
+ * copy of the accumulator in the bundle must equal it, or the bundle is
+ * rejected. Every value is decoded with the checks of GroupElement::decode,
+ * so a malformed bundle is rejected rather than fed to the group arithmetic.
+ */
+
+/**
+ * Verifies proof index of a bilinear-map bundle against accumulator, which
+ * may be in either G1 or G2. Returns false if the bundle is for another
+ * backend or placement, or holds a different accumulator.
+ */
+template <typename Backend, typename Ops>
+bool verify(const View& bundle, size_t index, const GroupElement<Backend, Ops>& accumulator,
+            const BilinearMapAccumulator::PublicKeyValues<Backend>& publicKey);
+
+/**
+ * Verifies every proof in a bilinear-map bundle against accumulator, pairing
+ * it with the generator of the witnesses' group only once for the whole
+ * bundle.
+ * @return true if the bundle is for this backend and accumulator and all the
+ * proofs verify
+ */
+template <typename Backend, typename Ops>
+bool verifyAll(const View& bundle, const GroupElement<Backend, Ops>& accumulator,
+               const BilinearMapAccumulator::PublicKeyValues<Backend>& publicKey);
+
+/** Verifies proof index of an RSA bundle against accumulator, as RSAAccumulator::verify does */
+bool verify(const View& bundle, size_t index, const flint::BigMod& accumulator, const RSAKey::PublicKey& publicKey);
+bool verifyAll(const View& bundle, const flint::BigMod& accumulator, const RSAKey::PublicKey& publicKey);
+
+/** The element of an RSA proof */
+flint::BigInt rsaElement(const View& bundle, size_t index);
+
+}  // namespace ProofBundle
+
+#endif /* PROOFBUNDLE_HPP_ */
@@ -1,6 +1,7 @@
 #ifndef RSAACCUMULATOR_H
 #define RSAACCUMULATOR_H
 
+#include <functional>
 #include <vector>
 
 #include <flint/BigInt.hpp>
@@ -33,6 +34,27 @@ namespace RSAAccumulator {
  */
 void genKey(const unsigned int elementBits, const unsigned int modulusBits, RSAKey& key);
 
+/**
+ * Generates a key pair like genKey above, but searches for each of the two
+ * primes on every thread of the given ThreadPool at once. Candidates are
+ * drawn from an AutoSeededRandomPool and sieved by the small primes before
+ * they are tested.
+ *
+ * @param elementBits (optional) the number of bits in an element that will
+ *         be accumulated with this key pair. Ignored if 0.
+ * @param modulusBits (optional) the number of bits in the RSA modulus that
+ *         will be generated. Ignored if 0.
+ * @param key the RSAKey object in which the generated key pair will be
+ *         placed.
+ * @param threadPool the ThreadPool to use for concurrent computation.
+ * @param safePrimes if true, p and q are safe primes, so that (p-1)/2 and
+ *         (q-1)/2 are also prime. This is what the strong RSA assumption
+ *         calls for, but takes tens to hundreds of times longer.
+ * @throws std::invalid_argument if the modulus would have fewer than 64 bits
+ */
+void genKey(const unsigned int elementBits, const unsigned int modulusBits, RSAKey& key, ThreadPool& threadPool,
+            const bool safePrimes = false);
+
 /**
  * Generates prime representatives for the given set of bigints, using the
  * given prime representative generator, and places the results in the
@@ -49,6 +71,18 @@ void genKey(const unsigned int elementBits, const unsigned int modulusBits, RSAK
 void genRepresentatives(const std::vector<flint::BigInt>& set, PrimeRepGenerator& repGen,
                         std::vector<flint::BigInt>& reps, ThreadPool& threadPool);
 
+/**
+ * Generates prime representatives like genRepresentatives above, and also
+ * the hint for each one (see PrimeRepGenerator::genRepresentativeWithHint),
+ * which can be handed out with witnesses so that verifiers don't have to
+ * search for the representatives themselves.
+ *
+ * @param hints resized to the size of set, with hints[i] the hint for
+ *        reps[i], or PrimeRepGenerator::NO_HINT
+ */
+void genRepresentatives(const std::vector<flint::BigInt>& set, PrimeRepGenerator& repGen,
+                        std::vector<flint::BigInt>& reps, std::vector<uint32_t>& hints, ThreadPool& threadPool);
+
 /**
  * Accumulates the given set of prime representatives (stored as bigints)
  * using the given RSA accumulator key pair, placing the result into the
@@ -80,6 +114,62 @@ void accumulateSet(const std::vector<flint::BigInt>& reps, const RSAKey& key,
 void accumulateSet(const std::vector<flint::BigInt>& reps, const RSAKey::PublicKey& publicKey,
                    flint::BigMod& accumulator);
 
+/**
+ * Supplies the elements of a set one at a time to accumulateElements: each
+ * call stores the next element in its argument and returns true, or returns
+ * false once there are no more elements.
+ */
+typedef std::function<bool(flint::BigInt& element)> ElementSource;
+
+/**
+ * Accumulates a set of raw elements with the key pair, without first
+ * generating all of their representatives. Elements are read from the
+ * source in batches, each batch's representatives are generated and
+ * multiplied together in the thread pool, and the batch products are folded
+ * into the exponent (mod phi(N)) as they complete, so only a few batches are
+ * held in memory at once, however large the set is. The result is the same
+ * as genRepresentatives followed by accumulateSet.
+ *
+ * @param next the source of the elements, which is only called from the
+ *        calling thread
+ * @param key the key object for this RSA accumulator; its public key's
+ *        generator makes the representatives
+ * @param accumulator A BigMod that will contain the accumulated value of
+ *         the set after running this function
+ * @param threadPool the ThreadPool to use for concurrent computation.
+ * @return the number of elements accumulated
+ * @throws any exception the source or the generator throws, once the
+ *         batches already started have finished
+ */
+size_t accumulateElements(const ElementSource& next, const RSAKey& key, flint::BigMod& accumulator,
+                          ThreadPool& threadPool);
+
+/**
+ * Accumulates a set of raw elements like accumulateElements above, using
+ * only the public key. Without phi(N) the batch products can't be folded
+ * together, so the accumulator is raised to each one as it completes, while
+ * the pool works on the batches after it.
+ */
+size_t accumulateElements(const ElementSource& next, const RSAKey::PublicKey& publicKey,
+                          flint::BigMod& accumulator, ThreadPool& threadPool);
+
+/**
+ * Accumulates the elements in [begin, end) with accumulateElements, where
+ * Key is either an RSAKey or an RSAKey::PublicKey.
+ */
+template<typename Iterator, typename Key>
+size_t accumulateElements(Iterator begin, Iterator end, const Key& key, flint::BigMod& accumulator,
+                          ThreadPool& threadPool) {
+    ElementSource next = [&begin, end](flint::BigInt& element) {
+        if(begin == end)
+            return false;
+        element = *begin;
+        ++begin;
+        return true;
+    };
+    return accumulateElements(next, key, accumulator, threadPool);
+}
+
 /**
  * Computes a witness for each prime representative in the given set
  * (with respect to the entire set), using the given RSA accumulator key
@@ -126,11 +216,196 @@ void witnessesForSet(const std::vector<flint::BigInt>& reps, const RSAKey::Publi
  *         the set that {@code element} should be a member of
  * @param pubKey the public key for the accumulator
  * @return true if the witness verifies the element's set membership with
- *          the accumulator, false otherwise
+ *          the accumulator, false otherwise. A witness whose power is the
+ *          negated accumulator also verifies, since its negation is a valid
+ *          witness; verifyBatch accepts the same witnesses.
  */
 bool verify(const flint::BigInt& element, const flint::BigMod& witness, const flint::BigMod& accumulator,
             const RSAKey::PublicKey& pubKey);
 
+/**
+ * Verifies a witness like verify above, but recovers the element's
+ * representative from a hint that genRepresentatives gave, which takes one
+ * primality test instead of a search. If the hint is NO_HINT or doesn't lead
+ * to a valid representative, the representative is generated as usual; a
+ * hint that leads to some other valid representative makes the check fail.
+ */
+bool verify(const flint::BigInt& element, uint32_t hint, const flint::BigMod& witness,
+            const flint::BigMod& accumulator, const RSAKey::PublicKey& pubKey);
+
+/**
+ * Verifies many independent (element, witness) pairs against one
+ * accumulator at once, with the small-exponents test: for random 64-bit r_i,
+ * it checks that the product of witness_i^(r_i x_i) is accumulator^(sum r_i),
+ * where x_i is the representative of element i. The representatives are
+ * regenerated concurrently in the thread pool, and the product is computed
+ * as a few simultaneous multi-exponentiations that share their squarings,
+ * which costs much less than one exponentiation per pair. Both sides are
+ * squared before they are compared, so that witnesses off by -1 can't cancel
+ * each other out; such witnesses are accepted one at a time by verify too.
+ * Any other wrong witness passes with probability about 2^-64, as long as
+ * its maker doesn't know another element of small order, which (for a
+ * modulus of safe primes) would reveal the factorization.
+ *
+ * @param elements the elements whose membership should be checked
+ * @param witnesses witnesses[i] is the witness for elements[i]
+ * @param accumulator the accumulated value of the set
+ * @param pubKey the public key for the accumulator
+ * @param threadPool the ThreadPool to use for concurrent computation.
+ * @param failures if not NULL, receives the indices of the pairs that don't
+ *        verify, in increasing order, which are found by bisecting the batch
+ * @return true if every pair verifies
+ * @throws std::invalid_argument if elements and witnesses differ in length
+ */
+bool verifyBatch(const std::vector<flint::BigInt>& elements, const std::vector<flint::BigMod>& witnesses,
+                 const flint::BigMod& accumulator, const RSAKey::PublicKey& pubKey, ThreadPool& threadPool,
+                 std::vector<size_t>* failures = NULL);
+
+/**
+ * A membership proof for several elements at once, in the style of Boneh,
+ * Bunz and Fisch: a single witness W for the product x of the elements'
+ * representatives (so that W^x is the accumulator), and a Wesolowski proof
+ * that W^x really is the accumulator, which saves the verifier from
+ * exponentiating by x. The proof is W^floor(x / l) for a 128-bit prime l
+ * derived by hashing W, the accumulator and the representatives.
+ */
+struct BatchWitness {
+    flint::BigMod witness;
+    flint::BigMod proof;
+};
+
+/**
+ * Combines the witnesses of several elements into one witness for all of
+ * them, using Shamir's trick: if w1^x1 = w2^x2 = A and ax1 + bx2 = 1, then
+ * (w1^b w2^a)^(x1 x2) = A. The witnesses may have been computed separately,
+ * with either key. Witnesses are combined in a tree, a level at a time, so
+ * each level's work is spread over the thread pool.
+ *
+ * @param reps the prime representatives of the elements
+ * @param witnesses witnesses[i] is a witness for reps[i]
+ * @param threadPool the ThreadPool to use for concurrent computation.
+ * @return a witness W such that W^(product of reps) is the accumulator
+ * @throws std::invalid_argument if reps and witnesses differ in length or
+ *         are empty, or if a representative is repeated
+ */
+flint::BigMod aggregateWitnesses(const std::vector<flint::BigInt>& reps, const std::vector<flint::BigMod>& witnesses,
+                                 ThreadPool& threadPool);
+
+/**
+ * Aggregates the witnesses of several elements, as aggregateWitnesses does,
+ * and proves that the aggregate witness raised to the product of their
+ * representatives is the accumulator.
+ *
+ * @param reps the prime representatives of the elements, in the order the
+ *        client will list the elements in when verifying
+ * @param witnesses witnesses[i] is a witness for reps[i]
+ * @param accumulator the accumulator the witnesses are for
+ * @param threadPool the ThreadPool to use for concurrent computation.
+ * @throws std::invalid_argument as aggregateWitnesses does
+ */
+BatchWitness proveBatch(const std::vector<flint::BigInt>& reps, const std::vector<flint::BigMod>& witnesses,
+                        const flint::BigMod& accumulator, ThreadPool& threadPool);
+
+/**
+ * Computes a batch proof directly with the secret key, without needing the
+ * elements' witnesses: the aggregate witness is the accumulator raised to
+ * the inverse of the representatives' product mod phi(N), so proving takes
+ * two exponentiations instead of the log(k) rounds of Shamir's trick. Like
+ * every secret-key operation, this trusts that the elements are in the set.
+ *
+ * @param reps the prime representatives of the elements
+ * @param key the key object for this RSA accumulator
+ * @param accumulator the accumulated value of the set
+ * @param threadPool the ThreadPool to use for concurrent computation.
+ * @throws std::invalid_argument if reps is empty, or in the negligibly
+ *         likely case that its product or the challenge shares a factor
+ *         with phi(N)
+ */
+BatchWitness proveBatch(const std::vector<flint::BigInt>& reps, const RSAKey& key, const flint::BigMod& accumulator,
+                        ThreadPool& threadPool);
+
+/**
+ * Verifies several elements at once as members of the set represented by
+ * the given accumulator. Like verify, this regenerates each element's prime
+ * representative (concurrently, in the thread pool), but instead of
+ * raising the witness to the product of the representatives it only needs
+ * two exponentiations by 128-bit numbers, whatever the number of elements.
+ *
+ * @param elements the elements, in the same order as the representatives
+ *        the proof was made with
+ * @param batch the batch proof for elements
+ * @param accumulator the accumulated value of the set
+ * @param pubKey the public key for the accumulator
+ * @param threadPool the ThreadPool to use for concurrent computation.
+ * @return true if every element is proved to be a member of the set
+ */
+bool verifyBatch(const std::vector<flint::BigInt>& elements, const BatchWitness& batch,
+                 const flint::BigMod& accumulator, const RSAKey::PublicKey& pubKey, ThreadPool& threadPool);
+
+/*
+ * Dynamic accumulators: elements can be added to and deleted from an
+ * accumulator without accumulating the whole set again, and a client can
+ * bring its witness up to date with the changes instead of asking for a new
+ * one. Every function takes a batch of changes and folds them into a single
+ * exponent, so a batch costs about as much as one change.
+ */
+
+/**
+ * Adds the given representatives to an accumulator, using only the public
+ * key: the accumulator is raised to their product.
+ *
+ * @param reps the prime representatives of the new elements
+ * @param publicKey the public key for this RSA accumulator
+ * @param accumulator the accumulator, which is updated in place
+ */
+void add(const std::vector<flint::BigInt>& reps, const RSAKey::PublicKey& publicKey, flint::BigMod& accumulator);
+
+/**
+ * Deletes the given representatives from an accumulator, which takes the
+ * secret key: the accumulator is raised to the inverse of their product
+ * mod phi(N). The representatives are not checked to be in the set.
+ *
+ * @param reps the prime representatives of the deleted elements
+ * @param key the key object for this RSA accumulator
+ * @param accumulator the accumulator, which is updated in place
+ * @throws std::invalid_argument in the negligibly likely case that a
+ *         representative shares a factor with phi(N)
+ */
+void remove(const std::vector<flint::BigInt>& reps, const RSAKey& key, flint::BigMod& accumulator);
+
+/**
+ * Adds and deletes representatives with one exponentiation, by the product
+ * of the added ones over the product of the deleted ones mod phi(N).
+ *
+ * @param added the prime representatives of the new elements
+ * @param deleted the prime representatives of the deleted elements
+ * @param key the key object for this RSA accumulator
+ * @param accumulator the accumulator, which is updated in place
+ * @throws std::invalid_argument as remove does
+ */
+void update(const std::vector<flint::BigInt>& added, const std::vector<flint::BigInt>& deleted, const RSAKey& key,
+            flint::BigMod& accumulator);
+
+/**
+ * Brings a witness up to date after a batch of changes to its accumulator,
+ * using only public information. With X and Y the products of the added
+ * and deleted representatives, and a x + b Y = 1 from the extended GCD of
+ * the element's representative x and Y, the new witness is
+ * witness^(b X) * newAccumulator^a. This is a couple of exponentiations,
+ * however large the set is.
+ *
+ * @param rep the prime representative of the element the witness is for
+ * @param witness the element's witness before the changes, which is
+ *        updated in place
+ * @param added the prime representatives of the elements that were added
+ * @param deleted the prime representatives of the elements that were deleted
+ * @param newAccumulator the accumulator after the changes
+ * @return false, leaving the witness unchanged, if the element itself was
+ *         deleted
+ */
+bool updateWitness(const flint::BigInt& rep, flint::BigMod& witness, const std::vector<flint::BigInt>& added,
+                   const std::vector<flint::BigInt>& deleted, const flint::BigMod& newAccumulator);
+
 };  // namespace RSAAccumulator
 
 #endif  // RSAACCUMULATOR_H
@@ -0,0 +1,114 @@
+/*
+ * TablePrimeRep.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TABLEPRIMEREP_HPP_
+#define TABLEPRIMEREP_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <algorithms/PrimeRepGenerator.hpp>
+#include <flint/BigInt.hpp>
+#include <utils/ThreadPool.hpp>
+
+/**
+ * Prime representative generator for elements from a bounded universe, the
+ * integers 0 to size - 1. Element i is represented by the first prime after
+ * (2^domainBits + i) * 2^PADDING_BITS, where 2^domainBits is the smallest
+ * power of two that is at least size, so every representative has the same
+ * length and different elements' representatives are different. The
+ * distance from each element's start to its prime is precomputed into a
+ * table of 16-bit entries, which makes genRepresentative a lookup.
+ *
+ * The table can be saved to a file and mapped back in with load. A file is
+ * a header of HEADER_SIZE bytes, holding the magic "PTAB" (4 bytes), the
+ * version (2), PADDING_BITS (1), domainBits (1) and size (8), followed by
+ * size distances of 2 bytes each, all little-endian.
+ *
+ * A loaded file isn't trusted, since a composite representative would let
+ * witnesses be forged. Checking a whole table on load would take as long as
+ * building it, so each entry of a loaded table is checked the first time it
+ * is used instead: its distance must be odd and the representative must
+ * pass the same deterministic Miller-Rabin test that building uses. A
+ * bitmap of one bit per element remembers which entries have passed.
+ */
+class TablePrimeRep : public PrimeRepGenerator {
+public:
+    /** Low-order bits of each element's start; primes are much closer together than 2^16 */
+    static const unsigned int PADDING_BITS = 16;
+    /** The largest domainBits, which keeps every representative below 2^64 */
+    static const unsigned int MAX_DOMAIN_BITS = 64 - PADDING_BITS - 1;
+    static const uint16_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+
+    /**
+     * Builds the table for the elements 0 to size - 1, with the elements
+     * split among the threads of threadPool.
+     * @throws std::invalid_argument if size is 0 or needs more than
+     *         MAX_DOMAIN_BITS bits
+     */
+    TablePrimeRep(uint64_t size, ThreadPool& threadPool);
+    ~TablePrimeRep();
+    TablePrimeRep(const TablePrimeRep&) = delete;
+    TablePrimeRep& operator=(const TablePrimeRep&) = delete;
+
+    /**
+     * Maps a table file written by save, which stays mapped (read-only) for
+     * the life of the generator.
+     * @return the generator, or NULL if the file can't be read or isn't a
+     *         valid table
+     */
+    static std::unique_ptr<TablePrimeRep> load(const char* fileName);
+    /** @return false if the file couldn't be written */
+    bool save(const char* fileName) const;
+
+    /**
+     * @throws std::out_of_range if element isn't in [0, size)
+     * @throws std::runtime_error if the table was loaded and element's entry
+     *         isn't a prime
+     */
+    void genRepresentative(const flint::BigInt& element, flint::BigInt& representative);
+    /**
+     * @return the representative of element, which must be less than size
+     * @throws std::runtime_error if the table was loaded and element's entry
+     *         isn't a prime
+     */
+    uint64_t representative(uint64_t element) const {
+        uint64_t value = ((domainStart + element) << PADDING_BITS) + distances[element];
+        if(checked && !(checked[element / 64].load(std::memory_order_relaxed) & (1ULL << (element % 64))))
+            checkEntry(element, value);
+        return value;
+    }
+
+    uint64_t getSize() const {
+        return size;
+    }
+    unsigned int getDomainBits() const {
+        return domainBits;
+    }
+
+private:
+    TablePrimeRep();
+    void setDomain(uint64_t size, unsigned int domainBits);
+    //Checks an entry of a loaded table the first time it is used
+    void checkEntry(uint64_t element, uint64_t value) const;
+
+    uint64_t size;
+    unsigned int domainBits;
+    uint64_t domainStart;
+    //Either the table built in memory or the entries of a mapped file
+    const uint16_t* distances;
+    std::vector<uint16_t> builtDistances;
+    const unsigned char* mapped;
+    size_t mappedSize;
+    //For a loaded table, one bit per element that is set once its entry has been checked
+    std::unique_ptr<std::atomic<uint64_t>[]> checked;
+};
+
+#endif /* TABLEPRIMEREP_HPP_ */
@@ -0,0 +1,395 @@
+/*
+ * Backends.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef BACKENDS_HPP_
+#define BACKENDS_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <curvepoint_fp.h>
+#include <curvepoint_fp_multiscalar.h>
+#include <fp12e.h>
+#include <optate.h>
+#include <scalar.h>
+#include <twistpoint_fp2.h>
+#include <twistpoint_fp2_multiscalar.h>
+}
+
+#include <bilinear/G1_DCLXVI.hpp>
+#include <bilinear/G1_Mont64.hpp>
+#include <bilinear/G2_DCLXVI.hpp>
+#include <bilinear/G2_Mont64.hpp>
+#include <bilinear/GT_DCLXVI.hpp>
+#include <bilinear/GT_Mont64.hpp>
+#include <bilinear/Mont64Curve.hpp>
+#include <bilinear/PairingBackend.hpp>
+#include <utils/Metrics.hpp>
+
+extern const scalar_t bn_n;
+extern const curvepoint_fp_t bn_curvegen;
+extern const twistpoint_fp2_t bn_twistgen;
+
+/*
+ * Compile-time descriptions of the pairing backends, for the value types in
+ * bilinear/GroupElement.hpp. Each backend has the same members:
+ *   G1Ops, G2Ops  the point type of the group and static functions on it
+ *   GTOps         the same for GT
+ *   pairing       the pairing on bare points
+ *   TYPE          the matching PairingBackend::Type
+ * The Adapter typedefs name the G/GT class that wraps the same point type,
+ * which is how values cross over to the virtual interface.
+ *
+ * All functions allow the result to alias an operand. Exponents are DCLXVI
+ * scalars on both backends. encode writes the format of the Adapter's
+ * writeToFile, and needs a normalized point. decode reads it back, and
+ * returns false, leaving rop unspecified, unless the bytes are an element of
+ * the group with fully reduced coordinates (see Mont64::g1_isvalid and its
+ * G2 and GT counterparts), so it is safe on untrusted input. For G2 and GT
+ * this costs a multiplication by the group order.
+ */
+
+struct DCLXVIBackend {
+    static const PairingBackend::Type TYPE = PairingBackend::DCLXVI;
+
+    struct G1Ops {
+        typedef curvepoint_fp_struct_t Point;
+        typedef G1DCLXVI Adapter;
+
+        static void setGenerator(Point& rop) {
+            curvepoint_fp_set(&rop, bn_curvegen);
+        }
+        static void setIdentity(Point& rop) {
+            curvepoint_fp_setneutral(&rop);
+        }
+        static bool isEqual(const Point& op1, const Point& op2) {
+            return G1DCLXVI::pointsEqual(&op1, &op2);
+        }
+        static void multiply(Point& rop, const Point& op1, const Point& op2) {
+            G1DCLXVI::multiply(&rop, &op1, &op2);
+        }
+        static void power(Point& rop, const Point& op, const scalar_t scalar) {
+            G1DCLXVI::power(&rop, &op, scalar);
+        }
+        static void batchNormalize(Point* points, size_t count) {
+            G1DCLXVI::batchNormalize(points, count);
+        }
+        static const size_t ENCODED_SIZE = G1DCLXVI::ENCODED_SIZE;
+        static void encode(std::byte* out, const Point& op) {
+            G1DCLXVI::encode(out, &op);
+        }
+        static bool decode(Point& rop, const std::byte* in) {
+            Point decoded;
+            Mont64::G1Point point;
+            if(!integerCoefficients(in, ENCODED_SIZE))
+                return false;
+            G1DCLXVI::decode(&decoded, in);
+            Mont64::g1_from_dclxvi(point, &decoded);
+            if(!Mont64::g1_isvalid(point))
+                return false;
+            Mont64::g1_to_dclxvi(&rop, point);
+            return true;
+        }
+        //DCLXVI's Bos-Coster multi-exponentiation overwrites its inputs, so it gets copies
+        static void multiPower(Point& rop, const Point* points, const scalar_t* scalars, size_t count) {
+            METRICS_COUNT(MSM_CALLS);
+            METRICS_ADD(MSM_POINTS, count);
+            std::vector<Point> pointsCopy(points, points + count);
+            std::vector<ScalarLimbs> scalarsCopy(count);
+            for(size_t i = 0; i < count; i++) {
+                for(int limb = 0; limb < 4; limb++) {
+                    scalarsCopy[i].limbs[limb] = scalars[i][limb];
+                }
+            }
+            curvepoint_fp_multiscalarmult_vartime(&rop, pointsCopy.data(), (scalar_t*)scalarsCopy.data(), count);
+        }
+    };
+
+    struct G2Ops {
+        typedef twistpoint_fp2_struct_t Point;
+        typedef G2DCLXVI Adapter;
+
+        static void setGenerator(Point& rop) {
+            twistpoint_fp2_set(&rop, bn_twistgen);
+        }
+        static void setIdentity(Point& rop) {
+            twistpoint_fp2_setneutral(&rop);
+        }
+        static bool isEqual(const Point& op1, const Point& op2) {
+            return G2DCLXVI::pointsEqual(&op1, &op2);
+        }
+        static void multiply(Point& rop, const Point& op1, const Point& op2) {
+            G2DCLXVI::multiply(&rop, &op1, &op2);
+        }
+        static void power(Point& rop, const Point& op, const scalar_t scalar) {
+            G2DCLXVI::power(&rop, &op, scalar);
+        }
+        static void batchNormalize(Point* points, size_t count) {
+            G2DCLXVI::batchNormalize(points, count);
+        }
+        static const size_t ENCODED_SIZE = G2DCLXVI::ENCODED_SIZE;
+        static void encode(std::byte* out, const Point& op) {
+            G2DCLXVI::encode(out, &op);
+        }
+        static bool decode(Point& rop, const std::byte* in) {
+            Point decoded;
+            Mont64::G2Point point;
+            if(!integerCoefficients(in, ENCODED_SIZE))
+                return false;
+            G2DCLXVI::decode(&decoded, in);
+            Mont64::g2_from_dclxvi(point, &decoded);
+            if(!Mont64::g2_isvalid(point))
+                return false;
+            Mont64::g2_to_dclxvi(&rop, point);
+            return true;
+        }
+        static void multiPower(Point& rop, const Point* points, const scalar_t* scalars, size_t count) {
+            METRICS_COUNT(MSM_CALLS);
+            METRICS_ADD(MSM_POINTS, count);
+            std::vector<Point> pointsCopy(points, points + count);
+            std::vector<ScalarLimbs> scalarsCopy(count);
+            for(size_t i = 0; i < count; i++) {
+                for(int limb = 0; limb < 4; limb++) {
+                    scalarsCopy[i].limbs[limb] = scalars[i][limb];
+                }
+            }
+            twistpoint_fp2_multiscalarmult_vartime(&rop, pointsCopy.data(), (scalar_t*)scalarsCopy.data(), count);
+        }
+    };
+
+    struct GTOps {
+        typedef fp12e_struct_t Element;
+        typedef GTDCLXVI Adapter;
+
+        static void setOne(Element& rop) {
+            fp12e_setone(&rop);
+        }
+        static bool isEqual(const Element& op1, const Element& op2) {
+            return fp12e_iseq(&op1, &op2);
+        }
+        static void multiply(Element& rop, const Element& op1, const Element& op2) {
+            fp12e_mul(&rop, &op1, &op2);
+        }
+        static void square(Element& rop, const Element& op) {
+            GTDCLXVI::square(&rop, &op);
+        }
+        static void power(Element& rop, const Element& op, const scalar_t scalar) {
+            GTDCLXVI::power(&rop, &op, scalar);
+        }
+        static const size_t ENCODED_SIZE = GTDCLXVI::ENCODED_SIZE;
+        static void encode(std::byte* out, const Element& op) {
+            GTDCLXVI::encode(out, &op);
+        }
+        static bool decode(Element& rop, const std::byte* in) {
+            Element decoded;
+            Mont64::Fp12 element;
+            if(!integerCoefficients(in, ENCODED_SIZE))
+                return false;
+            GTDCLXVI::decode(&decoded, in);
+            Mont64::fp12_from_dclxvi(element, &decoded);
+            if(!Mont64::gt_isvalid(element))
+                return false;
+            Mont64::fp12_to_dclxvi(&rop, element);
+            return true;
+        }
+        static void compress(unsigned char* rop, const Element& op) {
+            GTDCLXVI::compress(rop, &op);
+        }
+        static bool decompress(Element& rop, const unsigned char* op) {
+            return GTDCLXVI::decompress(&rop, op);
+        }
+    };
+
+    //optate needs affine points, and takes the G2 argument first
+    static void pairing(GTOps::Element& rop, const G1Ops::Point& p, const G2Ops::Point& q) {
+        curvepoint_fp_t pAffine;
+        twistpoint_fp2_t qAffine;
+        curvepoint_fp_set(pAffine, &p);
+        twistpoint_fp2_set(qAffine, &q);
+        G1DCLXVI::batchNormalize(pAffine, 1);
+        G2DCLXVI::batchNormalize(qAffine, 1);
+        optate(&rop, qAffine, pAffine);
+    }
+
+private:
+    //scalar_t is an array type, which std::vector can't hold
+    struct ScalarLimbs {
+        unsigned long long limbs[4];
+    };
+
+    /*
+     * DCLXVI's representation of an element isn't unique, so decode checks
+     * the value rather than the bytes: every coefficient must be an integer
+     * small enough to convert exactly, and the element is then rebuilt from
+     * its value mod p, so only reduced coefficients reach DCLXVI's arithmetic.
+     */
+    static bool integerCoefficients(const std::byte* in, size_t size) {
+        const mydouble MAX_COEFFICIENT = 1ULL << 50;
+        for(size_t offset = 0; offset < size; offset += sizeof(mydouble)) {
+            mydouble coefficient;
+            memcpy(&coefficient, in + offset, sizeof(mydouble));
+            if(!(std::fabs(coefficient) <= MAX_COEFFICIENT) || coefficient != std::floor(coefficient))
+                return false;
+        }
+        return true;
+    }
+};
+
+struct Mont64Backend {
+    static const PairingBackend::Type TYPE = PairingBackend::MONT64;
+
+    struct G1Ops {
+        typedef Mont64::G1Point Point;
+        typedef G1Mont64 Adapter;
+
+        static void setGenerator(Point& rop) {
+            Mont64::g1_setgenerator(rop);
+        }
+        static void setIdentity(Point& rop) {
+            Mont64::g1_setidentity(rop);
+        }
+        static bool isEqual(const Point& op1, const Point& op2) {
+            return Mont64::g1_iseq(op1, op2);
+        }
+        static void multiply(Point& rop, const Point& op1, const Point& op2) {
+            METRICS_COUNT(G1_MULTIPLICATION);
+            Mont64::g1_add(rop, op1, op2);
+        }
+        static void power(Point& rop, const Point& op, const scalar_t scalar) {
+            METRICS_COUNT(G1_POWER);
+            Mont64::g1_scalarmult(rop, op, scalar);
+        }
+        static void batchNormalize(Point* points, size_t count) {
+            std::vector<Point*> pointers;
+            for(size_t i = 0; i < count; i++) {
+                pointers.push_back(&points[i]);
+            }
+            Mont64::g1_batch_makeaffine(pointers.data(), count);
+        }
+        static const size_t ENCODED_SIZE = sizeof(Point);
+        static void encode(std::byte* out, const Point& op) {
+            memcpy(out, &op, sizeof(op));
+        }
+        static bool decode(Point& rop, const std::byte* in) {
+            Point point;
+            memcpy(&point, in, sizeof(point));
+            if(!Mont64::g1_isvalid(point))
+                return false;
+            rop = point;
+            return true;
+        }
+        static void multiPower(Point& rop, const Point* points, const scalar_t* scalars, size_t count) {
+            METRICS_COUNT(MSM_CALLS);
+            METRICS_ADD(MSM_POINTS, count);
+            Point term;
+            Mont64::g1_setidentity(rop);
+            for(size_t i = 0; i < count; i++) {
+                Mont64::g1_scalarmult(term, points[i], scalars[i]);
+                Mont64::g1_add(rop, rop, term);
+            }
+        }
+    };
+
+    struct G2Ops {
+        typedef Mont64::G2Point Point;
+        typedef G2Mont64 Adapter;
+
+        static void setGenerator(Point& rop) {
+            Mont64::g2_setgenerator(rop);
+        }
+        static void setIdentity(Point& rop) {
+            Mont64::g2_setidentity(rop);
+        }
+        static bool isEqual(const Point& op1, const Point& op2) {
+            return Mont64::g2_iseq(op1, op2);
+        }
+        static void multiply(Point& rop, const Point& op1, const Point& op2) {
+            METRICS_COUNT(G2_MULTIPLICATION);
+            Mont64::g2_add(rop, op1, op2);
+        }
+        static void power(Point& rop, const Point& op, const scalar_t scalar) {
+            METRICS_COUNT(G2_POWER);
+            Mont64::g2_scalarmult(rop, op, scalar);
+        }
+        static void batchNormalize(Point* points, size_t count) {
+            std::vector<Point*> pointers;
+            for(size_t i = 0; i < count; i++) {
+                pointers.push_back(&points[i]);
+            }
+            Mont64::g2_batch_makeaffine(pointers.data(), count);
+        }
+        static const size_t ENCODED_SIZE = sizeof(Point);
+        static void encode(std::byte* out, const Point& op) {
+            memcpy(out, &op, sizeof(op));
+        }
+        static bool decode(Point& rop, const std::byte* in) {
+            Point point;
+            memcpy(&point, in, sizeof(point));
+            if(!Mont64::g2_isvalid(point))
+                return false;
+            rop = point;
+            return true;
+        }
+        static void multiPower(Point& rop, const Point* points, const scalar_t* scalars, size_t count) {
+            METRICS_COUNT(MSM_CALLS);
+            METRICS_ADD(MSM_POINTS, count);
+            Point term;
+            Mont64::g2_setidentity(rop);
+            for(size_t i = 0; i < count; i++) {
+                Mont64::g2_scalarmult(term, points[i], scalars[i]);
+                Mont64::g2_add(rop, rop, term);
+            }
+        }
+    };
+
+    struct GTOps {
+        typedef Mont64::Fp12 Element;
+        typedef GTMont64 Adapter;
+
+        static void setOne(Element& rop) {
+            Mont64::fp12_setone(rop);
+        }
+        static bool isEqual(const Element& op1, const Element& op2) {
+            return Mont64::fp12_iseq(op1, op2);
+        }
+        static void multiply(Element& rop, const Element& op1, const Element& op2) {
+            Mont64::fp12_mul(rop, op1, op2);
+        }
+        static void square(Element& rop, const Element& op) {
+            Mont64::fp12_cyclotomic_square(rop, op);
+        }
+        static void power(Element& rop, const Element& op, const scalar_t scalar) {
+            Mont64::gt_pow(rop, op, scalar);
+        }
+        static const size_t ENCODED_SIZE = sizeof(Element);
+        static void encode(std::byte* out, const Element& op) {
+            memcpy(out, &op, sizeof(op));
+        }
+        static bool decode(Element& rop, const std::byte* in) {
+            Element element;
+            memcpy(&element, in, sizeof(element));
+            if(!Mont64::gt_isvalid(element))
+                return false;
+            rop = element;
+            return true;
+        }
+        static void compress(unsigned char* rop, const Element& op) {
+            Mont64::gt_compress(rop, op);
+        }
+        static bool decompress(Element& rop, const unsigned char* op) {
+            return Mont64::gt_decompress(rop, op);
+        }
+    };
+
+    static void pairing(GTOps::Element& rop, const G1Ops::Point& p, const G2Ops::Point& q) {
+        Mont64::pairing(rop, p, q);
+    }
+};
+
+#endif /* BACKENDS_HPP_ */
@@ -6,6 +6,7 @@
 #ifndef _G_H_
 #define _G_H_
 
+#include <cstddef>
 #include <fstream>
 
 #include <bilinear/Scalar.hpp>
@@ -23,6 +24,10 @@ public:
     // Destructor
     virtual ~G() = 0;
 
+    // Heap allocations of group elements and scalars are counted by MemoryAccounting
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     // Assignment operator
     virtual G& operator=(const G& other) = 0;
 
@@ -44,6 +49,11 @@ public:
     // Power: result = this ^ scalar
     virtual void doPower(const Scalar& scalar, G& result) = 0;
 
+    // Convert to the canonical representation. Group operations may leave
+    // their results in a redundant form (e.g. projective coordinates), which
+    // exportObject, getByteBuffer and writeToFile normalize automatically.
+    virtual void normalize() = 0;
+
     // Import the underlying implementation to this object
     virtual void importObject(const void* obj) = 0;
 
@@ -56,11 +66,24 @@ public:
     // Serialize this object to a read-only byte buffer
     virtual char* getByteBuffer() const = 0;
 
-    // Import object from file
+    // Import object from file. An invalid encoding sets the stream's failbit
     virtual void readFromFile(std::istream& inFile) = 0;
 
     // Export object to file
     virtual void writeToFile(std::ostream& outFile) const = 0;
+
+    // Number of bytes encode writes and decode reads
+    virtual size_t getEncodedSize() const = 0;
+
+    // Encode this object into getEncodedSize() bytes at out, the same bytes
+    // writeToFile writes. To encode many elements back to back, see
+    // PairingBackend::encodeAll and utils/BinaryIO.hpp
+    virtual void encode(std::byte* out) const = 0;
+
+    // Decode an object from the bytes written by encode or writeToFile. Returns
+    // false, leaving this object unchanged, unless the bytes are a point of the group
+    // with reduced coordinates (see bilinear/Backends.hpp), so untrusted input is safe
+    virtual bool decode(const std::byte* in) = 0;
 };
 
 #endif /* _G_H_ */
@@ -10,6 +10,9 @@ extern "C" {
 #include <curvepoint_fp.h>
 }
 
+#include <memory>
+#include <vector>
+
 #include <bilinear/G.hpp>
 #include <bilinear/Scalar_DCLXVI.hpp>
 
@@ -31,20 +34,46 @@ public:
     bool isEqual(const G& other);
     void doMultiplication(const G& other, G& result);
     void doPower(const Scalar& scalar, G& result);
+    void normalize();
     void importObject(const void* obj);
     void exportObject(void* obj) const;
     size_t getSize() const;
     char* getByteBuffer() const;
     void readFromFile(std::istream& inFile);
     void writeToFile(std::ostream& outFile) const;
+    size_t getEncodedSize() const;
+    void encode(std::byte* out) const;
+    bool decode(const std::byte* in);
+
+    // True if this point is in affine form (Z = 1) or is the identity (Z = 0)
+    bool isNormalized() const;
+
+    // Normalize many points at once, with a single field inversion
+    static void batchNormalize(G1DCLXVI* elements, size_t count);
+    static void batchNormalize(const std::vector<std::unique_ptr<G>>& elements);
+    static void batchNormalize(curvepoint_fp_struct_t* points, size_t count);
+
+    // The group operations on bare points, which the methods above wrap; used
+    // by the value types in bilinear/GroupElement.hpp. rop may alias an operand.
+    static bool pointsEqual(const curvepoint_fp_struct_t* op1, const curvepoint_fp_struct_t* op2);
+    static void multiply(curvepoint_fp_struct_t* rop, const curvepoint_fp_struct_t* op1, const curvepoint_fp_struct_t* op2);
+    static void power(curvepoint_fp_struct_t* rop, const curvepoint_fp_struct_t* op, const scalar_t scalar);
+
+    // encode and decode on bare points, which must be normalized for encode
+    static const size_t ENCODED_SIZE = 12 * 4 * sizeof(mydouble);
+    static void encode(std::byte* out, const curvepoint_fp_struct_t* point);
+    static void decode(curvepoint_fp_struct_t* point, const std::byte* in);
 
-    // Get the pointer to G1 object of the underlying DCLXVI implementation
+    // Get the pointer to G1 object of the underlying DCLXVI implementation.
+    // The point may be in Jacobian form; see normalize()
     const curvepoint_fp_struct_t* getUnderlyingObj() const;
     curvepoint_fp_struct_t* getUnderlyingObj();
 
 private:
-    // The underlying G1 object
-    curvepoint_fp_t _curvepoint;
+    // The underlying G1 object, in Jacobian coordinates until something needs
+    // the affine form. Mutable so that const methods can normalize it.
+    mutable curvepoint_fp_t _curvepoint;
+    void makeAffine() const;
     // Required by DCLXVI library after doing mul/pow
     void isReduced(curvepoint_fp_t curvepoint);
 };
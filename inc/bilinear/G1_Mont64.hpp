@@ -0,0 +1,66 @@
+/*
+ * G1_Mont64.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef G1_MONT64_HPP_
+#define G1_MONT64_HPP_
+
+#include <memory>
+#include <vector>
+
+#include <bilinear/G.hpp>
+#include <bilinear/G1_DCLXVI.hpp>
+#include <bilinear/Mont64Curve.hpp>
+#include <bilinear/Scalar_DCLXVI.hpp>
+
+/*
+ * G1 on the Mont64 backend (see bilinear/Mont64Field.hpp). It is the same group
+ * as G1DCLXVI with the same generator, and takes the same ScalarDCLXVI
+ * exponents, but the two can't be mixed in one operation; convert with the
+ * constructor below. Serialized points are not compatible with G1DCLXVI's.
+ */
+
+class G1Mont64 : public G {
+public:
+    // APIs defined in include/bilinear/G.h
+    G1Mont64();
+    G1Mont64(const G1Mont64& other);
+    // Converts a DCLXVI point to the same point on this backend
+    explicit G1Mont64(const G1DCLXVI& other);
+    G& operator=(const G& other);
+    void generateRandom();
+    void becomeIdentity();
+    void becomeGenerator();
+    bool isEqual(const G& other);
+    void doMultiplication(const G& other, G& result);
+    void doPower(const Scalar& scalar, G& result);
+    void normalize();
+    void importObject(const void* obj);
+    void exportObject(void* obj) const;
+    size_t getSize() const;
+    char* getByteBuffer() const;
+    void readFromFile(std::istream& inFile);
+    void writeToFile(std::ostream& outFile) const;
+    size_t getEncodedSize() const;
+    void encode(std::byte* out) const;
+    bool decode(const std::byte* in);
+
+    // True if this point is in affine form (Z = 1) or is the identity (Z = 0)
+    bool isNormalized() const;
+
+    // Normalize many points at once, with a single field inversion
+    static void batchNormalize(G1Mont64* elements, size_t count);
+    static void batchNormalize(const std::vector<std::unique_ptr<G>>& elements);
+
+    // Get the underlying point, which may be in Jacobian form; see normalize()
+    const Mont64::G1Point* getUnderlyingObj() const;
+    Mont64::G1Point* getUnderlyingObj();
+
+private:
+    // Mutable so that const methods can normalize it
+    mutable Mont64::G1Point _point;
+};
+
+#endif /* G1_MONT64_HPP_ */
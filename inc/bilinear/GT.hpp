@@ -6,6 +6,7 @@
 #ifndef _GT_H_
 #define _GT_H_
 
+#include <cstddef>
 #include <fstream>
 
 #include <bilinear/Scalar.hpp>
@@ -23,12 +24,25 @@ public:
     // Destructor
     virtual ~GT() = 0;
 
+    // Heap allocations of group elements and scalars are counted by MemoryAccounting
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     // Assignment operator
     virtual GT& operator=(const GT& e) = 0;
 
     // Multiplication: result = this * other
     virtual void doMultiplication(const GT& other, GT& result) = 0;
 
+    // In-place multiplication: this = this * other
+    virtual void multiplyBy(const GT& other) = 0;
+
+    // Square: result = this * this, which is cheaper than doMultiplication.
+    // Requires this to be in GT, the pairing's image (including products and
+    // powers of pairings): the squaring formula only holds in the cyclotomic
+    // subgroup, and gives a wrong result for any other element of Fp12
+    virtual void doSquare(GT& result) = 0;
+
     // Power: result = this ^ scalar
     virtual void doPower(const Scalar& scalar, GT& result) = 0;
 
@@ -41,11 +55,37 @@ public:
     // Export this object to the underlying implementation
     virtual void exportObject(void* obj) const = 0;
 
-    // Import object from file
+    // Import object from file. An invalid encoding sets the stream's failbit
     virtual void readFromFile(std::istream& inFile) = 0;
 
     // Export object to file
     virtual void writeToFile(std::ostream& outFile) const = 0;
+
+    // Number of bytes encode writes and decode reads
+    virtual size_t getEncodedSize() const = 0;
+
+    // Encode this object into getEncodedSize() bytes at out, the same bytes
+    // writeToFile writes
+    virtual void encode(std::byte* out) const = 0;
+
+    // Decode an object from the bytes written by encode or writeToFile. Returns
+    // false, leaving this object unchanged, unless the bytes are an element of GT
+    // with reduced coordinates (see bilinear/Backends.hpp), so untrusted input is safe
+    virtual bool decode(const std::byte* in) = 0;
+
+    // Number of bytes written by writeCompressedToFile
+    static const size_t COMPRESSED_SIZE = 193;
+
+    // Import an object written by writeCompressedToFile on either backend;
+    // returns false, leaving this object unchanged, unless the bytes are the
+    // encoding of an element of GT. Checking membership costs about as much
+    // as an exponentiation
+    virtual bool readCompressedFromFile(std::istream& inFile) = 0;
+
+    // Export object to file in a compact, backend-independent form. Only
+    // elements of the pairing's image (and products and powers of them) can
+    // be written this way
+    virtual void writeCompressedToFile(std::ostream& outFile) const = 0;
 };
 
 #endif /* _GT_H_ */
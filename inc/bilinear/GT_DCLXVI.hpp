@@ -26,12 +26,29 @@ public:
     GTDCLXVI(const GTDCLXVI& other);
     GT& operator=(const GT& other);
     void doMultiplication(const GT& other, GT& result);
+    void multiplyBy(const GT& other);
+    void doSquare(GT& result);
     void doPower(const Scalar& scalar, GT& result);
     int isEqual(const GT& other);
     void importObject(const void* obj);
     void exportObject(void* obj) const;
     void readFromFile(std::istream& inFile);
     void writeToFile(std::ostream& outFile) const;
+    bool readCompressedFromFile(std::istream& inFile);
+    void writeCompressedToFile(std::ostream& outFile) const;
+    size_t getEncodedSize() const;
+    void encode(std::byte* out) const;
+    bool decode(const std::byte* in);
+
+    // doSquare, doPower and the encodings on bare elements, for the
+    // value types in bilinear/GroupElement.hpp
+    static void square(fp12e_struct_t* rop, const fp12e_struct_t* op);
+    static void power(fp12e_struct_t* rop, const fp12e_struct_t* op, const scalar_t scalar);
+    static void compress(unsigned char* rop, const fp12e_struct_t* op);
+    static bool decompress(fp12e_struct_t* rop, const unsigned char* op);
+    static const size_t ENCODED_SIZE = 6 * 24 * sizeof(mydouble);
+    static void encode(std::byte* out, const fp12e_struct_t* element);
+    static void decode(fp12e_struct_t* element, const std::byte* in);
 
 private:
     // The underlying GT object
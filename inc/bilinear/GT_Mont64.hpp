@@ -0,0 +1,49 @@
+/*
+ * GT_Mont64.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef GT_MONT64_HPP_
+#define GT_MONT64_HPP_
+
+#include <bilinear/GT.hpp>
+#include <bilinear/GT_DCLXVI.hpp>
+#include <bilinear/Mont64Field.hpp>
+#include <bilinear/Scalar_DCLXVI.hpp>
+
+/*
+ * GT on the Mont64 backend. Elements are expected to come out of the pairing
+ * (or be products and powers of such), since doPower relies on them lying in
+ * the cyclotomic subgroup.
+ */
+
+class GTMont64 : public GT {
+public:
+    // APIs defined in include/bilinear/GT.h
+    GTMont64();
+    GTMont64(const GTMont64& other);
+    // Converts a DCLXVI element to the same element on this backend
+    explicit GTMont64(const GTDCLXVI& other);
+    GT& operator=(const GT& other);
+    void doMultiplication(const GT& other, GT& result);
+    void multiplyBy(const GT& other);
+    void doSquare(GT& result);
+    void doPower(const Scalar& scalar, GT& result);
+    int isEqual(const GT& other);
+    void importObject(const void* obj);
+    void exportObject(void* obj) const;
+    void readFromFile(std::istream& inFile);
+    void writeToFile(std::ostream& outFile) const;
+    size_t getEncodedSize() const;
+    void encode(std::byte* out) const;
+    bool decode(const std::byte* in);
+    bool readCompressedFromFile(std::istream& inFile);
+    void writeCompressedToFile(std::ostream& outFile) const;
+
+private:
+    // The underlying element of Fp12, initially 1
+    Mont64::Fp12 _element;
+};
+
+#endif /* GT_MONT64_HPP_ */
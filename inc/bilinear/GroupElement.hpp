@@ -0,0 +1,336 @@
+/*
+ * GroupElement.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef GROUPELEMENT_HPP_
+#define GROUPELEMENT_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <scalar.h>
+}
+
+#include <flint/BigMod.hpp>
+
+#include <bilinear/Backends.hpp>
+#include <bilinear/G.hpp>
+#include <bilinear/GT.hpp>
+#include <bilinear/Scalar.hpp>
+#include <bilinear/Scalar_DCLXVI.hpp>
+#include <utils/BinaryIO.hpp>
+#include <utils/Metrics.hpp>
+#include <utils/Pointers.hpp>
+
+/*
+ * Value types for the pairing groups, specialized at compile time on one of
+ * the backends in bilinear/Backends.hpp:
+ *   Fr<Backend>         an exponent, an integer mod the group order
+ *   G1<Backend>         a point of G1
+ *   G2<Backend>         a point of G2
+ *   GTElement<Backend>  an element of GT
+ * Unlike G, GT and Scalar they have no virtual functions and hold their point
+ * directly, so they can be kept by value in a contiguous std::vector and every
+ * operation is a direct call into the backend. The constructors taking a G, GT
+ * or Scalar and the exportTo methods convert to and from the virtual classes.
+ *
+ * Like the G classes, points stay in Jacobian form after operations until
+ * normalize or batchNormalize is called.
+ */
+
+template <typename Backend>
+class Fr {
+public:
+    // Zero
+    Fr() : _value{0, 0, 0, 0} {}
+    explicit Fr(const Scalar& scalar) {
+        scalar.exportObject(_value);
+    }
+    explicit Fr(const flint::BigMod& value) {
+        ScalarDCLXVI scalar(value);
+        scalar.exportObject(_value);
+    }
+
+    void generateRandom() {
+        scalar_setrandom(_value, bn_n);
+    }
+    void exportTo(Scalar& scalar) const {
+        scalar.importObject(_value);
+    }
+    void exportTo(flint::BigMod& value) const {
+        ScalarDCLXVI scalar;
+        scalar.importObject(_value);
+        scalar.exportFlintObject(value);
+    }
+
+    const unsigned long long* getLimbs() const {
+        return _value;
+    }
+
+    // The encoding of ScalarDCLXVI::encode, for count elements back to back
+    static const size_t ENCODED_SIZE = sizeof(scalar_t);
+    static void encode(std::byte* out, const Fr* elements, size_t count) {
+        memcpy(out, elements, count * ENCODED_SIZE);
+    }
+    // Returns false if any of the elements isn't below the group order
+    static bool decode(Fr* elements, const std::byte* in, size_t count) {
+        memcpy(elements, in, count * ENCODED_SIZE);
+        for(size_t i = 0; i < count; i++) {
+            if(!scalar_lt_vartime(elements[i]._value, bn_n))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    scalar_t _value;
+};
+
+template <typename Backend, typename Ops>
+class GroupElement {
+public:
+    typedef typename Ops::Point Point;
+
+    // The generator, like the default constructors of the G classes
+    GroupElement() {
+        Ops::setGenerator(_point);
+    }
+    // Copies a point out of the G class of the same backend and group
+    explicit GroupElement(const G& element) {
+        _point = *ref_cast<typename Ops::Adapter>(element).getUnderlyingObj();
+    }
+
+    static GroupElement identity() {
+        GroupElement identity;
+        Ops::setIdentity(identity._point);
+        return identity;
+    }
+
+    void exportTo(G& element) const {
+        ref_cast<typename Ops::Adapter>(element).importObject(&_point);
+    }
+
+    bool operator==(const GroupElement& other) const {
+        return Ops::isEqual(_point, other._point);
+    }
+    bool operator!=(const GroupElement& other) const {
+        return !Ops::isEqual(_point, other._point);
+    }
+
+    // The group operation, written multiplicatively as in G
+    GroupElement operator*(const GroupElement& other) const {
+        GroupElement product(*this);
+        Ops::multiply(product._point, _point, other._point);
+        return product;
+    }
+    GroupElement& operator*=(const GroupElement& other) {
+        Ops::multiply(_point, _point, other._point);
+        return *this;
+    }
+
+    GroupElement pow(const Fr<Backend>& exponent) const {
+        GroupElement power(*this);
+        Ops::power(power._point, _point, exponent.getLimbs());
+        return power;
+    }
+
+    /**
+     * Computes the product of bases[i]^exponents[i] over i < count, with the
+     * backend's multi-exponentiation if it has one
+     */
+    static GroupElement multiPower(const GroupElement* bases, const Fr<Backend>* exponents, size_t count) {
+        static_assert(sizeof(GroupElement) == sizeof(Point), "GroupElement must be a bare point");
+        static_assert(sizeof(Fr<Backend>) == sizeof(scalar_t), "Fr must be a bare scalar_t");
+        GroupElement product;
+        Ops::multiPower(product._point, reinterpret_cast<const Point*>(bases),
+                        reinterpret_cast<const scalar_t*>(exponents), count);
+        return product;
+    }
+
+    void normalize() {
+        Ops::batchNormalize(&_point, 1);
+    }
+
+    // Normalizes count elements with a single field inversion
+    static void batchNormalize(GroupElement* elements, size_t count) {
+        static_assert(sizeof(GroupElement) == sizeof(Point), "GroupElement must be a bare point");
+        Ops::batchNormalize(reinterpret_cast<Point*>(elements), count);
+    }
+    static void batchNormalize(std::vector<GroupElement>& elements) {
+        batchNormalize(elements.data(), elements.size());
+    }
+
+    /**
+     * Encodes count elements back to back into out, which must have room for
+     * count * ENCODED_SIZE bytes, in the format of the G class's writeToFile.
+     * The elements are normalized first with a single field inversion.
+     */
+    static const size_t ENCODED_SIZE = Ops::ENCODED_SIZE;
+    static void encode(std::byte* out, GroupElement* elements, size_t count) {
+        batchNormalize(elements, count);
+        for(size_t i = 0; i < count; i++) {
+            Ops::encode(out + i * ENCODED_SIZE, elements[i]._point);
+        }
+    }
+    /**
+     * Decodes count elements written by encode. Returns false if any of them
+     * isn't a point of the group in normalized form (see bilinear/Backends.hpp),
+     * which makes this safe on untrusted input.
+     */
+    static bool decode(GroupElement* elements, const std::byte* in, size_t count) {
+        for(size_t i = 0; i < count; i++) {
+            if(!Ops::decode(elements[i]._point, in + i * ENCODED_SIZE))
+                return false;
+        }
+        return true;
+    }
+
+    const Point& getPoint() const {
+        return _point;
+    }
+    Point& getPoint() {
+        return _point;
+    }
+
+private:
+    Point _point;
+};
+
+template <typename Backend>
+using G1 = GroupElement<Backend, typename Backend::G1Ops>;
+template <typename Backend>
+using G2 = GroupElement<Backend, typename Backend::G2Ops>;
+
+template <typename Backend>
+class GTElement {
+public:
+    typedef typename Backend::GTOps::Element Element;
+
+    // One, like the default constructors of the GT classes
+    GTElement() {
+        Backend::GTOps::setOne(_element);
+    }
+    explicit GTElement(const GT& element) {
+        ref_cast<typename Backend::GTOps::Adapter>(element).exportObject(&_element);
+    }
+
+    void exportTo(GT& element) const {
+        ref_cast<typename Backend::GTOps::Adapter>(element).importObject(&_element);
+    }
+
+    bool operator==(const GTElement& other) const {
+        return Backend::GTOps::isEqual(_element, other._element);
+    }
+    bool operator!=(const GTElement& other) const {
+        return !Backend::GTOps::isEqual(_element, other._element);
+    }
+    GTElement operator*(const GTElement& other) const {
+        GTElement product;
+        Backend::GTOps::multiply(product._element, _element, other._element);
+        return product;
+    }
+    GTElement& operator*=(const GTElement& other) {
+        Backend::GTOps::multiply(_element, _element, other._element);
+        return *this;
+    }
+    GTElement square() const {
+        GTElement result;
+        Backend::GTOps::square(result._element, _element);
+        return result;
+    }
+    GTElement pow(const Fr<Backend>& exponent) const {
+        GTElement power;
+        Backend::GTOps::power(power._element, _element, exponent.getLimbs());
+        return power;
+    }
+
+    // The encoding of the GT class's writeToFile, for count elements back to back
+    static const size_t ENCODED_SIZE = Backend::GTOps::ENCODED_SIZE;
+    static void encode(std::byte* out, const GTElement* elements, size_t count) {
+        for(size_t i = 0; i < count; i++) {
+            Backend::GTOps::encode(out + i * ENCODED_SIZE, elements[i]._element);
+        }
+    }
+    // Returns false if any of the elements isn't in GT
+    static bool decode(GTElement* elements, const std::byte* in, size_t count) {
+        for(size_t i = 0; i < count; i++) {
+            if(!Backend::GTOps::decode(elements[i]._element, in + i * ENCODED_SIZE))
+                return false;
+        }
+        return true;
+    }
+
+    // The encoding of GT::writeCompressedToFile, GT::COMPRESSED_SIZE bytes
+    void compress(unsigned char* bytes) const {
+        Backend::GTOps::compress(bytes, _element);
+    }
+    // Returns false, leaving this element unchanged, if the bytes aren't a valid encoding
+    bool decompress(const unsigned char* bytes) {
+        return Backend::GTOps::decompress(_element, bytes);
+    }
+
+    const Element& getElement() const {
+        return _element;
+    }
+    Element& getElement() {
+        return _element;
+    }
+
+private:
+    Element _element;
+};
+
+template <typename Backend>
+GTElement<Backend> pairing(const G1<Backend>& p, const G2<Backend>& q) {
+    METRICS_COUNT(PAIRING);
+    GTElement<Backend> result;
+    Backend::pairing(result.getElement(), p.getPoint(), q.getPoint());
+    return result;
+}
+
+/**
+ * Writes elements to writer, T::ENCODED_SIZE bytes each, for any of the value
+ * types above. Points are normalized along the way. Elements are encoded
+ * straight into the writer's buffer a block at a time.
+ */
+template <typename T>
+void writeElements(BufferedWriter& writer, std::vector<T>& elements) {
+    const size_t BLOCK = 512;
+    for(size_t start = 0; start < elements.size(); start += BLOCK) {
+        size_t count = std::min(BLOCK, elements.size() - start);
+        T::encode(writer.reserve(count * T::ENCODED_SIZE), elements.data() + start, count);
+    }
+}
+
+/**
+ * Reads count elements written by writeElements and appends them to elements.
+ * Returns false if the input ends first or holds an invalid encoding, keeping
+ * the valid elements read before that.
+ */
+template <typename T>
+bool readElements(BufferedReader& reader, size_t count, std::vector<T>& elements) {
+    const size_t BLOCK = 512;
+    for(size_t start = 0; start < count; start += BLOCK) {
+        size_t blockCount = std::min(BLOCK, count - start);
+        const std::byte* in = reader.take(blockCount * T::ENCODED_SIZE);
+        if(in == NULL)
+            return false;
+        size_t oldSize = elements.size();
+        elements.resize(oldSize + blockCount);
+        //One at a time, so that a failure leaves exactly the valid elements before it
+        for(size_t i = 0; i < blockCount; i++) {
+            if(!T::decode(elements.data() + oldSize + i, in + i * T::ENCODED_SIZE, 1)) {
+                elements.resize(oldSize + i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+#endif /* GROUPELEMENT_HPP_ */
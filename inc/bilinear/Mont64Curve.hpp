@@ -0,0 +1,130 @@
+/*
+ * Mont64Curve.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MONT64CURVE_HPP_
+#define MONT64CURVE_HPP_
+
+#include <cstddef>
+
+extern "C" {
+#include <curvepoint_fp.h>
+#include <fp12e.h>
+#include <scalar.h>
+#include <twistpoint_fp2.h>
+}
+
+#include <bilinear/Mont64Field.hpp>
+
+/**
+ * Group arithmetic and the optimal ate pairing for the Mont64 backend, on the
+ * same groups as DCLXVI: G1 is y^2 = x^3 + 3 over Fp, G2 is the D-type sextic
+ * twist y^2 = x^3 + 3/xi over Fp2, and GT is the order-n subgroup of Fp12*.
+ *
+ * Points are kept in Jacobian coordinates (X/Z^2, Y/Z^3), like DCLXVI's, with
+ * Z = 0 for the identity. The conversions to and from DCLXVI's types exist so
+ * the two backends can be cross-checked and existing keys migrated.
+ */
+namespace Mont64 {
+
+struct G1Point {
+    Fp x, y, z;
+};
+
+struct G2Point {
+    Fp2 x, y, z;
+};
+
+/*---------------------------------------G1-----------------------------------*/
+
+void g1_setgenerator(G1Point& rop);
+void g1_setidentity(G1Point& rop);
+bool g1_isidentity(const G1Point& op);
+/** True if the two points are the same, whatever their Z coordinates */
+bool g1_iseq(const G1Point& op1, const G1Point& op2);
+void g1_double(G1Point& rop, const G1Point& op);
+/** Adds any two points, including equal points, inverses and the identity */
+void g1_add(G1Point& rop, const G1Point& op1, const G1Point& op2);
+void g1_neg(G1Point& rop, const G1Point& op);
+/** rop = op^scalar, with a GLV decomposition of the scalar */
+void g1_scalarmult(G1Point& rop, const G1Point& op, const scalar_t scalar);
+void g1_makeaffine(G1Point& op);
+/** Brings count points to affine form with a single field inversion */
+void g1_batch_makeaffine(G1Point* const* points, size_t count);
+/**
+ * True if op is a point of G1 in the form points are encoded in: fully
+ * reduced coordinates, and either Z = 1 and (X, Y) on the curve or Z = 0 for
+ * the identity. The curve has prime order n, so every point on it is in G1.
+ */
+bool g1_isvalid(const G1Point& op);
+
+/*---------------------------------------G2-----------------------------------*/
+
+void g2_setgenerator(G2Point& rop);
+void g2_setidentity(G2Point& rop);
+bool g2_isidentity(const G2Point& op);
+bool g2_iseq(const G2Point& op1, const G2Point& op2);
+void g2_double(G2Point& rop, const G2Point& op);
+void g2_add(G2Point& rop, const G2Point& op1, const G2Point& op2);
+void g2_neg(G2Point& rop, const G2Point& op);
+/** rop = op^scalar, with a four-way decomposition along the Frobenius endomorphism */
+void g2_scalarmult(G2Point& rop, const G2Point& op, const scalar_t scalar);
+void g2_makeaffine(G2Point& op);
+void g2_batch_makeaffine(G2Point* const* points, size_t count);
+/**
+ * Like g1_isvalid for the twist, which has points outside G2, so this also
+ * checks that n times op is the identity.
+ */
+bool g2_isvalid(const G2Point& op);
+
+/*---------------------------------------GT-----------------------------------*/
+
+/**
+ * The optimal ate pairing e(p, q), identical to DCLXVI's optate(q, p). Either
+ * argument may be in Jacobian form. The pairing with the identity is 1.
+ */
+void pairing(Fp12& rop, const G1Point& p, const G2Point& q);
+/** rop = op^scalar for op in GT, with the same decomposition as G2 */
+void gt_pow(Fp12& rop, const Fp12& op, const scalar_t scalar);
+/**
+ * True if op's coefficients are fully reduced and op is in GT, which is
+ * checked by raising it to the power n. Elements of Fp12 outside GT must not
+ * reach gt_pow or the cyclotomic squaring, which assume membership.
+ */
+bool gt_isvalid(const Fp12& op);
+
+/**
+ * Bytes in the compressed encoding of an element of GT: a flag byte, then the
+ * six Fp coefficients of its torus coordinate (see fp12_compress) in the order
+ * c0.c0, c0.c1, c1.c0, ..., each as a big-endian integer. The flag is 0 for
+ * that case, or 1 for the element 1, whose coefficients are zero. op must be
+ * in GT; -1, the other element without a torus coordinate, is outside GT and
+ * gets the flag 2, which gt_decompress rejects.
+ */
+const size_t GT_COMPRESSED_BYTES = 1 + 6 * FP_BYTES;
+void gt_compress(unsigned char* rop, const Fp12& op);
+/**
+ * Returns false, leaving rop unchanged, unless op is the encoding of an
+ * element of GT. Every torus coordinate decompresses into the cyclotomic
+ * subgroup, which is larger than GT, so this costs a gt_isvalid check.
+ */
+bool gt_decompress(Fp12& rop, const unsigned char* op);
+
+/*-----------------------------Conversions to DCLXVI--------------------------*/
+
+void fp_from_dclxvi(Fp& rop, const fpe_t op);
+void fp_to_dclxvi(fpe_t rop, const Fp& op);
+void fp2_from_dclxvi(Fp2& rop, const fp2e_t op);
+void fp2_to_dclxvi(fp2e_t rop, const Fp2& op);
+void fp12_from_dclxvi(Fp12& rop, const fp12e_t op);
+void fp12_to_dclxvi(fp12e_t rop, const Fp12& op);
+void g1_from_dclxvi(G1Point& rop, const curvepoint_fp_t op);
+void g1_to_dclxvi(curvepoint_fp_t rop, const G1Point& op);
+void g2_from_dclxvi(G2Point& rop, const twistpoint_fp2_t op);
+void g2_to_dclxvi(twistpoint_fp2_t rop, const G2Point& op);
+
+}  // namespace Mont64
+
+#endif /* MONT64CURVE_HPP_ */
@@ -0,0 +1,177 @@
+/*
+ * Mont64Field.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MONT64FIELD_HPP_
+#define MONT64FIELD_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <gmp.h>
+
+/**
+ * Field arithmetic for the Mont64 backend: the same BN curve as DCLXVI, with
+ * elements of Fp stored as four 64-bit limbs in Montgomery form (R = 2^256)
+ * instead of DCLXVI's twelve doubles.
+ *
+ * The extension tower is the one DCLXVI uses, so coefficients line up one to
+ * one with DCLXVI's and results can be compared bit for bit:
+ *   Fp2  = Fp[i] / (i^2 + 1)
+ *   Fp6  = Fp2[v] / (v^3 - xi), xi = i + 3
+ *   Fp12 = Fp6[w] / (w^2 - v)
+ *
+ * Functions follow DCLXVI's argument order (result first) and all of them
+ * allow the result to alias an operand. Every element is kept fully reduced,
+ * so limbs can be compared directly for equality.
+ */
+namespace Mont64 {
+
+struct Fp {
+    uint64_t v[4];
+};
+
+struct Fp2 {
+    Fp c0, c1;  //c0 + c1*i
+};
+
+struct Fp6 {
+    Fp2 c0, c1, c2;  //c0 + c1*v + c2*v^2
+};
+
+struct Fp12 {
+    Fp6 c0, c1;  //c0 + c1*w
+};
+
+/**
+ * Frobenius constants, in Montgomery form: FROBENIUS_GAMMA1[k-1] = xi^(k(p-1)/6)
+ * and FROBENIUS_GAMMA2[k-1] = xi^(k(p^2-1)/6) for k = 1..5. Besides the Fp12
+ * Frobenius maps they give the curve endomorphisms: GAMMA2[1] is a cube root
+ * of unity (DCLXVI's bn_zeta2), GAMMA1[1] and GAMMA1[2] are bn_z2p and bn_z3p.
+ */
+extern const Fp2 FROBENIUS_GAMMA1[5];
+extern const Fp FROBENIUS_GAMMA2[5];
+
+/*---------------------------------------Fp-----------------------------------*/
+
+void fp_setzero(Fp& rop);
+void fp_setone(Fp& rop);
+bool fp_iszero(const Fp& op);
+bool fp_iseq(const Fp& op1, const Fp& op2);
+/** True if op's limbs are below p, as every element computed here is; decoded elements must be checked */
+bool fp_isreduced(const Fp& op);
+void fp_add(Fp& rop, const Fp& op1, const Fp& op2);
+void fp_sub(Fp& rop, const Fp& op1, const Fp& op2);
+void fp_neg(Fp& rop, const Fp& op);
+void fp_double(Fp& rop, const Fp& op);
+void fp_half(Fp& rop, const Fp& op);
+void fp_mul(Fp& rop, const Fp& op1, const Fp& op2);
+void fp_square(Fp& rop, const Fp& op);
+void fp_invert(Fp& rop, const Fp& op);
+/** Converts a value in [0, p) into Montgomery form */
+void fp_from_mpz(Fp& rop, const mpz_t op);
+/** Converts out of Montgomery form into an integer in [0, p) */
+void fp_to_mpz(mpz_t rop, const Fp& op);
+/** The field characteristic, as an integer */
+void fp_modulus(mpz_t rop);
+
+/** Bytes in the big-endian encoding of an element of Fp */
+const size_t FP_BYTES = 32;
+/** Writes op as a FP_BYTES-byte big-endian integer in [0, p) */
+void fp_to_bytes(unsigned char* rop, const Fp& op);
+/** Reads a big-endian integer; returns false, leaving rop unchanged, unless it is below p */
+bool fp_from_bytes(Fp& rop, const unsigned char* op);
+
+/*---------------------------------------Fp2----------------------------------*/
+
+void fp2_setzero(Fp2& rop);
+void fp2_setone(Fp2& rop);
+bool fp2_iszero(const Fp2& op);
+bool fp2_isone(const Fp2& op);
+bool fp2_iseq(const Fp2& op1, const Fp2& op2);
+void fp2_add(Fp2& rop, const Fp2& op1, const Fp2& op2);
+void fp2_sub(Fp2& rop, const Fp2& op1, const Fp2& op2);
+void fp2_neg(Fp2& rop, const Fp2& op);
+void fp2_double(Fp2& rop, const Fp2& op);
+void fp2_triple(Fp2& rop, const Fp2& op);
+void fp2_conjugate(Fp2& rop, const Fp2& op);
+void fp2_mul(Fp2& rop, const Fp2& op1, const Fp2& op2);
+void fp2_mul_fp(Fp2& rop, const Fp2& op1, const Fp& op2);
+void fp2_square(Fp2& rop, const Fp2& op);
+/** rop = op * xi */
+void fp2_mulxi(Fp2& rop, const Fp2& op);
+void fp2_invert(Fp2& rop, const Fp2& op);
+
+/*---------------------------------------Fp6----------------------------------*/
+
+void fp6_setzero(Fp6& rop);
+void fp6_setone(Fp6& rop);
+bool fp6_iseq(const Fp6& op1, const Fp6& op2);
+void fp6_add(Fp6& rop, const Fp6& op1, const Fp6& op2);
+void fp6_sub(Fp6& rop, const Fp6& op1, const Fp6& op2);
+void fp6_neg(Fp6& rop, const Fp6& op);
+void fp6_mul(Fp6& rop, const Fp6& op1, const Fp6& op2);
+void fp6_square(Fp6& rop, const Fp6& op);
+/** rop = op * v */
+void fp6_mulv(Fp6& rop, const Fp6& op);
+void fp6_invert(Fp6& rop, const Fp6& op);
+bool fp6_iszero(const Fp6& op);
+
+/*---------------------------------------Fp12---------------------------------*/
+
+void fp12_setone(Fp12& rop);
+bool fp12_isone(const Fp12& op);
+bool fp12_iseq(const Fp12& op1, const Fp12& op2);
+void fp12_mul(Fp12& rop, const Fp12& op1, const Fp12& op2);
+/**
+ * Multiplies by a line function value l0 + l1*w + l3*w^3, the only non-zero
+ * coefficients a Miller loop line has on this tower
+ */
+void fp12_mul_line(Fp12& rop, const Fp12& op, const Fp2& l0, const Fp2& l1, const Fp2& l3);
+void fp12_square(Fp12& rop, const Fp12& op);
+/** Granger-Scott squaring, only valid in the cyclotomic subgroup (e.g. after the easy part of the final exponentiation) */
+void fp12_cyclotomic_square(Fp12& rop, const Fp12& op);
+/** rop = op^(p^6), which is the inverse in the cyclotomic subgroup */
+void fp12_conjugate(Fp12& rop, const Fp12& op);
+void fp12_invert(Fp12& rop, const Fp12& op);
+void fp12_frobenius_p(Fp12& rop, const Fp12& op);
+void fp12_frobenius_p2(Fp12& rop, const Fp12& op);
+/**
+ * Torus (T2) compression of an element of the cyclotomic subgroup, which is
+ * determined by rop = (1 + c0)/c1 alone. Returns false, leaving rop unchanged,
+ * for the only two elements with c1 = 0, 1 and -1.
+ */
+bool fp12_compress(Fp6& rop, const Fp12& op);
+/**
+ * rop = (op + w)/(op - w), the element fp12_compress maps to op. Every op gives
+ * an element of the cyclotomic subgroup, though not necessarily one of GT.
+ */
+void fp12_decompress(Fp12& rop, const Fp6& op);
+
+/*-------------------------------Kernel selection-----------------------------*/
+
+/**
+ * The implementations of fp_mul and fp_square, in order of preference. They
+ * are the same code compiled for different targets. The first one the CPU
+ * supports is used unless setMulKernel picks another; see utils/CpuDispatch.hpp.
+ */
+enum MulKernel {
+    /** Built with BMI2 and ADX, so the 64x64-bit products use mulx */
+    MUL_BMI2_ADX,
+    /** Built for baseline x86-64 */
+    MUL_PORTABLE,
+    NUM_MUL_KERNELS
+};
+
+const char* getMulKernelName(MulKernel kernel);
+/** @return true if this CPU can run kernel */
+bool isSupported(MulKernel kernel);
+MulKernel getMulKernel();
+/** Switches fp_mul and fp_square to kernel, which must be supported */
+void setMulKernel(MulKernel kernel);
+
+}  // namespace Mont64
+
+#endif /* MONT64FIELD_HPP_ */
@@ -0,0 +1,86 @@
+/*
+ * PairingBackend.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef PAIRINGBACKEND_HPP_
+#define PAIRINGBACKEND_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bilinear/G.hpp>
+#include <bilinear/GT.hpp>
+#include <utils/BinaryIO.hpp>
+
+/**
+ * Chooses between the implementations of the pairing groups. Both implement
+ * the same BN curve with the same generators and the same ScalarDCLXVI
+ * exponents, so they give identical results, but their elements can't be
+ * mixed in one operation or read from each other's files.
+ *
+ * New keys use the default backend, which is DCLXVI unless the library is
+ * built with -DACCUMULATOR_BACKEND_MONT64 (see rule.mk), and can be changed at
+ * runtime with setDefault. Operations on existing elements always use the
+ * backend those elements belong to.
+ */
+namespace PairingBackend {
+
+enum Type {
+    /** The DCLXVI library, on 12-double field elements with qhasm arithmetic */
+    DCLXVI,
+    /** The 4x64-bit Montgomery arithmetic in bilinear/Mont64Field.hpp */
+    MONT64
+};
+
+Type getDefault();
+void setDefault(Type type);
+
+const char* getName(Type type);
+/** Parses a backend name as returned by getName; returns false if it names none */
+bool fromName(const std::string& name, Type& type);
+
+/** The backend a G1 or G2 element belongs to */
+Type typeOf(const G& element);
+/** True if element is a G2 element (of either backend), false if it is in G1 */
+bool isG2(const G& element);
+
+/** New elements, initialized to the generator (G1, G2) or 1 (GT) */
+std::unique_ptr<G> newG1(Type type = getDefault());
+std::unique_ptr<G> newG2(Type type = getDefault());
+std::unique_ptr<GT> newGT(Type type = getDefault());
+
+/**
+ * Computes result = e(g1Element, g2Element). Both elements and the result must
+ * belong to the same backend.
+ */
+void pairing(GT& result, const G& g1Element, const G& g2Element);
+
+/**
+ * Normalizes a vector of elements of the same group and backend with a single
+ * field inversion.
+ */
+void batchNormalize(const std::vector<std::unique_ptr<G>>& elements);
+
+/**
+ * Encodes a vector of elements of the same group and backend back to back
+ * into out, which must have room for elements.size() * getEncodedSize() bytes.
+ * They are normalized first with batchNormalize.
+ */
+void encodeAll(std::byte* out, const std::vector<std::unique_ptr<G>>& elements);
+/** Like encodeAll, but straight into a writer's buffer */
+void writeAll(BufferedWriter& writer, const std::vector<std::unique_ptr<G>>& elements);
+/**
+ * Reads count elements written by writeAll (or by writeToFile one after the
+ * other), creating each with newElement(type), e.g. newG1, and appends them to
+ * elements. Returns false if the input ends first or holds an encoding that
+ * G::decode rejects, keeping the valid elements read before that.
+ */
+bool readAll(BufferedReader& reader, size_t count, std::unique_ptr<G> (*newElement)(Type), Type type,
+             std::vector<std::unique_ptr<G>>& elements);
+
+}  // namespace PairingBackend
+
+#endif /* PAIRINGBACKEND_HPP_ */
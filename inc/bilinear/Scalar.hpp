@@ -9,6 +9,7 @@
 //#include <LiDIA/bigmod.h>
 #include <flint/BigMod.hpp>
 
+#include <cstddef>
 #include <fstream>
 
 /*
@@ -24,6 +25,10 @@ public:
     // Destructor
     virtual ~Scalar() = 0;
 
+    // Heap allocations of group elements and scalars are counted by MemoryAccounting
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     // Assignment operator
     virtual Scalar& operator=(const Scalar& s) = 0;
 
@@ -70,10 +75,20 @@ public:
     virtual void printPretty() const = 0;
 
     // Import object from file
-    virtual void readFromFile(std::ifstream& inFile) = 0;
+    virtual void readFromFile(std::istream& inFile) = 0;
 
     // Export object to file
-    virtual void writeToFile(std::ofstream& outFile) const = 0;
+    virtual void writeToFile(std::ostream& outFile) const = 0;
+
+    // Number of bytes encode writes and decode reads
+    virtual size_t getEncodedSize() const = 0;
+
+    // Encode this number into getEncodedSize() bytes at out, the same bytes
+    // writeToFile writes
+    virtual void encode(std::byte* out) const = 0;
+
+    // Decode a number from the bytes written by encode or writeToFile
+    virtual void decode(const std::byte* in) = 0;
 };
 
 #endif /* _SCALAR_H_ */
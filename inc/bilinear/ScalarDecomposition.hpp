@@ -0,0 +1,68 @@
+/*
+ * ScalarDecomposition.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SCALARDECOMPOSITION_HPP_
+#define SCALARDECOMPOSITION_HPP_
+
+extern "C" {
+#include <scalar.h>
+}
+
+/**
+ * Splits exponents of the BN curve groups into short sub-scalars using an
+ * efficiently computable endomorphism, and recodes the sub-scalars in wNAF
+ * form so that G1, G2 and GT can exponentiate with one interleaved
+ * double-and-add loop of half (G1) or a quarter (G2, GT) of the usual length.
+ *
+ * A scalar k is written as k = k_0 + k_1*lambda + ... + k_{d-1}*lambda^{d-1}
+ * (mod n), where lambda is the eigenvalue of the endomorphism on the group and
+ * each k_i is about 256/d bits. The split is Babai rounding against a
+ * precomputed LLL-reduced basis of the lattice of vectors that map to 0.
+ */
+namespace ScalarDecomposition {
+
+/**
+ * The endomorphisms that a scalar can be decomposed for.
+ */
+enum Endomorphism {
+    /** (x, y) -> (zeta*x, y) on G1, with zeta a primitive cube root of unity in Fp */
+    GLV,
+    /** The p-power Frobenius: the twist endomorphism on G2, and x -> x^p on GT */
+    FROBENIUS
+};
+
+const int MAX_DIMENSION = 4;
+//Sub-scalars are at most 129 bits, and a wNAF has at most one more digit than its number
+const int MAX_DIGITS = 131;
+
+/**
+ * The wNAF digits of every sub-scalar of a decomposed scalar. Each digit is
+ * zero or an odd number in (-2^(w-1), 2^(w-1)); the sign of the sub-scalar is
+ * folded into its digits, so the caller only ever needs the positive odd
+ * multiples 1, 3, ..., 2^(w-1)-1 of each base and their negations.
+ */
+struct Recoding {
+    int dimension;
+    //One past the index of the most significant non-zero digit over all sub-scalars;
+    //0 if the scalar is 0 mod n
+    int length;
+    signed char digits[MAX_DIMENSION][MAX_DIGITS];
+};
+
+/**
+ * Reduces the scalar modulo the group order, decomposes it for the given
+ * endomorphism and recodes each part as a width-w NAF.
+ *
+ * @param scalar the exponent, in DCLXVI's representation
+ * @param endomorphism which endomorphism's eigenvalue to decompose against
+ * @param window the wNAF window width w, between 2 and 7
+ * @param result the recoded sub-scalars
+ */
+void recode(const scalar_t scalar, Endomorphism endomorphism, int window, Recoding& result);
+
+}  // namespace ScalarDecomposition
+
+#endif /* SCALARDECOMPOSITION_HPP_ */
@@ -48,8 +48,11 @@ public:
 
     void print() const;
     void printPretty() const;
-    void readFromFile(std::ifstream& inFile);
-    void writeToFile(std::ofstream& outFile) const;
+    void readFromFile(std::istream& inFile);
+    void writeToFile(std::ostream& outFile) const;
+    size_t getEncodedSize() const;
+    void encode(std::byte* out) const;
+    void decode(const std::byte* in);
 
     // Get the pointer to Zp object of the underlying DCLXVI implementation
     unsigned long long* getUnderlyingObj();
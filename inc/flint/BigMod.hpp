@@ -9,13 +9,20 @@
 #define BIGMOD_H_
 
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include <flint/BigInt.hpp>
+#include <flint/ModContext.hpp>
 #include <flint/fmpz.h>
 
 namespace flint {
 
+/**
+ * A residue modulo some modulus. The modulus lives in a ModContext that is
+ * shared with every other BigMod of the same modulus (see
+ * ModContext::forModulus), so copying a BigMod copies only its value.
+ */
 class BigMod {
 public:
     /**
@@ -63,6 +70,15 @@ public:
      *        modulus
      */
     BigMod(const unsigned long value, const unsigned long modulus);
+    /**
+     * Constructs a BigMod with a value and an existing context, which skips
+     * looking up the context for the modulus. If value > modulus, it will be
+     * reduced modulo modulus.
+     * @param value A BigInt whose value should become the BigMod's value
+     * @param context The context of the modulus, which may be NULL for a
+     *        modulus of 0
+     */
+    BigMod(const BigInt& value, std::shared_ptr<const ModContext> context);
 
     /**
      * Returns the mantissa (residue value) as a BigInt. Note that this
@@ -78,6 +94,10 @@ public:
      * @return a BigInt containing a copy of the modulus value.
      */
     BigInt getModulus() const;
+    /** @return the context of the modulus, which is NULL if the modulus is 0 */
+    const std::shared_ptr<const ModContext>& getContext() const {
+        return context;
+    }
 
     /**
      * Sets the modulus to the value of the given BigInt, then reduces the
@@ -85,6 +105,12 @@ public:
      * @param modulus a BigInt containing the desired modulus value.
      */
     void setModulus(const BigInt& modulus);
+    /**
+     * Switches to an existing context, as setModulus does to the context of
+     * its modulus, then reduces the mantissa modulo the context's modulus.
+     * @param context The new context, which may be NULL for a modulus of 0
+     */
+    void setContext(std::shared_ptr<const ModContext> context);
 
     //Mutative arithmetic methods. Return this to allow for chaining.
     /** Adds another BigMod to this one */
@@ -156,7 +182,7 @@ public:
 
 private:
     fmpz_t value;
-    fmpz_t modulus;
+    std::shared_ptr<const ModContext> context;
 
     friend void swap(BigMod& first, BigMod& second);
 
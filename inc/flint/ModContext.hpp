@@ -0,0 +1,101 @@
+/*
+ * ModContext.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MODCONTEXT_HPP_
+#define MODCONTEXT_HPP_
+
+#include <memory>
+
+#include <flint/BigInt.hpp>
+#include <flint/ModN.hpp>
+#include <flint/fmpz.h>
+
+namespace flint {
+
+/**
+ * A modulus together with the data precomputed for reducing by it. BigMods
+ * refer to a shared, immutable ModContext instead of each holding a copy of
+ * their modulus, so a vector of residues stores the modulus only once, and
+ * every product they compute is reduced with the precomputed inverse instead
+ * of a full division. A context for an odd modulus of 1024, 2048, 3072 or
+ * 4096 bits also holds a fixed-width ModN engine for exponentiation.
+ */
+class ModContext {
+public:
+    /**
+     * Returns the context for a modulus, reusing the one already shared by
+     * live BigMods with that modulus if there is one. This is safe to call
+     * from several threads at once, but it takes a lock and hashes the
+     * modulus, so code that makes many BigMods with one modulus should look
+     * its context up once and pass it to them.
+     * @param modulus A positive modulus
+     * @return the context, or NULL for a modulus of 0
+     */
+    static std::shared_ptr<const ModContext> forModulus(const BigInt& modulus);
+
+    /**
+     * Precomputes the data for reducing by modulus. Prefer forModulus, which
+     * shares contexts; this is public so that a caller can keep a context of
+     * its own.
+     * @param modulus A positive modulus
+     */
+    explicit ModContext(const BigInt& modulus);
+    ~ModContext();
+    ModContext(const ModContext&) = delete;
+    ModContext& operator=(const ModContext&) = delete;
+
+    /** @return the modulus, which stays valid as long as the context does */
+    const BigInt& getModulus() const {
+        return modulus;
+    }
+    /** @return true if other has the same modulus as this context */
+    bool sameModulus(const ModContext& other) const {
+        return this == &other || modulus == other.modulus;
+    }
+
+    /** Reduces value (of either sign) into [0, modulus) */
+    void reduce(fmpz_t value) const;
+    /** Sets result to lhs * rhs mod modulus; result may alias either operand */
+    void multiply(fmpz_t result, const fmpz_t lhs, const fmpz_t rhs) const;
+    /**
+     * Sets result to base^exponent mod modulus with the selected PowerKernel,
+     * falling back to GMP when the modulus has no fixed-width engine or the
+     * exponent is negative. result may alias base.
+     * @param base An integer in [0, modulus)
+     */
+    void power(fmpz_t result, const fmpz_t base, const fmpz_t exponent) const;
+
+    /**
+     * The implementations of power, in order of preference. They all give the
+     * same result; the first one the CPU supports is the default, and the
+     * others are for comparing them on a given machine (see
+     * utils/CpuDispatch.hpp).
+     */
+    enum PowerKernel {
+        /** ModN with AVX-512 IFMA */
+        POWER_IFMA,
+        /** fmpz_powm, which is GMP's mpz_powm */
+        POWER_GMP,
+        /** ModN in 64-bit limbs */
+        POWER_PORTABLE,
+        NUM_POWER_KERNELS
+    };
+    static const char* getPowerKernelName(PowerKernel kernel);
+    /** @return true if this CPU can run kernel */
+    static bool isSupported(PowerKernel kernel);
+    static PowerKernel getPowerKernel();
+    /** Switches exponentiation by every modulus to kernel, which must be supported */
+    static void setPowerKernel(PowerKernel kernel);
+
+private:
+    BigInt modulus;
+    fmpz_preinvn_t inverse;
+    std::unique_ptr<const FixedWidthModulus> fixedWidth;
+};
+
+}  //end namespace flint
+
+#endif /* MODCONTEXT_HPP_ */
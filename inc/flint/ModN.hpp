@@ -0,0 +1,87 @@
+/*
+ * ModN.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef MODN_HPP_
+#define MODN_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <flint/BigInt.hpp>
+#include <flint/fmpz.h>
+
+namespace flint {
+
+/**
+ * Modular exponentiation by one fixed odd modulus, with the operands in
+ * fixed-size arrays instead of variable-size integers. ModContext keeps one
+ * of these for every modulus that one of the ModN widths fits.
+ */
+class FixedWidthModulus {
+public:
+    /** The implementations of power, in order of preference */
+    enum Kernel {
+        /** Montgomery multiplication in 52-bit limbs with AVX-512 IFMA */
+        KERNEL_IFMA,
+        /** Montgomery multiplication in 64-bit limbs, for any x86-64 */
+        KERNEL_PORTABLE,
+        NUM_KERNELS
+    };
+
+    virtual ~FixedWidthModulus() {}
+    /**
+     * Sets result to base^exponent mod the modulus with the given kernel,
+     * which this CPU must support.
+     * @param base An integer in [0, modulus)
+     * @param exponent A nonnegative integer of any length
+     */
+    virtual void power(fmpz_t result, const fmpz_t base, const fmpz_t exponent, Kernel kernel) const = 0;
+    virtual const BigInt& getModulus() const = 0;
+
+    /** @return an engine for modulus, or NULL if it is even or no ModN width fits it */
+    static std::unique_ptr<FixedWidthModulus> create(const BigInt& modulus);
+    /** @return true if this CPU can run kernel */
+    static bool isSupported(Kernel kernel);
+};
+
+/**
+ * The engine for moduli of exactly LIMBS 64-bit limbs: ModN<16> for 1024-bit
+ * moduli, ModN<32> for 2048-bit ones, and ModN<48> and ModN<64> for 3072 and
+ * 4096 bits, which are the widths it is instantiated for. Exponentiation
+ * uses a sliding window, with its table of odd powers on the stack.
+ */
+template <size_t LIMBS>
+class ModN : public FixedWidthModulus {
+public:
+    /** Lanes of 52 bits the IFMA kernel uses: enough that 4 * modulus < 2^(52 * LANES), in whole vectors */
+    static const size_t LANES = ((64 * LIMBS + 2 + 51) / 52 + 7) / 8 * 8;
+
+    /** @return true if modulus is odd and has exactly LIMBS limbs */
+    static bool fits(const BigInt& modulus);
+    /** Precomputes the Montgomery constants for modulus, which must fit */
+    explicit ModN(const BigInt& modulus);
+
+    void power(fmpz_t result, const fmpz_t base, const fmpz_t exponent, Kernel kernel) const override;
+    const BigInt& getModulus() const override {
+        return modulus;
+    }
+
+private:
+    BigInt modulus;
+    //64-bit limbs: the modulus, -modulus^-1 mod 2^64, and R^2 mod modulus for R = 2^(64 * LIMBS)
+    uint64_t limbs[LIMBS];
+    uint64_t inverse;
+    uint64_t rSquared[LIMBS];
+    //52-bit lanes: the modulus, -modulus^-1 mod 2^52, and R^2 mod modulus for R = 2^(52 * LANES)
+    alignas(64) uint64_t lanes[LANES];
+    uint64_t laneInverse;
+    alignas(64) uint64_t laneRSquared[LANES];
+};
+
+}  //end namespace flint
+
+#endif /* MODN_HPP_ */
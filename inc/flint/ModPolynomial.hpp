@@ -107,6 +107,26 @@ public:
     bool operator==(const ModPolynomial& rhs) const;
     bool operator!=(const ModPolynomial& rhs) const;
 
+    /**
+     * The algorithms multiply can use, in order of preference. They all give
+     * the same result; FLINT's own choice is the default. The others are for
+     * comparing them on a given machine (see utils/CpuDispatch.hpp).
+     */
+    enum MulKernel {
+        /** fmpz_mod_poly_mul, which picks an algorithm by operand size */
+        MUL_FLINT,
+        /** Kronecker substitution: one large integer multiplication in GMP */
+        MUL_KS,
+        MUL_KARATSUBA,
+        /** Schoolbook multiplication */
+        MUL_CLASSICAL,
+        NUM_MUL_KERNELS
+    };
+    static const char* getMulKernelName(MulKernel kernel);
+    static MulKernel getMulKernel();
+    /** Switches multiplication of all ModPolynomials to kernel */
+    static void setMulKernel(MulKernel kernel);
+
 private:
     fmpz_mod_poly_t mod_poly;
 
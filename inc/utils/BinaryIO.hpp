@@ -0,0 +1,91 @@
+/*
+ * BinaryIO.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef _BINARY_IO_H_
+#define _BINARY_IO_H_
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+/**
+ * Buffered binary output for bulk serialization. Elements are encoded
+ * straight into the writer's buffer (see reserve), and the buffer goes to the
+ * underlying stream in one write whenever it fills up, so the cost per element
+ * is a memcpy rather than an iostream call per field.
+ *
+ * The writer flushes when it is destroyed, but a failed write can only be seen
+ * by calling flush() and checking good() first.
+ */
+class BufferedWriter {
+public:
+    static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+    explicit BufferedWriter(std::ostream& out, size_t capacity = DEFAULT_CAPACITY);
+    // Creates (or truncates) fileName for binary output
+    explicit BufferedWriter(const char* fileName, size_t capacity = DEFAULT_CAPACITY);
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /**
+     * Returns space for size contiguous bytes at the end of the output, which
+     * the caller fills in before its next call to the writer. Requests bigger
+     * than the capacity grow the buffer.
+     */
+    std::byte* reserve(size_t size);
+    void write(const void* data, size_t size);
+    // Passes everything buffered so far on to the stream, and flushes it
+    void flush();
+    // @return false if opening the file or any write so far has failed
+    bool good() const;
+
+private:
+    std::unique_ptr<std::ostream> _file;
+    std::ostream& _out;
+    std::vector<std::byte> _buffer;
+    size_t _used;
+};
+
+/**
+ * The reading counterpart of BufferedWriter: the stream is read a buffer at a
+ * time, and callers decode elements directly from the pointers take returns.
+ * Since it reads ahead, the stream itself shouldn't be read while a reader is
+ * using it.
+ */
+class BufferedReader {
+public:
+    static const size_t DEFAULT_CAPACITY = BufferedWriter::DEFAULT_CAPACITY;
+
+    explicit BufferedReader(std::istream& in, size_t capacity = DEFAULT_CAPACITY);
+    // Opens fileName for binary input
+    explicit BufferedReader(const char* fileName, size_t capacity = DEFAULT_CAPACITY);
+
+    BufferedReader(const BufferedReader&) = delete;
+    BufferedReader& operator=(const BufferedReader&) = delete;
+
+    /**
+     * Returns the next size bytes of the input, contiguous and valid until
+     * the next call to the reader, or NULL if fewer than size bytes are left.
+     */
+    const std::byte* take(size_t size);
+    // Copies the next size bytes to data; returns false if fewer are left
+    bool read(void* data, size_t size);
+    // @return false if opening the file failed or a read came up short
+    bool good() const;
+
+private:
+    std::unique_ptr<std::istream> _file;
+    std::istream& _in;
+    std::vector<std::byte> _buffer;
+    size_t _begin;
+    size_t _end;
+    bool _failed;
+};
+
+#endif /* _BINARY_IO_H_ */
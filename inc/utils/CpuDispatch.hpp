@@ -0,0 +1,80 @@
+/*
+ * CpuDispatch.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef _CPU_DISPATCH_H_
+#define _CPU_DISPATCH_H_
+
+#include <string>
+#include <vector>
+
+/**
+ * Runtime selection between the implementations of the library's hottest
+ * kernels, so that one binary runs well on CPUs with different instruction
+ * set extensions. The kernels are:
+ *   field.multiply       Mont64 Fp multiplication (bilinear/Mont64Field.hpp)
+ *   sha256               SHA-256 (utils/SHA256.hpp)
+ *   sha256.batch         SHA-256 of many messages at once (utils/SHA256.hpp)
+ *   polynomial.multiply  ModPolynomial multiplication (flint/ModPolynomial.hpp)
+ *   modular.power        BigMod exponentiation (flint/ModContext.hpp)
+ * Each kernel starts out with its most preferred implementation that the CPU
+ * supports, as detected with CPUID the first time the kernel is used. The
+ * functions here report that choice and can override it, e.g. to benchmark
+ * the alternatives.
+ */
+namespace CpuDispatch {
+
+/** The instruction set extensions the kernels can make use of */
+struct Features {
+    bool bmi2;
+    bool adx;
+    bool sse41;
+    bool avx2;
+    bool avx512f;
+    bool avx512ifma;
+    bool sha;
+};
+
+/** The features of the CPU this process runs on, detected on first use */
+const Features& getFeatures();
+/** The detected features as a space-separated list, e.g. "bmi2 adx avx2 sha" */
+std::string describeFeatures();
+
+enum Kernel {
+    FIELD_MULTIPLICATION,
+    SHA256_DIGEST,
+    SHA256_BATCH,
+    POLYNOMIAL_MULTIPLICATION,
+    MODULAR_POWER
+};
+
+const std::vector<Kernel>& getKernels();
+const char* getName(Kernel kernel);
+/** Parses a kernel name as returned by getName; returns false if it names none */
+bool fromName(const std::string& name, Kernel& kernel);
+
+/** The names of the implementations of a kernel, in order of preference */
+std::vector<std::string> getVariants(Kernel kernel);
+/** @return true if variant names an implementation of kernel that this CPU can run */
+bool isSupported(Kernel kernel, const std::string& variant);
+/** The name of the implementation of kernel that is currently in use */
+std::string getSelected(Kernel kernel);
+
+/**
+ * Switches a kernel to the named implementation. Returns false, leaving the
+ * kernel unchanged, if the variant doesn't exist or this CPU can't run it.
+ * Results don't depend on the implementation, but this should not be called
+ * while other threads are using the kernel.
+ */
+bool select(Kernel kernel, const std::string& variant);
+/** Returns every kernel to its preferred supported implementation */
+void selectDefaults();
+
+/** One "kernel=variant" entry per kernel, separated by spaces, for logs */
+std::string describeSelection();
+
+}  // namespace CpuDispatch
+
+#endif /* _CPU_DISPATCH_H_ */
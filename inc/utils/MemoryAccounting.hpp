@@ -0,0 +1,160 @@
+/*
+ * MemoryAccounting.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef _MEMORY_ACCOUNTING_H_
+#define _MEMORY_ACCOUNTING_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <utils/Metrics.hpp>
+
+/**
+ * Tracks how many bytes the library has allocated, both overall and during
+ * each public API call, so that callers can see (and predict, with
+ * estimateMemory) the footprint of operations like witnessesForSet.
+ *
+ * Three kinds of allocation are counted:
+ *  - GMP and FLINT allocations, i.e. the limbs of every BigInt, BigMod and
+ *    ModPolynomial. These are only visible if MemoryPool::install() has been
+ *    called, since the pool's hooks are what observe them.
+ *  - Heap-allocated group elements and scalars (G, GT and Scalar subclasses),
+ *    through class-level operator new/delete.
+ *  - Large temporary arrays inside the accumulator algorithms, such as the
+ *    subsets and coefficient vectors of public-key witness generation, which
+ *    are registered explicitly with MEMORY_TRACK.
+ *
+ * Like Metrics, all of this compiles away unless the library is built with
+ * -DACCUMULATOR_MEMORY_ACCOUNTING (see rule.mk). The resident-set queries
+ * and estimateMemory work regardless.
+ */
+namespace MemoryAccounting {
+
+/** The number of calls whose peaks can be measured at the same time */
+const unsigned int MAX_SCOPES = 64;
+
+/** The API calls that can be attributed are the same ones Metrics times. */
+typedef Metrics::Timer Operation;
+
+struct OperationStats {
+    uint64_t calls;
+    //Highest tracked footprint reached during the most recent call, above
+    //what was already allocated when it started
+    uint64_t lastPeakBytes;
+    //The largest lastPeakBytes of any call
+    uint64_t maxPeakBytes;
+    //Bytes allocated by all calls, including ones freed again before they returned
+    uint64_t totalAllocatedBytes;
+};
+
+void recordAllocation(size_t bytes);
+void recordFree(size_t bytes);
+
+/** @return the number of tracked bytes currently allocated */
+uint64_t currentBytes();
+/** @return the largest value currentBytes() has had since the last resetPeak() */
+uint64_t peakBytes();
+void resetPeak();
+
+/**
+ * Returns the accounting for one API call. Each call's peak is measured from
+ * its own start, also when it runs inside another call (such as
+ * RSA_ACCUMULATE_PUBLIC inside RSA_ACCUMULATE_PIPELINED). The footprint is
+ * process-wide, though, since the allocations of a call are spread over the
+ * ThreadPool's threads: if several calls run at once (from different client
+ * threads), each one's peak also includes the others' allocations. Up to
+ * MAX_SCOPES calls are measured at once; calls beyond that are counted with
+ * a peak of 0.
+ */
+OperationStats getOperationStats(Operation op);
+void resetOperationStats();
+
+/** @return the peak resident set size of the process, from getrusage */
+uint64_t peakResidentBytes();
+/** @return the current resident set size of the process, from /proc/self/statm */
+uint64_t currentResidentBytes();
+
+/**
+ * The sizes of the group elements a bilinear API call works with, which
+ * depend on the pairing backend and on which group holds the accumulators.
+ * BilinearMapAccumulator::elementSizes gives them.
+ */
+struct ElementSizes {
+    //A heap-allocated G1 and G2 element, as public keys hold them
+    size_t g1Element;
+    size_t g2Element;
+    //A bare point of the accumulators' group, as multi-exponentiation arrays hold them
+    size_t accumulatorPoint;
+    //A bare exponent
+    size_t exponent;
+};
+
+/**
+ * Estimates the peak number of bytes an RSA API call allocates for a set of
+ * n elements, beyond its inputs and the outputs the caller passes in. This
+ * is meant for admission control, so it errs on the high side; it is
+ * calibrated against the tracked peaks reported by getOperationStats.
+ *
+ * @param op The API call
+ * @param n The number of elements in the set
+ * @param threads The number of threads in the ThreadPool passed to the
+ *        call. Only matters for operations where each concurrently running
+ *        task holds its own temporaries.
+ * @param modulusBits The RSA modulus size
+ * @return The estimated peak allocation, in bytes
+ * @throws std::invalid_argument if op is a bilinear operation, which needs
+ *         the overload taking ElementSizes
+ */
+size_t estimateMemory(Operation op, size_t n, size_t threads = 1, size_t modulusBits = 3072);
+/** Like estimateMemory above, for a bilinear API call on elements of the given sizes */
+size_t estimateMemory(Operation op, size_t n, const ElementSizes& elements, size_t threads = 1);
+
+/**
+ * Attributes everything allocated during its lifetime to an API call. Use
+ * through MEMORY_SCOPE at the top of the call.
+ */
+class Scope {
+public:
+    Scope(Operation op);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Operation op;
+    uint64_t startBytes;
+    uint64_t startTotal;
+    //The slot holding this call's peak, or MAX_SCOPES if none was free
+    unsigned int slot;
+};
+
+/** Counts a block of memory that isn't otherwise visible for its lifetime. */
+class Tracked {
+public:
+    Tracked(size_t bytes) : bytes(bytes) { recordAllocation(bytes); }
+    ~Tracked() { recordFree(bytes); }
+    Tracked(const Tracked&) = delete;
+    Tracked& operator=(const Tracked&) = delete;
+
+private:
+    size_t bytes;
+};
+
+}  // namespace MemoryAccounting
+
+#ifdef ACCUMULATOR_MEMORY_ACCOUNTING
+#define MEMORY_SCOPE(op) MemoryAccounting::Scope memoryAccountingScope_##op(Metrics::op)
+#define MEMORY_TRACK(name, bytes) MemoryAccounting::Tracked memoryTracked_##name(bytes)
+#define MEMORY_RECORD_ALLOCATION(bytes) MemoryAccounting::recordAllocation(bytes)
+#define MEMORY_RECORD_FREE(bytes) MemoryAccounting::recordFree(bytes)
+#else
+#define MEMORY_SCOPE(op) ((void)0)
+#define MEMORY_TRACK(name, bytes) ((void)0)
+#define MEMORY_RECORD_ALLOCATION(bytes) ((void)0)
+#define MEMORY_RECORD_FREE(bytes) ((void)0)
+#endif
+
+#endif /* _MEMORY_ACCOUNTING_H_ */
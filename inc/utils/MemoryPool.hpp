@@ -0,0 +1,80 @@
+/*
+ * MemoryPool.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef _MEMORY_POOL_H_
+#define _MEMORY_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * A thread-caching pool allocator for the limb arrays and other temporaries
+ * that GMP and FLINT allocate on behalf of flint::BigInt, BigMod and
+ * ModPolynomial. Every arithmetic operator on those wrappers returns a new
+ * object by value, so without a pool each one costs a malloc/free pair and
+ * the threads of a ThreadPool all contend on the system allocator's locks.
+ *
+ * Requests are rounded up to a power-of-two size class and freed blocks are
+ * kept on a free list belonging to the thread that freed them, so the
+ * steady state of a loop such as the witness-exponent products does not
+ * touch the system allocator at all. Requests larger than the biggest size
+ * class go straight to malloc.
+ *
+ * The pool is off until install() is called, which redirects GMP's and
+ * FLINT's memory functions to it. Because pooled blocks carry a header, this
+ * must happen before the program allocates any GMP or FLINT object (i.e.
+ * first thing in main), and the hooks cannot be removed afterwards.
+ */
+namespace MemoryPool {
+
+struct Stats {
+    uint64_t allocations;        //Requests served, from the cache or the system
+    uint64_t systemAllocations;  //Requests that had to call malloc
+    uint64_t systemFrees;        //Blocks actually returned to the system
+    uint64_t cachedBytes;        //Bytes currently held on free lists
+};
+
+/** Redirects GMP and FLINT allocation to the pool. Call at most once, at startup. */
+void install();
+/** @return true if install() has been called */
+bool isInstalled();
+
+void* allocate(size_t size);
+void* reallocate(void* ptr, size_t newSize);
+void deallocate(void* ptr);
+
+/**
+ * Asks every thread to return the blocks on its free lists to the system.
+ * The calling thread does so immediately; other threads do so the next time
+ * they allocate or free.
+ */
+void trim();
+
+/** @return totals across all threads that have used the pool */
+Stats getStats();
+void resetStats();
+
+/**
+ * Marks an operation (e.g. one accumulator API call) whose temporaries
+ * should not outlive it. When the outermost Scope on any thread ends, the
+ * pool is trimmed, so a burst of large temporaries from one call does not
+ * stay cached for the life of the process. Does nothing if the pool is not
+ * installed.
+ */
+class Scope {
+public:
+    Scope();
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool active;
+};
+
+}  // namespace MemoryPool
+
+#endif /* _MEMORY_POOL_H_ */
@@ -48,8 +48,11 @@ public:
     void getHashes(int index, std::vector<HashNode>& hashes) const;
     bool checkHashes(const std::vector<HashNode>& hashes) const;
     void updateHash(int offset, const std::vector<unsigned char>& digest);
+    // Replaces the leaves at offsets[i] with digests[i], rehashing the nodes above them a level at a time
+    void updateHashes(const std::vector<int>& offsets, const std::vector<std::vector<unsigned char>>& digests);
 
     int getHeight();
+    const std::vector<unsigned char>& getRootHash() const;
 
 private:
     int _height;
@@ -58,6 +61,8 @@ private:
 
     void getParentOffset(int offset, int level, int& parentOffset) const;
     void getParentSiblingOffset(int offset, int level, int& parentSiblingOffset) const;
+    // Hashes the pairs of nodes at the given level that start at leftChildren into their parents
+    void hashParents(const std::vector<int>& leftChildren, int level);
 };
 
 #endif /* _MERKLE_TREE_H_ */
@@ -0,0 +1,141 @@
+/*
+ * Metrics.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+/**
+ * Lightweight instrumentation for the accumulator hot paths: monotonic
+ * operation counters and per-API latency histograms, which can be exported
+ * as a snapshot in JSON or Prometheus text exposition format.
+ *
+ * Library code should only touch this module through the METRICS_* macros
+ * at the bottom of this file, which expand to nothing unless the library
+ * is compiled with -DACCUMULATOR_METRICS (see rule.mk). The functions in
+ * the namespace are always available, so a client can export a snapshot
+ * regardless of how the library was built; it will simply be all zeroes
+ * if instrumentation was compiled out.
+ */
+namespace Metrics {
+
+/** Operations counted by the library. */
+enum Counter {
+    G1_POWER,
+    G1_MULTIPLICATION,
+    G2_POWER,
+    G2_MULTIPLICATION,
+    PAIRING,
+    MSM_CALLS,            //Calls to the DCLXVI multi-scalar multiplication
+    MSM_POINTS,           //Total number of points passed to those calls
+    MODULAR_EXPONENTIATION,
+    PRIME_REP_GENERATED,  //Prime representatives computed
+    PRIME_REP_CANDIDATES, //Candidate integers examined while searching for them
+    PRIME_REP_CACHE_HITS, //Representatives found in a PrimeRepCache instead of computed
+    PRIME_REP_HINTS,      //Representatives recovered from a hint with one primality test
+    NUM_COUNTERS
+};
+
+/** Public API entry points whose latency is recorded. */
+enum Timer {
+    BILINEAR_GEN_KEY,
+    BILINEAR_ACCUMULATE_PRIVATE,
+    BILINEAR_ACCUMULATE_PUBLIC,
+    BILINEAR_WITNESSES_PRIVATE,
+    BILINEAR_WITNESSES_PUBLIC,
+    BILINEAR_VERIFY,
+    RSA_GEN_KEY,
+    RSA_GEN_REPRESENTATIVES,
+    RSA_ACCUMULATE_PRIVATE,
+    RSA_ACCUMULATE_PUBLIC,
+    RSA_WITNESSES_PRIVATE,
+    RSA_WITNESSES_PUBLIC,
+    RSA_VERIFY,
+    RSA_AGGREGATE_WITNESSES,
+    RSA_PROVE_BATCH,
+    RSA_VERIFY_BATCH,
+    RSA_VERIFY_RANDOMIZED,
+    RSA_ADD,
+    RSA_UPDATE,
+    RSA_UPDATE_WITNESS,
+    RSA_ACCUMULATE_PIPELINED,
+    NUM_TIMERS
+};
+
+/**
+ * Histograms use power-of-two microsecond buckets: bucket 0 counts samples
+ * under 1us, and bucket i counts samples in [2^(i-1), 2^i) us. The last
+ * bucket also absorbs everything larger (about 18 minutes and up).
+ */
+const size_t NUM_BUCKETS = 32;
+
+struct HistogramSnapshot {
+    uint64_t count;
+    uint64_t sumNanos;
+    uint64_t buckets[NUM_BUCKETS];
+};
+
+/** A point-in-time copy of every counter and histogram. */
+struct Snapshot {
+    uint64_t counters[NUM_COUNTERS];
+    HistogramSnapshot latencies[NUM_TIMERS];
+};
+
+void increment(Counter counter, uint64_t amount = 1);
+void recordLatency(Timer timer, uint64_t nanoseconds);
+uint64_t getCount(Counter counter);
+
+/** @return true if the library was built with instrumentation enabled */
+bool isEnabled();
+/** Zeroes all counters and histograms. */
+void reset();
+
+const char* counterName(Counter counter);
+const char* timerName(Timer timer);
+/** @return the upper bound of a histogram bucket, in seconds */
+double bucketUpperBound(size_t bucket);
+
+Snapshot takeSnapshot();
+void writeJson(std::ostream& out, const Snapshot& snapshot = takeSnapshot());
+void writePrometheus(std::ostream& out, const Snapshot& snapshot = takeSnapshot());
+
+/**
+ * Records the lifetime of the object as one sample of the given timer.
+ * Construct one at the top of a function to time the whole call.
+ */
+class ScopedTimer {
+public:
+    ScopedTimer(Timer timer) : timer(timer), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        recordLatency(timer, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - start).count());
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Timer timer;
+    std::chrono::steady_clock::time_point start;
+};
+
+}  // namespace Metrics
+
+#ifdef ACCUMULATOR_METRICS
+#define METRICS_COUNT(counter) Metrics::increment(Metrics::counter)
+#define METRICS_ADD(counter, amount) Metrics::increment(Metrics::counter, (amount))
+#define METRICS_TIME(timer) Metrics::ScopedTimer metricsTimer_##timer(Metrics::timer)
+#else
+//Arguments are not evaluated when instrumentation is disabled
+#define METRICS_COUNT(counter) ((void)0)
+#define METRICS_ADD(counter, amount) ((void)0)
+#define METRICS_TIME(timer) ((void)0)
+#endif
+
+#endif /* _METRICS_H_ */
@@ -7,6 +7,7 @@
 #define _SHA_256_H_
 
 #include <bilinear/G.hpp>
+#include <cstddef>
 #include <vector>
 
 /**
@@ -18,9 +19,65 @@ namespace SHA256 {
 inline constexpr int DIGEST_LENGTH = 32;
 
 void computeDigest(const char* input, int length, std::vector<unsigned char>& output);
+/** Writes the DIGEST_LENGTH-byte digest of input to output */
+void computeDigest(const unsigned char* input, size_t length, unsigned char* output);
+/**
+ * Hashes count independent messages at once, writing the digest of
+ * inputs[i], which is lengths[i] bytes long, to outputs + i * DIGEST_LENGTH.
+ * The vector kernels hash one message in each lane of a register and start
+ * a lane on the next message as soon as its current one is done, so
+ * messages of different lengths can be mixed freely.
+ */
+void computeDigests(const unsigned char* const* inputs, const size_t* lengths, size_t count,
+                    unsigned char* outputs);
+/** Hashes count messages of length bytes each, stored one after another at input, like computeDigests above */
+void computeDigests(const unsigned char* input, size_t length, size_t count, unsigned char* outputs);
 void computeAccumulatorDigest(const G* acc, std::vector<unsigned char>& output);
 bool isHashesEqual(const std::vector<unsigned char>& hash1, const std::vector<unsigned char>& hash2);
 
+/**
+ * The implementations of computeDigest, in order of preference. The first one
+ * the CPU supports is used unless setKernel picks another; see
+ * utils/CpuDispatch.hpp.
+ */
+enum Kernel {
+    /** The SHA extensions' round and message-schedule instructions */
+    KERNEL_SHA_NI,
+    /** Crypto++, which does its own CPU detection */
+    KERNEL_CRYPTOPP,
+    /** Plain C++ */
+    KERNEL_PORTABLE,
+    NUM_KERNELS
+};
+
+const char* getKernelName(Kernel kernel);
+/** @return true if this CPU can run kernel */
+bool isSupported(Kernel kernel);
+Kernel getKernel();
+/** Switches computeDigest to kernel, which must be supported */
+void setKernel(Kernel kernel);
+
+/**
+ * The implementations of computeDigests, in order of preference, chosen the
+ * same way as computeDigest's.
+ */
+enum BatchKernel {
+    /** Sixteen messages at a time, one in each 32-bit lane of an AVX-512 register */
+    BATCH_AVX512,
+    /** Eight messages at a time in AVX2 registers */
+    BATCH_AVX2,
+    /** One message at a time with computeDigest, whichever kernel it uses */
+    BATCH_SERIAL,
+    NUM_BATCH_KERNELS
+};
+
+const char* getBatchKernelName(BatchKernel kernel);
+/** @return true if this CPU can run kernel */
+bool isSupported(BatchKernel kernel);
+BatchKernel getBatchKernel();
+/** Switches computeDigests to kernel, which must be supported */
+void setBatchKernel(BatchKernel kernel);
+
 }  // namespace SHA256
 
 #endif /* _SHA_256_H_ */
@@ -0,0 +1,89 @@
+/*
+ * TaskTrace.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef _TASK_TRACE_H_
+#define _TASK_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+/**
+ * A fixed-size ring buffer of task timing events recorded by a ThreadPool
+ * with tracing enabled. Each event records when a task was enqueued, when a
+ * worker picked it up, when it finished, which worker ran it and the label
+ * it was submitted with. Once the buffer is full the oldest events are
+ * overwritten, so a long run keeps only its most recent tasks.
+ *
+ * The buffer can be written out in the Chrome trace-event JSON format, which
+ * can be loaded into chrome://tracing or ui.perfetto.dev to see each worker's
+ * timeline and how long tasks sat in the queue.
+ */
+class TaskTrace {
+public:
+    struct Event {
+        const char* label;
+        size_t workerId;
+        uint64_t enqueueTime;  //All times are nanoseconds since the trace was created
+        uint64_t startTime;
+        uint64_t endTime;
+    };
+
+    TaskTrace(size_t capacity);
+
+    /** @return the current time on the trace's clock */
+    uint64_t now() const;
+    /**
+     * Records a completed task. Safe to call concurrently from any number of
+     * worker threads. The worker ID is that of the calling thread. If a newer
+     * event is already being written to the same slot of the ring, which can
+     * only happen once the ring has wrapped around, this event is dropped.
+     */
+    void record(const char* label, uint64_t enqueueTime, uint64_t startTime, uint64_t endTime);
+    /** Discards all recorded events. Should only be called while the pool is idle. */
+    void clear();
+    /**
+     * Returns the recorded events, oldest first. This may be called while
+     * tasks are still recording: every slot carries a sequence stamp, so an
+     * event that is half written or is overwritten while it is read is left
+     * out instead of being returned torn.
+     * @return the recorded events, oldest first
+     */
+    std::vector<Event> getEvents() const;
+    /**
+     * Writes the recorded events as Chrome trace-event JSON, leaving out any
+     * that getEvents would. To see every traced task, call this once they
+     * have completed (e.g. after waiting on their futures).
+     */
+    void writeChromeTrace(std::ostream& out) const;
+
+    /** Sets the worker ID that record() attributes events on this thread to. */
+    static void setCurrentWorkerId(size_t workerId);
+
+private:
+    /**
+     * One event in the ring. The sequence stamp is 2i + 1 while the slot's
+     * i-th event is being written and 2i + 2 once it has been, so a reader
+     * that sees the same even stamp before and after copying the fields has
+     * a whole event. The fields are atomic so that the copy isn't a data race.
+     */
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> label{nullptr};
+        std::atomic<size_t> workerId{0};
+        std::atomic<uint64_t> enqueueTime{0};
+        std::atomic<uint64_t> startTime{0};
+        std::atomic<uint64_t> endTime{0};
+    };
+
+    std::vector<Slot> ring;
+    std::atomic<uint64_t> numRecorded;
+    uint64_t epoch;
+};
+
+#endif /* _TASK_TRACE_H_ */
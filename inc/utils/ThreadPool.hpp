@@ -20,6 +20,8 @@
  *   3. This notice may not be removed or altered from any source
  *   distribution.
  *
+ * Altered from the original: enqueue takes an optional task label, and
+ * the pool can record a per-task timeline (see utils/TaskTrace.hpp).
  */
 
 #ifndef THREAD_POOL_H
@@ -34,16 +36,20 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <atomic>
+
+#include <utils/TaskTrace.hpp>
 
 class ThreadPool;
  
 // our worker thread objects
 class Worker {
 public:
-    Worker(ThreadPool &s) : pool(s) { }
+    Worker(ThreadPool &s, size_t id) : pool(s), id(id) { }
     void operator()();
 private:
     ThreadPool &pool;
+    size_t id;
 };
 
 // the actual thread pool
@@ -51,9 +57,24 @@ class ThreadPool {
 public:
     ThreadPool();
     ThreadPool(size_t);
+    // label should be a string literal (or otherwise outlive the pool),
+    // since traces keep a pointer to it rather than a copy
     template<class T, class F>
-    std::future<T> enqueue(F f);
+    std::future<T> enqueue(F f, const char* label = "task");
     ~ThreadPool();
+    // The number of worker threads, which is how many tasks can run at once
+    size_t size() const;
+
+    // Starts recording a timeline of the most recent traceCapacity tasks,
+    // discarding any previous trace. Tasks already enqueued keep recording
+    // into the trace that was current when they were enqueued. A task's
+    // event is recorded before its future becomes ready, so once a caller
+    // has waited for its tasks it can read the trace.
+    void enableTracing(size_t traceCapacity = 1 << 16);
+    // Stops recording; the trace collected so far is kept
+    void disableTracing();
+    // The current trace, or nullptr if tracing was never enabled
+    const TaskTrace* getTrace() const;
 private:
     friend class Worker;
 
@@ -66,6 +87,19 @@ private:
     std::mutex queue_mutex;
     std::condition_variable condition;
     bool stop;
+
+    // tracing
+    std::shared_ptr<TaskTrace> trace;
+    std::atomic<bool> tracing;
+
+    // records a traced task's event when the task returns or throws
+    struct TraceRecorder {
+        TaskTrace* trace;
+        const char* label;
+        uint64_t enqueueTime;
+        uint64_t startTime;
+        ~TraceRecorder() { trace->record(label, enqueueTime, startTime, trace->now()); }
+    };
 };
 
 //The enqueue method must be fully defined in the header because it's templated.
@@ -73,13 +107,25 @@ private:
 
 // add new work item to the pool
 template<class T, class F>
-std::future<T> ThreadPool::enqueue(F f)
+std::future<T> ThreadPool::enqueue(F f, const char* label)
 {
     // don't allow enqueueing after stopping the pool
     if(stop)
         throw std::runtime_error("enqueue on stopped ThreadPool");
 
-    auto task = std::make_shared< std::packaged_task<T()> >(f);
+    std::shared_ptr< std::packaged_task<T()> > task;
+    if(tracing.load(std::memory_order_relaxed)) {
+        // record inside the packaged task, so the event is written before the future is ready
+        std::shared_ptr<TaskTrace> taskTrace = std::atomic_load(&trace);
+        uint64_t enqueueTime = taskTrace->now();
+        task = std::make_shared< std::packaged_task<T()> >(
+            [f = std::move(f), taskTrace, label, enqueueTime]() mutable -> T {
+                TraceRecorder recorder{taskTrace.get(), label, enqueueTime, taskTrace->now()};
+                return f();
+            });
+    } else {
+        task = std::make_shared< std::packaged_task<T()> >(std::move(f));
+    }
     std::future<T> res = task->get_future();
     {
         std::unique_lock<std::mutex> lock(queue_mutex);
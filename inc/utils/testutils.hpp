@@ -10,6 +10,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <string>
 
 namespace testutils {
 
@@ -28,6 +29,30 @@ inline void print_hex(const unsigned char* arr, const int size){
     std::dec(std::cout);
 }
 
+//The number of checks that have failed so far in this test program
+inline int& failedChecks() {
+    static int failures = 0;
+    return failures;
+}
+
+//Reports a failed check, naming what was checked, and counts it
+inline void check(bool condition, const std::string& what) {
+    if(!condition) {
+        std::cout << "FAILED: " << what << std::endl;
+        failedChecks()++;
+    }
+}
+
+//Prints a summary of the checks, and returns the exit status for main
+inline int checkResults() {
+    if(failedChecks()) {
+        std::cout << failedChecks() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
+
 }
 
 
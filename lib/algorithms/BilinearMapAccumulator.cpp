@@ -8,17 +8,21 @@
 #include <future>
 #include <math.h>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 #include <utils/LibConversions.hpp>
+#include <utils/MemoryAccounting.hpp>
+#include <utils/MemoryPool.hpp>
+#include <utils/Metrics.hpp>
 #include <utils/Pointers.hpp>
 #include <utils/Profiler.hpp>
 #include <utils/ThreadPool.hpp>
 #include <utils/testutils.hpp>
 
-#include <bilinear/G1_DCLXVI.hpp>
-#include <bilinear/G2_DCLXVI.hpp>
-#include <bilinear/GT_DCLXVI.hpp>
+#include <bilinear/Backends.hpp>
+#include <bilinear/GroupElement.hpp>
+#include <bilinear/PairingBackend.hpp>
 #include <bilinear/Scalar_DCLXVI.hpp>
 
 #include <flint/BigInt.hpp>
@@ -30,9 +34,6 @@
 using std::cout;
 using std::endl;
 
-extern "C" {
-#include <optate.h>
-}
 using std::reference_wrapper;
 using std::unique_ptr;
 
@@ -40,29 +41,154 @@ namespace BilinearMapAccumulator {
 
 typedef std::unique_lock<std::mutex> lock_t;
 
+/*
+ * The algorithms are written once, on the value types of whichever backend
+ * they are instantiated with (see the end of this file). The functions that
+ * take G, GT and Scalar objects are adapters: they copy their arguments into
+ * values of the backend the group elements belong to, call the typed
+ * function, and copy the results back.
+ *
+ * Group operations leave their results in Jacobian form, so the API functions
+ * (other than accumulateSetFromCoeffs) normalize the group elements they hand
+ * back. Callers can then share them between threads without a const accessor
+ * like exportObject having to normalize them in place.
+ */
+
+namespace {
+
+//Calls body with a (stateless) instance of the backend type that matches type
+template <typename Body>
+void withBackend(PairingBackend::Type type, Body&& body) {
+    if(type == PairingBackend::MONT64) {
+        body(Mont64Backend());
+    } else {
+        body(DCLXVIBackend());
+    }
+}
+
+//Calls body with instances of the backend type and of the placement (see AccumulatorInG1)
+template <typename Body>
+void withPlacement(PairingBackend::Type type, bool accumulatorInG2, Body&& body) {
+    withBackend(type, [&](auto backend) {
+        typedef decltype(backend) Backend;
+        if(accumulatorInG2) {
+            body(backend, AccumulatorInG2<Backend>());
+        } else {
+            body(backend, AccumulatorInG1<Backend>());
+        }
+    });
+}
+
+template <typename Backend>
+std::vector<Fr<Backend>> toValues(const std::vector<reference_wrapper<Scalar>>& set) {
+    std::vector<Fr<Backend>> values;
+    values.reserve(set.size());
+    for(const Scalar& element : set) {
+        values.emplace_back(element);
+    }
+    return values;
+}
+
+template <typename Backend>
+std::vector<Fr<Backend>> toValues(const std::vector<unique_ptr<Scalar>>& scalars) {
+    std::vector<Fr<Backend>> values;
+    values.reserve(scalars.size());
+    for(const unique_ptr<Scalar>& scalar : scalars) {
+        values.emplace_back(*scalar);
+    }
+    return values;
+}
+
+template <typename Backend, typename Ops>
+std::vector<GroupElement<Backend, Ops>> toValues(const std::vector<unique_ptr<G>>& elements) {
+    std::vector<GroupElement<Backend, Ops>> values;
+    values.reserve(elements.size());
+    for(const unique_ptr<G>& element : elements) {
+        values.emplace_back(*element);
+    }
+    return values;
+}
+
+template <typename Backend>
+PublicKeyValues<Backend> toValues(const BilinearMapKey::PublicKey& publicKey) {
+    return PublicKeyValues<Backend>(toValues<Backend, typename Backend::G1Ops>(publicKey.first),
+                                    toValues<Backend, typename Backend::G2Ops>(publicKey.second));
+}
+
+//Copies values into existing elements of the same group and backend
+template <typename Backend, typename Ops>
+void exportValues(const std::vector<GroupElement<Backend, Ops>>& values, std::vector<unique_ptr<G>>& elements) {
+    for(size_t i = 0; i < values.size(); i++) {
+        values.at(i).exportTo(*elements.at(i));
+    }
+}
+
+template <typename Backend>
+std::vector<flint::BigMod> toBigMods(const std::vector<Fr<Backend>>& values, const flint::BigInt& modulus) {
+    std::vector<flint::BigMod> bigMods(values.size(), flint::BigMod(modulus));
+    for(size_t i = 0; i < values.size(); i++) {
+        values.at(i).exportTo(bigMods.at(i));
+    }
+    return bigMods;
+}
+
+flint::BigInt groupOrder() {
+    flint::BigInt modulus;
+    LibConversions::getModulus(modulus);
+    return modulus;
+}
+
+}  // anonymous namespace
+
 /*-------------------------------Key Generation-------------------------------*/
 //Private helper method
-void computeG1Powers(const Scalar& secretKey, const unsigned int numPowers, std::vector<unique_ptr<G>>& pk1) {
-    pk1.push_back(std::make_unique<G1DCLXVI>());
-    for(unsigned int i = 0; i < numPowers; i++) {
-        unique_ptr<G> g1Pow = std::make_unique<G1DCLXVI>();
-        pk1.back()->doPower(secretKey, *g1Pow);
-        pk1.push_back(move(g1Pow));
+template <typename Backend, typename Ops>
+std::vector<GroupElement<Backend, Ops>> computePowers(const Fr<Backend>& secretKey, size_t numPowers) {
+    std::vector<GroupElement<Backend, Ops>> powers;
+    powers.reserve(numPowers + 1);
+    powers.emplace_back();
+    for(size_t i = 0; i < numPowers; i++) {
+        powers.push_back(powers.back().pow(secretKey));
     }
+    return powers;
 }
 
 //Private helper method
-void computeG2Powers(const Scalar& secretKey, const unsigned int numPowers, std::vector<unique_ptr<G>>& pk2) {
-    pk2.push_back(std::make_unique<G2DCLXVI>());
-    for(unsigned int i = 0; i < numPowers; i++) {
-        unique_ptr<G> g2Pow = std::make_unique<G2DCLXVI>();
-        pk2.back()->doPower(secretKey, *g2Pow);
-        pk2.push_back(move(g2Pow));
+template <typename Element>
+void trimPowers(std::vector<Element>& powers, size_t highestPower) {
+    if(powers.size() > highestPower + 1) {
+        powers.resize(highestPower + 1);
+        powers.shrink_to_fit();
     }
 }
 
+template <typename Backend>
+void genKey(size_t size, Fr<Backend>& secretKey, PublicKeyValues<Backend>& publicKey, ThreadPool& threadPool) {
+    genKey(BilinearMapKey::Sizes{size, size}, secretKey, publicKey, threadPool);
+}
+
+template <typename Backend>
+void genKey(const BilinearMapKey::Sizes& sizes, Fr<Backend>& secretKey, PublicKeyValues<Backend>& publicKey,
+            ThreadPool& threadPool) {
+    METRICS_TIME(BILINEAR_GEN_KEY);
+    MEMORY_SCOPE(BILINEAR_GEN_KEY);
+    secretKey.generateRandom();
+
+    //Each component of the public key (powers of G1 and powers of G2) can be computed separately
+    std::future<void> pk1Future = threadPool.enqueue<void>([&]() {
+        publicKey.first = computePowers<Backend, typename Backend::G1Ops>(secretKey, sizes.g1Powers);
+    }, "bilinear.g1Powers");
+    std::future<void> pk2Future = threadPool.enqueue<void>([&]() {
+        publicKey.second = computePowers<Backend, typename Backend::G2Ops>(secretKey, sizes.g2Powers);
+    }, "bilinear.g2Powers");
+
+    pk1Future.get();
+    pk2Future.get();
+    G1<Backend>::batchNormalize(publicKey.first);
+    G2<Backend>::batchNormalize(publicKey.second);
+}
+
 void genKey(const std::vector<std::vector<reference_wrapper<Scalar>>>& sets, const unsigned int maxPkSize, BilinearMapKey& key, ThreadPool& threadPool) {
-    // cout<<"Generating key...";
     unsigned int q = 0;
 
     if(maxPkSize > 0) {
@@ -80,134 +206,170 @@ void genKey(const std::vector<std::vector<reference_wrapper<Scalar>>>& sets, con
             q = m;
         }
     }
+    genKey(BilinearMapKey::Sizes{q, q}, key, threadPool);
+}
 
-    // Secret key
-    Scalar& sk = key.getSecretKey();
-    sk.generateRandom();
+void genKey(const BilinearMapKey::Sizes& sizes, BilinearMapKey& key, ThreadPool& threadPool) {
+    const PairingBackend::Type type = PairingBackend::getDefault();
+    withBackend(type, [&](auto backend) {
+        typedef decltype(backend) Backend;
+        Fr<Backend> secretKey;
+        PublicKeyValues<Backend> publicKey;
+        genKey(sizes, secretKey, publicKey, threadPool);
+
+        secretKey.exportTo(key.getSecretKey());
+        BilinearMapKey::PublicKey& pk = key.getPublicKey();
+        for(const G1<Backend>& power : publicKey.first) {
+            pk.first.push_back(PairingBackend::newG1(type));
+            power.exportTo(*pk.first.back());
+        }
+        for(const G2<Backend>& power : publicKey.second) {
+            pk.second.push_back(PairingBackend::newG2(type));
+            power.exportTo(*pk.second.back());
+        }
+    });
+}
 
-    // Public key
-    BilinearMapKey::PublicKey& pk = key.getPublicKey();
-    std::vector<unique_ptr<G>>& pk1 = pk.first;
-    std::vector<unique_ptr<G>>& pk2 = pk.second;
+BilinearMapKey::Sizes proverKeySizes(size_t maxSetSize, bool accumulatorInG2) {
+    size_t accumulatorPowers = maxSetSize, witnessPowers = maxSetSize > 0 ? maxSetSize - 1 : 0;
+    if(accumulatorInG2)
+        return BilinearMapKey::Sizes{witnessPowers, accumulatorPowers};
+    return BilinearMapKey::Sizes{accumulatorPowers, witnessPowers};
+}
 
-    //Each component of the public key (powers of G1 and powers of G2) can be computed separately
-    std::future<void> pk1Future = threadPool.enqueue<void>([&]() {
-        computeG1Powers(sk, q, pk1);
-    });
-    std::future<void> pk2Future = threadPool.enqueue<void>([&]() {
-        computeG2Powers(sk, q, pk2);
-    });
+BilinearMapKey::Sizes verifierKeySizes(bool accumulatorInG2) {
+    return accumulatorInG2 ? BilinearMapKey::Sizes{0, 1} : BilinearMapKey::Sizes{1, 0};
+}
 
-    pk1Future.get();
-    pk2Future.get();
+namespace {
 
-    // cout<<"done. Generated "<<q<<" elements in both G1/G2."<<endl;
+template <typename Backend>
+MemoryAccounting::ElementSizes elementSizesOf(bool accumulatorInG2) {
+    return MemoryAccounting::ElementSizes{
+            sizeof(typename Backend::G1Ops::Adapter), sizeof(typename Backend::G2Ops::Adapter),
+            accumulatorInG2 ? sizeof(typename Backend::G2Ops::Point) : sizeof(typename Backend::G1Ops::Point),
+            sizeof(scalar_t)};
+}
+
+}  // namespace
+
+MemoryAccounting::ElementSizes elementSizes(PairingBackend::Type backend, bool accumulatorInG2) {
+    if(backend == PairingBackend::MONT64)
+        return elementSizesOf<Mont64Backend>(accumulatorInG2);
+    return elementSizesOf<DCLXVIBackend>(accumulatorInG2);
+}
+
+template <typename Backend>
+void trimKey(PublicKeyValues<Backend>& publicKey, const BilinearMapKey::Sizes& sizes) {
+    trimPowers(publicKey.first, sizes.g1Powers);
+    trimPowers(publicKey.second, sizes.g2Powers);
 }
 
 /*--------------------------Private key accumulation--------------------------*/
 
-void accumulateSet(const std::vector<reference_wrapper<Scalar>>& set, const Scalar& privKey, G& acc) {
-    flint::BigInt modulus;
-    LibConversions::getModulus(modulus);
+template <typename Backend, typename Ops>
+GroupElement<Backend, Ops> accumulateSet(const std::vector<Fr<Backend>>& set, const Fr<Backend>& privKey,
+                                         const GroupElement<Backend, Ops>& base) {
+    METRICS_TIME(BILINEAR_ACCUMULATE_PRIVATE);
+    MEMORY_SCOPE(BILINEAR_ACCUMULATE_PRIVATE);
+    MemoryPool::Scope memoryScope;
+    flint::BigInt modulus = groupOrder();
     flint::BigMod sk(modulus);
-    privKey.exportFlintObject(sk);
+    privKey.exportTo(sk);
 
     flint::BigMod sum(modulus), power(modulus);
     flint::BigMod element(modulus);
     power = 1;
-    for(Scalar& scalar : set) {
-        scalar.exportFlintObject(element);
+    for(const Fr<Backend>& scalar : set) {
+        scalar.exportTo(element);
         sum = sk + element;
         power = power * sum;
     }
 
-    ScalarDCLXVI pScalar;
-    pScalar.importFlintObject(power);
-    acc.doPower(pScalar, acc);
+    GroupElement<Backend, Ops> acc = base.pow(Fr<Backend>(power));
+    acc.normalize();
+    return acc;
 }
 
-/*---------------------------Public key accumulation--------------------------*/
-/**
- * Private (not in header) helper function, to be submitted as a thread task.
- * Computes the product of a range of public-key elements raised to the powers
- * of a corresponding range of coefficients. Since each public-key element is
- * g to a power of s, and each coefficient is the coefficient of a power of s,
- * this computes g^(c0 + c1*s + c2*s^2 + c3*s^3) by computing g * (g^s)^c1 *
- * (g^(s^2))^c2 * (g^(s^3))^c3.
- *
- * @param inG2 True if the value being accumulated is in G2, false if it is in
- *        G1. This affects whether the public-key elements for G1 or G2 are used.
- * @param publicKey The public key of the bilinear-map accumulator, containing
- *        all the s-powers of G1 and G2
- * @param coeffs The vector of coefficients, a subset of which should be multiplied
- * @param startOffset The index into coeffs and publicKey at which to start multiplication
- * @param endOffset The index into coeffs and publicKey at which multiplication
- *        ends, exclusive
- * @return The product of the range of key elements raised to the powers of the
- *         corresponding range of coefficients
- */
-unique_ptr<G> computePower(const bool& inG2, const BilinearMapKey::PublicKey& publicKey,
-                           const std::vector<unique_ptr<Scalar>>& coeffs, size_t startOffset, size_t endOffset) {
-    size_t rangeLen = endOffset - startOffset;
+void accumulateSet(const std::vector<reference_wrapper<Scalar>>& set, const Scalar& privKey, G& acc) {
+    withPlacement(PairingBackend::typeOf(acc), PairingBackend::isG2(acc), [&](auto backend, auto placement) {
+        typedef decltype(backend) Backend;
+        typedef typename decltype(placement)::Accumulator Accumulator;
+        accumulateSet(toValues<Backend>(set), Fr<Backend>(privKey), Accumulator(acc)).exportTo(acc);
+    });
+}
 
-    scalar_t coeffs_scalars[rangeLen];
-    unique_ptr<curvepoint_fp_struct_t[]> pk_curvepoints;
-    unique_ptr<twistpoint_fp2_struct_t[]> pk_twistpoints;
+/*---------------------------Public key accumulation--------------------------*/
 
-    if(inG2) {
-        pk_twistpoints = unique_ptr<twistpoint_fp2_struct_t[]>(new twistpoint_fp2_struct_t[rangeLen]);
+//Private function - not declared in header
+void recursivePolMult(int low, int high, const std::vector<flint::BigMod>& roots, const flint::BigInt& modulus,
+                      flint::ModPolynomial* pPoly) {
+    if(high - low == 1) {
+        flint::ModPolynomial x(modulus);
+        //Sets coefficient 1 to 1, and modulus to the global DCLXVI modulus
+        x.set(1, 1);
+        x.set(0L, roots.at(low).getMantissa());
+        (*pPoly) = x;
     } else {
-        pk_curvepoints = unique_ptr<curvepoint_fp_struct_t[]>(new curvepoint_fp_struct_t[rangeLen]);
-    }
-
-    //Convert all the C++ objects (Scalar, G1, G2) to their underlying C objects (scalar_t, twistpoint, curvepoint)
-    int arraysIndex = 0;
-    for(size_t i = startOffset; i < endOffset; i++) {
-        coeffs.at(i)->exportObject(&coeffs_scalars[arraysIndex]);
-        if(inG2) {
-            publicKey.second.at(i)->exportObject(&pk_twistpoints[arraysIndex]);
-        } else {
-            publicKey.first.at(i)->exportObject(&pk_curvepoints[arraysIndex]);
-        }
-        arraysIndex++;
+        int mid = (high - low) / 2;
+        flint::ModPolynomial* pPoly1 = new flint::ModPolynomial(modulus);
+        flint::ModPolynomial* pPoly2 = new flint::ModPolynomial(modulus);
+        recursivePolMult(low, low + mid, roots, modulus, pPoly1);
+        recursivePolMult(low + mid, high, roots, modulus, pPoly2);
+        (*pPoly) = (*pPoly1) * (*pPoly2);
+        delete pPoly1;
+        delete pPoly2;
     }
+}
 
-    //Using the magical batch-multiply function from DCLXVI, raise all the public
-    //key elements to the power of the coefficients and multiply the powers together
-    unique_ptr<G> tempProduct;
-    if(inG2) {
-        tempProduct = std::make_unique<G2DCLXVI>();
-        twistpoint_fp2_multiscalarmult_vartime(((G2DCLXVI*)(tempProduct.get()))->getUnderlyingObj(), pk_twistpoints.get(), coeffs_scalars, arraysIndex);
+template <typename Backend>
+void computeCoefficients(const std::vector<Fr<Backend>>& roots, std::vector<Fr<Backend>>& coeffs) {
+    const flint::BigInt modulus = groupOrder();
+    flint::ModPolynomial polynomial(modulus);
+    if(roots.size()) {
+        recursivePolMult(0, roots.size(), toBigMods(roots, modulus), modulus, &polynomial);
     } else {
-        tempProduct = std::make_unique<G1DCLXVI>();
-        curvepoint_fp_multiscalarmult_vartime(((G1DCLXVI*)(tempProduct.get()))->getUnderlyingObj(), pk_curvepoints.get(), coeffs_scalars, arraysIndex);
+        polynomial.setConstant(1);
     }
 
-    // cout << "Computed powers from coeffs[" << startOffset << "] to coeffs[" << (endOffset - 1) << "]" << endl;
-    // cout << "Result: ";
-    // testutils::print_hex(tempProduct->getByteBuffer(), tempProduct->getSize());
+    long degree = polynomial.getDegree() + 1;
+    coeffs.reserve(coeffs.size() + degree);
+    for(long i = 0; i < degree; i++) {
+        coeffs.emplace_back(polynomial.at(i));
+    }
+}
 
-    return tempProduct;
+void computeCoefficients(const std::vector<reference_wrapper<Scalar>>& roots, std::vector<unique_ptr<Scalar>>& coeffs) {
+    //Exponents are the same on every backend
+    std::vector<Fr<DCLXVIBackend>> values;
+    computeCoefficients(toValues<DCLXVIBackend>(roots), values);
+    for(const Fr<DCLXVIBackend>& value : values) {
+        unique_ptr<Scalar> pScalar = std::make_unique<ScalarDCLXVI>();
+        value.exportTo(*pScalar);
+        coeffs.push_back(move(pScalar));
+    }
 }
 
-void accumulateSetFromCoeffs(const std::vector<unique_ptr<Scalar>>& coeffs, const BilinearMapKey::PublicKey& publicKey,
-                             G& acc, bool inG2, ThreadPool& threadPool) {
+/**
+ * Computes an accumulator from the coefficients of its polynomial. Since each
+ * public-key element is g to a power of s, and each coefficient is the
+ * coefficient of a power of s, the product of (g^(s^i))^(c_i) is
+ * g^(c0 + c1*s + c2*s^2 + ...). The terms after the first are split into
+ * ranges, and each range is submitted to the thread pool as one
+ * multi-exponentiation.
+ */
+template <typename Backend, typename Ops>
+GroupElement<Backend, Ops> accumulateSetFromCoeffs(const std::vector<Fr<Backend>>& coeffs,
+                                                   const std::vector<GroupElement<Backend, Ops>>& powers,
+                                                   ThreadPool& threadPool) {
+    typedef GroupElement<Backend, Ops> Element;
     static const size_t MAX_TASKS = 50;
     static const size_t MIN_OPERATIONS_PER_TASK = 1000;
-    const std::vector<unique_ptr<G>>& pk1 = publicKey.first;
-    const std::vector<unique_ptr<G>>& pk2 = publicKey.second;
+    if(coeffs.size() > powers.size())
+        throw std::out_of_range("The public key has fewer elements than the set has coefficients");
 
     //compute the first power, for the constant term, outside of threads
-    //initialize acc to this value (disregard what it used to be)
-    if(inG2) {
-        pk2.at(0)->doPower(*(coeffs.at(0)), acc);
-    } else {
-        pk1.at(0)->doPower(*(coeffs.at(0)), acc);
-    }
-    // cout << "After raising publicKey element 0 to [";
-    // coeffs.at(0)->printPretty();
-    // cout << "], acc is: ";
-    // testutils::print_hex(acc.getByteBuffer(), acc.getSize());
+    Element acc = powers.at(0).pow(coeffs.at(0));
 
     //Given the size of the coefficients vector and target number of threads,
     //determine the number of coefficients each thread can work on, and how many
@@ -235,11 +397,7 @@ void accumulateSetFromCoeffs(const std::vector<unique_ptr<Scalar>>& coeffs, cons
         leftItems = size % numOfThreads;
     }
 
-    // cout << "Size: " << size << endl;
-    // cout << "Threads: " << numOfThreads <<endl;
-    // cout << "leftItems: " << leftItems << endl;
-
-    std::vector<std::future<unique_ptr<G>>> workerFutures;
+    std::vector<std::future<Element>> workerFutures;
     //Starting at index 1, divide the coefficients vector up into rangeLen-size
     //chunks, and spawn a new thread to deal with each subset
     size_t offset = 1;
@@ -262,223 +420,275 @@ void accumulateSetFromCoeffs(const std::vector<unique_ptr<Scalar>>& coeffs, cons
         }
         offset = endOffset;
 
-        // cout << "Thread " << i << " will have offsets " << startOffset << " to " << endOffset << endl;
-
         //Note: the offsets must be passed by value, because they'll get cleaned
         //up once this scope ends, but the threads may still be running!
         workerFutures.push_back(
-                threadPool.enqueue<unique_ptr<G>>([&, startOffset, endOffset]() {
-                    return computePower(inG2, publicKey, coeffs, startOffset, endOffset);
-                }));
+                threadPool.enqueue<Element>([&, startOffset, endOffset]() {
+                    size_t rangeLen = endOffset - startOffset;
+                    MEMORY_TRACK(msmInputs, rangeLen * (sizeof(Fr<Backend>) + sizeof(Element)));
+                    return Element::multiPower(&powers[startOffset], &coeffs[startOffset], rangeLen);
+                }, "bilinear.computePower"));
     }
 
-    //Set acc to the first non-null temporary product, then multiply into it
-    // bool accInitialized = false;
-    // int i = -1;
-    for(std::future<unique_ptr<G>>& workerFuture : workerFutures) {
-        // i++;
-        unique_ptr<G> tempProduct = workerFuture.get();
-        // if(tempProduct == nullptr)
-        //     continue;
-        // if(!accInitialized) {
-        //     acc = *(tempProduct);
-        //     accInitialized = true;
-        // } else {
-        // }
-        acc.doMultiplication(*(tempProduct), acc);
-        // cout << "Product from thread " << i << " is ";
-        // testutils::print_hex(tempProduct->getByteBuffer(), tempProduct->getSize());
-        // cout << "After including product from thread " << i << ", acc is: ";
-        // testutils::print_hex(acc.getByteBuffer(), acc.getSize());
+    for(std::future<Element>& workerFuture : workerFutures) {
+        acc *= workerFuture.get();
     }
+    return acc;
 }
 
-//Private function - not declared in header
-void recursivePolMult(int low, int high, const std::vector<reference_wrapper<Scalar>>& diff, flint::ModPolynomial* pPoly) {
-    const flint::BigInt modulus = ([]() {flint::BigInt modulus;
-                                        LibConversions::getModulus(modulus);
-                                        return modulus; })();
-    if(high - low == 1) {
-        flint::ModPolynomial x(modulus);
-        //Sets coefficient 1 to 1, and modulus to the global DCLXVI modulus
-        x.set(1, 1);
-        flint::BigMod diffLow(modulus);
-        diff.at(low).get().exportFlintObject(diffLow);
-        x.set(0L, diffLow.getMantissa());
-        (*pPoly) = x;
-    } else {
-        int mid = (high - low) / 2;
-        flint::ModPolynomial* pPoly1 = new flint::ModPolynomial(modulus);
-        flint::ModPolynomial* pPoly2 = new flint::ModPolynomial(modulus);
-        recursivePolMult(low, low + mid, diff, pPoly1);
-        recursivePolMult(low + mid, high, diff, pPoly2);
-        (*pPoly) = (*pPoly1) * (*pPoly2);
-        delete pPoly1;
-        delete pPoly2;
-    }
+void accumulateSetFromCoeffs(const std::vector<unique_ptr<Scalar>>& coeffs, const BilinearMapKey::PublicKey& publicKey,
+                             G& acc, bool inG2, ThreadPool& threadPool) {
+    withBackend(PairingBackend::typeOf(acc), [&](auto backend) {
+        typedef decltype(backend) Backend;
+        if(inG2) {
+            accumulateSetFromCoeffs(toValues<Backend>(coeffs), toValues<Backend, typename Backend::G2Ops>(publicKey.second),
+                                    threadPool).exportTo(acc);
+        } else {
+            accumulateSetFromCoeffs(toValues<Backend>(coeffs), toValues<Backend, typename Backend::G1Ops>(publicKey.first),
+                                    threadPool).exportTo(acc);
+        }
+    });
 }
 
-//Private function - not declared in header
-void computeCoefficients(const std::vector<reference_wrapper<Scalar>>& roots, std::vector<unique_ptr<Scalar>>& coeffs) {
-    const flint::BigInt modulus = ([]() {flint::BigInt modulus;
-                                        LibConversions::getModulus(modulus);
-                                        return modulus; })();
-    flint::ModPolynomial polynomial(modulus);
-    if(roots.size()) {
-        recursivePolMult(0, roots.size(), roots, &polynomial);
-    } else {
-        polynomial.setConstant(1);
-    }
-
-    long degree = polynomial.getDegree() + 1;
-    for(long i = 0; i < degree; i++) {
-        unique_ptr<Scalar> pScalar = std::make_unique<ScalarDCLXVI>();
-        pScalar->importFlintObject(polynomial.at(i));
-        coeffs.push_back(move(pScalar));
-    }
+template <typename Backend, typename Placement>
+typename Placement::Accumulator accumulateSet(const std::vector<Fr<Backend>>& set,
+                                              const PublicKeyValues<Backend>& publicKey, ThreadPool& threadPool) {
+    METRICS_TIME(BILINEAR_ACCUMULATE_PUBLIC);
+    MEMORY_SCOPE(BILINEAR_ACCUMULATE_PUBLIC);
+    MemoryPool::Scope memoryScope;
+    std::vector<Fr<Backend>> coeffs;
+    computeCoefficients(set, coeffs);
+    MEMORY_TRACK(coefficients, coeffs.capacity() * sizeof(Fr<Backend>));
+    typename Placement::Accumulator acc = accumulateSetFromCoeffs(coeffs, Placement::accumulatorPowers(publicKey),
+                                                                  threadPool);
+    acc.normalize();
+    return acc;
 }
 
-//Private function - not declared in header
-void accumulateSet(const std::vector<reference_wrapper<Scalar>>& set, const BilinearMapKey::PublicKey& publicKey,
-                   G& acc, bool inG2, ThreadPool& threadPool) {
-    std::vector<unique_ptr<Scalar>> coeffs;
-    computeCoefficients(set, coeffs);
-    // cout << "Set is: " << endl;
-    // for(const Scalar& el : set) {
-    //     el.printPretty();
-    // }
-    // cout << endl;
-    // cout << "Coefficients are: " << endl;
-    // for(const unique_ptr<Scalar>& c : coeffs) {
-    //     c->printPretty();
-    // }
-    accumulateSetFromCoeffs(coeffs, publicKey, acc, inG2, threadPool);
-}
-
-//Just a wrapper to hide the "inG2" parameter from the client
 void accumulateSet(const std::vector<reference_wrapper<Scalar>>& set, const BilinearMapKey::PublicKey& publicKey,
                    G& acc, ThreadPool& threadPool) {
-    accumulateSet(set, publicKey, acc, false, threadPool);
+    withPlacement(PairingBackend::typeOf(acc), PairingBackend::isG2(acc), [&](auto backend, auto placement) {
+        typedef decltype(backend) Backend;
+        typedef decltype(placement) Placement;
+        accumulateSet<Backend, Placement>(toValues<Backend>(set), toValues<Backend>(publicKey), threadPool)
+                .exportTo(acc);
+    });
 }
 
 /*-----------------------Private key witness generation-----------------------*/
 
-std::vector<flint::BigMod> multiplyLeftProducts(const std::vector<reference_wrapper<Scalar>>& set, const flint::BigMod& secretKey, const flint::BigInt& modulus) {
+std::vector<flint::BigMod> multiplyLeftProducts(const std::vector<flint::BigMod>& set, const flint::BigMod& secretKey, const flint::BigInt& modulus) {
     std::vector<flint::BigMod> leftProducts(set.size() + 1, flint::BigMod(1, modulus));
     //Compute products (x_i + s) for the exponent of g left-to-right, saving each partial product
-    flint::BigMod sum(modulus), element(modulus);
+    flint::BigMod sum(modulus);
     for(size_t i = 1; i <= set.size(); i++) {
-        set.at(i - 1).get().exportFlintObject(element);
-        sum = secretKey + element;
+        sum = secretKey + set.at(i - 1);
         leftProducts.at(i) = leftProducts.at(i - 1) * sum;
     }
 
     return leftProducts;
 }
 
-std::vector<flint::BigMod> multiplyRightProducts(const std::vector<reference_wrapper<Scalar>>& set, const flint::BigMod& secretKey, const flint::BigInt& modulus) {
+std::vector<flint::BigMod> multiplyRightProducts(const std::vector<flint::BigMod>& set, const flint::BigMod& secretKey, const flint::BigInt& modulus) {
     std::vector<flint::BigMod> rightProducts(set.size() + 1, flint::BigMod(1, modulus));
     //Compute products (x_i + s) for the exponent of g right-to-left, saving each partial product
-    flint::BigMod sum(modulus), element(modulus);
+    flint::BigMod sum(modulus);
     for(int i = set.size() - 1; i >= 0; i--) {  //must be int not size_t so it can stop at 0
-        set.at(i).get().exportFlintObject(element);
-        sum = secretKey + element;
+        sum = secretKey + set.at(i);
         rightProducts.at(i) = rightProducts.at(i + 1) * sum;
     }
     return rightProducts;
 }
 
-void witnessesForSet(const std::vector<reference_wrapper<Scalar>>& set, const Scalar& privKey,
-                     G& base, std::vector<unique_ptr<G>>& witnesses, ThreadPool& threadPool) {
-    flint::BigInt modulus;
-    LibConversions::getModulus(modulus);
+template <typename Backend, typename Ops>
+std::vector<GroupElement<Backend, Ops>> witnessesForSet(const std::vector<Fr<Backend>>& set,
+                                                        const Fr<Backend>& privKey,
+                                                        const GroupElement<Backend, Ops>& base,
+                                                        ThreadPool& threadPool) {
+    METRICS_TIME(BILINEAR_WITNESSES_PRIVATE);
+    MEMORY_SCOPE(BILINEAR_WITNESSES_PRIVATE);
+    MemoryPool::Scope memoryScope;
+    const flint::BigInt modulus = groupOrder();
     flint::BigMod sk(modulus);
-    privKey.exportFlintObject(sk);
+    privKey.exportTo(sk);
+    const std::vector<flint::BigMod> elements = toBigMods(set, modulus);
 
     //Compute products for the exponent separately in threads; the vectors will
     //also be initialized in the threads, since initialization is O(n)
     std::future<std::vector<flint::BigMod>> leftFuture = threadPool.enqueue<std::vector<flint::BigMod>>([&]() {
-        return multiplyLeftProducts(set, sk, modulus);
-    });
+        return multiplyLeftProducts(elements, sk, modulus);
+    }, "bilinear.leftProducts");
     std::future<std::vector<flint::BigMod>> rightFuture = threadPool.enqueue<std::vector<flint::BigMod>>([&]() {
-        return multiplyRightProducts(set, sk, modulus);
-    });
+        return multiplyRightProducts(elements, sk, modulus);
+    }, "bilinear.rightProducts");
 
     std::vector<flint::BigMod> leftProducts = leftFuture.get();
     std::vector<flint::BigMod> rightProducts = rightFuture.get();
+    MEMORY_TRACK(products, (leftProducts.capacity() + rightProducts.capacity()) * sizeof(flint::BigMod));
     //Generate exponent for element i's witness by multiplying left-product i with right-product i+1
+    std::vector<GroupElement<Backend, Ops>> witnesses;
+    witnesses.reserve(set.size());
     flint::BigMod power(modulus);
     for(size_t i = 0; i < set.size(); i++) {
         power = leftProducts.at(i) * rightProducts.at(i + 1);
-        ScalarDCLXVI powerScalar;
-        powerScalar.importFlintObject(power);
-        base.doPower(powerScalar, *(witnesses.at(i)));
+        witnesses.push_back(base.pow(Fr<Backend>(power)));
     }
+    GroupElement<Backend, Ops>::batchNormalize(witnesses);
+    return witnesses;
+}
+
+void witnessesForSet(const std::vector<reference_wrapper<Scalar>>& set, const Scalar& privKey,
+                     G& base, std::vector<unique_ptr<G>>& witnesses, ThreadPool& threadPool) {
+    //Witnesses in G1 are for accumulators in G2
+    withPlacement(PairingBackend::typeOf(base), !PairingBackend::isG2(base), [&](auto backend, auto placement) {
+        typedef decltype(backend) Backend;
+        typedef typename decltype(placement)::Witness Witness;
+        exportValues(witnessesForSet(toValues<Backend>(set), Fr<Backend>(privKey), Witness(base), threadPool),
+                     witnesses);
+    });
 }
 
 /*------------------------Public key witness generation-----------------------*/
 
 /* Unfortunately, the only way to compute witnesses with the public key is
- * brute force: by calling accumulateSet on each subset {set - set[i]}
+ * brute force: by accumulating each subset {set - set[i]}
  */
-void witnessTask(const std::vector<reference_wrapper<Scalar>>& set, const BilinearMapKey::PublicKey& publicKey,
-                 const int witnessIndex, unique_ptr<G>& witness) {
-    //Don't use the thread pool this task is in to run accumulateSet, otherwise the tasks
-    //created by accumulateSet might get blocked by the witnessTask itself
+template <typename Backend, typename Placement>
+typename Placement::Witness witnessTask(const std::vector<Fr<Backend>>& set, const PublicKeyValues<Backend>& publicKey,
+                                        const size_t witnessIndex) {
+    //Don't use the thread pool this task is in to run accumulateSetFromCoeffs, otherwise the tasks
+    //it creates might get blocked by the witnessTask itself
     static const size_t THREADS_IN_SUB_POOL = 16;
     static ThreadPool localPool(THREADS_IN_SUB_POOL);
     //Make a subset that excludes witnessIndex
-    std::vector<reference_wrapper<Scalar>> subset = std::vector<reference_wrapper<Scalar>>(set.begin(), set.begin() + witnessIndex);
+    std::vector<Fr<Backend>> subset(set.begin(), set.begin() + witnessIndex);
     subset.insert(subset.end(), set.begin() + witnessIndex + 1, set.end());
-    accumulateSet(subset, publicKey, *(witness), true, localPool);
+    MEMORY_TRACK(subset, subset.capacity() * sizeof(Fr<Backend>));
+    std::vector<Fr<Backend>> coeffs;
+    computeCoefficients(subset, coeffs);
+    return accumulateSetFromCoeffs(coeffs, Placement::witnessPowers(publicKey), localPool);
 }
-void witnessesForSet(const std::vector<reference_wrapper<Scalar>>& set, const BilinearMapKey::PublicKey& publicKey,
-                     std::vector<unique_ptr<G>>& witnesses, ThreadPool& threadPool) {
-    std::vector<std::future<void>> futures;
+
+template <typename Backend, typename Placement>
+std::vector<typename Placement::Witness> witnessesForSet(const std::vector<Fr<Backend>>& set,
+                                                         const PublicKeyValues<Backend>& publicKey,
+                                                         ThreadPool& threadPool) {
+    typedef typename Placement::Witness Witness;
+    METRICS_TIME(BILINEAR_WITNESSES_PUBLIC);
+    MEMORY_SCOPE(BILINEAR_WITNESSES_PUBLIC);
+    MemoryPool::Scope memoryScope;
+    std::vector<std::future<Witness>> futures;
     for(size_t i = 0; i < set.size(); i++) {
-        futures.push_back(threadPool.enqueue<void>([&, i]() {
-            witnessTask(set, publicKey, i, witnesses.at(i));
-        }));
+        futures.push_back(threadPool.enqueue<Witness>([&, i]() {
+            return witnessTask<Backend, Placement>(set, publicKey, i);
+        }, "bilinear.witnessTask"));
     }
+    std::vector<Witness> witnesses;
+    witnesses.reserve(set.size());
     for(auto& future : futures) {
-        future.get();
+        witnesses.push_back(future.get());
     }
+    Witness::batchNormalize(witnesses);
+    return witnesses;
+}
+
+void witnessesForSet(const std::vector<reference_wrapper<Scalar>>& set, const BilinearMapKey::PublicKey& publicKey,
+                     std::vector<unique_ptr<G>>& witnesses, ThreadPool& threadPool) {
+    if(witnesses.empty())
+        return;
+    const G& first = *witnesses.front();
+    withPlacement(PairingBackend::typeOf(first), !PairingBackend::isG2(first), [&](auto backend, auto placement) {
+        typedef decltype(backend) Backend;
+        typedef decltype(placement) Placement;
+        exportValues(witnessesForSet<Backend, Placement>(toValues<Backend>(set), toValues<Backend>(publicKey),
+                                                         threadPool),
+                     witnesses);
+    });
 }
 
 /*--------------------------------Verification--------------------------------*/
 
 void pairing(GT& result, const G& g1Element, const G& g2Element) {
-    fp12e_t rop;
-    curvepoint_fp_t op1;
-    twistpoint_fp2_t op2;
-    const G1DCLXVI& pG1 = ref_cast<G1DCLXVI>(g1Element);
-    const G2DCLXVI& pG2 = ref_cast<G2DCLXVI>(g2Element);
-    pG1.exportObject(op1);
-    pG2.exportObject(op2);
-    optate(rop, op2, op1);  //wtf?
-    GTDCLXVI& pGT = ref_cast<GTDCLXVI>(result);
-    pGT.importObject(rop);
+    METRICS_COUNT(PAIRING);
+    PairingBackend::pairing(result, g1Element, g2Element);
+}
+
+//Private helper: verification only needs g^s from the accumulator's half of the public key
+template <typename Placement, typename Backend>
+bool verifyWithPower(const Fr<Backend>& element, const typename Placement::Witness& witness,
+                     const typename Placement::Accumulator& accumulator,
+                     const typename Placement::Accumulator& gToTheS) {
+    typedef typename Placement::Accumulator Accumulator;
+    METRICS_TIME(BILINEAR_VERIFY);
+    MEMORY_SCOPE(BILINEAR_VERIFY);
+    //Compute g^element * g^s, in the accumulator's group
+    Accumulator elementInAccumulator = Accumulator().pow(element) * gToTheS;
+    //Pairing e1 is g^(element+s) with witness; pairing e2 is the accumulator with the generator
+    //of the witness's group. They should be equal.
+    return Placement::pairing(elementInAccumulator, witness)
+           == Placement::pairing(accumulator, typename Placement::Witness());
+}
+
+template <typename Backend>
+bool verify(const Fr<Backend>& element, const G2<Backend>& witness, const G1<Backend>& accumulator,
+            const PublicKeyValues<Backend>& publicKey) {
+    return verifyWithPower<AccumulatorInG1<Backend>>(element, witness, accumulator, publicKey.first.at(1));
+}
+
+template <typename Backend>
+bool verify(const Fr<Backend>& element, const G1<Backend>& witness, const G2<Backend>& accumulator,
+            const PublicKeyValues<Backend>& publicKey) {
+    return verifyWithPower<AccumulatorInG2<Backend>>(element, witness, accumulator, publicKey.second.at(1));
 }
 
 bool verify(const Scalar& element, const G& witness, const G& accumulator, BilinearMapKey::PublicKey& publicKey) {
-    G1DCLXVI g1Generator;
-    G2DCLXVI g2Generator;
-
-    //Compute g^element
-    G1DCLXVI elementAsG;
-    g1Generator.doPower(element, elementAsG);
-    //Compute g^element * g^s, retrieving g^s from the public key
-    G1DCLXVI elementInAccumulator;
-    G& gPower1 = *(publicKey.first.at(1));
-    gPower1.doMultiplication(elementAsG, elementInAccumulator);
-    //Pairing e1 is g^(element+s) with witness, where g^(element+s) is in G1 and witness is in G2
-    GTDCLXVI e1;
-    pairing(e1, elementInAccumulator, witness);
-    //Pairing e2 is the accumulator (in G1) with the generator for G2
-    GTDCLXVI e2;
-    pairing(e2, accumulator, g2Generator);
-    //The results of the two pairings should be equal
-    return e1.isEqual(e2);
+    bool verified = false;
+    bool accumulatorInG2 = PairingBackend::isG2(accumulator);
+    withPlacement(PairingBackend::typeOf(accumulator), accumulatorInG2, [&](auto backend, auto placement) {
+        typedef decltype(backend) Backend;
+        typedef decltype(placement) Placement;
+        typedef typename Placement::Accumulator Accumulator;
+        const G& gToTheS = accumulatorInG2 ? *publicKey.second.at(1) : *publicKey.first.at(1);
+        verified = verifyWithPower<Placement>(Fr<Backend>(element), typename Placement::Witness(witness),
+                                              Accumulator(accumulator), Accumulator(gToTheS));
+    });
+    return verified;
 }
 
+/*----------------------------Typed instantiations----------------------------*/
+
+#define INSTANTIATE_FOR_BACKEND(Backend)                                                                      \
+    template void genKey(size_t, Fr<Backend>&, PublicKeyValues<Backend>&, ThreadPool&);                      \
+    template void genKey(const BilinearMapKey::Sizes&, Fr<Backend>&, PublicKeyValues<Backend>&,              \
+                         ThreadPool&);                                                                       \
+    template void trimKey(PublicKeyValues<Backend>&, const BilinearMapKey::Sizes&);                          \
+    template G1<Backend> accumulateSet(const std::vector<Fr<Backend>>&, const Fr<Backend>&,                  \
+                                       const G1<Backend>&);                                                  \
+    template G2<Backend> accumulateSet(const std::vector<Fr<Backend>>&, const Fr<Backend>&,                  \
+                                       const G2<Backend>&);                                                  \
+    template G1<Backend> accumulateSet<Backend, AccumulatorInG1<Backend>>(                                   \
+            const std::vector<Fr<Backend>>&, const PublicKeyValues<Backend>&, ThreadPool&);                  \
+    template G2<Backend> accumulateSet<Backend, AccumulatorInG2<Backend>>(                                   \
+            const std::vector<Fr<Backend>>&, const PublicKeyValues<Backend>&, ThreadPool&);                  \
+    template void computeCoefficients(const std::vector<Fr<Backend>>&, std::vector<Fr<Backend>>&);           \
+    template G1<Backend> accumulateSetFromCoeffs(const std::vector<Fr<Backend>>&,                            \
+                                                 const std::vector<G1<Backend>>&, ThreadPool&);              \
+    template G2<Backend> accumulateSetFromCoeffs(const std::vector<Fr<Backend>>&,                            \
+                                                 const std::vector<G2<Backend>>&, ThreadPool&);              \
+    template std::vector<G2<Backend>> witnessesForSet(const std::vector<Fr<Backend>>&, const Fr<Backend>&,   \
+                                                      const G2<Backend>&, ThreadPool&);                      \
+    template std::vector<G1<Backend>> witnessesForSet(const std::vector<Fr<Backend>>&, const Fr<Backend>&,   \
+                                                      const G1<Backend>&, ThreadPool&);                      \
+    template std::vector<G2<Backend>> witnessesForSet<Backend, AccumulatorInG1<Backend>>(                    \
+            const std::vector<Fr<Backend>>&, const PublicKeyValues<Backend>&, ThreadPool&);                  \
+    template std::vector<G1<Backend>> witnessesForSet<Backend, AccumulatorInG2<Backend>>(                    \
+            const std::vector<Fr<Backend>>&, const PublicKeyValues<Backend>&, ThreadPool&);                  \
+    template bool verify(const Fr<Backend>&, const G2<Backend>&, const G1<Backend>&,                         \
+                         const PublicKeyValues<Backend>&);                                                   \
+    template bool verify(const Fr<Backend>&, const G1<Backend>&, const G2<Backend>&,                         \
+                         const PublicKeyValues<Backend>&);
+
+INSTANTIATE_FOR_BACKEND(DCLXVIBackend)
+INSTANTIATE_FOR_BACKEND(Mont64Backend)
+
 }  // namespace BilinearMapAccumulator
@@ -5,12 +5,33 @@
 
 #include <algorithms/BilinearMapKey.hpp>
 
-#include <bilinear/G1_DCLXVI.hpp>
-#include <bilinear/G2_DCLXVI.hpp>
+#include <cstdint>
 
+#include <bilinear/PairingBackend.hpp>
 #include <bilinear/Scalar_DCLXVI.hpp>
+#include <utils/BinaryIO.hpp>
 #include <utils/Pointers.hpp>
 
+namespace {
+
+//Written in place of the single count of a key file whose halves have different lengths
+const size_t DIFFERENT_SIZES = SIZE_MAX;
+//Written in place of the single count of a key file that records its backend
+const size_t WITH_BACKEND = SIZE_MAX - 1;
+
+size_t highestPower(const std::vector<std::unique_ptr<G>>& powers) {
+    return powers.empty() ? 0 : powers.size() - 1;
+}
+
+void trimPowers(std::vector<std::unique_ptr<G>>& powers, size_t highestPower) {
+    if(powers.size() > highestPower + 1) {
+        powers.resize(highestPower + 1);
+        powers.shrink_to_fit();
+    }
+}
+
+}  // namespace
+
 BilinearMapKey::BilinearMapKey() {
     _sk = std::make_unique<ScalarDCLXVI>();
     _pk = std::make_unique<BilinearMapKey::PublicKey>();
@@ -27,6 +48,15 @@ BilinearMapKey::PublicKey& BilinearMapKey::getPublicKey() const {
     return *(_pk);
 }
 
+BilinearMapKey::Sizes BilinearMapKey::getPublicKeySizes() const {
+    return Sizes{highestPower(_pk->first), highestPower(_pk->second)};
+}
+
+void BilinearMapKey::trimPublicKey(const Sizes& sizes) {
+    trimPowers(_pk->first, sizes.g1Powers);
+    trimPowers(_pk->second, sizes.g2Powers);
+}
+
 void BilinearMapKey::readSkFromFile(const char* fName) {
     std::ifstream in(fName, std::ios::in | std::ios::binary);
     _sk->readFromFile(in);
@@ -39,41 +69,55 @@ void BilinearMapKey::writeSkToFile(const char* fName) const {
     out.close();
 }
 
-void BilinearMapKey::readPkFromFile(const char* fName) {
-    std::ifstream in(fName, std::ios::in | std::ios::binary);
-
-    size_t pkSize;
-    in.read((char*)&pkSize, sizeof(pkSize));
+bool BilinearMapKey::readPkFromFile(const char* fName) {
+    BufferedReader in(fName);
+
+    //Files without a backend tag predate Mont64, so they hold DCLXVI elements
+    size_t pkSize = 0, g2Size = 0, tag = PairingBackend::DCLXVI;
+    bool headerRead = in.read(&pkSize, sizeof(pkSize));
+    if(pkSize == WITH_BACKEND) {
+        headerRead = in.read(&tag, sizeof(tag)) && in.read(&pkSize, sizeof(pkSize)) && in.read(&g2Size, sizeof(g2Size));
+    } else if(pkSize == DIFFERENT_SIZES) {
+        headerRead = in.read(&pkSize, sizeof(pkSize)) && in.read(&g2Size, sizeof(g2Size));
+    } else {
+        g2Size = pkSize;
+    }
 
-    for(size_t i = 0; i < pkSize; i++) {
-        std::unique_ptr<G> g1 = std::make_unique<G1DCLXVI>();
-        g1->readFromFile(in);
-        _pk->first.push_back(std::move(g1));
+    PairingBackend::Type backend = PairingBackend::getDefault();
+    if(!headerRead) {
+        std::cerr << "Loading public key failed: " << fName << " has no header." << std::endl;
+        return false;
     }
-    for(size_t i = 0; i < pkSize; i++) {
-        std::unique_ptr<G> g2 = std::make_unique<G2DCLXVI>();
-        g2->readFromFile(in);
-        _pk->second.push_back(std::move(g2));
+    if(tag != static_cast<size_t>(backend)) {
+        std::cerr << "Loading public key failed: " << fName << " does not hold "
+                  << PairingBackend::getName(backend) << " elements." << std::endl;
+        return false;
     }
-
-    in.close();
+    PublicKey pk;
+    if(!PairingBackend::readAll(in, pkSize, PairingBackend::newG1, backend, pk.first)
+       || !PairingBackend::readAll(in, g2Size, PairingBackend::newG2, backend, pk.second)) {
+        std::cerr << "Loading public key failed: " << fName
+                  << " is shorter than its header says or holds an invalid element." << std::endl;
+        return false;
+    }
+    *_pk = std::move(pk);
 
     std::cout << "Loading public key done."
-              << " Size = " << pkSize << " element(s)." << std::endl;
+              << " Size = " << pkSize << " G1 and " << g2Size << " G2 element(s)." << std::endl;
+    return true;
 }
 
 void BilinearMapKey::writePkToFile(const char* fName) const {
-    std::ofstream out(fName, std::ios::out | std::ios::binary);
-
-    size_t pkSize = _pk->first.size();
-    out.write((char*)&pkSize, sizeof(pkSize));
-
-    for(size_t i = 0; i < _pk->first.size(); i++) {
-        _pk->first.at(i)->writeToFile(out);
-    }
-    for(size_t i = 0; i < _pk->second.size(); i++) {
-        _pk->second.at(i)->writeToFile(out);
-    }
-
-    out.close();
+    BufferedWriter out(fName);
+
+    //Every new file records its backend, so it can't be loaded as the other one's
+    size_t tag = _pk->first.empty() ? PairingBackend::getDefault() : PairingBackend::typeOf(*_pk->first.front());
+    size_t pkSize = _pk->first.size(), g2Size = _pk->second.size();
+    out.write(&WITH_BACKEND, sizeof(WITH_BACKEND));
+    out.write(&tag, sizeof(tag));
+    out.write(&pkSize, sizeof(pkSize));
+    out.write(&g2Size, sizeof(g2Size));
+
+    PairingBackend::writeAll(out, _pk->first);
+    PairingBackend::writeAll(out, _pk->second);
 }
@@ -13,9 +13,10 @@
 #include <algorithms/OraclePrimeRep.hpp>
 
 #include <utils/LibConversions.hpp>
+#include <utils/Metrics.hpp>
+#include <utils/SHA256.hpp>
 #include <utils/testutils.hpp>
 
-#include <cryptopp/sha.h>
 
 using std::cout;
 using std::dec;
@@ -43,18 +44,17 @@ uint_fast64_t first64Bits(const flint::BigInt& flintNum) {
     return first64bits;
 }
 
-void OraclePrimeRep::genRepresentative(const flint::BigInt& element, flint::BigInt& representative) {
+void OraclePrimeRep::saltElement(const flint::BigInt& element, std::vector<unsigned char>& bytes) {
     typedef std::linear_congruential_engine<uint_fast64_t, 48271, 0, 2147483647> minst_rand_64;
     //Awkwardly convert the bit length of the element into a byte length, rounding up
     size_t byteLength = element.bitLength() / 8;
     if(element.bitLength() % 8 != 0)
         byteLength++;
     // cout << "Getting representative for " << element << endl;
-    unsigned char bytesToHash[byteLength + SALT_BYTES];
-    //Initializing this array is very important because the element and salt may not exactly fill it
-    memset(bytesToHash, 0, byteLength + SALT_BYTES);
+    //Zeroing this is very important because the element and salt may not exactly fill it
+    bytes.assign(byteLength + SALT_BYTES, 0);
     //Convert the element to bytes at the beginning of the byte array
-    LibConversions::bigIntToBytes(element, bytesToHash);
+    LibConversions::bigIntToBytes(element, bytes.data());
     //Generate 16 random bits using the element as a seed
     uint_fast64_t elementTruncated = first64Bits(element);
     minst_rand_64 randEngine(elementTruncated);
@@ -62,21 +62,81 @@ void OraclePrimeRep::genRepresentative(const flint::BigInt& element, flint::BigI
     uint16_t salt = rand16bits();
     // cout << "  Generated random salt: " << salt << endl;
     //Append them to the byte array
-    std::copy(reinterpret_cast<const char*>(&salt), reinterpret_cast<const char*>(&salt) + sizeof(salt), &bytesToHash[byteLength]);
+    std::copy(reinterpret_cast<const char*>(&salt), reinterpret_cast<const char*>(&salt) + sizeof(salt), &bytes[byteLength]);
+}
+
+void OraclePrimeRep::padHash(const unsigned char* digest, flint::BigInt& paddedHash) {
+    // cout << "  Result of hash: ";
+    // testutils::print_hex(digest, SHA256::DIGEST_LENGTH);
+    LibConversions::bytesToBigInt(digest, SHA256::DIGEST_LENGTH, paddedHash);
+    //Add some zeroes in the lower-order bits
+    // cout << "Bitshifting hash " << hex << paddedHash << endl;
+    paddedHash <<= PADDING_LENGTH;
+}
+
+void OraclePrimeRep::hashElement(const flint::BigInt& element, flint::BigInt& paddedHash) {
+    std::vector<unsigned char> bytesToHash;
+    saltElement(element, bytesToHash);
     //Hash the element+salt
     // cout << "  Hashing bytes: ";
-    // testutils::print_hex(bytesToHash, byteLength+SALT_BYTES);
-    unsigned char hashedBytes[CryptoPP::SHA256::DIGESTSIZE];
-    CryptoPP::SHA256().CalculateDigest(hashedBytes, bytesToHash, byteLength + SALT_BYTES);
-    // cout << "  Result of hash: ";
-    // testutils::print_hex(hashedBytes, CryptoPP::SHA256::DIGESTSIZE);
-    flint::BigInt hashedElement;
-    LibConversions::bytesToBigInt(hashedBytes, CryptoPP::SHA256::DIGESTSIZE, hashedElement);
-    //Add some zeroes in the lower-order bits, then find the next prime
-    // cout << "Bitshifting hash " << hex << hashedElement << endl;
-    hashedElement <<= PADDING_LENGTH;
-    // cout << "  Bitshifted hash: " << hex << hashedElement << dec << endl;
+    // testutils::print_hex(bytesToHash.data(), bytesToHash.size());
+    unsigned char hashedBytes[SHA256::DIGEST_LENGTH];
+    SHA256::computeDigest(bytesToHash.data(), bytesToHash.size(), hashedBytes);
+    padHash(hashedBytes, paddedHash);
+}
+
+void OraclePrimeRep::findRepresentative(const flint::BigInt& paddedHash, flint::BigInt& representative,
+                                        uint32_t& hint) {
+    //Find the next prime after the padded hash
+    // cout << "  Bitshifted hash: " << hex << paddedHash << dec << endl;
     // cout << "Finding next prime..." << endl;
-    representative = hashedElement.nextPrime();
+    representative = paddedHash.nextPrime();
     // cout << "  Next probable prime: " << representative << endl;
+    METRICS_COUNT(PRIME_REP_GENERATED);
+    unsigned long distance = fmpz_get_ui((representative - paddedHash).getUnderlyingObject());
+    //nextPrime tests every odd number from paddedHash+1 up to the representative
+    METRICS_ADD(PRIME_REP_CANDIDATES, (distance >> 1) + 1);
+    //Prime gaps this long are vanishingly rare at this size, but a hint can't describe one
+    hint = distance < (1UL << PADDING_LENGTH) ? distance : NO_HINT;
+}
+
+void OraclePrimeRep::genRepresentative(const flint::BigInt& element, flint::BigInt& representative) {
+    uint32_t hint;
+    genRepresentativeWithHint(element, representative, hint);
+}
+
+void OraclePrimeRep::genRepresentativeWithHint(const flint::BigInt& element, flint::BigInt& representative,
+                                               uint32_t& hint) {
+    flint::BigInt hashedElement;
+    hashElement(element, hashedElement);
+    findRepresentative(hashedElement, representative, hint);
+}
+
+void OraclePrimeRep::genRepresentatives(const flint::BigInt* elements, flint::BigInt* representatives,
+                                        uint32_t* hints, size_t count) {
+    std::vector<std::vector<unsigned char>> bytesToHash(count);
+    std::vector<const unsigned char*> inputs(count);
+    std::vector<size_t> lengths(count);
+    for(size_t i = 0; i < count; i++) {
+        saltElement(elements[i], bytesToHash[i]);
+        inputs[i] = bytesToHash[i].data();
+        lengths[i] = bytesToHash[i].size();
+    }
+    std::vector<unsigned char> hashedBytes(count * SHA256::DIGEST_LENGTH);
+    SHA256::computeDigests(inputs.data(), lengths.data(), count, hashedBytes.data());
+    flint::BigInt hashedElement;
+    for(size_t i = 0; i < count; i++) {
+        padHash(&hashedBytes[i * SHA256::DIGEST_LENGTH], hashedElement);
+        findRepresentative(hashedElement, representatives[i], hints[i]);
+    }
+}
+
+bool OraclePrimeRep::representativeFromHint(const flint::BigInt& element, uint32_t hint,
+                                            flint::BigInt& representative) {
+    if(hint >= (1UL << PADDING_LENGTH))
+        return false;
+    hashElement(element, representative);
+    representative += flint::BigInt((long)hint);
+    METRICS_COUNT(PRIME_REP_HINTS);
+    return fmpz_is_probabprime(representative.getUnderlyingObject());
 }
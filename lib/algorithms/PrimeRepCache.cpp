@@ -0,0 +1,374 @@
+/*
+ * PrimeRepCache.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <flint/fmpz.h>
+
+#include <algorithms/PrimeRepCache.hpp>
+
+#include <utils/BinaryIO.hpp>
+#include <utils/Metrics.hpp>
+
+namespace {
+
+const char MAGIC[4] = {'P', 'R', 'E', 'P'};
+
+//A slot's state: empty, claimed by a writer that is still filling it in, or holding an entry
+enum SlotState : uint32_t { EMPTY, WRITING, READY };
+
+//Little-endian fields of the file, whatever the host's byte order
+void store(unsigned char* out, uint64_t value, size_t bytes) {
+    for(size_t i = 0; i < bytes; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+uint64_t load(const unsigned char* in, size_t bytes) {
+    uint64_t value = 0;
+    for(size_t i = 0; i < bytes; i++) {
+        value |= uint64_t(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+//The key is the hash of the element's sign and big-endian magnitude
+void elementBytes(const flint::BigInt& element, std::vector<unsigned char>& bytes) {
+    size_t length = (element.bitLength() + 7) / 8;
+    bytes.assign(length + 1, 0);
+    bytes[0] = fmpz_sgn(element.getUnderlyingObject()) < 0;
+    if(length > 0) {
+        mpz_t mpzValue;
+        mpz_init(mpzValue);
+        fmpz_get_mpz(mpzValue, element.getUnderlyingObject());
+        mpz_export(bytes.data() + 1, NULL, 1, 1, 1, 0, mpzValue);
+        mpz_clear(mpzValue);
+    }
+}
+
+void hashElement(const flint::BigInt& element, unsigned char* key) {
+    std::vector<unsigned char> bytes;
+    elementBytes(element, bytes);
+    SHA256::computeDigest(bytes.data(), bytes.size(), key);
+}
+
+//The hash is uniformly distributed, so its first bytes make a good table index
+size_t indexOf(const unsigned char* key, size_t mask) {
+    return load(key, 8) & mask;
+}
+
+//Writes a positive value big-endian into its (bitLength + 7) / 8 bytes
+void encodeRepresentative(unsigned char* out, const flint::BigInt& value) {
+    mpz_t mpzValue;
+    mpz_init(mpzValue);
+    fmpz_get_mpz(mpzValue, value.getUnderlyingObject());
+    mpz_export(out, NULL, 1, 1, 1, 0, mpzValue);
+    mpz_clear(mpzValue);
+}
+
+void decodeRepresentative(const unsigned char* in, size_t length, flint::BigInt& value) {
+    mpz_t mpzValue;
+    mpz_init(mpzValue);
+    mpz_import(mpzValue, length, 1, 1, 1, 0, in);
+    fmpz_t result;
+    fmpz_init(result);
+    fmpz_set_mpz(result, mpzValue);
+    mpz_clear(mpzValue);
+    value = flint::BigInt(std::move(result));
+}
+
+size_t powerOfTwoAtLeast(size_t size) {
+    size_t power = 16;
+    while(power < size)
+        power <<= 1;
+    return power;
+}
+
+}  // namespace
+
+struct PrimeRepCache::Slot {
+    std::atomic<uint32_t> state;
+    uint32_t hint;
+    uint32_t length;
+    unsigned char key[KEY_BYTES];
+    unsigned char representative[MAX_REPRESENTATIVE_BYTES];
+
+    Slot() : state(EMPTY), hint(NO_HINT), length(0) {}
+};
+
+struct PrimeRepCache::MappedFile {
+    const unsigned char* data;
+    size_t size;
+    size_t mask;
+
+    MappedFile(const unsigned char* data, size_t size, size_t mask) : data(data), size(size), mask(mask) {}
+    ~MappedFile() { munmap(const_cast<unsigned char*>(data), size); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+PrimeRepCache::PrimeRepCache(std::unique_ptr<PrimeRepGenerator> generator, size_t capacity)
+        : generator(std::move(generator)), count(0), mapped(NULL) {
+    size_t slotCount = powerOfTwoAtLeast(capacity);
+    slots.reset(new Slot[slotCount]);
+    mask = slotCount - 1;
+}
+
+PrimeRepCache::~PrimeRepCache() {
+    delete mapped.load();
+}
+
+PrimeRepCache& PrimeRepCache::attach(RSAKey::PublicKey& publicKey, size_t capacity) {
+    PrimeRepCache* cache = dynamic_cast<PrimeRepCache*>(publicKey.primeRepGenerator.get());
+    if(cache)
+        return *cache;
+    cache = new PrimeRepCache(std::move(publicKey.primeRepGenerator), capacity);
+    publicKey.primeRepGenerator.reset(cache);
+    return *cache;
+}
+
+void PrimeRepCache::genRepresentative(const flint::BigInt& element, flint::BigInt& representative) {
+    uint32_t hint;
+    genRepresentativeWithHint(element, representative, hint);
+}
+
+void PrimeRepCache::genRepresentativeWithHint(const flint::BigInt& element, flint::BigInt& representative,
+                                              uint32_t& hint) {
+    unsigned char key[KEY_BYTES];
+    hashElement(element, key);
+    if(lookupMemory(key, representative, &hint) || lookupFile(element, key, representative, &hint)) {
+        METRICS_COUNT(PRIME_REP_CACHE_HITS);
+        return;
+    }
+    generator->genRepresentativeWithHint(element, representative, hint);
+    insert(key, representative, hint);
+}
+
+void PrimeRepCache::genRepresentatives(const flint::BigInt* elements, flint::BigInt* representatives,
+                                       uint32_t* hints, size_t count) {
+    std::vector<std::vector<unsigned char>> bytes(count);
+    std::vector<const unsigned char*> inputs(count);
+    std::vector<size_t> lengths(count);
+    for(size_t i = 0; i < count; i++) {
+        elementBytes(elements[i], bytes[i]);
+        inputs[i] = bytes[i].data();
+        lengths[i] = bytes[i].size();
+    }
+    std::vector<unsigned char> keys(count * KEY_BYTES);
+    SHA256::computeDigests(inputs.data(), lengths.data(), count, keys.data());
+    //The misses go to the wrapped generator together, so that it can batch them too
+    std::vector<size_t> misses;
+    for(size_t i = 0; i < count; i++) {
+        const unsigned char* key = &keys[i * KEY_BYTES];
+        if(lookupMemory(key, representatives[i], &hints[i])
+           || lookupFile(elements[i], key, representatives[i], &hints[i]))
+            METRICS_COUNT(PRIME_REP_CACHE_HITS);
+        else
+            misses.push_back(i);
+    }
+    if(misses.empty())
+        return;
+    std::vector<flint::BigInt> missedElements, missedRepresentatives(misses.size());
+    std::vector<uint32_t> missedHints(misses.size());
+    for(size_t i : misses) {
+        missedElements.push_back(elements[i]);
+    }
+    generator->genRepresentatives(missedElements.data(), missedRepresentatives.data(), missedHints.data(),
+                                  misses.size());
+    for(size_t m = 0; m < misses.size(); m++) {
+        representatives[misses[m]] = missedRepresentatives[m];
+        hints[misses[m]] = missedHints[m];
+        insert(&keys[misses[m] * KEY_BYTES], missedRepresentatives[m], missedHints[m]);
+    }
+}
+
+bool PrimeRepCache::representativeFromHint(const flint::BigInt& element, uint32_t hint,
+                                           flint::BigInt& representative) {
+    if(lookup(element, representative)) {
+        METRICS_COUNT(PRIME_REP_CACHE_HITS);
+        return true;
+    }
+    return generator->representativeFromHint(element, hint, representative);
+}
+
+bool PrimeRepCache::lookup(const flint::BigInt& element, flint::BigInt& representative, uint32_t* hint) const {
+    unsigned char key[KEY_BYTES];
+    hashElement(element, key);
+    return lookupMemory(key, representative, hint) || lookupFile(element, key, representative, hint);
+}
+
+size_t PrimeRepCache::size() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+void PrimeRepCache::insert(const unsigned char* key, const flint::BigInt& representative, uint32_t hint) const {
+    size_t length = (representative.bitLength() + 7) / 8;
+    if(length > MAX_REPRESENTATIVE_BYTES || fmpz_sgn(representative.getUnderlyingObject()) <= 0)
+        return;
+    //Stop at three-quarters full, so that probes stay short and always reach an empty slot
+    if(count.load(std::memory_order_relaxed) >= (mask + 1) / 4 * 3)
+        return;
+    for(size_t index = indexOf(key, mask);; index = (index + 1) & mask) {
+        Slot& slot = slots[index];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if(state == READY && memcmp(slot.key, key, KEY_BYTES) == 0)
+            return;
+        //A slot another writer is filling in may hold this key too, which only wastes a slot
+        if(state != EMPTY || !slot.state.compare_exchange_strong(state, WRITING, std::memory_order_acquire))
+            continue;
+        memcpy(slot.key, key, KEY_BYTES);
+        slot.hint = hint;
+        slot.length = length;
+        encodeRepresentative(slot.representative, representative);
+        slot.state.store(READY, std::memory_order_release);
+        count.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+}
+
+bool PrimeRepCache::lookupMemory(const unsigned char* key, flint::BigInt& representative, uint32_t* hint) const {
+    for(size_t index = indexOf(key, mask);; index = (index + 1) & mask) {
+        const Slot& slot = slots[index];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if(state == EMPTY)
+            return false;
+        if(state != READY || memcmp(slot.key, key, KEY_BYTES) != 0)
+            continue;
+        decodeRepresentative(slot.representative, slot.length, representative);
+        if(hint)
+            *hint = slot.hint;
+        return true;
+    }
+}
+
+bool PrimeRepCache::lookupFile(const flint::BigInt& element, const unsigned char* key,
+                               flint::BigInt& representative, uint32_t* hint) const {
+    const MappedFile* file = mapped.load(std::memory_order_acquire);
+    if(!file)
+        return false;
+    const unsigned char* table = file->data + FILE_HEADER_SIZE;
+    //A valid file always has an empty slot, but don't count on it
+    for(size_t probe = 0, index = indexOf(key, file->mask); probe <= file->mask;
+        probe++, index = (index + 1) & file->mask) {
+        const unsigned char* slot = table + index * FILE_SLOT_SIZE;
+        size_t length = load(slot + KEY_BYTES + 4, 4);
+        if(length == 0)
+            return false;
+        if(memcmp(slot, key, KEY_BYTES) != 0)
+            continue;
+        //The file may have been tampered with, so the entry must be what the generator gives for its hint
+        uint32_t fileHint = load(slot + KEY_BYTES, 4);
+        flint::BigInt stored, recovered;
+        decodeRepresentative(slot + KEY_BYTES + 8, length, stored);
+        if(fileHint == NO_HINT || !generator->representativeFromHint(element, fileHint, recovered)
+           || recovered != stored)
+            return false;
+        insert(key, stored, fileHint);
+        representative = std::move(stored);
+        if(hint)
+            *hint = fileHint;
+        return true;
+    }
+    return false;
+}
+
+bool PrimeRepCache::save(const char* fileName) const {
+    //Gather the in-memory slots and the file's in the same form, the file's second so duplicates keep memory's
+    std::vector<const unsigned char*> keys;
+    std::vector<uint32_t> hints, lengths;
+    std::vector<const unsigned char*> representatives;
+    for(size_t index = 0; index <= mask; index++) {
+        const Slot& slot = slots[index];
+        if(slot.state.load(std::memory_order_acquire) != READY)
+            continue;
+        keys.push_back(slot.key);
+        hints.push_back(slot.hint);
+        lengths.push_back(slot.length);
+        representatives.push_back(slot.representative);
+    }
+    const MappedFile* mappedFile = mapped.load(std::memory_order_acquire);
+    for(size_t index = 0; mappedFile && index <= mappedFile->mask; index++) {
+        const unsigned char* slot = mappedFile->data + FILE_HEADER_SIZE + index * FILE_SLOT_SIZE;
+        uint32_t length = load(slot + KEY_BYTES + 4, 4);
+        if(length == 0)
+            continue;
+        keys.push_back(slot);
+        hints.push_back(load(slot + KEY_BYTES, 4));
+        lengths.push_back(length);
+        representatives.push_back(slot + KEY_BYTES + 8);
+    }
+
+    size_t slotCount = powerOfTwoAtLeast(2 * keys.size());
+    size_t fileMask = slotCount - 1;
+    std::vector<unsigned char> file(FILE_HEADER_SIZE + slotCount * FILE_SLOT_SIZE, 0);
+    unsigned char* table = file.data() + FILE_HEADER_SIZE;
+    uint64_t entries = 0;
+    for(size_t entry = 0; entry < keys.size(); entry++) {
+        size_t index = indexOf(keys[entry], fileMask);
+        unsigned char* slot;
+        for(;; index = (index + 1) & fileMask) {
+            slot = table + index * FILE_SLOT_SIZE;
+            if(load(slot + KEY_BYTES + 4, 4) == 0 || memcmp(slot, keys[entry], KEY_BYTES) == 0)
+                break;
+        }
+        if(load(slot + KEY_BYTES + 4, 4) != 0)
+            continue;
+        memcpy(slot, keys[entry], KEY_BYTES);
+        store(slot + KEY_BYTES, hints[entry], 4);
+        store(slot + KEY_BYTES + 4, lengths[entry], 4);
+        memcpy(slot + KEY_BYTES + 8, representatives[entry], lengths[entry]);
+        entries++;
+    }
+    memcpy(file.data(), MAGIC, sizeof(MAGIC));
+    store(file.data() + 4, FILE_VERSION, 2);
+    store(file.data() + 8, slotCount, 8);
+    store(file.data() + 16, entries, 8);
+
+    BufferedWriter out(fileName);
+    out.write(file.data(), file.size());
+    out.flush();
+    return out.good();
+}
+
+bool PrimeRepCache::open(const char* fileName) {
+    if(mapped.load(std::memory_order_acquire))
+        return false;
+    int descriptor = ::open(fileName, O_RDONLY);
+    if(descriptor < 0)
+        return false;
+    struct stat status;
+    void* address = MAP_FAILED;
+    if(fstat(descriptor, &status) == 0 && (size_t)status.st_size >= FILE_HEADER_SIZE)
+        address = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(address == MAP_FAILED)
+        return false;
+    const unsigned char* data = static_cast<const unsigned char*>(address);
+    size_t size = status.st_size;
+    uint64_t slotCount = load(data + 8, 8);
+    std::unique_ptr<MappedFile> file(new MappedFile(data, size, slotCount - 1));
+    if(memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || load(data + 4, 2) != FILE_VERSION || slotCount == 0
+       || (slotCount & (slotCount - 1)) != 0 || slotCount > (size - FILE_HEADER_SIZE) / FILE_SLOT_SIZE
+       || size != FILE_HEADER_SIZE + slotCount * FILE_SLOT_SIZE)
+        return false;
+    //A corrupt length would read past the slot
+    for(size_t index = 0; index < slotCount; index++) {
+        if(load(data + FILE_HEADER_SIZE + index * FILE_SLOT_SIZE + KEY_BYTES + 4, 4) > MAX_REPRESENTATIVE_BYTES)
+            return false;
+    }
+    //Another open may have got there first, in which case this file is unmapped again
+    const MappedFile* expected = NULL;
+    if(!mapped.compare_exchange_strong(expected, file.get(), std::memory_order_acq_rel))
+        return false;
+    file.release();
+    return true;
+}
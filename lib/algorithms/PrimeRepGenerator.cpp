@@ -5,3 +5,21 @@ PrimeRepGenerator::PrimeRepGenerator() {
 
 PrimeRepGenerator::~PrimeRepGenerator() {
 }
+
+void PrimeRepGenerator::genRepresentativeWithHint(const flint::BigInt& element, flint::BigInt& representative,
+                                                  uint32_t& hint) {
+    genRepresentative(element, representative);
+    hint = NO_HINT;
+}
+
+bool PrimeRepGenerator::representativeFromHint(const flint::BigInt& element, uint32_t hint,
+                                               flint::BigInt& representative) {
+    return false;
+}
+
+void PrimeRepGenerator::genRepresentatives(const flint::BigInt* elements, flint::BigInt* representatives,
+                                           uint32_t* hints, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        genRepresentativeWithHint(elements[i], representatives[i], hints[i]);
+    }
+}
@@ -0,0 +1,278 @@
+/*
+ * ProofBundle.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#include <flint/fmpz.h>
+
+#include <algorithms/ProofBundle.hpp>
+#include <algorithms/RSAAccumulator.hpp>
+
+#include <bilinear/Backends.hpp>
+#include <utils/Metrics.hpp>
+
+namespace ProofBundle {
+
+namespace {
+
+const char MAGIC[4] = {'A', 'C', 'C', 'P'};
+
+//Little-endian fields of the header, whatever the host's byte order
+void store(std::byte* out, uint64_t value, size_t bytes) {
+    for(size_t i = 0; i < bytes; i++) {
+        out[i] = std::byte(value >> (8 * i));
+    }
+}
+
+uint64_t load(const std::byte* in, size_t bytes) {
+    uint64_t value = 0;
+    for(size_t i = 0; i < bytes; i++) {
+        value |= uint64_t(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+size_t bytesOf(const flint::BigInt& value) {
+    return (value.bitLength() + 7) / 8;
+}
+
+//Writes a nonnegative value big-endian into size bytes; returns false if it doesn't fit
+bool encodeBigInt(std::byte* out, size_t size, const flint::BigInt& value) {
+    size_t length = bytesOf(value);
+    if(length > size)
+        return false;
+    memset(out, 0, size - length);
+    if(length > 0) {
+        mpz_t mpzValue;
+        mpz_init(mpzValue);
+        fmpz_get_mpz(mpzValue, value.getUnderlyingObject());
+        mpz_export(out + size - length, NULL, 1, 1, 1, 0, mpzValue);
+        mpz_clear(mpzValue);
+    }
+    return true;
+}
+
+flint::BigInt decodeBigInt(const std::byte* in, size_t size) {
+    mpz_t mpzValue;
+    mpz_init(mpzValue);
+    mpz_import(mpzValue, size, 1, 1, 1, 0, in);
+    fmpz_t value;
+    fmpz_init(value);
+    fmpz_set_mpz(value, mpzValue);
+    mpz_clear(mpzValue);
+    return flint::BigInt(std::move(value));
+}
+
+using BilinearMapAccumulator::AccumulatorInG1;
+using BilinearMapAccumulator::AccumulatorInG2;
+
+bool sameSizes(const Layout& layout, const Layout& expected) {
+    return layout.accumulatorSize == expected.accumulatorSize && layout.elementSize == expected.elementSize
+           && layout.witnessSize == expected.witnessSize;
+}
+
+//Whether the sizes in a header are the ones its scheme uses
+bool validSizes(const Layout& layout) {
+    switch(layout.scheme) {
+        case BILINEAR_DCLXVI:
+            return sameSizes(layout, bilinearLayout<DCLXVIBackend>(0));
+        case BILINEAR_MONT64:
+            return sameSizes(layout, bilinearLayout<Mont64Backend>(0));
+        case BILINEAR_DCLXVI_ACCUMULATOR_IN_G2:
+            return sameSizes(layout, bilinearLayout<DCLXVIBackend, AccumulatorInG2<DCLXVIBackend>>(0));
+        case BILINEAR_MONT64_ACCUMULATOR_IN_G2:
+            return sameSizes(layout, bilinearLayout<Mont64Backend, AccumulatorInG2<Mont64Backend>>(0));
+        case RSA_ACCUMULATOR:
+            return layout.elementSize > 0 && layout.witnessSize > 0 && layout.accumulatorSize == layout.witnessSize;
+        default:
+            return false;
+    }
+}
+
+//Whether the bundle holds accumulator, which also checks it is for the accumulator's backend and group
+template <typename Backend, typename Ops>
+bool holdsAccumulator(const View& bundle, const GroupElement<Backend, Ops>& accumulator) {
+    typedef GroupElement<Backend, Ops> Accumulator;
+    typedef BilinearMapAccumulator::PlacementOf<Backend, Accumulator> Placement;
+    Accumulator embedded;
+    return bundle.getScheme() == bilinearScheme<Backend, Placement>()
+           && Accumulator::decode(&embedded, bundle.accumulator(), 1) && embedded == accumulator;
+}
+
+template <typename Placement, typename Backend>
+bool verifyRecord(const View& bundle, size_t index, const typename Placement::Accumulator& gToTheS,
+                  const GTElement<Backend>& accumulatorPairing) {
+    typedef typename Placement::Accumulator Accumulator;
+    typedef typename Placement::Witness Witness;
+    METRICS_TIME(BILINEAR_VERIFY);
+    Fr<Backend> element;
+    Witness witness;
+    if(!Fr<Backend>::decode(&element, bundle.element(index), 1) || !Witness::decode(&witness, bundle.witness(index), 1))
+        return false;
+    return Placement::pairing(Accumulator().pow(element) * gToTheS, witness) == accumulatorPairing;
+}
+
+//Whether the bundle is an RSA bundle for the key's modulus that holds accumulator
+bool holdsAccumulator(const View& bundle, const flint::BigMod& accumulator, const RSAKey::PublicKey& publicKey) {
+    const Layout& layout = bundle.getLayout();
+    if(layout.scheme != RSA_ACCUMULATOR || layout.accumulatorSize != bytesOf(publicKey.rsaModulus)
+       || accumulator.getModulus() != publicKey.rsaModulus)
+        return false;
+    return decodeBigInt(bundle.accumulator(), layout.accumulatorSize) == accumulator.getMantissa();
+}
+
+bool verifyRecord(const View& bundle, size_t index, const flint::BigMod& accumulator,
+                  const RSAKey::PublicKey& publicKey) {
+    flint::BigInt witness = decodeBigInt(bundle.witness(index), bundle.getLayout().witnessSize);
+    if(witness >= publicKey.rsaModulus)
+        return false;
+    return RSAAccumulator::verify(rsaElement(bundle, index), flint::BigMod(witness, publicKey.rsaModulus),
+                                  accumulator, publicKey);
+}
+
+}  // namespace
+
+Layout rsaLayout(const flint::BigInt& modulus, size_t elementSize, uint64_t count) {
+    return Layout{RSA_ACCUMULATOR, count, (uint32_t)bytesOf(modulus), (uint32_t)elementSize,
+                  (uint32_t)bytesOf(modulus)};
+}
+
+void encodeHeader(std::byte* out, const Layout& layout) {
+    memcpy(out, MAGIC, sizeof(MAGIC));
+    store(out + 4, VERSION, 2);
+    store(out + 6, layout.scheme, 1);
+    store(out + 7, 0, 1);
+    store(out + 8, layout.bundleSize(), 8);
+    store(out + 16, layout.count, 8);
+    store(out + 24, layout.accumulatorSize, 4);
+    store(out + 28, layout.elementSize, 4);
+    store(out + 32, layout.witnessSize, 4);
+    store(out + 36, layout.recordSize(), 4);
+}
+
+/*----------------------------------View-------------------------------------*/
+
+View::View() : _data(NULL), _layout{Scheme(0), 0, 0, 0, 0} {
+}
+
+bool View::parse(const std::byte* data, size_t size) {
+    *this = View();
+    if(size < HEADER_SIZE || memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || load(data + 4, 2) != VERSION
+       || load(data + 7, 1) != 0)
+        return false;
+    Layout layout{Scheme(load(data + 6, 1)), load(data + 16, 8), (uint32_t)load(data + 24, 4),
+                  (uint32_t)load(data + 28, 4), (uint32_t)load(data + 32, 4)};
+    if(!validSizes(layout) || load(data + 36, 4) != layout.recordSize())
+        return false;
+    //Check the count against the size first, so that computing the bundle size can't overflow
+    if(layout.recordsOffset() > size || layout.count > (size - layout.recordsOffset()) / layout.recordSize()
+       || load(data + 8, 8) != layout.bundleSize())
+        return false;
+    _data = data;
+    _layout = layout;
+    return true;
+}
+
+/*---------------------------------Writer------------------------------------*/
+
+Writer::Writer(BufferedWriter& out, const Layout& layout) : _out(out), _layout(layout), _written(0) {
+    encodeHeader(_out.reserve(HEADER_SIZE), _layout);
+}
+
+Writer::Writer(BufferedWriter& out, const flint::BigMod& accumulator, size_t elementSize, uint64_t count)
+        : Writer(out, rsaLayout(accumulator.getModulus(), elementSize, count)) {
+    encodeBigInt(reserve(align(_layout.accumulatorSize)), _layout.accumulatorSize, accumulator.getMantissa());
+}
+
+std::byte* Writer::reserve(size_t size) {
+    std::byte* space = _out.reserve(size);
+    memset(space, 0, size);
+    return space;
+}
+
+void Writer::checkScheme(Scheme scheme, size_t count) {
+    if(scheme != _layout.scheme)
+        throw std::logic_error("Adding a proof of the wrong kind to a proof bundle");
+    if(count > _layout.count - _written)
+        throw std::logic_error("Adding more proofs than the proof bundle was started with");
+    _written += count;
+}
+
+void Writer::add(const flint::BigInt& element, const flint::BigMod& witness) {
+    if(bytesOf(element) > _layout.elementSize)
+        throw std::length_error("Element is too long for the proof bundle");
+    checkScheme(RSA_ACCUMULATOR, 1);
+    std::byte* record = reserve(_layout.recordSize());
+    encodeBigInt(record, _layout.elementSize, element);
+    encodeBigInt(record + align(_layout.elementSize), _layout.witnessSize, witness.getMantissa());
+}
+
+bool Writer::finish() {
+    _out.flush();
+    return _written == _layout.count && _out.good();
+}
+
+/*------------------------------Verification---------------------------------*/
+
+template <typename Backend, typename Ops>
+bool verify(const View& bundle, size_t index, const GroupElement<Backend, Ops>& accumulator,
+            const BilinearMapAccumulator::PublicKeyValues<Backend>& publicKey) {
+    typedef BilinearMapAccumulator::PlacementOf<Backend, GroupElement<Backend, Ops>> Placement;
+    if(index >= bundle.getCount() || !holdsAccumulator(bundle, accumulator))
+        return false;
+    return verifyRecord<Placement>(bundle, index, Placement::accumulatorPowers(publicKey).at(1),
+                                   Placement::pairing(accumulator, typename Placement::Witness()));
+}
+
+template <typename Backend, typename Ops>
+bool verifyAll(const View& bundle, const GroupElement<Backend, Ops>& accumulator,
+               const BilinearMapAccumulator::PublicKeyValues<Backend>& publicKey) {
+    typedef BilinearMapAccumulator::PlacementOf<Backend, GroupElement<Backend, Ops>> Placement;
+    if(!holdsAccumulator(bundle, accumulator))
+        return false;
+    //The accumulator paired with the generator of the witnesses' group, which every proof is checked against
+    GTElement<Backend> target = Placement::pairing(accumulator, typename Placement::Witness());
+    const typename Placement::Accumulator& gToTheS = Placement::accumulatorPowers(publicKey).at(1);
+    for(size_t i = 0; i < bundle.getCount(); i++) {
+        if(!verifyRecord<Placement>(bundle, i, gToTheS, target))
+            return false;
+    }
+    return true;
+}
+
+bool verify(const View& bundle, size_t index, const flint::BigMod& accumulator, const RSAKey::PublicKey& publicKey) {
+    if(index >= bundle.getCount() || !holdsAccumulator(bundle, accumulator, publicKey))
+        return false;
+    return verifyRecord(bundle, index, accumulator, publicKey);
+}
+
+bool verifyAll(const View& bundle, const flint::BigMod& accumulator, const RSAKey::PublicKey& publicKey) {
+    if(!holdsAccumulator(bundle, accumulator, publicKey))
+        return false;
+    for(size_t i = 0; i < bundle.getCount(); i++) {
+        if(!verifyRecord(bundle, i, accumulator, publicKey))
+            return false;
+    }
+    return true;
+}
+
+flint::BigInt rsaElement(const View& bundle, size_t index) {
+    return decodeBigInt(bundle.element(index), bundle.getLayout().elementSize);
+}
+
+#define INSTANTIATE_FOR_GROUP(Backend, Ops)                                                                   \
+    template bool verify(const View&, size_t, const GroupElement<Backend, Backend::Ops>&,                     \
+                         const BilinearMapAccumulator::PublicKeyValues<Backend>&);                            \
+    template bool verifyAll(const View&, const GroupElement<Backend, Backend::Ops>&,                          \
+                            const BilinearMapAccumulator::PublicKeyValues<Backend>&);
+
+INSTANTIATE_FOR_GROUP(DCLXVIBackend, G1Ops)
+INSTANTIATE_FOR_GROUP(DCLXVIBackend, G2Ops)
+INSTANTIATE_FOR_GROUP(Mont64Backend, G1Ops)
+INSTANTIATE_FOR_GROUP(Mont64Backend, G2Ops)
+
+}  // namespace ProofBundle
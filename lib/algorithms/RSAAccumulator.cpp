@@ -4,12 +4,27 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
+#include <flint/fmpz.h>
+#include <flint/fmpz_vec.h>
+
 #include <utils/LibConversions.hpp>
+#include <utils/MemoryAccounting.hpp>
+#include <utils/MemoryPool.hpp>
+#include <utils/Metrics.hpp>
 #include <utils/Pointers.hpp>
+#include <utils/SHA256.hpp>
 #include <utils/ThreadPool.hpp>
 
 #include <algorithms/OraclePrimeRep.hpp>
@@ -17,7 +32,6 @@
 #include <algorithms/RSAAccumulator.hpp>
 
 #include <cryptopp/osrng.h>
-#include <cryptopp/rsa.h>
 
 using std::future;
 using std::vector;
@@ -26,7 +40,170 @@ namespace RSAAccumulator {
 
 /*-------------------------------Key Generation-------------------------------*/
 
+namespace {
+
+//Candidates with a factor below this are discarded by the sieve, before any primality test
+const unsigned long SIEVE_LIMIT = 1 << 13;
+//Each pass of the sieve covers this many consecutive odd candidates
+const size_t SIEVE_WINDOW = 1 << 11;
+
+//The odd primes below SIEVE_LIMIT
+const vector<unsigned long>& sievePrimes() {
+    static const vector<unsigned long> primes = []() {
+        vector<bool> composite(SIEVE_LIMIT, false);
+        vector<unsigned long> primes;
+        for(unsigned long n = 3; n < SIEVE_LIMIT; n += 2) {
+            if(composite[n])
+                continue;
+            primes.push_back(n);
+            for(unsigned long multiple = n * n; multiple < SIEVE_LIMIT; multiple += 2 * n)
+                composite[multiple] = true;
+        }
+        return primes;
+    }();
+    return primes;
+}
+
+//Sets candidate to a random odd integer of exactly bits bits whose top two bits are set, so that the product
+//of two such integers has exactly twice as many bits
+void randomCandidate(fmpz_t candidate, const unsigned int bits, CryptoPP::AutoSeededRandomPool& random) {
+    vector<ulong> limbs((bits + 63) / 64);
+    random.GenerateBlock(reinterpret_cast<unsigned char*>(limbs.data()), limbs.size() * sizeof(ulong));
+    if(bits % 64 != 0)
+        limbs.back() &= (1UL << (bits % 64)) - 1;
+    fmpz_set_ui_array(candidate, limbs.data(), limbs.size());
+    fmpz_setbit(candidate, bits - 1);
+    fmpz_setbit(candidate, bits - 2);
+    fmpz_setbit(candidate, 0);
+}
+
+//Marks the candidates start + 2k in the window that are congruent to target mod prime, given start mod prime
+void strike(std::bitset<SIEVE_WINDOW>& composite, const unsigned long residue, const unsigned long target,
+            const unsigned long prime) {
+    //start + 2k = target (mod prime) when k = (target - residue) / 2, and 1/2 = (prime + 1) / 2
+    unsigned long k = (target + prime - residue) % prime * ((prime + 1) / 2) % prime;
+    for(; k < SIEVE_WINDOW; k += prime)
+        composite[k] = true;
+}
+
+//True if 2^(n-1) = 1 mod n, which rules out almost every composite at the cost of one exponentiation
+bool fermatBase2(const fmpz_t n, fmpz_t scratch) {
+    fmpz_t two;
+    fmpz_init_set_ui(two, 2);
+    fmpz_sub_ui(scratch, n, 1);
+    fmpz_powm(scratch, two, scratch, n);
+    fmpz_clear(two);
+    return fmpz_is_one(scratch);
+}
+
+//One search for a prime, which each of the searching tasks shares; the first to find a prime ends the others
+struct PrimeSearch {
+    PrimeSearch(const unsigned int bits, const bool safe) : bits(bits), safe(safe), found(false) {}
+    const unsigned int bits;
+    //If true, the prime p must also have (p - 1) / 2 prime
+    const bool safe;
+    std::atomic<bool> found;
+    std::mutex resultMutex;
+    flint::BigInt result;
+};
+
+/**
+ * Tests random candidates for search until some task finds a prime. Each
+ * candidate window is sieved by the small primes first, and the residues of
+ * the window's start are updated incrementally as the search moves on to
+ * the next window, rather than recomputed. A search for safe primes sieves
+ * and tests q, and the prime is p = 2q + 1.
+ */
+void searchPrimes(PrimeSearch& search) {
+    CryptoPP::AutoSeededRandomPool random;
+    const vector<unsigned long>& primes = sievePrimes();
+    vector<unsigned long> residues(primes.size());
+    std::bitset<SIEVE_WINDOW> composite;
+    const unsigned int bits = search.safe ? search.bits - 1 : search.bits;
+    fmpz_t start, candidate, prime, scratch;
+    fmpz_init(start);
+    fmpz_init(candidate);
+    fmpz_init(prime);
+    fmpz_init(scratch);
+    bool restart = true;
+    while(!search.found.load(std::memory_order_relaxed)) {
+        if(restart) {
+            randomCandidate(start, bits, random);
+            for(size_t i = 0; i < primes.size(); i++)
+                residues[i] = fmpz_fdiv_ui(start, primes[i]);
+            restart = false;
+        }
+        composite.reset();
+        for(size_t i = 0; i < primes.size(); i++) {
+            strike(composite, residues[i], 0, primes[i]);
+            //2q + 1 is divisible by a prime r when q = (r - 1) / 2 mod r
+            if(search.safe)
+                strike(composite, residues[i], (primes[i] - 1) / 2, primes[i]);
+        }
+        for(size_t k = 0; k < SIEVE_WINDOW && !search.found.load(std::memory_order_relaxed); k++) {
+            if(composite[k])
+                continue;
+            fmpz_add_ui(candidate, start, 2 * k);
+            if(fmpz_bits(candidate) > bits) {
+                restart = true;
+                break;
+            }
+            if(search.safe) {
+                fmpz_mul_2exp(prime, candidate, 1);
+                fmpz_add_ui(prime, prime, 1);
+                if(!fermatBase2(candidate, scratch) || !fermatBase2(prime, scratch)
+                   || !fmpz_is_probabprime(candidate) || !fmpz_is_probabprime(prime))
+                    continue;
+            } else {
+                if(!fmpz_is_probabprime(candidate))
+                    continue;
+                fmpz_set(prime, candidate);
+            }
+            std::lock_guard<std::mutex> lock(search.resultMutex);
+            if(!search.found) {
+                search.result = flint::BigInt(prime);
+                search.found = true;
+            }
+            break;
+        }
+        if(!restart) {
+            fmpz_add_ui(start, start, 2 * SIEVE_WINDOW);
+            for(size_t i = 0; i < primes.size(); i++)
+                residues[i] = (residues[i] + 2 * SIEVE_WINDOW) % primes[i];
+        }
+    }
+    fmpz_clear(start);
+    fmpz_clear(candidate);
+    fmpz_clear(prime);
+    fmpz_clear(scratch);
+}
+
+//Runs one prime search on every thread in the pool
+flint::BigInt findPrime(const unsigned int bits, const bool safe, ThreadPool& threadPool) {
+    PrimeSearch search(bits, safe);
+    vector<future<void>> futures;
+    for(size_t task = 0; task < threadPool.size(); task++) {
+        futures.push_back(threadPool.enqueue<void>([&search]() {
+            searchPrimes(search);
+        }, "rsa.findPrime"));
+    }
+    for(auto& future : futures) {
+        future.get();
+    }
+    return std::move(search.result);
+}
+
+}  // namespace
+
 void genKey(const unsigned int elementBits, const unsigned int modulusBits, RSAKey& key) {
+    ThreadPool threadPool(1);
+    genKey(elementBits, modulusBits, key, threadPool);
+}
+
+void genKey(const unsigned int elementBits, const unsigned int modulusBits, RSAKey& key, ThreadPool& threadPool,
+            const bool safePrimes) {
+    METRICS_TIME(RSA_GEN_KEY);
+    MEMORY_SCOPE(RSA_GEN_KEY);
     unsigned int modBits;
     if(modulusBits == 0) {
         modBits = 3 * elementBits + 1;
@@ -35,13 +212,17 @@ void genKey(const unsigned int elementBits, const unsigned int modulusBits, RSAK
     } else {
         modBits = std::max(3 * elementBits + 1, modulusBits);
     }
-    //Use Crypto++ to generate an RSA modulus
-    CryptoPP::AutoSeededRandomPool random;
-    CryptoPP::RSA::PrivateKey rsaKey;
-    rsaKey.GenerateRandomWithKeySize(random, modBits);
-    LibConversions::CryptoPPToFlint(rsaKey.GetModulus(), key.getPublicKey().rsaModulus);
-    LibConversions::CryptoPPToFlint(rsaKey.GetPrime1(), key.getSecretKey().p);
-    LibConversions::CryptoPPToFlint(rsaKey.GetPrime2(), key.getSecretKey().q);
+    if(modBits < 64)
+        throw std::invalid_argument("An RSA modulus must have at least 64 bits.");
+    //p gets the extra bit of an odd-sized modulus, and both have their top two bits set, so pq has exactly modBits
+    flint::BigInt p = findPrime((modBits + 1) / 2, safePrimes, threadPool);
+    flint::BigInt q;
+    do {
+        q = findPrime(modBits / 2, safePrimes, threadPool);
+    } while(q == p);
+    key.getPublicKey().rsaModulus = p * q;
+    key.getSecretKey().p = std::move(p);
+    key.getSecretKey().q = std::move(q);
     //Apparently, this is a reasonable number to hard-code for the base
     key.getPublicKey().base = flint::BigMod(65537, key.getPublicKey().rsaModulus);
     //For now, just hard-code in which PrimeRepGenerator to instantiate...
@@ -50,24 +231,61 @@ void genKey(const unsigned int elementBits, const unsigned int modulusBits, RSAK
 
 /*-------------------------------Representatives------------------------------*/
 
-void genRepresentatives(const vector<flint::BigInt>& set, PrimeRepGenerator& repGen,
-                        vector<flint::BigInt>& reps, ThreadPool& threadPool) {
+namespace {
+
+//Elements are handed to the generator this many at a time, enough to fill the lanes of a batched hash
+const size_t REPRESENTATIVE_BATCH = 16;
+
+/**
+ * Splits the set into batches of consecutive elements and generates each
+ * batch's representatives with one call to the generator, in the thread
+ * pool. Batches are made smaller when the set is small, so there are still
+ * a few tasks per thread to balance the load.
+ */
+void generateBatches(const vector<flint::BigInt>& set, PrimeRepGenerator& repGen, vector<flint::BigInt>& reps,
+                     uint32_t* hints, ThreadPool& threadPool) {
+    if(reps.size() < set.size())
+        throw std::out_of_range("There must be a representative for every element");
+    size_t batch = std::max<size_t>(1, std::min(REPRESENTATIVE_BATCH, set.size() / (4 * threadPool.size())));
     vector<future<void>> futures;
-    for(vector<flint::BigMod>::size_type element = 0; element < set.size(); element++) {
-        //Submit repGen.genRepresentative(set[element], reps[element]) to the thread pool
-        futures.push_back(threadPool.enqueue<void>([&, element]() {
-            repGen.genRepresentative(set.at(element), reps.at(element));
-        }));
+    for(size_t first = 0; first < set.size(); first += batch) {
+        size_t count = std::min(batch, set.size() - first);
+        futures.push_back(threadPool.enqueue<void>([&, first, count]() {
+            vector<uint32_t> scratchHints(hints ? 0 : count);
+            repGen.genRepresentatives(&set[first], &reps[first], hints ? hints + first : scratchHints.data(), count);
+        }, "rsa.genRepresentative"));
     }
     for(auto& future : futures) {
         future.get();
     }
 }
 
+}  // namespace
+
+void genRepresentatives(const vector<flint::BigInt>& set, PrimeRepGenerator& repGen,
+                        vector<flint::BigInt>& reps, ThreadPool& threadPool) {
+    METRICS_TIME(RSA_GEN_REPRESENTATIVES);
+    MEMORY_SCOPE(RSA_GEN_REPRESENTATIVES);
+    MemoryPool::Scope memoryScope;
+    generateBatches(set, repGen, reps, NULL, threadPool);
+}
+
+void genRepresentatives(const vector<flint::BigInt>& set, PrimeRepGenerator& repGen, vector<flint::BigInt>& reps,
+                        vector<uint32_t>& hints, ThreadPool& threadPool) {
+    METRICS_TIME(RSA_GEN_REPRESENTATIVES);
+    MEMORY_SCOPE(RSA_GEN_REPRESENTATIVES);
+    MemoryPool::Scope memoryScope;
+    hints.resize(set.size());
+    generateBatches(set, repGen, reps, hints.data(), threadPool);
+}
+
 /*--------------------------Private key accumulation--------------------------*/
 
 void accumulateSet(const vector<flint::BigInt>& reps, const RSAKey& key, flint::BigMod& accumulator,
                    ThreadPool& threadPool) {
+    METRICS_TIME(RSA_ACCUMULATE_PRIVATE);
+    MEMORY_SCOPE(RSA_ACCUMULATE_PRIVATE);
+    MemoryPool::Scope memoryScope;
     flint::BigInt phiOfN = (key.getSecretKey().p - 1) * (key.getSecretKey().q - 1);
     //The accumulator's exponent is the product of all the representatives mod phi(N)
     flint::BigMod exponent(1, phiOfN);
@@ -113,6 +331,9 @@ flint::BigMod accumulateSetHelper(const vector<flint::BigInt>& reps, const size_
 }
 
 void accumulateSet(const vector<flint::BigInt>& reps, const RSAKey::PublicKey& publicKey, flint::BigMod& accumulator) {
+    METRICS_TIME(RSA_ACCUMULATE_PUBLIC);
+    MEMORY_SCOPE(RSA_ACCUMULATE_PUBLIC);
+    MemoryPool::Scope memoryScope;
     //Just wrap the helper, hiding the "indexToSkip" parameter
     accumulator = accumulateSetHelper(reps, reps.size(), publicKey);
 }
@@ -120,8 +341,9 @@ void accumulateSet(const vector<flint::BigInt>& reps, const RSAKey::PublicKey& p
 /*-----------------------Private key witness generation-----------------------*/
 
 //Compute products for the witness exponents left-to-right, saving each partial product
-vector<flint::BigMod> multiplyLeftProducts(const vector<flint::BigInt>& reps, const flint::BigInt& phiOfN) {
-    vector<flint::BigMod> leftProducts(reps.size() + 1, flint::BigMod(1, phiOfN));
+vector<flint::BigMod> multiplyLeftProducts(const vector<flint::BigInt>& reps,
+                                           const std::shared_ptr<const flint::ModContext>& phiContext) {
+    vector<flint::BigMod> leftProducts(reps.size() + 1, flint::BigMod(flint::BigInt(1), phiContext));
     for(vector<flint::BigMod>::size_type i = 1; i <= reps.size(); i++) {
         leftProducts.at(i) = leftProducts.at(i - 1) * reps.at(i - 1);
     }
@@ -129,8 +351,9 @@ vector<flint::BigMod> multiplyLeftProducts(const vector<flint::BigInt>& reps, co
 }
 
 //Compute products for the witness exponents right-to-left, saving each partial product
-vector<flint::BigMod> multiplyRightProducts(const vector<flint::BigInt>& reps, const flint::BigInt& phiOfN) {
-    vector<flint::BigMod> rightProducts(reps.size() + 1, flint::BigMod(1, phiOfN));
+vector<flint::BigMod> multiplyRightProducts(const vector<flint::BigInt>& reps,
+                                            const std::shared_ptr<const flint::ModContext>& phiContext) {
+    vector<flint::BigMod> rightProducts(reps.size() + 1, flint::BigMod(flint::BigInt(1), phiContext));
     for(vector<flint::BigMod>::size_type i = reps.size() - 1; i != (vector<flint::BigMod>::size_type) - 1; i--) {
         rightProducts.at(i) = rightProducts.at(i + 1) * reps.at(i);
     }
@@ -146,26 +369,32 @@ void powerWrapper(const flint::BigMod base, const flint::BigMod& leftProduct,
 
 void witnessesForSet(const vector<flint::BigInt>& reps, const RSAKey& key, vector<flint::BigMod>& witnesses,
                      ThreadPool& threadPool) {
-    flint::BigInt phiOfN = (key.getSecretKey().p - 1) * (key.getSecretKey().q - 1);
+    METRICS_TIME(RSA_WITNESSES_PRIVATE);
+    MEMORY_SCOPE(RSA_WITNESSES_PRIVATE);
+    MemoryPool::Scope memoryScope;
+    //The pool threads share these contexts instead of each looking them up for every BigMod
+    auto phiContext = flint::ModContext::forModulus((key.getSecretKey().p - 1) * (key.getSecretKey().q - 1));
+    auto modulusContext = flint::ModContext::forModulus(key.getPublicKey().rsaModulus);
     //Compute left and right products in threads.
     //The vectors will be initialized in the threads,
     //since initialization is O(n) and can be done in parallel
     future<vector<flint::BigMod>> leftFuture = threadPool.enqueue<vector<flint::BigMod>>([&]() {
-        return multiplyLeftProducts(reps, phiOfN);
-    });
+        return multiplyLeftProducts(reps, phiContext);
+    }, "rsa.leftProducts");
     future<vector<flint::BigMod>> rightFuture = threadPool.enqueue<vector<flint::BigMod>>([&]() {
-        return multiplyRightProducts(reps, phiOfN);
-    });
+        return multiplyRightProducts(reps, phiContext);
+    }, "rsa.rightProducts");
     //Wait for both threads to finish
     vector<flint::BigMod> leftProducts = leftFuture.get();
     vector<flint::BigMod> rightProducts = rightFuture.get();
+    MEMORY_TRACK(products, (leftProducts.capacity() + rightProducts.capacity()) * sizeof(flint::BigMod));
     //Generate exponent for element i's witness by multiplying left-product i with right-product i+1
     vector<future<void>> powerResults;
     for(vector<flint::BigMod>::size_type i = 0; i < reps.size(); i++) {
-        witnesses.at(i).setModulus(key.getPublicKey().rsaModulus);
+        witnesses.at(i).setContext(modulusContext);
         powerResults.push_back(threadPool.enqueue<void>([&, i]() {
             powerWrapper(key.getPublicKey().base, leftProducts.at(i), rightProducts.at(i + 1), witnesses.at(i));
-        }));
+        }, "rsa.witnessPower"));
     }
     for(auto& future : powerResults) {
         future.get();
@@ -176,13 +405,16 @@ void witnessesForSet(const vector<flint::BigInt>& reps, const RSAKey& key, vecto
 
 void witnessesForSet(const std::vector<flint::BigInt>& reps, const RSAKey::PublicKey& publicKey,
                      vector<flint::BigMod>& witnesses, ThreadPool& threadPool) {
+    METRICS_TIME(RSA_WITNESSES_PUBLIC);
+    MEMORY_SCOPE(RSA_WITNESSES_PUBLIC);
+    MemoryPool::Scope memoryScope;
     vector<std::future<flint::BigMod>> futures;
     //Submit a task for each witness
     for(size_t witnessIndex = 0; witnessIndex < reps.size(); witnessIndex++) {
         futures.push_back(threadPool.enqueue<flint::BigMod>(
                 [&reps, &publicKey, witnessIndex]() {
                     return accumulateSetHelper(reps, witnessIndex, publicKey);
-                }));
+                }, "rsa.witnessPublic"));
     }
     //Wait for them all to finish
     for(size_t witnessIndex = 0; witnessIndex < reps.size(); witnessIndex++) {
@@ -192,7 +424,28 @@ void witnessesForSet(const std::vector<flint::BigInt>& reps, const RSAKey::Publi
 
 /*--------------------------------Verification--------------------------------*/
 
+namespace {
+
+/**
+ * Whether value is the accumulator or its negation. A witness w with
+ * w^x = -A gives the valid witness -w, since x is odd, so accepting it
+ * proves nothing more; and accepting both is what lets verifyBatch agree
+ * with verify, since its randomizers can't tell the two apart.
+ */
+bool matchesUpToSign(const flint::BigMod& value, const flint::BigMod& accumulator) {
+    return value == accumulator || value == flint::BigInt(0) - accumulator;
+}
+
+}  // namespace
+
 bool verify(const flint::BigInt& element, const flint::BigMod& witness, const flint::BigMod& accumulator, const RSAKey::PublicKey& pubKey) {
+    return verify(element, PrimeRepGenerator::NO_HINT, witness, accumulator, pubKey);
+}
+
+bool verify(const flint::BigInt& element, uint32_t hint, const flint::BigMod& witness,
+            const flint::BigMod& accumulator, const RSAKey::PublicKey& pubKey) {
+    METRICS_TIME(RSA_VERIFY);
+    MEMORY_SCOPE(RSA_VERIFY);
     if(witness.getModulus() != pubKey.rsaModulus || accumulator.getModulus() != pubKey.rsaModulus) {
         std::cout << "Verification failed due to modulus mismatch. Witness modulus was ";
         std::cout << witness.getModulus() << std::endl;
@@ -201,14 +454,570 @@ bool verify(const flint::BigInt& element, const flint::BigMod& witness, const fl
         return false;
     }
     flint::BigInt elementRep;
-    pubKey.primeRepGenerator->genRepresentative(element, elementRep);
-    flint::BigMod accCandidate(pubKey.rsaModulus);
-    flint::power(witness, elementRep, accCandidate);
-    bool valid = accCandidate == accumulator;
+    if(hint == PrimeRepGenerator::NO_HINT || !pubKey.primeRepGenerator->representativeFromHint(element, hint, elementRep))
+        pubKey.primeRepGenerator->genRepresentative(element, elementRep);
+    flint::BigMod accCandidate = witness ^ elementRep;
+    bool valid = matchesUpToSign(accCandidate, accumulator);
     if(!valid) {
         std::cout << "Verification failed! Representative for element " << element << " was " << elementRep << std::endl;
     }
     return valid;
 }
 
+/*-----------------------Randomized batch verification------------------------*/
+
+namespace {
+
+//Bits of each exponent consumed by one multiplication in the sliding-window multi-exponentiation
+const size_t WINDOW_BITS = 4;
+//Pairs per multi-exponentiation task, which bounds the memory for window tables
+const size_t MULTI_EXPONENTIATION_CHUNK = 128;
+
+/**
+ * The product of bases[i]^exponents[i], with interleaved sliding windows:
+ * every exponent is cut into odd windows of up to WINDOW_BITS bits, and the
+ * windows of all the exponents are multiplied into one accumulator that is
+ * squared once per bit of the longest exponent.
+ */
+flint::BigMod multiExponentiate(const flint::BigMod* bases, const flint::BigInt* exponents, size_t count) {
+    const size_t TABLE_SIZE = size_t(1) << (WINDOW_BITS - 1);
+    //The bases share a context, whose precomputed inverse of the modulus reduces every product
+    const flint::ModContext& context = *bases[0].getContext();
+    //Entry i * TABLE_SIZE + j of the table is bases[i]^(2j + 1)
+    fmpz* table = _fmpz_vec_init(count * TABLE_SIZE);
+    fmpz_t square;
+    fmpz_init(square);
+    //windows[bit] lists the table entries multiplied in after squaring down to that bit
+    vector<vector<size_t>> windows;
+    for(size_t i = 0; i < count; i++) {
+        fmpz* powers = table + i * TABLE_SIZE;
+        fmpz_set(powers, bases[i].getMantissa().getUnderlyingObject());
+        context.multiply(square, powers, powers);
+        for(size_t j = 1; j < TABLE_SIZE; j++) {
+            context.multiply(powers + j, powers + j - 1, square);
+        }
+        const fmpz* exponent = exponents[i].getUnderlyingObject();
+        long bit = (long)exponents[i].bitLength() - 1;
+        if(windows.size() < (size_t)(bit + 1))
+            windows.resize(bit + 1);
+        while(bit >= 0) {
+            if(!fmpz_tstbit(exponent, bit)) {
+                bit--;
+                continue;
+            }
+            long low = std::max(bit - (long)WINDOW_BITS + 1, 0L);
+            while(!fmpz_tstbit(exponent, low)) {
+                low++;
+            }
+            size_t digit = 0;
+            for(long b = bit; b >= low; b--) {
+                digit = (digit << 1) | fmpz_tstbit(exponent, b);
+            }
+            windows[low].push_back(i * TABLE_SIZE + (digit >> 1));
+            bit = low - 1;
+        }
+    }
+    fmpz_t result;
+    fmpz_init_set_ui(result, 1);
+    for(size_t bit = windows.size(); bit-- > 0;) {
+        context.multiply(result, result, result);
+        for(size_t entry : windows[bit]) {
+            context.multiply(result, result, table + entry);
+        }
+    }
+    flint::BigMod product(flint::BigInt(result), bases[0].getContext());
+    fmpz_clear(result);
+    fmpz_clear(square);
+    _fmpz_vec_clear(table, count * TABLE_SIZE);
+    return product;
+}
+
+//The witnesses of a randomized batch whose moduli are right, with their exponents r_i * x_i
+struct RandomizedBatch {
+    vector<size_t> indices;
+    vector<flint::BigMod> witnesses;
+    vector<flint::BigInt> reps;
+    vector<flint::BigInt> randomizers;
+    vector<flint::BigInt> exponents;
+};
+
+/**
+ * Whether entries [begin, end) of the batch pass: exactly for one entry, and
+ * with the small-exponents test otherwise. Both sides of the test are
+ * squared, which removes the factors of -1 that would otherwise cancel in
+ * pairs, so the test accepts what verify accepts.
+ */
+bool batchHolds(const RandomizedBatch& batch, size_t begin, size_t end, const flint::BigMod& accumulator,
+                ThreadPool& threadPool) {
+    if(end - begin == 1)
+        return matchesUpToSign(batch.witnesses.at(begin) ^ batch.reps.at(begin), accumulator);
+    vector<future<flint::BigMod>> futures;
+    for(size_t chunk = begin; chunk < end; chunk += MULTI_EXPONENTIATION_CHUNK) {
+        size_t count = std::min(MULTI_EXPONENTIATION_CHUNK, end - chunk);
+        futures.push_back(threadPool.enqueue<flint::BigMod>([&batch, chunk, count]() {
+            return multiExponentiate(&batch.witnesses.at(chunk), &batch.exponents.at(chunk), count);
+        }, "rsa.multiExponentiate"));
+    }
+    flint::BigInt randomizerSum(0);
+    for(size_t i = begin; i < end; i++) {
+        randomizerSum += batch.randomizers.at(i);
+    }
+    flint::BigMod expected = accumulator ^ randomizerSum;
+    flint::BigMod product(flint::BigInt(1), accumulator.getContext());
+    for(auto& future : futures) {
+        product *= future.get();
+    }
+    return product * product == expected * expected;
+}
+
+//Adds the indices of the failing entries in [begin, end) to failures, given that the range as a whole failed
+void bisect(const RandomizedBatch& batch, size_t begin, size_t end, const flint::BigMod& accumulator,
+            ThreadPool& threadPool, vector<size_t>& failures) {
+    if(end - begin == 1) {
+        failures.push_back(batch.indices.at(begin));
+        return;
+    }
+    size_t middle = begin + (end - begin) / 2;
+    if(!batchHolds(batch, begin, middle, accumulator, threadPool))
+        bisect(batch, begin, middle, accumulator, threadPool, failures);
+    if(!batchHolds(batch, middle, end, accumulator, threadPool))
+        bisect(batch, middle, end, accumulator, threadPool, failures);
+}
+
+}  // namespace
+
+bool verifyBatch(const vector<flint::BigInt>& elements, const vector<flint::BigMod>& witnesses,
+                 const flint::BigMod& accumulator, const RSAKey::PublicKey& pubKey, ThreadPool& threadPool,
+                 vector<size_t>* failures) {
+    METRICS_TIME(RSA_VERIFY_RANDOMIZED);
+    MEMORY_SCOPE(RSA_VERIFY_RANDOMIZED);
+    MemoryPool::Scope memoryScope;
+    if(elements.size() != witnesses.size())
+        throw std::invalid_argument("Batch verification needs one witness for each element");
+    if(failures)
+        failures->clear();
+    if(accumulator.getModulus() != pubKey.rsaModulus) {
+        for(size_t i = 0; failures && i < elements.size(); i++) {
+            failures->push_back(i);
+        }
+        return elements.empty();
+    }
+    //Witnesses in another modulus fail without taking part in the test
+    RandomizedBatch batch;
+    vector<size_t> wrongModulus;
+    vector<flint::BigInt> batchElements;
+    for(size_t i = 0; i < elements.size(); i++) {
+        if(witnesses.at(i).getModulus() != pubKey.rsaModulus) {
+            wrongModulus.push_back(i);
+            continue;
+        }
+        batch.indices.push_back(i);
+        batch.witnesses.push_back(witnesses.at(i));
+        batchElements.push_back(elements.at(i));
+    }
+    size_t count = batch.indices.size();
+    batch.reps.resize(count);
+    genRepresentatives(batchElements, *pubKey.primeRepGenerator, batch.reps, threadPool);
+    //The randomizers must be unpredictable to whoever made the witnesses, so they come from the OS
+    std::random_device random;
+    for(size_t i = 0; i < count; i++) {
+        flint::BigInt randomizer = (flint::BigInt((long)random()) << 32) + flint::BigInt((long)random());
+        randomizer += flint::BigInt(1);
+        batch.exponents.push_back(randomizer * batch.reps.at(i));
+        batch.randomizers.push_back(std::move(randomizer));
+    }
+
+    bool valid = wrongModulus.empty();
+    vector<size_t> batchFailures;
+    if(count > 0 && !batchHolds(batch, 0, count, accumulator, threadPool)) {
+        valid = false;
+        if(failures)
+            bisect(batch, 0, count, accumulator, threadPool, batchFailures);
+    }
+    if(failures) {
+        std::merge(wrongModulus.begin(), wrongModulus.end(), batchFailures.begin(), batchFailures.end(),
+                   std::back_inserter(*failures));
+    }
+    return valid;
+}
+
+/*---------------------------Batch membership proofs--------------------------*/
+
+namespace {
+
+//Bits in the prime that challenges a proof of exponentiation
+const unsigned long CHALLENGE_BITS = 128;
+
+//A witness together with the product of the representatives it is a witness for
+struct Aggregate {
+    flint::BigMod witness;
+    flint::BigInt product;
+};
+
+//Sets inverse to 1/value in value's modulus; returns false if there is no inverse
+bool invert(const flint::BigMod& value, flint::BigMod& inverse) {
+    flint::BigInt mantissa = value.getMantissa(), modulus = value.getModulus();
+    fmpz_t result;
+    fmpz_init(result);
+    bool invertible = fmpz_invmod(result, mantissa.getUnderlyingObject(), modulus.getUnderlyingObject());
+    inverse = flint::BigMod(flint::BigInt(std::move(result)), value.getContext());
+    return invertible;
+}
+
+//base^exponent for an exponent of either sign
+flint::BigMod signedPower(const flint::BigMod& base, const flint::BigInt& exponent) {
+    flint::BigMod result(flint::BigInt(), base.getContext());
+    if(exponent >= 0) {
+        flint::power(base, exponent, result);
+        return result;
+    }
+    flint::BigMod inverse;
+    if(!invert(base, inverse))
+        throw std::invalid_argument("Witness is not invertible modulo the RSA modulus");
+    flint::power(inverse, flint::BigInt(0) - exponent, result);
+    return result;
+}
+
+//Shamir's trick: one witness for the union of two sets of elements with coprime products
+Aggregate combine(const Aggregate& left, const Aggregate& right) {
+    fmpz_t gcd, leftCoefficient, rightCoefficient;
+    fmpz_init(gcd);
+    fmpz_init(leftCoefficient);
+    fmpz_init(rightCoefficient);
+    fmpz_xgcd(gcd, leftCoefficient, rightCoefficient, left.product.getUnderlyingObject(),
+              right.product.getUnderlyingObject());
+    bool coprime = fmpz_is_one(gcd);
+    fmpz_clear(gcd);
+    flint::BigInt a(std::move(leftCoefficient)), b(std::move(rightCoefficient));
+    if(!coprime)
+        throw std::invalid_argument("Aggregated witnesses must be for distinct prime representatives");
+    //a*x1 + b*x2 = 1, so (w1^b * w2^a)^(x1*x2) = A^(b*x2) * A^(a*x1) = A
+    return Aggregate{signedPower(left.witness, b) * signedPower(right.witness, a), left.product * right.product};
+}
+
+//Combines the witnesses pairwise, a level of the tree at a time
+Aggregate aggregate(const vector<flint::BigInt>& reps, const vector<flint::BigMod>& witnesses,
+                    ThreadPool& threadPool) {
+    if(reps.empty() || reps.size() != witnesses.size())
+        throw std::invalid_argument("Aggregating witnesses needs one witness for each representative");
+    vector<Aggregate> level;
+    level.reserve(reps.size());
+    for(size_t i = 0; i < reps.size(); i++) {
+        level.push_back(Aggregate{witnesses.at(i), reps.at(i)});
+    }
+    while(level.size() > 1) {
+        vector<future<Aggregate>> futures;
+        for(size_t i = 0; i + 1 < level.size(); i += 2) {
+            futures.push_back(threadPool.enqueue<Aggregate>([&level, i]() {
+                return combine(level.at(i), level.at(i + 1));
+            }, "rsa.aggregateWitnesses"));
+        }
+        //Wait for every task before rethrowing, since they all refer to level
+        vector<Aggregate> next;
+        std::exception_ptr error;
+        for(auto& future : futures) {
+            try {
+                next.push_back(future.get());
+            } catch(...) {
+                error = std::current_exception();
+            }
+        }
+        if(error)
+            std::rethrow_exception(error);
+        if(level.size() % 2 == 1)
+            next.push_back(std::move(level.back()));
+        level = std::move(next);
+    }
+    return std::move(level.front());
+}
+
+//Appends value to the bytes to hash, prefixed with its length so that the encoding is unambiguous
+void appendForHash(const flint::BigInt& value, vector<unsigned char>& bytes) {
+    size_t length = (value.bitLength() + 7) / 8;
+    for(int shift = 24; shift >= 0; shift -= 8) {
+        bytes.push_back((unsigned char)(length >> shift));
+    }
+    bytes.resize(bytes.size() + length);
+    if(length > 0)
+        LibConversions::bigIntToBytes(value, bytes.data() + bytes.size() - length);
+}
+
+/**
+ * The Fiat-Shamir challenge for a proof that witness^x = accumulator, where x
+ * is the product of reps: a CHALLENGE_BITS-bit prime derived from a hash of
+ * everything the proof is about
+ */
+flint::BigInt challengePrime(const flint::BigMod& witness, const flint::BigMod& accumulator,
+                             const vector<flint::BigInt>& reps) {
+    vector<unsigned char> bytes;
+    appendForHash(accumulator.getModulus(), bytes);
+    appendForHash(accumulator.getMantissa(), bytes);
+    appendForHash(witness.getMantissa(), bytes);
+    for(const flint::BigInt& rep : reps) {
+        appendForHash(rep, bytes);
+    }
+    unsigned char digest[SHA256::DIGEST_LENGTH];
+    SHA256::computeDigest(bytes.data(), bytes.size(), digest);
+    flint::BigInt candidate;
+    LibConversions::bytesToBigInt(digest, CHALLENGE_BITS / 8, candidate);
+    //Set the top bit, so that every challenge is the full length
+    candidate = (candidate >> 1) + (flint::BigInt(1) << (CHALLENGE_BITS - 1));
+    return candidate.nextPrime();
+}
+
+}  // namespace
+
+flint::BigMod aggregateWitnesses(const vector<flint::BigInt>& reps, const vector<flint::BigMod>& witnesses,
+                                 ThreadPool& threadPool) {
+    METRICS_TIME(RSA_AGGREGATE_WITNESSES);
+    MEMORY_SCOPE(RSA_AGGREGATE_WITNESSES);
+    MemoryPool::Scope memoryScope;
+    return aggregate(reps, witnesses, threadPool).witness;
+}
+
+BatchWitness proveBatch(const vector<flint::BigInt>& reps, const vector<flint::BigMod>& witnesses,
+                        const flint::BigMod& accumulator, ThreadPool& threadPool) {
+    METRICS_TIME(RSA_PROVE_BATCH);
+    MEMORY_SCOPE(RSA_PROVE_BATCH);
+    MemoryPool::Scope memoryScope;
+    Aggregate aggregated = aggregate(reps, witnesses, threadPool);
+    flint::BigInt challenge = challengePrime(aggregated.witness, accumulator, reps);
+    BatchWitness batch{aggregated.witness, flint::BigMod(flint::BigInt(), accumulator.getContext())};
+    //x = l*floor(x/l) + (x mod l), so the verifier only needs W^floor(x/l) to check W^x
+    flint::power(aggregated.witness, aggregated.product / challenge, batch.proof);
+    return batch;
+}
+
+BatchWitness proveBatch(const vector<flint::BigInt>& reps, const RSAKey& key, const flint::BigMod& accumulator,
+                        ThreadPool& threadPool) {
+    METRICS_TIME(RSA_PROVE_BATCH);
+    MEMORY_SCOPE(RSA_PROVE_BATCH);
+    MemoryPool::Scope memoryScope;
+    if(reps.empty())
+        throw std::invalid_argument("A batch proof needs at least one representative");
+    auto phiContext = flint::ModContext::forModulus((key.getSecretKey().p - 1) * (key.getSecretKey().q - 1));
+    //Every exponent only matters mod phi(N), so the product x is never formed
+    flint::BigMod product(flint::BigInt(1), phiContext), productInverse;
+    for(const flint::BigInt& rep : reps) {
+        product *= rep;
+    }
+    if(!invert(product, productInverse))
+        throw std::invalid_argument("The representatives' product is not invertible mod phi(N)");
+    BatchWitness batch{flint::BigMod(flint::BigInt(), accumulator.getContext()),
+                       flint::BigMod(flint::BigInt(), accumulator.getContext())};
+    flint::power(accumulator, productInverse.getMantissa(), batch.witness);
+
+    flint::BigInt challenge = challengePrime(batch.witness, accumulator, reps);
+    //Each challenge is used once, so its context is kept out of the shared registry
+    flint::BigMod remainder(flint::BigInt(1), std::make_shared<const flint::ModContext>(challenge)), challengeInverse;
+    for(const flint::BigInt& rep : reps) {
+        remainder *= rep;
+    }
+    if(!invert(flint::BigMod(challenge, phiContext), challengeInverse))
+        throw std::invalid_argument("The proof's challenge divides phi(N)");
+    //floor(x/l) = (x - (x mod l)) / l, and l divides x - (x mod l) exactly
+    flint::BigMod quotient = (product - remainder.getMantissa()) * challengeInverse;
+    flint::power(batch.witness, quotient.getMantissa(), batch.proof);
+    return batch;
+}
+
+bool verifyBatch(const vector<flint::BigInt>& elements, const BatchWitness& batch, const flint::BigMod& accumulator,
+                 const RSAKey::PublicKey& pubKey, ThreadPool& threadPool) {
+    METRICS_TIME(RSA_VERIFY_BATCH);
+    MEMORY_SCOPE(RSA_VERIFY_BATCH);
+    MemoryPool::Scope memoryScope;
+    if(elements.empty() || accumulator.getModulus() != pubKey.rsaModulus
+       || batch.witness.getModulus() != pubKey.rsaModulus || batch.proof.getModulus() != pubKey.rsaModulus)
+        return false;
+    vector<flint::BigInt> reps(elements.size());
+    genRepresentatives(elements, *pubKey.primeRepGenerator, reps, threadPool);
+    flint::BigInt challenge = challengePrime(batch.witness, accumulator, reps);
+    //The product of the representatives is only ever needed mod l, and l only for this proof, so its context
+    //is kept out of the shared registry
+    flint::BigMod remainder(flint::BigInt(1), std::make_shared<const flint::ModContext>(challenge));
+    for(const flint::BigInt& rep : reps) {
+        remainder *= rep;
+    }
+    return (batch.proof ^ challenge) * (batch.witness ^ remainder.getMantissa()) == accumulator;
+}
+
+/*----------------------------Dynamic accumulators----------------------------*/
+
+namespace {
+
+//The product of reps[begin, end), multiplied in a balanced tree so that the operands stay similar in size
+flint::BigInt productOf(const vector<flint::BigInt>& reps, size_t begin, size_t end) {
+    if(end - begin == 0)
+        return flint::BigInt(1);
+    if(end - begin == 1)
+        return reps.at(begin);
+    size_t middle = begin + (end - begin) / 2;
+    return productOf(reps, begin, middle) * productOf(reps, middle, end);
+}
+
+flint::BigInt productOf(const vector<flint::BigInt>& reps) {
+    return productOf(reps, 0, reps.size());
+}
+
+}  // namespace
+
+void add(const vector<flint::BigInt>& reps, const RSAKey::PublicKey& publicKey, flint::BigMod& accumulator) {
+    METRICS_TIME(RSA_ADD);
+    MEMORY_SCOPE(RSA_ADD);
+    MemoryPool::Scope memoryScope;
+    flint::BigMod result(publicKey.rsaModulus);
+    flint::power(accumulator, productOf(reps), result);
+    accumulator = result;
+}
+
+void remove(const vector<flint::BigInt>& reps, const RSAKey& key, flint::BigMod& accumulator) {
+    update(vector<flint::BigInt>(), reps, key, accumulator);
+}
+
+void update(const vector<flint::BigInt>& added, const vector<flint::BigInt>& deleted, const RSAKey& key,
+            flint::BigMod& accumulator) {
+    METRICS_TIME(RSA_UPDATE);
+    MEMORY_SCOPE(RSA_UPDATE);
+    MemoryPool::Scope memoryScope;
+    auto phiContext = flint::ModContext::forModulus((key.getSecretKey().p - 1) * (key.getSecretKey().q - 1));
+    flint::BigMod deletedProduct(productOf(deleted), phiContext), exponent;
+    if(!invert(deletedProduct, exponent))
+        throw std::invalid_argument("A deleted representative is not invertible mod phi(N)");
+    exponent *= productOf(added);
+    flint::BigMod result(flint::BigInt(), accumulator.getContext());
+    flint::power(accumulator, exponent.getMantissa(), result);
+    accumulator = result;
+}
+
+bool updateWitness(const flint::BigInt& rep, flint::BigMod& witness, const vector<flint::BigInt>& added,
+                   const vector<flint::BigInt>& deleted, const flint::BigMod& newAccumulator) {
+    METRICS_TIME(RSA_UPDATE_WITNESS);
+    MEMORY_SCOPE(RSA_UPDATE_WITNESS);
+    MemoryPool::Scope memoryScope;
+    flint::BigInt addedProduct = productOf(added);
+    if(deleted.empty()) {
+        witness ^= addedProduct;
+        return true;
+    }
+    fmpz_t gcd, repCoefficient, deletedCoefficient;
+    fmpz_init(gcd);
+    fmpz_init(repCoefficient);
+    fmpz_init(deletedCoefficient);
+    fmpz_xgcd(gcd, repCoefficient, deletedCoefficient, rep.getUnderlyingObject(),
+              productOf(deleted).getUnderlyingObject());
+    bool coprime = fmpz_is_one(gcd);
+    fmpz_clear(gcd);
+    flint::BigInt a(std::move(repCoefficient)), b(std::move(deletedCoefficient));
+    if(!coprime)
+        return false;
+    //a*x + b*Y = 1, and newAccumulator^Y = oldAccumulator^X = witness^(x*X), so
+    //(witness^(b*X) * newAccumulator^a)^x = newAccumulator^(b*Y) * newAccumulator^(a*x) = newAccumulator
+    witness = signedPower(witness, b * addedProduct) * signedPower(newAccumulator, a);
+    return true;
+}
+
+/*--------------------------Pipelined accumulation----------------------------*/
+
+namespace {
+
+//Elements are read, given representatives and multiplied together this many at a time
+const size_t PIPELINE_BATCH = 64;
+
+/**
+ * Reads batches of elements from next and hands each to the thread pool,
+ * which generates their representatives and reduces them to one number with
+ * batchProduct. Finished products are passed to merge in the order their
+ * batches were read, and only a couple of batches per thread are allowed to
+ * be in flight, so the caller merges while the pool keeps working and the
+ * elements read so far never pile up.
+ * @return the number of elements read
+ */
+size_t runPipeline(const ElementSource& next, PrimeRepGenerator& repGen, ThreadPool& threadPool,
+                   const std::function<flint::BigInt(const vector<flint::BigInt>&)>& batchProduct,
+                   const std::function<void(const flint::BigInt&)>& merge) {
+    const size_t maxInFlight = 2 * threadPool.size() + 1;
+    std::deque<future<flint::BigInt>> inFlight;
+    size_t count = 0;
+    try {
+        bool more = true;
+        while(more) {
+            vector<flint::BigInt> batch;
+            batch.reserve(PIPELINE_BATCH);
+            while(batch.size() < PIPELINE_BATCH) {
+                batch.emplace_back();
+                if(!next(batch.back())) {
+                    batch.pop_back();
+                    more = false;
+                    break;
+                }
+            }
+            if(batch.empty())
+                break;
+            count += batch.size();
+            inFlight.push_back(threadPool.enqueue<flint::BigInt>([&repGen, &batchProduct, batch = std::move(batch)]() {
+                vector<flint::BigInt> reps(batch.size());
+                vector<uint32_t> hints(batch.size());
+                repGen.genRepresentatives(batch.data(), reps.data(), hints.data(), batch.size());
+                return batchProduct(reps);
+            }, "rsa.pipelineBatch"));
+            if(inFlight.size() >= maxInFlight) {
+                merge(inFlight.front().get());
+                inFlight.pop_front();
+            }
+        }
+        while(!inFlight.empty()) {
+            merge(inFlight.front().get());
+            inFlight.pop_front();
+        }
+    } catch(...) {
+        //The tasks still refer to the caller's generator, so they must finish before the exception leaves
+        for(auto& pending : inFlight) {
+            if(pending.valid())
+                pending.wait();
+        }
+        throw;
+    }
+    return count;
+}
+
+}  // namespace
+
+size_t accumulateElements(const ElementSource& next, const RSAKey& key, flint::BigMod& accumulator,
+                          ThreadPool& threadPool) {
+    METRICS_TIME(RSA_ACCUMULATE_PIPELINED);
+    MEMORY_SCOPE(RSA_ACCUMULATE_PIPELINED);
+    MemoryPool::Scope memoryScope;
+    //The pool threads share this context instead of each looking it up for every batch
+    auto phiContext = flint::ModContext::forModulus((key.getSecretKey().p - 1) * (key.getSecretKey().q - 1));
+    flint::BigMod exponent(flint::BigInt(1), phiContext);
+    size_t count = runPipeline(next, *key.getPublicKey().primeRepGenerator, threadPool,
+            [&phiContext](const vector<flint::BigInt>& reps) {
+                return flint::BigMod(productOf(reps), phiContext).getMantissa();
+            },
+            [&exponent](const flint::BigInt& product) {
+                exponent *= product;
+            });
+    accumulator.setModulus(key.getPublicKey().rsaModulus);
+    flint::power(key.getPublicKey().base, exponent.getMantissa(), accumulator);
+    return count;
+}
+
+size_t accumulateElements(const ElementSource& next, const RSAKey::PublicKey& publicKey, flint::BigMod& accumulator,
+                          ThreadPool& threadPool) {
+    METRICS_TIME(RSA_ACCUMULATE_PIPELINED);
+    MEMORY_SCOPE(RSA_ACCUMULATE_PIPELINED);
+    MemoryPool::Scope memoryScope;
+    flint::BigMod result(publicKey.rsaModulus);
+    result = publicKey.base;
+    size_t count = runPipeline(next, *publicKey.primeRepGenerator, threadPool,
+            [](const vector<flint::BigInt>& reps) {
+                return productOf(reps);
+            },
+            [&result](const flint::BigInt& product) {
+                result ^= product;
+            });
+    accumulator = result;
+    return count;
+}
+
 }  // namespace RSAAccumulator
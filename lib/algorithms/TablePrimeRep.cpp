@@ -0,0 +1,248 @@
+/*
+ * TablePrimeRep.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <flint/fmpz.h>
+
+#include <algorithms/TablePrimeRep.hpp>
+
+#include <utils/BinaryIO.hpp>
+#include <utils/Metrics.hpp>
+
+namespace {
+
+typedef unsigned __int128 uint128_t;
+
+const char MAGIC[4] = {'P', 'T', 'A', 'B'};
+
+//Each task fills in the distances of this many consecutive elements
+const uint64_t ELEMENTS_PER_TASK = 1 << 14;
+//Candidates within this distance of an element's start are sieved together; a prime is almost always among them
+const size_t SIEVE_WINDOW = 1 << 9;
+//The odd primes the sieve strikes out multiples of
+const unsigned int SMALL_PRIMES[] = {
+        3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103,
+        107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167, 173, 179, 181, 191, 193, 197, 199, 211, 223,
+        227, 229, 233, 239, 241, 251, 257, 263, 269, 271, 277, 281, 283, 293, 307, 311, 313, 317, 331, 337, 347,
+        349, 353, 359, 367, 373, 379, 383, 389, 397, 401, 409, 419, 421, 431, 433, 439, 443, 449, 457, 461, 463,
+        467, 479, 487, 491, 499, 503, 509};
+const size_t NUM_SMALL_PRIMES = sizeof(SMALL_PRIMES) / sizeof(SMALL_PRIMES[0]);
+
+//Little-endian fields of the file header, whatever the host's byte order
+void writeField(unsigned char* out, uint64_t value, size_t bytes) {
+    for(size_t i = 0; i < bytes; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+uint64_t readField(const unsigned char* in, size_t bytes) {
+    uint64_t value = 0;
+    for(size_t i = 0; i < bytes; i++) {
+        value |= uint64_t(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t mulMod(uint64_t a, uint64_t b, uint64_t n) {
+    return (uint128_t)a * b % n;
+}
+
+uint64_t powMod(uint64_t base, uint64_t exponent, uint64_t n) {
+    uint64_t result = 1;
+    base %= n;
+    for(; exponent; exponent >>= 1) {
+        if(exponent & 1)
+            result = mulMod(result, base, n);
+        base = mulMod(base, base, n);
+    }
+    return result;
+}
+
+//Deterministic Miller-Rabin for odd n > 2^10: these seven bases have no common strong liar below 2^64
+bool isPrime(uint64_t n) {
+    static const uint64_t BASES[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    uint64_t oddPart = n - 1;
+    unsigned int twos = 0;
+    while(!(oddPart & 1)) {
+        oddPart >>= 1;
+        twos++;
+    }
+    for(uint64_t base : BASES) {
+        uint64_t x = powMod(base, oddPart, n);
+        if(x == 0 || x == 1 || x == n - 1)
+            continue;
+        bool composite = true;
+        for(unsigned int i = 1; i < twos && composite; i++) {
+            x = mulMod(x, x, n);
+            composite = x != n - 1;
+        }
+        if(composite)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Fills in the distances of elements [first, last). The starts of
+ * consecutive elements are 2^PADDING_BITS apart, so the residues of the
+ * start by each small prime are carried from one element to the next
+ * instead of recomputed, and each element's first SIEVE_WINDOW candidates
+ * are sieved before any of them is tested.
+ */
+void fillDistances(uint64_t domainStart, uint64_t first, uint64_t last, uint16_t* distances) {
+    uint64_t start = (domainStart + first) << TablePrimeRep::PADDING_BITS;
+    unsigned int residues[NUM_SMALL_PRIMES];
+    unsigned int steps[NUM_SMALL_PRIMES];
+    for(size_t i = 0; i < NUM_SMALL_PRIMES; i++) {
+        residues[i] = start % SMALL_PRIMES[i];
+        steps[i] = (1UL << TablePrimeRep::PADDING_BITS) % SMALL_PRIMES[i];
+    }
+    std::bitset<SIEVE_WINDOW> composite;
+    for(uint64_t element = first; element < last; element++) {
+        composite.reset();
+        for(size_t i = 0; i < NUM_SMALL_PRIMES; i++) {
+            //start + d is divisible by the prime when d = -residue mod prime
+            for(size_t d = (SMALL_PRIMES[i] - residues[i]) % SMALL_PRIMES[i]; d < SIEVE_WINDOW; d += SMALL_PRIMES[i])
+                composite[d] = true;
+        }
+        uint64_t distance = 1;
+        while(distance < SIEVE_WINDOW && (composite[distance] || !isPrime(start + distance)))
+            distance += 2;
+        //Past the window, keep going without the sieve
+        while(distance >= SIEVE_WINDOW && !isPrime(start + distance)) {
+            distance += 2;
+            if(distance >= (1UL << TablePrimeRep::PADDING_BITS))
+                throw std::runtime_error("No prime within 2^16 of an element's start");
+        }
+        distances[element] = distance;
+        METRICS_COUNT(PRIME_REP_GENERATED);
+        METRICS_ADD(PRIME_REP_CANDIDATES, (distance >> 1) + 1);
+        start += 1UL << TablePrimeRep::PADDING_BITS;
+        for(size_t i = 0; i < NUM_SMALL_PRIMES; i++) {
+            residues[i] += steps[i];
+            if(residues[i] >= SMALL_PRIMES[i])
+                residues[i] -= SMALL_PRIMES[i];
+        }
+    }
+}
+
+bool littleEndianHost() {
+    const uint16_t one = 1;
+    return *reinterpret_cast<const unsigned char*>(&one) == 1;
+}
+
+}  // namespace
+
+TablePrimeRep::TablePrimeRep()
+        : size(0), domainBits(0), domainStart(0), distances(NULL), mapped(NULL), mappedSize(0) {}
+
+TablePrimeRep::TablePrimeRep(uint64_t size, ThreadPool& threadPool) : TablePrimeRep() {
+    unsigned int bits = 0;
+    while(bits <= MAX_DOMAIN_BITS && (1ULL << bits) < size)
+        bits++;
+    if(size == 0 || bits > MAX_DOMAIN_BITS)
+        throw std::invalid_argument("A prime table must have between 1 and 2^47 elements.");
+    setDomain(size, bits);
+    builtDistances.resize(size);
+    distances = builtDistances.data();
+    std::vector<std::future<void>> futures;
+    for(uint64_t first = 0; first < size; first += ELEMENTS_PER_TASK) {
+        uint64_t last = std::min(size, first + ELEMENTS_PER_TASK);
+        futures.push_back(threadPool.enqueue<void>([this, first, last]() {
+            fillDistances(domainStart, first, last, builtDistances.data());
+        }, "rsa.buildPrimeTable"));
+    }
+    for(auto& future : futures) {
+        future.get();
+    }
+}
+
+TablePrimeRep::~TablePrimeRep() {
+    if(mapped)
+        munmap(const_cast<unsigned char*>(mapped), mappedSize);
+}
+
+void TablePrimeRep::setDomain(uint64_t size, unsigned int domainBits) {
+    this->size = size;
+    this->domainBits = domainBits;
+    domainStart = 1ULL << domainBits;
+}
+
+std::unique_ptr<TablePrimeRep> TablePrimeRep::load(const char* fileName) {
+    //The entries are read in place, so they must already be in the host's byte order
+    if(!littleEndianHost())
+        return NULL;
+    int descriptor = ::open(fileName, O_RDONLY);
+    if(descriptor < 0)
+        return NULL;
+    struct stat status;
+    void* address = MAP_FAILED;
+    if(fstat(descriptor, &status) == 0 && (size_t)status.st_size >= HEADER_SIZE)
+        address = mmap(NULL, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if(address == MAP_FAILED)
+        return NULL;
+    std::unique_ptr<TablePrimeRep> table(new TablePrimeRep());
+    table->mapped = static_cast<const unsigned char*>(address);
+    table->mappedSize = status.st_size;
+    const unsigned char* header = table->mapped;
+    uint64_t size = readField(header + 8, 8);
+    unsigned int bits = header[7];
+    if(memcmp(header, MAGIC, sizeof(MAGIC)) != 0 || readField(header + 4, 2) != VERSION || header[6] != PADDING_BITS
+       || bits > MAX_DOMAIN_BITS || size == 0 || size > (1ULL << bits) || (bits > 0 && size <= (1ULL << (bits - 1)))
+       || table->mappedSize != HEADER_SIZE + 2 * size)
+        return NULL;
+    table->setDomain(size, bits);
+    table->distances = reinterpret_cast<const uint16_t*>(header + HEADER_SIZE);
+    size_t words = (size + 63) / 64;
+    table->checked.reset(new std::atomic<uint64_t>[words]);
+    for(size_t word = 0; word < words; word++) {
+        table->checked[word].store(0, std::memory_order_relaxed);
+    }
+    return table;
+}
+
+bool TablePrimeRep::save(const char* fileName) const {
+    BufferedWriter out(fileName);
+    unsigned char* header = reinterpret_cast<unsigned char*>(out.reserve(HEADER_SIZE));
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    writeField(header + 4, VERSION, 2);
+    header[6] = PADDING_BITS;
+    header[7] = domainBits;
+    writeField(header + 8, size, 8);
+    for(uint64_t element = 0; element < size; element++) {
+        writeField(reinterpret_cast<unsigned char*>(out.reserve(2)), distances[element], 2);
+    }
+    out.flush();
+    return out.good();
+}
+
+void TablePrimeRep::checkEntry(uint64_t element, uint64_t value) const {
+    //The start is even, so an odd distance is needed for a prime; isPrime expects an odd n
+    if(!(distances[element] & 1) || !isPrime(value))
+        throw std::runtime_error("Prime table entry is not a prime");
+    checked[element / 64].fetch_or(1ULL << (element % 64), std::memory_order_relaxed);
+}
+
+void TablePrimeRep::genRepresentative(const flint::BigInt& element, flint::BigInt& representative) {
+    const fmpz* value = element.getUnderlyingObject();
+    if(fmpz_sgn(value) < 0 || fmpz_bits(value) > 64 || fmpz_get_ui(value) >= size)
+        throw std::out_of_range("Element is outside the prime table's domain");
+    fmpz_t result;
+    fmpz_init(result);
+    fmpz_set_ui(result, this->representative(fmpz_get_ui(value)));
+    representative = flint::BigInt(std::move(result));
+}
@@ -4,9 +4,20 @@
  */
 
 #include <bilinear/G.hpp>
+#include <utils/MemoryAccounting.hpp>
 
 G::G(){
 }
 
 G::~G(){
 }
+
+void* G::operator new(size_t size){
+	MEMORY_RECORD_ALLOCATION(size);
+	return ::operator new(size);
+}
+
+void G::operator delete(void* ptr, size_t size){
+	MEMORY_RECORD_FREE(size);
+	::operator delete(ptr);
+}
@@ -3,11 +3,18 @@
  *         May 18, 2011
  */
 
+#include <cstring>
+#include <vector>
+
+#include <bilinear/Backends.hpp>
 #include <bilinear/G1_DCLXVI.hpp>
+#include <bilinear/ScalarDecomposition.hpp>
+#include <utils/Metrics.hpp>
 #include <utils/Pointers.hpp>
 
 extern const scalar_t bn_n;
 extern const curvepoint_fp_t bn_curvegen;
+extern const fpe_t bn_zeta2;
 
 G1DCLXVI::G1DCLXVI() {
     curvepoint_fp_set(_curvepoint, bn_curvegen);
@@ -15,20 +22,17 @@ G1DCLXVI::G1DCLXVI() {
     fpe_isreduced(_curvepoint->m_y);
 }
 
+//Copies keep the other point's coordinates as they are, normalized or not
 G1DCLXVI::G1DCLXVI(const G1DCLXVI& other) {
-    curvepoint_fp_t eObj;
-    other.exportObject(eObj);
-    curvepoint_fp_set(_curvepoint, eObj);
+    curvepoint_fp_set(_curvepoint, other._curvepoint);
 }
 
 G& G1DCLXVI::operator=(const G& other) {
     if(this == &other) {
         return *this;
     } else {
-        G1DCLXVI* pG1 = (G1DCLXVI*)&other;
-        curvepoint_fp_t eObj;
-        pG1->exportObject(eObj);
-        curvepoint_fp_set(_curvepoint, eObj);
+        const G1DCLXVI& otherG1 = ref_cast<G1DCLXVI>(other);
+        curvepoint_fp_set(_curvepoint, otherG1._curvepoint);
         return *this;
     }
 }
@@ -37,7 +41,6 @@ void G1DCLXVI::generateRandom() {
     scalar_t scalar;
     scalar_setrandom(scalar, bn_n);
     curvepoint_fp_scalarmult_vartime(_curvepoint, _curvepoint, scalar);
-    curvepoint_fp_makeaffine(_curvepoint);
     isReduced(_curvepoint);
 }
 
@@ -52,28 +55,217 @@ void G1DCLXVI::becomeGenerator() {
 }
 
 bool G1DCLXVI::isEqual(const G& other) {
-    const G1DCLXVI& otherG1 = ref_cast<G1DCLXVI>(other);
-    curvepoint_fp_t op;
-    otherG1.exportObject(op);
-    curvepoint_fp_makeaffine(_curvepoint);
-    curvepoint_fp_makeaffine(op);
-    return (fpe_iseq(_curvepoint->m_x, op->m_x)
-            && fpe_iseq(_curvepoint->m_y, op->m_y)
-            && fpe_iseq(_curvepoint->m_z, op->m_z));
+    return pointsEqual(_curvepoint, ref_cast<G1DCLXVI>(other).getUnderlyingObj());
+}
+
+bool G1DCLXVI::pointsEqual(const curvepoint_fp_struct_t* p1, const curvepoint_fp_struct_t* p2) {
+    //The identity is the only point with Z = 0
+    bool identity1 = fpe_iszero(p1->m_z);
+    bool identity2 = fpe_iszero(p2->m_z);
+    if(identity1 || identity2)
+        return identity1 && identity2;
+    //Jacobian (X, Y, Z) is the affine point (X/Z^2, Y/Z^3), so compare
+    //X1*Z2^2 with X2*Z1^2 and Y1*Z2^3 with Y2*Z1^3 instead of inverting
+    fpe_t z1Squared, z2Squared, lhs, rhs;
+    fpe_square(z1Squared, p1->m_z);
+    fpe_square(z2Squared, p2->m_z);
+    fpe_mul(lhs, p1->m_x, z2Squared);
+    fpe_mul(rhs, p2->m_x, z1Squared);
+    if(!fpe_iseq(lhs, rhs))
+        return false;
+    fpe_mul(lhs, p1->m_y, z2Squared);
+    fpe_mul(lhs, lhs, p2->m_z);
+    fpe_mul(rhs, p2->m_y, z1Squared);
+    fpe_mul(rhs, rhs, p1->m_z);
+    return fpe_iseq(lhs, rhs);
+}
+
+namespace {
+
+//True if Z is 1 or 0. Testing that properly means reducing Z, but points made
+//affine have Z set by fpe_setone, so an exact match with that is checked first.
+bool isAffineOrIdentity(const curvepoint_fp_struct_t* point) {
+    static const fpe_struct_t ONE = []() {
+        fpe_struct_t one;
+        fpe_setone(&one);
+        return one;
+    }();
+    return memcmp(point->m_z, &ONE, sizeof(ONE)) == 0 || fpe_isone(point->m_z) || fpe_iszero(point->m_z);
+}
+
+//wNAF window for each of the two half-length sub-scalars; the table holds
+//the odd multiples P, 3P, ..., (2^(w-1) - 1)P
+const int POWER_WINDOW = 5;
+const int POWER_TABLE_SIZE = 1 << (POWER_WINDOW - 2);
+
+/**
+ * Adds two points. DCLXVI's add_vartime notices when op1 == op2 and doubles,
+ * but then falls through to the general formula and returns the identity,
+ * so that case is caught and redone here.
+ */
+void addPoints(curvepoint_fp_t rop, const curvepoint_fp_t op1, const curvepoint_fp_t op2) {
+    curvepoint_fp_t sum;
+    curvepoint_fp_add_vartime(sum, op1, op2);
+    //The sum only comes out as the identity if op1 = -op2, if op1 = op2, or if both are
+    //the identity; Y1*Z2^3 = Y2*Z1^3 tells the latter two apart, and doubling covers both
+    if(fpe_iszero(sum->m_z)) {
+        fpe_t z1Cubed, z2Cubed, lhs, rhs;
+        fpe_square(z1Cubed, op1->m_z);
+        fpe_mul(z1Cubed, z1Cubed, op1->m_z);
+        fpe_square(z2Cubed, op2->m_z);
+        fpe_mul(z2Cubed, z2Cubed, op2->m_z);
+        fpe_mul(lhs, op1->m_y, z2Cubed);
+        fpe_mul(rhs, op2->m_y, z1Cubed);
+        if(fpe_iseq(lhs, rhs)) {
+            curvepoint_fp_double(rop, op1);
+            return;
+        }
+    }
+    curvepoint_fp_set(rop, sum);
+}
+
+//The GLV endomorphism (x, y) -> (zeta*x, y), which acts on G1 as the scalar lambda
+//that ScalarDecomposition decomposes against. Scaling X leaves Jacobian form intact.
+void applyEndomorphism(curvepoint_fp_t rop, const curvepoint_fp_t op) {
+    curvepoint_fp_set(rop, op);
+    fpe_mul(rop->m_x, rop->m_x, bn_zeta2);
 }
 
+}  // anonymous namespace
+
 void G1DCLXVI::doMultiplication(const G& other, G& result) {
     const G1DCLXVI& otherG1 = ref_cast<G1DCLXVI>(other);
     G1DCLXVI& resultG1 = ref_cast<G1DCLXVI>(result);
-    curvepoint_fp_add_vartime(resultG1.getUnderlyingObj(), _curvepoint, otherG1.getUnderlyingObj());
-    curvepoint_fp_makeaffine(resultG1.getUnderlyingObj());
+    multiply(resultG1.getUnderlyingObj(), _curvepoint, otherG1.getUnderlyingObj());
+}
+
+void G1DCLXVI::multiply(curvepoint_fp_struct_t* rop, const curvepoint_fp_struct_t* op1, const curvepoint_fp_struct_t* op2) {
+    METRICS_COUNT(G1_MULTIPLICATION);
+    addPoints(rop, op1, op2);
 }
 
 void G1DCLXVI::doPower(const Scalar& scalar, G& result) {
     const ScalarDCLXVI& dScalar = ref_cast<ScalarDCLXVI>(scalar);
     G1DCLXVI& resultG1 = ref_cast<G1DCLXVI>(result);
-    curvepoint_fp_scalarmult_vartime(resultG1.getUnderlyingObj(), _curvepoint, dScalar.getUnderlyingObj());
-    curvepoint_fp_makeaffine(resultG1.getUnderlyingObj());
+    power(resultG1.getUnderlyingObj(), _curvepoint, dScalar.getUnderlyingObj());
+}
+
+//Splits the scalar into two ~128-bit halves with the GLV endomorphism and
+//runs one interleaved wNAF double-and-add loop over both, halving the doublings
+void G1DCLXVI::power(curvepoint_fp_struct_t* rop, const curvepoint_fp_struct_t* op, const scalar_t scalar) {
+    METRICS_COUNT(G1_POWER);
+    ScalarDecomposition::Recoding recoding;
+    ScalarDecomposition::recode(scalar, ScalarDecomposition::GLV, POWER_WINDOW, recoding);
+    curvepoint_fp_struct_t table[2][POWER_TABLE_SIZE];
+    curvepoint_fp_t twice;
+    curvepoint_fp_set(&table[0][0], op);
+    curvepoint_fp_double(twice, op);
+    for(int i = 1; i < POWER_TABLE_SIZE; i++) {
+        addPoints(&table[0][i], &table[0][i - 1], twice);
+    }
+    for(int i = 0; i < POWER_TABLE_SIZE; i++) {
+        applyEndomorphism(&table[1][i], &table[0][i]);
+    }
+    curvepoint_fp_t accumulator, negated;
+    curvepoint_fp_setneutral(accumulator);
+    bool started = false;
+    for(int bit = recoding.length - 1; bit >= 0; bit--) {
+        if(started)
+            curvepoint_fp_double(accumulator, accumulator);
+        for(int part = 0; part < 2; part++) {
+            int digit = recoding.digits[part][bit];
+            if(digit == 0)
+                continue;
+            const curvepoint_fp_struct_t* multiple = &table[part][(digit > 0 ? digit : -digit) / 2];
+            if(digit < 0) {
+                curvepoint_fp_neg(negated, multiple);
+                multiple = negated;
+            }
+            if(started) {
+                addPoints(accumulator, accumulator, multiple);
+            } else {
+                curvepoint_fp_set(accumulator, multiple);
+                started = true;
+            }
+        }
+    }
+    curvepoint_fp_set(rop, accumulator);
+}
+
+void G1DCLXVI::normalize() {
+    makeAffine();
+}
+
+//Converting to affine form doesn't change which point this is, so const methods may do it
+void G1DCLXVI::makeAffine() const {
+    if(!isNormalized())
+        curvepoint_fp_makeaffine(_curvepoint);
+}
+
+bool G1DCLXVI::isNormalized() const {
+    return isAffineOrIdentity(_curvepoint);
+}
+
+namespace {
+
+//Montgomery's trick: invert the product of all the Z coordinates once, then
+//recover each individual inverse with two multiplications
+void batchMakeAffine(std::vector<curvepoint_fp_struct_t*>& points) {
+    //Points already in affine form, and the identity, are left alone
+    size_t count = 0;
+    for(curvepoint_fp_struct_t* point : points) {
+        if(!isAffineOrIdentity(point))
+            points[count++] = point;
+    }
+    if(count == 0)
+        return;
+    std::vector<fpe_struct_t> prefixProducts(count);
+    fpe_set(&prefixProducts[0], points[0]->m_z);
+    for(size_t i = 1; i < count; i++) {
+        fpe_mul(&prefixProducts[i], &prefixProducts[i - 1], points[i]->m_z);
+    }
+    fpe_t inverse, zInverse, zInverseSquared;
+    fpe_invert(inverse, &prefixProducts[count - 1]);
+    for(size_t i = count; i-- > 0;) {
+        //inverse is now 1/(z_0 * ... * z_i)
+        if(i > 0) {
+            fpe_mul(zInverse, inverse, &prefixProducts[i - 1]);
+            fpe_mul(inverse, inverse, points[i]->m_z);
+        } else {
+            fpe_set(zInverse, inverse);
+        }
+        fpe_square(zInverseSquared, zInverse);
+        fpe_mul(points[i]->m_x, points[i]->m_x, zInverseSquared);
+        fpe_mul(points[i]->m_y, points[i]->m_y, zInverseSquared);
+        fpe_mul(points[i]->m_y, points[i]->m_y, zInverse);
+        fpe_setone(points[i]->m_z);
+    }
+}
+
+}  // anonymous namespace
+
+void G1DCLXVI::batchNormalize(G1DCLXVI* elements, size_t count) {
+    std::vector<curvepoint_fp_struct_t*> points;
+    for(size_t i = 0; i < count; i++) {
+        points.push_back(elements[i]._curvepoint);
+    }
+    batchMakeAffine(points);
+}
+
+void G1DCLXVI::batchNormalize(curvepoint_fp_struct_t* points, size_t count) {
+    std::vector<curvepoint_fp_struct_t*> pointers;
+    for(size_t i = 0; i < count; i++) {
+        pointers.push_back(&points[i]);
+    }
+    batchMakeAffine(pointers);
+}
+
+void G1DCLXVI::batchNormalize(const std::vector<std::unique_ptr<G>>& elements) {
+    std::vector<curvepoint_fp_struct_t*> points;
+    for(const std::unique_ptr<G>& element : elements) {
+        points.push_back(ref_cast<G1DCLXVI>(*element)._curvepoint);
+    }
+    batchMakeAffine(points);
 }
 
 void G1DCLXVI::importObject(const void* obj) {
@@ -82,6 +274,8 @@ void G1DCLXVI::importObject(const void* obj) {
 }
 
 void G1DCLXVI::exportObject(void* obj) const {
+    //DCLXVI's pairing needs affine points
+    makeAffine();
     curvepoint_fp_struct_t* rop = (curvepoint_fp_struct_t*)obj;
     curvepoint_fp_set(rop, _curvepoint);
 }
@@ -91,6 +285,7 @@ size_t G1DCLXVI::getSize() const {
 }
 
 char* G1DCLXVI::getByteBuffer() const {
+    makeAffine();
     return (char*)_curvepoint;
 }
 
@@ -104,20 +299,48 @@ const curvepoint_fp_struct_t* G1DCLXVI::getUnderlyingObj() const {
 }
 
 void G1DCLXVI::readFromFile(std::istream& inFile) {
+    std::byte bytes[ENCODED_SIZE];
+    if(inFile.read((char*)bytes, ENCODED_SIZE) && !decode(bytes))
+        inFile.setstate(std::ios::failbit);
+}
+
+void G1DCLXVI::writeToFile(std::ostream& outFile) const {
+    std::byte bytes[ENCODED_SIZE];
+    encode(bytes);
+    outFile.write((const char*)bytes, ENCODED_SIZE);
+}
+
+size_t G1DCLXVI::getEncodedSize() const {
+    return ENCODED_SIZE;
+}
+
+void G1DCLXVI::encode(std::byte* out) const {
+    makeAffine();
+    encode(out, _curvepoint);
+}
+
+bool G1DCLXVI::decode(const std::byte* in) {
+    return DCLXVIBackend::G1Ops::decode(*_curvepoint, in);
+}
+
+//The file format interleaves the coordinates: the i-th double of X, Y, Z and T, for each i
+void G1DCLXVI::encode(std::byte* out, const curvepoint_fp_struct_t* point) {
     for(int i = 0; i < 12; i++) {
-        inFile.read((char*)&_curvepoint->m_x->v[i], sizeof(mydouble));
-        inFile.read((char*)&_curvepoint->m_y->v[i], sizeof(mydouble));
-        inFile.read((char*)&_curvepoint->m_z->v[i], sizeof(mydouble));
-        inFile.read((char*)&_curvepoint->m_t->v[i], sizeof(mydouble));
+        memcpy(out, &point->m_x->v[i], sizeof(mydouble));
+        memcpy(out + sizeof(mydouble), &point->m_y->v[i], sizeof(mydouble));
+        memcpy(out + 2 * sizeof(mydouble), &point->m_z->v[i], sizeof(mydouble));
+        memcpy(out + 3 * sizeof(mydouble), &point->m_t->v[i], sizeof(mydouble));
+        out += 4 * sizeof(mydouble);
     }
 }
 
-void G1DCLXVI::writeToFile(std::ostream& outFile) const {
+void G1DCLXVI::decode(curvepoint_fp_struct_t* point, const std::byte* in) {
     for(int i = 0; i < 12; i++) {
-        outFile.write((char*)&_curvepoint->m_x->v[i], sizeof(mydouble));
-        outFile.write((char*)&_curvepoint->m_y->v[i], sizeof(mydouble));
-        outFile.write((char*)&_curvepoint->m_z->v[i], sizeof(mydouble));
-        outFile.write((char*)&_curvepoint->m_t->v[i], sizeof(mydouble));
+        memcpy(&point->m_x->v[i], in, sizeof(mydouble));
+        memcpy(&point->m_y->v[i], in + sizeof(mydouble), sizeof(mydouble));
+        memcpy(&point->m_z->v[i], in + 2 * sizeof(mydouble), sizeof(mydouble));
+        memcpy(&point->m_t->v[i], in + 3 * sizeof(mydouble), sizeof(mydouble));
+        in += 4 * sizeof(mydouble);
     }
 }
 
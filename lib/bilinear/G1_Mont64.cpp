@@ -0,0 +1,142 @@
+/*
+ * G1_Mont64.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstring>
+
+#include <bilinear/Backends.hpp>
+#include <bilinear/G1_Mont64.hpp>
+#include <utils/Metrics.hpp>
+#include <utils/Pointers.hpp>
+
+extern const scalar_t bn_n;
+
+G1Mont64::G1Mont64() {
+    Mont64::g1_setgenerator(_point);
+}
+
+//Copies keep the other point's coordinates as they are, normalized or not
+G1Mont64::G1Mont64(const G1Mont64& other) : _point(other._point) {
+}
+
+G1Mont64::G1Mont64(const G1DCLXVI& other) {
+    Mont64::g1_from_dclxvi(_point, other.getUnderlyingObj());
+}
+
+G& G1Mont64::operator=(const G& other) {
+    if(this != &other)
+        _point = ref_cast<G1Mont64>(other)._point;
+    return *this;
+}
+
+void G1Mont64::generateRandom() {
+    scalar_t scalar;
+    scalar_setrandom(scalar, bn_n);
+    Mont64::g1_scalarmult(_point, _point, scalar);
+}
+
+void G1Mont64::becomeIdentity() {
+    Mont64::g1_setidentity(_point);
+}
+
+void G1Mont64::becomeGenerator() {
+    Mont64::g1_setgenerator(_point);
+}
+
+bool G1Mont64::isEqual(const G& other) {
+    return Mont64::g1_iseq(_point, ref_cast<G1Mont64>(other)._point);
+}
+
+void G1Mont64::doMultiplication(const G& other, G& result) {
+    METRICS_COUNT(G1_MULTIPLICATION);
+    const G1Mont64& otherG1 = ref_cast<G1Mont64>(other);
+    G1Mont64& resultG1 = ref_cast<G1Mont64>(result);
+    Mont64::g1_add(resultG1._point, _point, otherG1._point);
+}
+
+void G1Mont64::doPower(const Scalar& scalar, G& result) {
+    METRICS_COUNT(G1_POWER);
+    const ScalarDCLXVI& dScalar = ref_cast<ScalarDCLXVI>(scalar);
+    G1Mont64& resultG1 = ref_cast<G1Mont64>(result);
+    Mont64::g1_scalarmult(resultG1._point, _point, dScalar.getUnderlyingObj());
+}
+
+//Converting to affine form doesn't change which point this is, so const methods may do it
+void G1Mont64::normalize() {
+    Mont64::g1_makeaffine(_point);
+}
+
+bool G1Mont64::isNormalized() const {
+    Mont64::Fp one;
+    Mont64::fp_setone(one);
+    return Mont64::fp_iszero(_point.z) || Mont64::fp_iseq(_point.z, one);
+}
+
+void G1Mont64::batchNormalize(G1Mont64* elements, size_t count) {
+    std::vector<Mont64::G1Point*> points;
+    for(size_t i = 0; i < count; i++) {
+        points.push_back(&elements[i]._point);
+    }
+    Mont64::g1_batch_makeaffine(points.data(), points.size());
+}
+
+void G1Mont64::batchNormalize(const std::vector<std::unique_ptr<G>>& elements) {
+    std::vector<Mont64::G1Point*> points;
+    for(const std::unique_ptr<G>& element : elements) {
+        points.push_back(&ref_cast<G1Mont64>(*element)._point);
+    }
+    Mont64::g1_batch_makeaffine(points.data(), points.size());
+}
+
+void G1Mont64::importObject(const void* obj) {
+    _point = *(const Mont64::G1Point*)obj;
+}
+
+void G1Mont64::exportObject(void* obj) const {
+    Mont64::g1_makeaffine(_point);
+    *(Mont64::G1Point*)obj = _point;
+}
+
+size_t G1Mont64::getSize() const {
+    return sizeof(_point);
+}
+
+char* G1Mont64::getByteBuffer() const {
+    Mont64::g1_makeaffine(_point);
+    return (char*)&_point;
+}
+
+Mont64::G1Point* G1Mont64::getUnderlyingObj() {
+    return &_point;
+}
+
+const Mont64::G1Point* G1Mont64::getUnderlyingObj() const {
+    return &_point;
+}
+
+//Points are written as their affine Montgomery-form limbs, in host byte order
+void G1Mont64::readFromFile(std::istream& inFile) {
+    std::byte bytes[sizeof(_point)];
+    if(inFile.read((char*)bytes, sizeof(bytes)) && !decode(bytes))
+        inFile.setstate(std::ios::failbit);
+}
+
+void G1Mont64::writeToFile(std::ostream& outFile) const {
+    Mont64::g1_makeaffine(_point);
+    outFile.write((char*)&_point, sizeof(_point));
+}
+
+size_t G1Mont64::getEncodedSize() const {
+    return sizeof(_point);
+}
+
+void G1Mont64::encode(std::byte* out) const {
+    Mont64::g1_makeaffine(_point);
+    memcpy(out, &_point, sizeof(_point));
+}
+
+bool G1Mont64::decode(const std::byte* in) {
+    return Mont64Backend::G1Ops::decode(_point, in);
+}
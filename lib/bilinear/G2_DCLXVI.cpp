@@ -3,11 +3,19 @@
  *         May 18, 2011
  */
 
+#include <cstring>
+#include <vector>
+
+#include <bilinear/Backends.hpp>
 #include <bilinear/G2_DCLXVI.hpp>
+#include <bilinear/ScalarDecomposition.hpp>
+#include <utils/Metrics.hpp>
 #include <utils/Pointers.hpp>
 
 extern const scalar_t bn_n;
 extern const twistpoint_fp2_t bn_twistgen;
+extern const fp2e_t bn_z2p;
+extern const fp2e_t bn_z3p;
 
 G2DCLXVI::G2DCLXVI() {
     twistpoint_fp2_set(_twistpoint, bn_twistgen);
@@ -15,20 +23,17 @@ G2DCLXVI::G2DCLXVI() {
     fp2e_isreduced(_twistpoint->m_y);
 }
 
+//Copies keep the other point's coordinates as they are, normalized or not
 G2DCLXVI::G2DCLXVI(const G2DCLXVI& other) {
-    twistpoint_fp2_t eObj;
-    other.exportObject(eObj);
-    twistpoint_fp2_set(_twistpoint, eObj);
+    twistpoint_fp2_set(_twistpoint, other._twistpoint);
 }
 
 G& G2DCLXVI::operator=(const G& other) {
     if(this == &other) {
         return *this;
     } else {
-        G2DCLXVI* pG2 = (G2DCLXVI*)&other;
-        twistpoint_fp2_t eObj;
-        pG2->exportObject(eObj);
-        twistpoint_fp2_set(_twistpoint, eObj);
+        const G2DCLXVI& pG2 = ref_cast<G2DCLXVI>(other);
+        twistpoint_fp2_set(_twistpoint, pG2._twistpoint);
         return *this;
     }
 }
@@ -37,7 +42,6 @@ void G2DCLXVI::generateRandom() {
     scalar_t scalar;
     scalar_setrandom(scalar, bn_n);
     twistpoint_fp2_scalarmult_vartime(_twistpoint, _twistpoint, scalar);
-    twistpoint_fp2_makeaffine(_twistpoint);
     isReduced(_twistpoint);
 }
 
@@ -52,28 +56,214 @@ void G2DCLXVI::becomeGenerator() {
 }
 
 bool G2DCLXVI::isEqual(const G& other) {
-    const G2DCLXVI& pG2 = ref_cast<G2DCLXVI>(other);
-    twistpoint_fp2_t op;
-    pG2.exportObject(op);
-    twistpoint_fp2_makeaffine(_twistpoint);
-    twistpoint_fp2_makeaffine(op);
-    return (fp2e_iseq(_twistpoint->m_x, op->m_x)
-            && fp2e_iseq(_twistpoint->m_y, op->m_y)
-            && fp2e_iseq(_twistpoint->m_z, op->m_z));
+    return pointsEqual(_twistpoint, ref_cast<G2DCLXVI>(other).getUnderlyingObj());
+}
+
+bool G2DCLXVI::pointsEqual(const twistpoint_fp2_struct_t* p1, const twistpoint_fp2_struct_t* p2) {
+    //The identity is the only point with Z = 0
+    bool identity1 = fp2e_iszero(p1->m_z);
+    bool identity2 = fp2e_iszero(p2->m_z);
+    if(identity1 || identity2)
+        return identity1 && identity2;
+    //Same cross-multiplication as G1DCLXVI::pointsEqual, over Fp2
+    fp2e_t z1Squared, z2Squared, lhs, rhs;
+    fp2e_square(z1Squared, p1->m_z);
+    fp2e_square(z2Squared, p2->m_z);
+    fp2e_mul(lhs, p1->m_x, z2Squared);
+    fp2e_mul(rhs, p2->m_x, z1Squared);
+    if(!fp2e_iseq(lhs, rhs))
+        return false;
+    fp2e_mul(lhs, p1->m_y, z2Squared);
+    fp2e_mul(lhs, lhs, p2->m_z);
+    fp2e_mul(rhs, p2->m_y, z1Squared);
+    fp2e_mul(rhs, rhs, p1->m_z);
+    return fp2e_iseq(lhs, rhs);
+}
+
+namespace {
+
+//True if Z is 1 or 0. Testing that properly means reducing Z, but points made
+//affine have Z set by fp2e_setone, so an exact match with that is checked first.
+bool isAffineOrIdentity(const twistpoint_fp2_struct_t* point) {
+    static const fp2e_struct_t ONE = []() {
+        fp2e_struct_t one;
+        fp2e_setone(&one);
+        return one;
+    }();
+    return memcmp(point->m_z, &ONE, sizeof(ONE)) == 0 || fp2e_isone(point->m_z) || fp2e_iszero(point->m_z);
 }
 
+//The four sub-scalars are only ~64 bits, so a smaller table than G1's pays off
+const int POWER_WINDOW = 4;
+const int POWER_TABLE_SIZE = 1 << (POWER_WINDOW - 2);
+const int POWER_DIMENSION = 4;
+
+//Adds two points, doubling when they are equal, which DCLXVI's add_vartime gets wrong (see G1DCLXVI)
+void addPoints(twistpoint_fp2_t rop, const twistpoint_fp2_t op1, const twistpoint_fp2_t op2) {
+    twistpoint_fp2_t sum;
+    twistpoint_fp2_add_vartime(sum, op1, op2);
+    if(fp2e_iszero(sum->m_z)) {
+        fp2e_t z1Cubed, z2Cubed, lhs, rhs;
+        fp2e_square(z1Cubed, op1->m_z);
+        fp2e_mul(z1Cubed, z1Cubed, op1->m_z);
+        fp2e_square(z2Cubed, op2->m_z);
+        fp2e_mul(z2Cubed, z2Cubed, op2->m_z);
+        fp2e_mul(lhs, op1->m_y, z2Cubed);
+        fp2e_mul(rhs, op2->m_y, z1Cubed);
+        if(fp2e_iseq(lhs, rhs)) {
+            twistpoint_fp2_double(rop, op1);
+            return;
+        }
+    }
+    twistpoint_fp2_set(rop, sum);
+}
+
+//The twisted p-power Frobenius (x, y) -> (conj(x)*z2p, conj(y)*z3p), as used by the
+//pairing to compute Q1; on G2 it acts as the scalar p mod n. Conjugating Z (and T = Z^2)
+//as well applies it to Jacobian coordinates without normalizing.
+void applyFrobenius(twistpoint_fp2_t rop, const twistpoint_fp2_t op) {
+    fp2e_conjugate(rop->m_x, op->m_x);
+    fp2e_mul(rop->m_x, rop->m_x, bn_z2p);
+    fp2e_conjugate(rop->m_y, op->m_y);
+    fp2e_mul(rop->m_y, rop->m_y, bn_z3p);
+    fp2e_conjugate(rop->m_z, op->m_z);
+    fp2e_conjugate(rop->m_t, op->m_t);
+}
+
+}  // anonymous namespace
+
 void G2DCLXVI::doMultiplication(const G& other, G& result) {
     const G2DCLXVI& pG2 = ref_cast<G2DCLXVI>(other);
     G2DCLXVI& pG2Result = ref_cast<G2DCLXVI>(result);
-    twistpoint_fp2_add_vartime(pG2Result.getUnderlyingObj(), _twistpoint, pG2.getUnderlyingObj());
-    twistpoint_fp2_makeaffine(pG2Result.getUnderlyingObj());
+    multiply(pG2Result.getUnderlyingObj(), _twistpoint, pG2.getUnderlyingObj());
+}
+
+void G2DCLXVI::multiply(twistpoint_fp2_struct_t* rop, const twistpoint_fp2_struct_t* op1, const twistpoint_fp2_struct_t* op2) {
+    METRICS_COUNT(G2_MULTIPLICATION);
+    addPoints(rop, op1, op2);
 }
 
 void G2DCLXVI::doPower(const Scalar& scalar, G& result) {
     const ScalarDCLXVI& pScalar = ref_cast<ScalarDCLXVI>(scalar);
     G2DCLXVI& pG2 = ref_cast<G2DCLXVI>(result);
-    twistpoint_fp2_scalarmult_vartime(pG2.getUnderlyingObj(), _twistpoint, pScalar.getUnderlyingObj());
-    twistpoint_fp2_makeaffine(pG2.getUnderlyingObj());
+    power(pG2.getUnderlyingObj(), _twistpoint, pScalar.getUnderlyingObj());
+}
+
+//Splits the scalar into four ~64-bit parts with the Frobenius endomorphism and
+//runs one interleaved wNAF double-and-add loop over all of them
+void G2DCLXVI::power(twistpoint_fp2_struct_t* rop, const twistpoint_fp2_struct_t* op, const scalar_t scalar) {
+    METRICS_COUNT(G2_POWER);
+    ScalarDecomposition::Recoding recoding;
+    ScalarDecomposition::recode(scalar, ScalarDecomposition::FROBENIUS, POWER_WINDOW, recoding);
+    twistpoint_fp2_struct_t table[POWER_DIMENSION][POWER_TABLE_SIZE];
+    twistpoint_fp2_t twice;
+    twistpoint_fp2_set(&table[0][0], op);
+    twistpoint_fp2_double(twice, op);
+    for(int i = 1; i < POWER_TABLE_SIZE; i++) {
+        addPoints(&table[0][i], &table[0][i - 1], twice);
+    }
+    for(int part = 1; part < POWER_DIMENSION; part++) {
+        for(int i = 0; i < POWER_TABLE_SIZE; i++) {
+            applyFrobenius(&table[part][i], &table[part - 1][i]);
+        }
+    }
+    twistpoint_fp2_t accumulator, negated;
+    twistpoint_fp2_setneutral(accumulator);
+    bool started = false;
+    for(int bit = recoding.length - 1; bit >= 0; bit--) {
+        if(started)
+            twistpoint_fp2_double(accumulator, accumulator);
+        for(int part = 0; part < POWER_DIMENSION; part++) {
+            int digit = recoding.digits[part][bit];
+            if(digit == 0)
+                continue;
+            const twistpoint_fp2_struct_t* multiple = &table[part][(digit > 0 ? digit : -digit) / 2];
+            if(digit < 0) {
+                twistpoint_fp2_neg(negated, multiple);
+                multiple = negated;
+            }
+            if(started) {
+                addPoints(accumulator, accumulator, multiple);
+            } else {
+                twistpoint_fp2_set(accumulator, multiple);
+                started = true;
+            }
+        }
+    }
+    twistpoint_fp2_set(rop, accumulator);
+}
+
+void G2DCLXVI::normalize() {
+    makeAffine();
+}
+
+//Converting to affine form doesn't change which point this is, so const methods may do it
+void G2DCLXVI::makeAffine() const {
+    if(!isNormalized())
+        twistpoint_fp2_makeaffine(_twistpoint);
+}
+
+bool G2DCLXVI::isNormalized() const {
+    return isAffineOrIdentity(_twistpoint);
+}
+
+namespace {
+
+//Montgomery's trick, as in G1DCLXVI: one Fp2 inversion for all the points
+void batchMakeAffine(std::vector<twistpoint_fp2_struct_t*>& points) {
+    size_t count = 0;
+    for(twistpoint_fp2_struct_t* point : points) {
+        if(!isAffineOrIdentity(point))
+            points[count++] = point;
+    }
+    if(count == 0)
+        return;
+    std::vector<fp2e_struct_t> prefixProducts(count);
+    fp2e_set(&prefixProducts[0], points[0]->m_z);
+    for(size_t i = 1; i < count; i++) {
+        fp2e_mul(&prefixProducts[i], &prefixProducts[i - 1], points[i]->m_z);
+    }
+    fp2e_t inverse, zInverse, zInverseSquared;
+    fp2e_invert(inverse, &prefixProducts[count - 1]);
+    for(size_t i = count; i-- > 0;) {
+        if(i > 0) {
+            fp2e_mul(zInverse, inverse, &prefixProducts[i - 1]);
+            fp2e_mul(inverse, inverse, points[i]->m_z);
+        } else {
+            fp2e_set(zInverse, inverse);
+        }
+        fp2e_square(zInverseSquared, zInverse);
+        fp2e_mul(points[i]->m_x, points[i]->m_x, zInverseSquared);
+        fp2e_mul(points[i]->m_y, points[i]->m_y, zInverseSquared);
+        fp2e_mul(points[i]->m_y, points[i]->m_y, zInverse);
+        fp2e_setone(points[i]->m_z);
+    }
+}
+
+}  // anonymous namespace
+
+void G2DCLXVI::batchNormalize(G2DCLXVI* elements, size_t count) {
+    std::vector<twistpoint_fp2_struct_t*> points;
+    for(size_t i = 0; i < count; i++) {
+        points.push_back(elements[i]._twistpoint);
+    }
+    batchMakeAffine(points);
+}
+
+void G2DCLXVI::batchNormalize(twistpoint_fp2_struct_t* points, size_t count) {
+    std::vector<twistpoint_fp2_struct_t*> pointers;
+    for(size_t i = 0; i < count; i++) {
+        pointers.push_back(&points[i]);
+    }
+    batchMakeAffine(pointers);
+}
+
+void G2DCLXVI::batchNormalize(const std::vector<std::unique_ptr<G>>& elements) {
+    std::vector<twistpoint_fp2_struct_t*> points;
+    for(const std::unique_ptr<G>& element : elements) {
+        points.push_back(ref_cast<G2DCLXVI>(*element)._twistpoint);
+    }
+    batchMakeAffine(points);
 }
 
 void G2DCLXVI::importObject(const void* obj) {
@@ -82,6 +272,8 @@ void G2DCLXVI::importObject(const void* obj) {
 }
 
 void G2DCLXVI::exportObject(void* obj) const {
+    //DCLXVI's pairing needs affine points
+    makeAffine();
     twistpoint_fp2_struct_t* rop = (twistpoint_fp2_struct_t*)obj;
     twistpoint_fp2_set(rop, _twistpoint);
 }
@@ -91,6 +283,7 @@ size_t G2DCLXVI::getSize() const {
 }
 
 char* G2DCLXVI::getByteBuffer() const {
+    makeAffine();
     return (char*)_twistpoint;
 }
 
@@ -103,20 +296,48 @@ const twistpoint_fp2_struct_t* G2DCLXVI::getUnderlyingObj() const {
 }
 
 void G2DCLXVI::readFromFile(std::istream& inFile) {
+    std::byte bytes[ENCODED_SIZE];
+    if(inFile.read((char*)bytes, ENCODED_SIZE) && !decode(bytes))
+        inFile.setstate(std::ios::failbit);
+}
+
+void G2DCLXVI::writeToFile(std::ostream& outFile) const {
+    std::byte bytes[ENCODED_SIZE];
+    encode(bytes);
+    outFile.write((const char*)bytes, ENCODED_SIZE);
+}
+
+size_t G2DCLXVI::getEncodedSize() const {
+    return ENCODED_SIZE;
+}
+
+void G2DCLXVI::encode(std::byte* out) const {
+    makeAffine();
+    encode(out, _twistpoint);
+}
+
+bool G2DCLXVI::decode(const std::byte* in) {
+    return DCLXVIBackend::G2Ops::decode(*_twistpoint, in);
+}
+
+//The file format interleaves the coordinates: the i-th double of X, Y, Z and T, for each i
+void G2DCLXVI::encode(std::byte* out, const twistpoint_fp2_struct_t* point) {
     for(int i = 0; i < 24; i++) {
-        inFile.read((char*)&_twistpoint->m_x->v[i], sizeof(mydouble));
-        inFile.read((char*)&_twistpoint->m_y->v[i], sizeof(mydouble));
-        inFile.read((char*)&_twistpoint->m_z->v[i], sizeof(mydouble));
-        inFile.read((char*)&_twistpoint->m_t->v[i], sizeof(mydouble));
+        memcpy(out, &point->m_x->v[i], sizeof(mydouble));
+        memcpy(out + sizeof(mydouble), &point->m_y->v[i], sizeof(mydouble));
+        memcpy(out + 2 * sizeof(mydouble), &point->m_z->v[i], sizeof(mydouble));
+        memcpy(out + 3 * sizeof(mydouble), &point->m_t->v[i], sizeof(mydouble));
+        out += 4 * sizeof(mydouble);
     }
 }
 
-void G2DCLXVI::writeToFile(std::ostream& outFile) const {
+void G2DCLXVI::decode(twistpoint_fp2_struct_t* point, const std::byte* in) {
     for(int i = 0; i < 24; i++) {
-        outFile.write((char*)&_twistpoint->m_x->v[i], sizeof(mydouble));
-        outFile.write((char*)&_twistpoint->m_y->v[i], sizeof(mydouble));
-        outFile.write((char*)&_twistpoint->m_z->v[i], sizeof(mydouble));
-        outFile.write((char*)&_twistpoint->m_t->v[i], sizeof(mydouble));
+        memcpy(&point->m_x->v[i], in, sizeof(mydouble));
+        memcpy(&point->m_y->v[i], in + sizeof(mydouble), sizeof(mydouble));
+        memcpy(&point->m_z->v[i], in + 2 * sizeof(mydouble), sizeof(mydouble));
+        memcpy(&point->m_t->v[i], in + 3 * sizeof(mydouble), sizeof(mydouble));
+        in += 4 * sizeof(mydouble);
     }
 }
 
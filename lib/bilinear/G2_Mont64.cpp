@@ -0,0 +1,140 @@
+/*
+ * G2_Mont64.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstring>
+
+#include <bilinear/Backends.hpp>
+#include <bilinear/G2_Mont64.hpp>
+#include <utils/Metrics.hpp>
+#include <utils/Pointers.hpp>
+
+extern const scalar_t bn_n;
+
+G2Mont64::G2Mont64() {
+    Mont64::g2_setgenerator(_point);
+}
+
+//Copies keep the other point's coordinates as they are, normalized or not
+G2Mont64::G2Mont64(const G2Mont64& other) : _point(other._point) {
+}
+
+G2Mont64::G2Mont64(const G2DCLXVI& other) {
+    Mont64::g2_from_dclxvi(_point, other.getUnderlyingObj());
+}
+
+G& G2Mont64::operator=(const G& other) {
+    if(this != &other)
+        _point = ref_cast<G2Mont64>(other)._point;
+    return *this;
+}
+
+void G2Mont64::generateRandom() {
+    scalar_t scalar;
+    scalar_setrandom(scalar, bn_n);
+    Mont64::g2_scalarmult(_point, _point, scalar);
+}
+
+void G2Mont64::becomeIdentity() {
+    Mont64::g2_setidentity(_point);
+}
+
+void G2Mont64::becomeGenerator() {
+    Mont64::g2_setgenerator(_point);
+}
+
+bool G2Mont64::isEqual(const G& other) {
+    return Mont64::g2_iseq(_point, ref_cast<G2Mont64>(other)._point);
+}
+
+void G2Mont64::doMultiplication(const G& other, G& result) {
+    METRICS_COUNT(G2_MULTIPLICATION);
+    const G2Mont64& otherG2 = ref_cast<G2Mont64>(other);
+    G2Mont64& resultG2 = ref_cast<G2Mont64>(result);
+    Mont64::g2_add(resultG2._point, _point, otherG2._point);
+}
+
+void G2Mont64::doPower(const Scalar& scalar, G& result) {
+    METRICS_COUNT(G2_POWER);
+    const ScalarDCLXVI& dScalar = ref_cast<ScalarDCLXVI>(scalar);
+    G2Mont64& resultG2 = ref_cast<G2Mont64>(result);
+    Mont64::g2_scalarmult(resultG2._point, _point, dScalar.getUnderlyingObj());
+}
+
+//Converting to affine form doesn't change which point this is, so const methods may do it
+void G2Mont64::normalize() {
+    Mont64::g2_makeaffine(_point);
+}
+
+bool G2Mont64::isNormalized() const {
+    return Mont64::fp2_iszero(_point.z) || Mont64::fp2_isone(_point.z);
+}
+
+void G2Mont64::batchNormalize(G2Mont64* elements, size_t count) {
+    std::vector<Mont64::G2Point*> points;
+    for(size_t i = 0; i < count; i++) {
+        points.push_back(&elements[i]._point);
+    }
+    Mont64::g2_batch_makeaffine(points.data(), points.size());
+}
+
+void G2Mont64::batchNormalize(const std::vector<std::unique_ptr<G>>& elements) {
+    std::vector<Mont64::G2Point*> points;
+    for(const std::unique_ptr<G>& element : elements) {
+        points.push_back(&ref_cast<G2Mont64>(*element)._point);
+    }
+    Mont64::g2_batch_makeaffine(points.data(), points.size());
+}
+
+void G2Mont64::importObject(const void* obj) {
+    _point = *(const Mont64::G2Point*)obj;
+}
+
+void G2Mont64::exportObject(void* obj) const {
+    Mont64::g2_makeaffine(_point);
+    *(Mont64::G2Point*)obj = _point;
+}
+
+size_t G2Mont64::getSize() const {
+    return sizeof(_point);
+}
+
+char* G2Mont64::getByteBuffer() const {
+    Mont64::g2_makeaffine(_point);
+    return (char*)&_point;
+}
+
+Mont64::G2Point* G2Mont64::getUnderlyingObj() {
+    return &_point;
+}
+
+const Mont64::G2Point* G2Mont64::getUnderlyingObj() const {
+    return &_point;
+}
+
+//Points are written as their affine Montgomery-form limbs, in host byte order
+void G2Mont64::readFromFile(std::istream& inFile) {
+    std::byte bytes[sizeof(_point)];
+    if(inFile.read((char*)bytes, sizeof(bytes)) && !decode(bytes))
+        inFile.setstate(std::ios::failbit);
+}
+
+void G2Mont64::writeToFile(std::ostream& outFile) const {
+    Mont64::g2_makeaffine(_point);
+    outFile.write((char*)&_point, sizeof(_point));
+}
+
+size_t G2Mont64::getEncodedSize() const {
+    return sizeof(_point);
+}
+
+void G2Mont64::encode(std::byte* out) const {
+    Mont64::g2_makeaffine(_point);
+    memcpy(out, &_point, sizeof(_point));
+}
+
+bool G2Mont64::decode(const std::byte* in) {
+    return Mont64Backend::G2Ops::decode(_point, in);
+}
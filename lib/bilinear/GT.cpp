@@ -4,9 +4,20 @@
  */
 
 #include <bilinear/GT.hpp>
+#include <utils/MemoryAccounting.hpp>
 
 GT::GT(){
 }
 
 GT::~GT(){
 }
+
+void* GT::operator new(size_t size){
+	MEMORY_RECORD_ALLOCATION(size);
+	return ::operator new(size);
+}
+
+void GT::operator delete(void* ptr, size_t size){
+	MEMORY_RECORD_FREE(size);
+	::operator delete(ptr);
+}
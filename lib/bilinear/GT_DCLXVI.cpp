@@ -3,54 +3,107 @@
  *         May 18, 2011
  */
 
+#include <cstring>
+
+#include <bilinear/Backends.hpp>
 #include <bilinear/GT_DCLXVI.hpp>
+#include <bilinear/Mont64Curve.hpp>
+#include <bilinear/ScalarDecomposition.hpp>
 #include <utils/Pointers.hpp>
 
 GTDCLXVI::GTDCLXVI() {
 }
 
 GTDCLXVI::GTDCLXVI(const GTDCLXVI& other) {
-    fp12e_t eObj;
-    other.exportObject(eObj);
-    fp12e_set(_fp12e, eObj);
+    fp12e_set(_fp12e, other._fp12e);
 }
 
 GT& GTDCLXVI::operator=(const GT& other) {
-    if(this == &other) {
-        return *this;
-    } else {
-        GTDCLXVI* pGT = (GTDCLXVI*)&other;
-        fp12e_t eObj;
-        pGT->exportObject(eObj);
-        fp12e_set(_fp12e, eObj);
-        return *this;
-    }
+    if(this != &other)
+        fp12e_set(_fp12e, ref_cast<GTDCLXVI>(other)._fp12e);
+    return *this;
 }
 
 void GTDCLXVI::doMultiplication(const GT& other, GT& result) {
     const GTDCLXVI& otherGT = ref_cast<GTDCLXVI>(other);
-    fp12e_t op, rop;
-    otherGT.exportObject(op);
-    fp12e_mul(rop, _fp12e, op);
     GTDCLXVI& resultGT = ref_cast<GTDCLXVI>(result);
-    resultGT.importObject(rop);
+    fp12e_mul(resultGT._fp12e, _fp12e, otherGT._fp12e);
+}
+
+void GTDCLXVI::multiplyBy(const GT& other) {
+    fp12e_mul(_fp12e, _fp12e, ref_cast<GTDCLXVI>(other)._fp12e);
+}
+
+void GTDCLXVI::doSquare(GT& result) {
+    square(ref_cast<GTDCLXVI>(result)._fp12e, _fp12e);
+}
+
+//DCLXVI's own final exponentiation squares with Granger-Scott, which is valid
+//for anything in the cyclotomic subgroup, so for all of GT
+void GTDCLXVI::square(fp12e_struct_t* rop, const fp12e_struct_t* op) {
+    fp12e_special_square_finexp(rop, op);
+}
+
+namespace {
+
+const int POWER_WINDOW = 4;
+const int POWER_TABLE_SIZE = 1 << (POWER_WINDOW - 2);
+const int POWER_DIMENSION = 4;
+
+}  // anonymous namespace
+
+//GT elements come out of the pairing with order n, so x^p = x^(p mod n) and the
+//scalar splits into four ~64-bit parts exactly as on G2. They also lie in the
+//cyclotomic subgroup, where the inverse is just the (cheap) conjugate.
+void GTDCLXVI::power(fp12e_struct_t* rop, const fp12e_struct_t* op, const scalar_t scalar) {
+    ScalarDecomposition::Recoding recoding;
+    ScalarDecomposition::recode(scalar, ScalarDecomposition::FROBENIUS, POWER_WINDOW, recoding);
+    fp12e_struct_t table[POWER_DIMENSION][POWER_TABLE_SIZE];
+    fp12e_t squared;
+    fp12e_set(&table[0][0], op);
+    square(squared, op);
+    for(int i = 1; i < POWER_TABLE_SIZE; i++) {
+        fp12e_mul(&table[0][i], &table[0][i - 1], squared);
+    }
+    for(int part = 1; part < POWER_DIMENSION; part++) {
+        for(int i = 0; i < POWER_TABLE_SIZE; i++) {
+            fp12e_frobenius_p(&table[part][i], &table[part - 1][i]);
+        }
+    }
+    fp12e_t accumulator, inverted;
+    fp12e_setone(accumulator);
+    bool started = false;
+    for(int bit = recoding.length - 1; bit >= 0; bit--) {
+        if(started)
+            square(accumulator, accumulator);
+        for(int part = 0; part < POWER_DIMENSION; part++) {
+            int digit = recoding.digits[part][bit];
+            if(digit == 0)
+                continue;
+            const fp12e_struct_t* multiple = &table[part][(digit > 0 ? digit : -digit) / 2];
+            if(digit < 0) {
+                fp12e_conjugate(inverted, multiple);
+                multiple = inverted;
+            }
+            if(started) {
+                fp12e_mul(accumulator, accumulator, multiple);
+            } else {
+                fp12e_set(accumulator, multiple);
+                started = true;
+            }
+        }
+    }
+    fp12e_set(rop, accumulator);
 }
 
 void GTDCLXVI::doPower(const Scalar& scalar, GT& result) {
     const ScalarDCLXVI& pScalar = ref_cast<ScalarDCLXVI>(scalar);
-    scalar_t cScalar;
-    pScalar.exportObject(cScalar);
-    fp12e_t rop;
-    fp12e_pow_vartime(rop, _fp12e, cScalar);
     GTDCLXVI& pGT = ref_cast<GTDCLXVI>(result);
-    pGT.importObject(rop);
+    power(pGT._fp12e, _fp12e, pScalar.getUnderlyingObj());
 }
 
 int GTDCLXVI::isEqual(const GT& other) {
-    const GTDCLXVI& pGT = ref_cast<GTDCLXVI>(other);
-    fp12e_t eObj;
-    pGT.exportObject(eObj);
-    return fp12e_iseq(_fp12e, eObj);
+    return fp12e_iseq(_fp12e, ref_cast<GTDCLXVI>(other)._fp12e);
 }
 
 void GTDCLXVI::importObject(const void* obj) {
@@ -64,23 +117,75 @@ void GTDCLXVI::exportObject(void* obj) const {
 }
 
 void GTDCLXVI::readFromFile(std::istream& inFile) {
+    std::byte bytes[ENCODED_SIZE];
+    if(inFile.read((char*)bytes, ENCODED_SIZE) && !decode(bytes))
+        inFile.setstate(std::ios::failbit);
+}
+
+void GTDCLXVI::writeToFile(std::ostream& outFile) const {
+    std::byte bytes[ENCODED_SIZE];
+    encode(bytes, _fp12e);
+    outFile.write((const char*)bytes, ENCODED_SIZE);
+}
+
+size_t GTDCLXVI::getEncodedSize() const {
+    return ENCODED_SIZE;
+}
+
+void GTDCLXVI::encode(std::byte* out) const {
+    encode(out, _fp12e);
+}
+
+bool GTDCLXVI::decode(const std::byte* in) {
+    return DCLXVIBackend::GTOps::decode(*_fp12e, in);
+}
+
+//Like the points, the file format interleaves the six Fp2 coefficients double by double
+void GTDCLXVI::encode(std::byte* out, const fp12e_struct_t* element) {
+    const fp2e_struct_t* coefficients[6] = {element->m_a->m_a, element->m_a->m_b, element->m_a->m_c,
+                                            element->m_b->m_a, element->m_b->m_b, element->m_b->m_c};
     for(int i = 0; i < 24; i++) {
-        inFile.read((char*)&_fp12e->m_a->m_a->v[i], sizeof(mydouble));
-        inFile.read((char*)&_fp12e->m_a->m_b->v[i], sizeof(mydouble));
-        inFile.read((char*)&_fp12e->m_a->m_c->v[i], sizeof(mydouble));
-        inFile.read((char*)&_fp12e->m_b->m_a->v[i], sizeof(mydouble));
-        inFile.read((char*)&_fp12e->m_b->m_b->v[i], sizeof(mydouble));
-        inFile.read((char*)&_fp12e->m_b->m_c->v[i], sizeof(mydouble));
+        for(int j = 0; j < 6; j++) {
+            memcpy(out, &coefficients[j]->v[i], sizeof(mydouble));
+            out += sizeof(mydouble);
+        }
     }
 }
 
-void GTDCLXVI::writeToFile(std::ostream& outFile) const {
+void GTDCLXVI::decode(fp12e_struct_t* element, const std::byte* in) {
+    fp2e_struct_t* coefficients[6] = {element->m_a->m_a, element->m_a->m_b, element->m_a->m_c,
+                                      element->m_b->m_a, element->m_b->m_b, element->m_b->m_c};
     for(int i = 0; i < 24; i++) {
-        outFile.write((char*)&_fp12e->m_a->m_a->v[i], sizeof(mydouble));
-        outFile.write((char*)&_fp12e->m_a->m_b->v[i], sizeof(mydouble));
-        outFile.write((char*)&_fp12e->m_a->m_c->v[i], sizeof(mydouble));
-        outFile.write((char*)&_fp12e->m_b->m_a->v[i], sizeof(mydouble));
-        outFile.write((char*)&_fp12e->m_b->m_b->v[i], sizeof(mydouble));
-        outFile.write((char*)&_fp12e->m_b->m_c->v[i], sizeof(mydouble));
+        for(int j = 0; j < 6; j++) {
+            memcpy(&coefficients[j]->v[i], in, sizeof(mydouble));
+            in += sizeof(mydouble);
+        }
     }
 }
+
+//The encoding is defined on Mont64's canonical integers, so that both backends
+//read and write the same bytes
+void GTDCLXVI::compress(unsigned char* rop, const fp12e_struct_t* op) {
+    Mont64::Fp12 element;
+    Mont64::fp12_from_dclxvi(element, op);
+    Mont64::gt_compress(rop, element);
+}
+
+bool GTDCLXVI::decompress(fp12e_struct_t* rop, const unsigned char* op) {
+    Mont64::Fp12 element;
+    if(!Mont64::gt_decompress(element, op))
+        return false;
+    Mont64::fp12_to_dclxvi(rop, element);
+    return true;
+}
+
+bool GTDCLXVI::readCompressedFromFile(std::istream& inFile) {
+    unsigned char bytes[COMPRESSED_SIZE];
+    return inFile.read((char*)bytes, COMPRESSED_SIZE) && decompress(_fp12e, bytes);
+}
+
+void GTDCLXVI::writeCompressedToFile(std::ostream& outFile) const {
+    unsigned char bytes[COMPRESSED_SIZE];
+    compress(bytes, _fp12e);
+    outFile.write((char*)bytes, COMPRESSED_SIZE);
+}
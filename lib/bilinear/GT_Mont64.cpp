@@ -0,0 +1,98 @@
+/*
+ * GT_Mont64.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstring>
+
+#include <bilinear/Backends.hpp>
+#include <bilinear/GT_Mont64.hpp>
+#include <bilinear/Mont64Curve.hpp>
+#include <utils/Pointers.hpp>
+
+static_assert(GT::COMPRESSED_SIZE == Mont64::GT_COMPRESSED_BYTES, "GT's compressed encoding is Mont64's");
+
+GTMont64::GTMont64() {
+    Mont64::fp12_setone(_element);
+}
+
+GTMont64::GTMont64(const GTMont64& other) : _element(other._element) {
+}
+
+GTMont64::GTMont64(const GTDCLXVI& other) {
+    fp12e_t element;
+    other.exportObject(element);
+    Mont64::fp12_from_dclxvi(_element, element);
+}
+
+GT& GTMont64::operator=(const GT& other) {
+    if(this != &other)
+        _element = ref_cast<GTMont64>(other)._element;
+    return *this;
+}
+
+void GTMont64::doMultiplication(const GT& other, GT& result) {
+    const GTMont64& otherGT = ref_cast<GTMont64>(other);
+    GTMont64& resultGT = ref_cast<GTMont64>(result);
+    Mont64::fp12_mul(resultGT._element, _element, otherGT._element);
+}
+
+void GTMont64::multiplyBy(const GT& other) {
+    Mont64::fp12_mul(_element, _element, ref_cast<GTMont64>(other)._element);
+}
+
+void GTMont64::doSquare(GT& result) {
+    Mont64::fp12_cyclotomic_square(ref_cast<GTMont64>(result)._element, _element);
+}
+
+void GTMont64::doPower(const Scalar& scalar, GT& result) {
+    const ScalarDCLXVI& pScalar = ref_cast<ScalarDCLXVI>(scalar);
+    GTMont64& resultGT = ref_cast<GTMont64>(result);
+    Mont64::gt_pow(resultGT._element, _element, pScalar.getUnderlyingObj());
+}
+
+int GTMont64::isEqual(const GT& other) {
+    return Mont64::fp12_iseq(_element, ref_cast<GTMont64>(other)._element);
+}
+
+void GTMont64::importObject(const void* obj) {
+    _element = *(const Mont64::Fp12*)obj;
+}
+
+void GTMont64::exportObject(void* obj) const {
+    *(Mont64::Fp12*)obj = _element;
+}
+
+void GTMont64::readFromFile(std::istream& inFile) {
+    std::byte bytes[sizeof(_element)];
+    if(inFile.read((char*)bytes, sizeof(bytes)) && !decode(bytes))
+        inFile.setstate(std::ios::failbit);
+}
+
+void GTMont64::writeToFile(std::ostream& outFile) const {
+    outFile.write((char*)&_element, sizeof(_element));
+}
+
+size_t GTMont64::getEncodedSize() const {
+    return sizeof(_element);
+}
+
+void GTMont64::encode(std::byte* out) const {
+    memcpy(out, &_element, sizeof(_element));
+}
+
+bool GTMont64::decode(const std::byte* in) {
+    return Mont64Backend::GTOps::decode(_element, in);
+}
+
+bool GTMont64::readCompressedFromFile(std::istream& inFile) {
+    unsigned char bytes[COMPRESSED_SIZE];
+    return inFile.read((char*)bytes, COMPRESSED_SIZE) && Mont64::gt_decompress(_element, bytes);
+}
+
+void GTMont64::writeCompressedToFile(std::ostream& outFile) const {
+    unsigned char bytes[COMPRESSED_SIZE];
+    Mont64::gt_compress(bytes, _element);
+    outFile.write((char*)bytes, COMPRESSED_SIZE);
+}
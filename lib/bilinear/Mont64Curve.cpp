@@ -0,0 +1,622 @@
+/*
+ * Mont64Curve.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <vector>
+
+#include <gmp.h>
+
+#include <bilinear/Mont64Curve.hpp>
+#include <bilinear/ScalarDecomposition.hpp>
+
+extern const scalar_t bn_n;
+
+namespace Mont64 {
+
+namespace {
+
+//The generator of the twist, DCLXVI's bn_twistgen, in Montgomery form
+const Fp2 TWIST_GENERATOR_X = {
+        {{0x88f9f11da7cdc184ULL, 0x18293f95d69509d3ULL, 0xb5ce0c55a735d5a1ULL, 0x015134189bfd45a0ULL}},
+        {{0x402c4ab7139e1404ULL, 0xce1c368a183d85a4ULL, 0xd67cf9a6cb8d3983ULL, 0x3cf246bbc2a9fbe8ULL}}};
+const Fp2 TWIST_GENERATOR_Y = {
+        {{0xc2e07c1463ea9e56ULL, 0xee4442052072ebd2ULL, 0x561a519486036937ULL, 0x05bd9394cc0d2cceULL}},
+        {{0xbfac7d731e9e87a2ULL, 0xa50bb8007962e441ULL, 0xafe910a4e8270556ULL, 0x5075c5429d69159aULL}}};
+
+//wNAF windows, as for G1DCLXVI and G2DCLXVI
+const int G1_WINDOW = 5;
+const int G2_WINDOW = 4;
+const int MAX_TABLE_SIZE = 1 << (G1_WINDOW - 2);
+
+/*
+ * The point formulas are the same over Fp and Fp2, so they are written once
+ * as templates over the point type, on top of these overloads.
+ */
+inline void f_setzero(Fp& rop) { fp_setzero(rop); }
+inline void f_setzero(Fp2& rop) { fp2_setzero(rop); }
+inline void f_setone(Fp& rop) { fp_setone(rop); }
+inline void f_setone(Fp2& rop) { fp2_setone(rop); }
+inline bool f_iszero(const Fp& op) { return fp_iszero(op); }
+inline bool f_iszero(const Fp2& op) { return fp2_iszero(op); }
+inline bool f_iseq(const Fp& op1, const Fp& op2) { return fp_iseq(op1, op2); }
+inline bool f_iseq(const Fp2& op1, const Fp2& op2) { return fp2_iseq(op1, op2); }
+inline void f_add(Fp& rop, const Fp& op1, const Fp& op2) { fp_add(rop, op1, op2); }
+inline void f_add(Fp2& rop, const Fp2& op1, const Fp2& op2) { fp2_add(rop, op1, op2); }
+inline void f_sub(Fp& rop, const Fp& op1, const Fp& op2) { fp_sub(rop, op1, op2); }
+inline void f_sub(Fp2& rop, const Fp2& op1, const Fp2& op2) { fp2_sub(rop, op1, op2); }
+inline void f_neg(Fp& rop, const Fp& op) { fp_neg(rop, op); }
+inline void f_neg(Fp2& rop, const Fp2& op) { fp2_neg(rop, op); }
+inline void f_double(Fp& rop, const Fp& op) { fp_double(rop, op); }
+inline void f_double(Fp2& rop, const Fp2& op) { fp2_double(rop, op); }
+inline void f_mul(Fp& rop, const Fp& op1, const Fp& op2) { fp_mul(rop, op1, op2); }
+inline void f_mul(Fp2& rop, const Fp2& op1, const Fp2& op2) { fp2_mul(rop, op1, op2); }
+inline void f_square(Fp& rop, const Fp& op) { fp_square(rop, op); }
+inline void f_square(Fp2& rop, const Fp2& op) { fp2_square(rop, op); }
+inline void f_invert(Fp& rop, const Fp& op) { fp_invert(rop, op); }
+inline void f_invert(Fp2& rop, const Fp2& op) { fp2_invert(rop, op); }
+inline bool f_isreduced(const Fp& op) { return fp_isreduced(op); }
+inline bool f_isreduced(const Fp2& op) { return fp_isreduced(op.c0) && fp_isreduced(op.c1); }
+
+template <typename Point>
+void setIdentity(Point& rop) {
+    f_setone(rop.x);
+    f_setone(rop.y);
+    f_setzero(rop.z);
+}
+
+//dbl-2009-l from the Explicit-Formulas Database, for a = 0. The identity
+//(Z = 0) doubles to Z = 0 without a special case.
+template <typename Point>
+void doublePoint(Point& rop, const Point& op) {
+    typedef decltype(op.x) F;
+    F a, b, c, d, e, f, t;
+    f_square(a, op.x);
+    f_square(b, op.y);
+    f_square(c, b);
+    //d = 2((x + b)^2 - a - c)
+    f_add(d, op.x, b);
+    f_square(d, d);
+    f_sub(d, d, a);
+    f_sub(d, d, c);
+    f_double(d, d);
+    //e = 3a, f = e^2
+    f_double(e, a);
+    f_add(e, e, a);
+    f_square(f, e);
+    //z3 = 2yz, before y is overwritten
+    f_mul(t, op.y, op.z);
+    f_double(rop.z, t);
+    //x3 = f - 2d
+    f_double(t, d);
+    f_sub(rop.x, f, t);
+    //y3 = e(d - x3) - 8c
+    f_sub(t, d, rop.x);
+    f_mul(t, e, t);
+    f_double(c, c);
+    f_double(c, c);
+    f_double(c, c);
+    f_sub(rop.y, t, c);
+}
+
+//add-2007-bl, falling back to doubling when the points are equal
+template <typename Point>
+void addPoints(Point& rop, const Point& op1, const Point& op2) {
+    typedef decltype(op1.x) F;
+    if(f_iszero(op1.z)) {
+        rop = op2;
+        return;
+    }
+    if(f_iszero(op2.z)) {
+        rop = op1;
+        return;
+    }
+    F z1z1, z2z2, u1, u2, s1, s2, h, i, j, r, v, t;
+    f_square(z1z1, op1.z);
+    f_square(z2z2, op2.z);
+    f_mul(u1, op1.x, z2z2);
+    f_mul(u2, op2.x, z1z1);
+    f_mul(s1, op1.y, op2.z);
+    f_mul(s1, s1, z2z2);
+    f_mul(s2, op2.y, op1.z);
+    f_mul(s2, s2, z1z1);
+    f_sub(h, u2, u1);
+    f_sub(r, s2, s1);
+    if(f_iszero(h)) {
+        //Same x: either the same point, or inverses that sum to the identity
+        if(f_iszero(r))
+            doublePoint(rop, op1);
+        else
+            setIdentity(rop);
+        return;
+    }
+    f_double(r, r);
+    //i = (2h)^2, j = h*i, v = u1*i
+    f_double(i, h);
+    f_square(i, i);
+    f_mul(j, h, i);
+    f_mul(v, u1, i);
+    //z3 = ((z1 + z2)^2 - z1z1 - z2z2) * h, before z1 and z2 are overwritten
+    f_add(t, op1.z, op2.z);
+    f_square(t, t);
+    f_sub(t, t, z1z1);
+    f_sub(t, t, z2z2);
+    f_mul(rop.z, t, h);
+    //x3 = r^2 - j - 2v
+    f_square(t, r);
+    f_sub(t, t, j);
+    f_sub(t, t, v);
+    f_sub(rop.x, t, v);
+    //y3 = r(v - x3) - 2*s1*j
+    f_sub(t, v, rop.x);
+    f_mul(t, r, t);
+    f_mul(s1, s1, j);
+    f_double(s1, s1);
+    f_sub(rop.y, t, s1);
+}
+
+template <typename Point>
+void negatePoint(Point& rop, const Point& op) {
+    rop.x = op.x;
+    f_neg(rop.y, op.y);
+    rop.z = op.z;
+}
+
+//Compares X1*Z2^2 with X2*Z1^2 and Y1*Z2^3 with Y2*Z1^3 instead of inverting
+template <typename Point>
+bool pointsEqual(const Point& op1, const Point& op2) {
+    typedef decltype(op1.x) F;
+    bool identity1 = f_iszero(op1.z);
+    bool identity2 = f_iszero(op2.z);
+    if(identity1 || identity2)
+        return identity1 && identity2;
+    F z1Squared, z2Squared, lhs, rhs;
+    f_square(z1Squared, op1.z);
+    f_square(z2Squared, op2.z);
+    f_mul(lhs, op1.x, z2Squared);
+    f_mul(rhs, op2.x, z1Squared);
+    if(!f_iseq(lhs, rhs))
+        return false;
+    f_mul(lhs, op1.y, z2Squared);
+    f_mul(lhs, lhs, op2.z);
+    f_mul(rhs, op2.y, z1Squared);
+    f_mul(rhs, rhs, op1.z);
+    return f_iseq(lhs, rhs);
+}
+
+//Scales the point by the inverse of its Z coordinate
+template <typename Point, typename F>
+void scaleToAffine(Point& op, const F& zInverse) {
+    F zInverseSquared;
+    f_square(zInverseSquared, zInverse);
+    f_mul(op.x, op.x, zInverseSquared);
+    f_mul(op.y, op.y, zInverseSquared);
+    f_mul(op.y, op.y, zInverse);
+    f_setone(op.z);
+}
+
+template <typename Point>
+bool isAffine(const Point& op) {
+    typedef decltype(op.x) F;
+    F one;
+    f_setone(one);
+    return f_iszero(op.z) || f_iseq(op.z, one);
+}
+
+template <typename Point>
+void makeAffine(Point& op) {
+    typedef decltype(op.x) F;
+    if(isAffine(op))
+        return;
+    F zInverse;
+    f_invert(zInverse, op.z);
+    scaleToAffine(op, zInverse);
+}
+
+//Montgomery's trick, as in G1DCLXVI::batchNormalize
+template <typename Point>
+void batchMakeAffine(Point* const* points, size_t count) {
+    typedef decltype(points[0]->x) F;
+    std::vector<Point*> pending;
+    for(size_t i = 0; i < count; i++) {
+        if(!isAffine(*points[i]))
+            pending.push_back(points[i]);
+    }
+    if(pending.empty())
+        return;
+    std::vector<F> prefixProducts(pending.size());
+    prefixProducts[0] = pending[0]->z;
+    for(size_t i = 1; i < pending.size(); i++) {
+        f_mul(prefixProducts[i], prefixProducts[i - 1], pending[i]->z);
+    }
+    F inverse, zInverse;
+    f_invert(inverse, prefixProducts.back());
+    for(size_t i = pending.size(); i-- > 0;) {
+        if(i > 0) {
+            f_mul(zInverse, inverse, prefixProducts[i - 1]);
+            f_mul(inverse, inverse, pending[i]->z);
+        } else {
+            zInverse = inverse;
+        }
+        scaleToAffine(*pending[i], zInverse);
+    }
+}
+
+/**
+ * Whether op is in the form points are encoded in, with fully reduced
+ * coordinates, and either the identity or an affine point on y^2 = x^3 + b
+ */
+template <typename Point, typename F>
+bool isValidEncoding(const Point& op, const F& b) {
+    if(!f_isreduced(op.x) || !f_isreduced(op.y) || !f_isreduced(op.z) || !isAffine(op))
+        return false;
+    if(f_iszero(op.z))
+        return true;
+    F lhs, rhs;
+    f_square(lhs, op.y);
+    f_square(rhs, op.x);
+    f_mul(rhs, rhs, op.x);
+    f_add(rhs, rhs, b);
+    return f_iseq(lhs, rhs);
+}
+
+//Plain double-and-add by the group order, since the decompositions scalarMult uses assume op is in the group
+template <typename Point>
+bool hasOrderN(const Point& op) {
+    Point result;
+    setIdentity(result);
+    for(int bit = scalar_scanb(bn_n); bit >= 0; bit--) {
+        doublePoint(result, result);
+        if(scalar_getbit(bn_n, bit))
+            addPoints(result, result, op);
+    }
+    return f_iszero(result.z);
+}
+
+//b = 3 for G1
+const Fp& curveB() {
+    static const Fp b = [] {
+        Fp one, b;
+        fp_setone(one);
+        fp_add(b, one, one);
+        fp_add(b, b, one);
+        return b;
+    }();
+    return b;
+}
+
+//b' = 3/xi for the twist, with xi = i + 3
+const Fp2& twistB() {
+    static const Fp2 b = [] {
+        Fp2 three, xi, b;
+        fp2_setone(three);
+        fp2_triple(three, three);
+        xi = three;
+        fp_setone(xi.c1);
+        fp2_invert(b, xi);
+        fp2_mul(b, b, three);
+        return b;
+    }();
+    return b;
+}
+
+/**
+ * Interleaved wNAF multiplication over a decomposed scalar: one table of odd
+ * multiples of op per sub-scalar, each table the previous one with the
+ * endomorphism applied, and one shared double-and-add loop.
+ */
+template <typename Point>
+void scalarMult(Point& rop, const Point& op, const scalar_t scalar, ScalarDecomposition::Endomorphism endomorphism,
+                int window, void (*applyEndomorphism)(Point&, const Point&)) {
+    ScalarDecomposition::Recoding recoding;
+    ScalarDecomposition::recode(scalar, endomorphism, window, recoding);
+    const int tableSize = 1 << (window - 2);
+    Point table[ScalarDecomposition::MAX_DIMENSION][MAX_TABLE_SIZE];
+    Point twice;
+    table[0][0] = op;
+    doublePoint(twice, op);
+    for(int i = 1; i < tableSize; i++) {
+        addPoints(table[0][i], table[0][i - 1], twice);
+    }
+    for(int part = 1; part < recoding.dimension; part++) {
+        for(int i = 0; i < tableSize; i++) {
+            applyEndomorphism(table[part][i], table[part - 1][i]);
+        }
+    }
+    Point accumulator, negated;
+    setIdentity(accumulator);
+    bool started = false;
+    for(int bit = recoding.length - 1; bit >= 0; bit--) {
+        if(started)
+            doublePoint(accumulator, accumulator);
+        for(int part = 0; part < recoding.dimension; part++) {
+            int digit = recoding.digits[part][bit];
+            if(digit == 0)
+                continue;
+            const Point* multiple = &table[part][(digit > 0 ? digit : -digit) / 2];
+            if(digit < 0) {
+                negatePoint(negated, *multiple);
+                multiple = &negated;
+            }
+            if(started) {
+                addPoints(accumulator, accumulator, *multiple);
+            } else {
+                accumulator = *multiple;
+                started = true;
+            }
+        }
+    }
+    rop = accumulator;
+}
+
+//(x, y) -> (zeta*x, y); scaling X leaves Jacobian form intact
+void g1Endomorphism(G1Point& rop, const G1Point& op) {
+    fp_mul(rop.x, op.x, FROBENIUS_GAMMA2[1]);
+    rop.y = op.y;
+    rop.z = op.z;
+}
+
+//The untwist-Frobenius-twist endomorphism, (x, y) -> (conj(x)*z2p, conj(y)*z3p)
+void g2Endomorphism(G2Point& rop, const G2Point& op) {
+    fp2_conjugate(rop.x, op.x);
+    fp2_mul(rop.x, rop.x, FROBENIUS_GAMMA1[1]);
+    fp2_conjugate(rop.y, op.y);
+    fp2_mul(rop.y, rop.y, FROBENIUS_GAMMA1[2]);
+    fp2_conjugate(rop.z, op.z);
+}
+
+}  // anonymous namespace
+
+/*---------------------------------------G1-----------------------------------*/
+
+void g1_setgenerator(G1Point& rop) {
+    //(1, -2)
+    fp_setone(rop.x);
+    fp_double(rop.y, rop.x);
+    fp_neg(rop.y, rop.y);
+    fp_setone(rop.z);
+}
+
+void g1_setidentity(G1Point& rop) {
+    setIdentity(rop);
+}
+
+bool g1_isidentity(const G1Point& op) {
+    return fp_iszero(op.z);
+}
+
+bool g1_iseq(const G1Point& op1, const G1Point& op2) {
+    return pointsEqual(op1, op2);
+}
+
+void g1_double(G1Point& rop, const G1Point& op) {
+    doublePoint(rop, op);
+}
+
+void g1_add(G1Point& rop, const G1Point& op1, const G1Point& op2) {
+    addPoints(rop, op1, op2);
+}
+
+void g1_neg(G1Point& rop, const G1Point& op) {
+    negatePoint(rop, op);
+}
+
+void g1_scalarmult(G1Point& rop, const G1Point& op, const scalar_t scalar) {
+    scalarMult(rop, op, scalar, ScalarDecomposition::GLV, G1_WINDOW, g1Endomorphism);
+}
+
+void g1_makeaffine(G1Point& op) {
+    makeAffine(op);
+}
+
+void g1_batch_makeaffine(G1Point* const* points, size_t count) {
+    batchMakeAffine(points, count);
+}
+
+bool g1_isvalid(const G1Point& op) {
+    return isValidEncoding(op, curveB());
+}
+
+/*---------------------------------------G2-----------------------------------*/
+
+void g2_setgenerator(G2Point& rop) {
+    rop.x = TWIST_GENERATOR_X;
+    rop.y = TWIST_GENERATOR_Y;
+    fp2_setone(rop.z);
+}
+
+void g2_setidentity(G2Point& rop) {
+    setIdentity(rop);
+}
+
+bool g2_isidentity(const G2Point& op) {
+    return fp2_iszero(op.z);
+}
+
+bool g2_iseq(const G2Point& op1, const G2Point& op2) {
+    return pointsEqual(op1, op2);
+}
+
+void g2_double(G2Point& rop, const G2Point& op) {
+    doublePoint(rop, op);
+}
+
+void g2_add(G2Point& rop, const G2Point& op1, const G2Point& op2) {
+    addPoints(rop, op1, op2);
+}
+
+void g2_neg(G2Point& rop, const G2Point& op) {
+    negatePoint(rop, op);
+}
+
+void g2_scalarmult(G2Point& rop, const G2Point& op, const scalar_t scalar) {
+    scalarMult(rop, op, scalar, ScalarDecomposition::FROBENIUS, G2_WINDOW, g2Endomorphism);
+}
+
+void g2_makeaffine(G2Point& op) {
+    makeAffine(op);
+}
+
+void g2_batch_makeaffine(G2Point* const* points, size_t count) {
+    batchMakeAffine(points, count);
+}
+
+bool g2_isvalid(const G2Point& op) {
+    return isValidEncoding(op, twistB()) && hasOrderN(op);
+}
+
+/*-----------------------------Conversions to DCLXVI--------------------------*/
+
+namespace {
+
+/*
+ * DCLXVI stores an element of Fp as twelve integer-valued doubles, the
+ * coefficients of a polynomial in v = 1868033 with weights
+ *   1, 6v, 6v^2, ..., 6v^6, 36v^7, ..., 36v^11
+ * so a value converts through GMP as a mixed-radix number.
+ */
+class DoubleRepresentation {
+public:
+    mpz_t weights[12];
+    mpz_t radices[11];
+    mpz_t modulus;
+
+    DoubleRepresentation() {
+        const unsigned long v = 1868033;
+        mpz_init_set_ui(weights[0], 1);
+        for(int i = 1; i < 12; i++) {
+            mpz_init(weights[i]);
+            mpz_ui_pow_ui(weights[i], v, i);
+            mpz_mul_ui(weights[i], weights[i], i < 7 ? 6 : 36);
+        }
+        for(int i = 0; i < 11; i++) {
+            mpz_init(radices[i]);
+            mpz_divexact(radices[i], weights[i + 1], weights[i]);
+        }
+        mpz_init(modulus);
+        fp_modulus(modulus);
+    }
+    ~DoubleRepresentation() {
+        for(int i = 0; i < 12; i++) {
+            mpz_clear(weights[i]);
+        }
+        for(int i = 0; i < 11; i++) {
+            mpz_clear(radices[i]);
+        }
+        mpz_clear(modulus);
+    }
+};
+
+const DoubleRepresentation& getDoubleRepresentation() {
+    static const DoubleRepresentation representation;
+    return representation;
+}
+
+}  // anonymous namespace
+
+void fp_from_dclxvi(Fp& rop, const fpe_t op) {
+    const DoubleRepresentation& representation = getDoubleRepresentation();
+    mpz_t value, term;
+    mpz_init(value);
+    mpz_init(term);
+    for(int i = 0; i < 12; i++) {
+        mpz_set_d(term, op->v[i]);
+        mpz_addmul(value, term, representation.weights[i]);
+    }
+    mpz_mod(value, value, representation.modulus);
+    fp_from_mpz(rop, value);
+    mpz_clear(value);
+    mpz_clear(term);
+}
+
+//Writes the value with balanced digits, the way DCLXVI keeps reduced elements
+void fp_to_dclxvi(fpe_t rop, const Fp& op) {
+    const DoubleRepresentation& representation = getDoubleRepresentation();
+    mpz_t value, digit, halfRadix;
+    mpz_init(value);
+    mpz_init(digit);
+    mpz_init(halfRadix);
+    fp_to_mpz(value, op);
+    //Values above p/2 are written as value - p, which keeps the top digit small
+    mpz_tdiv_q_2exp(halfRadix, representation.modulus, 1);
+    if(mpz_cmp(value, halfRadix) > 0)
+        mpz_sub(value, value, representation.modulus);
+    mydouble coefficients[12];
+    for(int i = 0; i < 11; i++) {
+        mpz_fdiv_r(digit, value, representation.radices[i]);
+        mpz_tdiv_q_2exp(halfRadix, representation.radices[i], 1);
+        if(mpz_cmp(digit, halfRadix) >= 0)
+            mpz_sub(digit, digit, representation.radices[i]);
+        mpz_sub(value, value, digit);
+        mpz_divexact(value, value, representation.radices[i]);
+        coefficients[i] = (double)mpz_get_si(digit);
+    }
+    coefficients[11] = (double)mpz_get_si(value);
+    fpe_set_doublearray(rop, coefficients);
+    mpz_clear(value);
+    mpz_clear(digit);
+    mpz_clear(halfRadix);
+}
+
+//DCLXVI's fp2e holds a*i + b as (a, b)
+void fp2_from_dclxvi(Fp2& rop, const fp2e_t op) {
+    fpe_t a, b;
+    fp2e_to_2fpe(a, b, op);
+    fp_from_dclxvi(rop.c0, b);
+    fp_from_dclxvi(rop.c1, a);
+}
+
+void fp2_to_dclxvi(fp2e_t rop, const Fp2& op) {
+    fpe_t a, b;
+    fp_to_dclxvi(a, op.c1);
+    fp_to_dclxvi(b, op.c0);
+    _2fpe_to_fp2e(rop, a, b);
+}
+
+//DCLXVI's fp12e is m_a*w + m_b, and its fp6e is m_a*v^2 + m_b*v + m_c
+void fp12_from_dclxvi(Fp12& rop, const fp12e_t op) {
+    fp2_from_dclxvi(rop.c0.c0, op->m_b->m_c);
+    fp2_from_dclxvi(rop.c0.c1, op->m_b->m_b);
+    fp2_from_dclxvi(rop.c0.c2, op->m_b->m_a);
+    fp2_from_dclxvi(rop.c1.c0, op->m_a->m_c);
+    fp2_from_dclxvi(rop.c1.c1, op->m_a->m_b);
+    fp2_from_dclxvi(rop.c1.c2, op->m_a->m_a);
+}
+
+void fp12_to_dclxvi(fp12e_t rop, const Fp12& op) {
+    fp2_to_dclxvi(rop->m_b->m_c, op.c0.c0);
+    fp2_to_dclxvi(rop->m_b->m_b, op.c0.c1);
+    fp2_to_dclxvi(rop->m_b->m_a, op.c0.c2);
+    fp2_to_dclxvi(rop->m_a->m_c, op.c1.c0);
+    fp2_to_dclxvi(rop->m_a->m_b, op.c1.c1);
+    fp2_to_dclxvi(rop->m_a->m_a, op.c1.c2);
+}
+
+void g1_from_dclxvi(G1Point& rop, const curvepoint_fp_t op) {
+    fp_from_dclxvi(rop.x, op->m_x);
+    fp_from_dclxvi(rop.y, op->m_y);
+    fp_from_dclxvi(rop.z, op->m_z);
+}
+
+void g1_to_dclxvi(curvepoint_fp_t rop, const G1Point& op) {
+    fp_to_dclxvi(rop->m_x, op.x);
+    fp_to_dclxvi(rop->m_y, op.y);
+    fp_to_dclxvi(rop->m_z, op.z);
+    fpe_setzero(rop->m_t);
+}
+
+void g2_from_dclxvi(G2Point& rop, const twistpoint_fp2_t op) {
+    fp2_from_dclxvi(rop.x, op->m_x);
+    fp2_from_dclxvi(rop.y, op->m_y);
+    fp2_from_dclxvi(rop.z, op->m_z);
+}
+
+void g2_to_dclxvi(twistpoint_fp2_t rop, const G2Point& op) {
+    fp2_to_dclxvi(rop->m_x, op.x);
+    fp2_to_dclxvi(rop->m_y, op.y);
+    fp2_to_dclxvi(rop->m_z, op.z);
+    fp2e_setzero(rop->m_t);
+}
+
+}  // namespace Mont64
@@ -0,0 +1,777 @@
+/*
+ * Mont64Field.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <atomic>
+
+#include <bilinear/Mont64Field.hpp>
+#include <utils/CpuDispatch.hpp>
+
+//The carry-chain intrinsics; like DCLXVI, this code is for x86-64 only
+#include <x86intrin.h>
+
+namespace Mont64 {
+
+namespace {
+
+typedef unsigned __int128 uint128_t;
+//The limb type the carry intrinsics take, which is not the same type as uint64_t
+typedef unsigned long long limb_t;
+
+//p = 36u^4 + 36u^3 + 24u^2 + 6u + 1 for u = 1868033^3, little-endian limbs
+const uint64_t P[4] = {0x185cac6c5e089667ULL, 0xee5b88d120b5b59eULL, 0xaa6fecb86184dc21ULL, 0x8fb501e34aa387f9ULL};
+//-p^-1 mod 2^64
+const uint64_t P_INV = 0x2387f9007f17daa9ULL;
+//R^2 mod p, to convert into Montgomery form
+const Fp R_SQUARED = {{0x9c21c3ff7e444f56ULL, 0x409ed151b2efb0c2ULL, 0x0c6dc37b80fb1651ULL, 0x7c36e0e62c2380b7ULL}};
+//R mod p, which is 1 in Montgomery form
+const Fp ONE = {{0xe7a35393a1f76999ULL, 0x11a4772edf4a4a61ULL, 0x559013479e7b23deULL, 0x704afe1cb55c7806ULL}};
+//p - 2, the exponent that inverts by Fermat's little theorem
+const uint64_t P_MINUS_2[4] = {0x185cac6c5e089665ULL, 0xee5b88d120b5b59eULL, 0xaa6fecb86184dc21ULL, 0x8fb501e34aa387f9ULL};
+
+//p is a full 256 bits, so sums can carry out of the top limb and every
+//result is brought back below p with one conditional subtraction
+
+//rop = s - p if carry is set or s >= p, else s. Branch-free, since for random
+//operands the outcome is a coin flip the branch predictor can't learn. The
+//limbs are passed as scalars so they stay in registers.
+inline void reduceOnce(uint64_t* rop, limb_t s0, limb_t s1, limb_t s2, limb_t s3, unsigned char carry) {
+    limb_t r0, r1, r2, r3;
+    unsigned char borrow = _subborrow_u64(0, s0, P[0], &r0);
+    borrow = _subborrow_u64(borrow, s1, P[1], &r1);
+    borrow = _subborrow_u64(borrow, s2, P[2], &r2);
+    borrow = _subborrow_u64(borrow, s3, P[3], &r3);
+    //Keep s only if the subtraction went negative with no carry to absorb it
+    bool keep = borrow & (carry ^ 1);
+    rop[0] = keep ? s0 : r0;
+    rop[1] = keep ? s1 : r1;
+    rop[2] = keep ? s2 : r2;
+    rop[3] = keep ? s3 : r3;
+}
+
+/*
+ * CIOS Montgomery multiplication, one round per limb of b: t += a*b[i], then
+ * t += m*p with m chosen to zero the low limb, then shift t down a limb. p
+ * uses all 256 bits, so t needs a fifth limb (which stays 0 or 1) and the
+ * result is below 2p until the final conditional subtraction.
+ */
+
+//(hi, lo) of a*b; with BMI2 enabled the compiler emits mulx, which leaves the flags alone for the carry chains
+inline limb_t mulWide(limb_t a, limb_t b, limb_t& hi) {
+    uint128_t product = (uint128_t)a * b;
+    hi = (limb_t)(product >> 64);
+    return (limb_t)product;
+}
+
+//t0..t4 += (x0..x3 at offset 0) + (h0..h3 at offset 1), the two halves of a 4x1 limb product
+inline void addProduct(limb_t& t0, limb_t& t1, limb_t& t2, limb_t& t3, limb_t& t4, limb_t& t5,
+                       limb_t x0, limb_t x1, limb_t x2, limb_t x3, limb_t h0, limb_t h1, limb_t h2, limb_t h3) {
+    unsigned char carry = _addcarry_u64(0, t0, x0, &t0);
+    carry = _addcarry_u64(carry, t1, x1, &t1);
+    carry = _addcarry_u64(carry, t2, x2, &t2);
+    carry = _addcarry_u64(carry, t3, x3, &t3);
+    carry = _addcarry_u64(carry, t4, 0, &t4);
+    t5 += carry;
+    carry = _addcarry_u64(0, t1, h0, &t1);
+    carry = _addcarry_u64(carry, t2, h1, &t2);
+    carry = _addcarry_u64(carry, t3, h2, &t3);
+    carry = _addcarry_u64(carry, t4, h3, &t4);
+    t5 += carry;
+}
+
+inline void montMul(uint64_t* rop, const uint64_t* a, const uint64_t* b) {
+    const limb_t a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3];
+    limb_t t0 = 0, t1 = 0, t2 = 0, t3 = 0, t4 = 0;
+    for(int i = 0; i < 4; i++) {
+        limb_t t5 = 0;
+        limb_t h0, h1, h2, h3;
+        limb_t x0 = mulWide(a0, b[i], h0);
+        limb_t x1 = mulWide(a1, b[i], h1);
+        limb_t x2 = mulWide(a2, b[i], h2);
+        limb_t x3 = mulWide(a3, b[i], h3);
+        addProduct(t0, t1, t2, t3, t4, t5, x0, x1, x2, x3, h0, h1, h2, h3);
+        limb_t m = t0 * P_INV;
+        x0 = mulWide(m, P[0], h0);
+        x1 = mulWide(m, P[1], h1);
+        x2 = mulWide(m, P[2], h2);
+        x3 = mulWide(m, P[3], h3);
+        addProduct(t0, t1, t2, t3, t4, t5, x0, x1, x2, x3, h0, h1, h2, h3);
+        //t0 is now 0
+        t0 = t1;
+        t1 = t2;
+        t2 = t3;
+        t3 = t4;
+        t4 = t5;
+    }
+    reduceOnce(rop, t0, t1, t2, t3, (unsigned char)t4);
+}
+
+/*
+ * The MulKernel implementations are montMul compiled for different targets.
+ * fp_mul calls through mulFunction, which starts out as a resolver that
+ * installs the preferred supported kernel on first use.
+ */
+
+typedef void (*MulFunction)(uint64_t* rop, const uint64_t* a, const uint64_t* b);
+
+__attribute__((target("bmi2,adx"))) void montMulBmi2Adx(uint64_t* rop, const uint64_t* a, const uint64_t* b) {
+    montMul(rop, a, b);
+}
+
+void montMulPortable(uint64_t* rop, const uint64_t* a, const uint64_t* b) {
+    montMul(rop, a, b);
+}
+
+const MulFunction MUL_FUNCTIONS[NUM_MUL_KERNELS] = {montMulBmi2Adx, montMulPortable};
+
+void resolveMul(uint64_t* rop, const uint64_t* a, const uint64_t* b);
+
+std::atomic<MulFunction> mulFunction(resolveMul);
+std::atomic<MulKernel> mulKernel(MUL_PORTABLE);
+
+void resolveMul(uint64_t* rop, const uint64_t* a, const uint64_t* b) {
+    for(int kernel = 0; kernel < NUM_MUL_KERNELS; kernel++) {
+        if(isSupported((MulKernel)kernel)) {
+            setMulKernel((MulKernel)kernel);
+            break;
+        }
+    }
+    mulFunction.load(std::memory_order_relaxed)(rop, a, b);
+}
+
+}  // anonymous namespace
+
+//xi^(k(p-1)/6) for k = 1..5, the factors the p-power Frobenius picks up on w^k
+const Fp2 FROBENIUS_GAMMA1[5] = {
+        {{{0x7407634dd9cca958ULL, 0x36d5bd6c7afb8f26ULL, 0xf4b1c32cebd880faULL, 0x06aa7869306f455fULL}},
+         {{0x25af52988477cdb7ULL, 0x3d81a455ddced86aULL, 0x227d012e872c2431ULL, 0x0179198d3ea65d05ULL}}},
+        {{{0xf8606916d3816f2cULL, 0x1e5c0d7926de927eULL, 0xbc45f3946d81185eULL, 0x80752a25aa738091ULL}},
+         {{0x4f59e37c01832e57ULL, 0xae6be39ac2bbbfe4ULL, 0xe04ea1bb697512f8ULL, 0x3097caa8fc40e10eULL}}},
+        {{{0x18dbee03fb7708faULL, 0x1e7601a602c843c7ULL, 0x5dde0688cdb231cbULL, 0x86db5cf2c605a524ULL}},
+         {{0x19da71333653ee20ULL, 0x7eaaf34fc6ed6019ULL, 0xc4ba3a29a60cdd1dULL, 0x75281311bcc9df79ULL}}},
+        {{{0x4d2ea218872f3d2cULL, 0x2fcb27fc4abe7b69ULL, 0xd31d972f0e88ced9ULL, 0x53adc04a00a73b15ULL}},
+         {{0x51678e7469b3c52aULL, 0x4fb98f8b13319fc9ULL, 0x29b2254db3f1df75ULL, 0x1c044935a3d22fb2ULL}}},
+        {{{0x6d2172b89027089cULL, 0x262c0ececead6206ULL, 0x9e0fbb045c9fe1baULL, 0x185f6ecc4c76fc78ULL}},
+         {{0xe2c023050dcfc5a1ULL, 0x8a6499cb8ad34b1aULL, 0x0a6877ec313e9134ULL, 0x8f2bb3af6e8fc223ULL}}}};
+//xi^(k(p^2-1)/6) for k = 1..5, which all lie in Fp
+const Fp FROBENIUS_GAMMA2[5] = {
+        {{0xe21a761d259c78afULL, 0x06358fa3f5e84f7eULL, 0xb7c444d01ac33f0dULL, 0x35a9333f6e50d058ULL}},
+        {{0x12d3cef5e1ada57dULL, 0xe2eca1463753babbULL, 0x0ca41e40ddccf750ULL, 0x551337060397e04cULL}},
+        {{0x30b958d8bc112cceULL, 0xdcb711a2416b6b3cULL, 0x54dfd970c309b843ULL, 0x1f6a03c695470ff3ULL}},
+        {{0x3642364f386c1db8ULL, 0xe825f92d2acd661fULL, 0xf2aba7e846c19d14ULL, 0x5a0bcea3dc52b7a0ULL}},
+        {{0x0588dd767c5af0eaULL, 0x0b6ee78ae961fae3ULL, 0x9dcbce7783b7e4d1ULL, 0x3aa1cadd470ba7adULL}}};
+
+/*---------------------------------------Fp-----------------------------------*/
+
+void fp_setzero(Fp& rop) {
+    for(int i = 0; i < 4; i++) {
+        rop.v[i] = 0;
+    }
+}
+
+void fp_setone(Fp& rop) {
+    rop = ONE;
+}
+
+bool fp_iszero(const Fp& op) {
+    return (op.v[0] | op.v[1] | op.v[2] | op.v[3]) == 0;
+}
+
+bool fp_iseq(const Fp& op1, const Fp& op2) {
+    return ((op1.v[0] ^ op2.v[0]) | (op1.v[1] ^ op2.v[1]) | (op1.v[2] ^ op2.v[2]) | (op1.v[3] ^ op2.v[3])) == 0;
+}
+
+bool fp_isreduced(const Fp& op) {
+    for(int i = 3; i >= 0; i--) {
+        if(op.v[i] != P[i])
+            return op.v[i] < P[i];
+    }
+    return false;
+}
+
+void fp_add(Fp& rop, const Fp& op1, const Fp& op2) {
+    limb_t s0, s1, s2, s3;
+    unsigned char carry = _addcarry_u64(0, op1.v[0], op2.v[0], &s0);
+    carry = _addcarry_u64(carry, op1.v[1], op2.v[1], &s1);
+    carry = _addcarry_u64(carry, op1.v[2], op2.v[2], &s2);
+    carry = _addcarry_u64(carry, op1.v[3], op2.v[3], &s3);
+    reduceOnce(rop.v, s0, s1, s2, s3, carry);
+}
+
+void fp_sub(Fp& rop, const Fp& op1, const Fp& op2) {
+    limb_t d0, d1, d2, d3;
+    unsigned char borrow = _subborrow_u64(0, op1.v[0], op2.v[0], &d0);
+    borrow = _subborrow_u64(borrow, op1.v[1], op2.v[1], &d1);
+    borrow = _subborrow_u64(borrow, op1.v[2], op2.v[2], &d2);
+    borrow = _subborrow_u64(borrow, op1.v[3], op2.v[3], &d3);
+    //Add p back if it went negative
+    uint64_t mask = 0 - (uint64_t)borrow;
+    unsigned char carry = _addcarry_u64(0, d0, P[0] & mask, &d0);
+    carry = _addcarry_u64(carry, d1, P[1] & mask, &d1);
+    carry = _addcarry_u64(carry, d2, P[2] & mask, &d2);
+    _addcarry_u64(carry, d3, P[3] & mask, &d3);
+    rop.v[0] = d0;
+    rop.v[1] = d1;
+    rop.v[2] = d2;
+    rop.v[3] = d3;
+}
+
+void fp_neg(Fp& rop, const Fp& op) {
+    Fp zero;
+    fp_setzero(zero);
+    fp_sub(rop, zero, op);
+}
+
+void fp_double(Fp& rop, const Fp& op) {
+    fp_add(rop, op, op);
+}
+
+void fp_half(Fp& rop, const Fp& op) {
+    //Make the value even by adding p if needed, then shift the 257-bit sum
+    uint64_t mask = 0 - (op.v[0] & 1);
+    limb_t s0, s1, s2, s3;
+    unsigned char carry = _addcarry_u64(0, op.v[0], P[0] & mask, &s0);
+    carry = _addcarry_u64(carry, op.v[1], P[1] & mask, &s1);
+    carry = _addcarry_u64(carry, op.v[2], P[2] & mask, &s2);
+    carry = _addcarry_u64(carry, op.v[3], P[3] & mask, &s3);
+    rop.v[0] = (s0 >> 1) | (s1 << 63);
+    rop.v[1] = (s1 >> 1) | (s2 << 63);
+    rop.v[2] = (s2 >> 1) | (s3 << 63);
+    rop.v[3] = (s3 >> 1) | ((uint64_t)carry << 63);
+}
+
+void fp_mul(Fp& rop, const Fp& op1, const Fp& op2) {
+    mulFunction.load(std::memory_order_relaxed)(rop.v, op1.v, op2.v);
+}
+
+void fp_square(Fp& rop, const Fp& op) {
+    mulFunction.load(std::memory_order_relaxed)(rop.v, op.v, op.v);
+}
+
+void fp_invert(Fp& rop, const Fp& op) {
+    Fp result = ONE;
+    for(int bit = 255; bit >= 0; bit--) {
+        fp_square(result, result);
+        if((P_MINUS_2[bit / 64] >> (bit % 64)) & 1)
+            fp_mul(result, result, op);
+    }
+    rop = result;
+}
+
+void fp_from_mpz(Fp& rop, const mpz_t op) {
+    Fp plain;
+    fp_setzero(plain);
+    mpz_export(plain.v, NULL, -1, sizeof(plain.v[0]), 0, 0, op);
+    montMul(rop.v, plain.v, R_SQUARED.v);
+}
+
+void fp_to_mpz(mpz_t rop, const Fp& op) {
+    const uint64_t one[4] = {1, 0, 0, 0};
+    uint64_t plain[4];
+    montMul(plain, op.v, one);
+    mpz_import(rop, 4, -1, sizeof(plain[0]), 0, 0, plain);
+}
+
+void fp_to_bytes(unsigned char* rop, const Fp& op) {
+    const uint64_t one[4] = {1, 0, 0, 0};
+    uint64_t plain[4];
+    montMul(plain, op.v, one);
+    for(size_t i = 0; i < FP_BYTES; i++) {
+        rop[FP_BYTES - 1 - i] = (unsigned char)(plain[i / 8] >> (8 * (i % 8)));
+    }
+}
+
+bool fp_from_bytes(Fp& rop, const unsigned char* op) {
+    Fp plain;
+    fp_setzero(plain);
+    for(size_t i = 0; i < FP_BYTES; i++) {
+        plain.v[i / 8] |= (uint64_t)op[FP_BYTES - 1 - i] << (8 * (i % 8));
+    }
+    //Only the canonical encoding, below p, is accepted
+    if(!fp_isreduced(plain))
+        return false;
+    montMul(rop.v, plain.v, R_SQUARED.v);
+    return true;
+}
+
+void fp_modulus(mpz_t rop) {
+    mpz_import(rop, 4, -1, sizeof(P[0]), 0, 0, P);
+}
+
+/*-------------------------------Kernel selection-----------------------------*/
+
+const char* getMulKernelName(MulKernel kernel) {
+    return kernel == MUL_BMI2_ADX ? "bmi2-adx" : "portable";
+}
+
+bool isSupported(MulKernel kernel) {
+    const CpuDispatch::Features& features = CpuDispatch::getFeatures();
+    return kernel == MUL_PORTABLE || (features.bmi2 && features.adx);
+}
+
+MulKernel getMulKernel() {
+    //Make sure the resolver has run, so this reports the kernel actually in use
+    if(mulFunction.load() == resolveMul) {
+        Fp product;
+        fp_mul(product, ONE, ONE);
+    }
+    return mulKernel.load();
+}
+
+void setMulKernel(MulKernel kernel) {
+    mulKernel.store(kernel);
+    mulFunction.store(MUL_FUNCTIONS[kernel]);
+}
+
+/*---------------------------------------Fp2----------------------------------*/
+
+void fp2_setzero(Fp2& rop) {
+    fp_setzero(rop.c0);
+    fp_setzero(rop.c1);
+}
+
+void fp2_setone(Fp2& rop) {
+    fp_setone(rop.c0);
+    fp_setzero(rop.c1);
+}
+
+bool fp2_iszero(const Fp2& op) {
+    return fp_iszero(op.c0) && fp_iszero(op.c1);
+}
+
+bool fp2_isone(const Fp2& op) {
+    return fp_iseq(op.c0, ONE) && fp_iszero(op.c1);
+}
+
+bool fp2_iseq(const Fp2& op1, const Fp2& op2) {
+    return fp_iseq(op1.c0, op2.c0) && fp_iseq(op1.c1, op2.c1);
+}
+
+void fp2_add(Fp2& rop, const Fp2& op1, const Fp2& op2) {
+    fp_add(rop.c0, op1.c0, op2.c0);
+    fp_add(rop.c1, op1.c1, op2.c1);
+}
+
+void fp2_sub(Fp2& rop, const Fp2& op1, const Fp2& op2) {
+    fp_sub(rop.c0, op1.c0, op2.c0);
+    fp_sub(rop.c1, op1.c1, op2.c1);
+}
+
+void fp2_neg(Fp2& rop, const Fp2& op) {
+    fp_neg(rop.c0, op.c0);
+    fp_neg(rop.c1, op.c1);
+}
+
+void fp2_double(Fp2& rop, const Fp2& op) {
+    fp_double(rop.c0, op.c0);
+    fp_double(rop.c1, op.c1);
+}
+
+void fp2_triple(Fp2& rop, const Fp2& op) {
+    Fp2 doubled;
+    fp2_double(doubled, op);
+    fp2_add(rop, doubled, op);
+}
+
+void fp2_conjugate(Fp2& rop, const Fp2& op) {
+    rop.c0 = op.c0;
+    fp_neg(rop.c1, op.c1);
+}
+
+//Karatsuba: three base field multiplications instead of four
+void fp2_mul(Fp2& rop, const Fp2& op1, const Fp2& op2) {
+    Fp t0, t1, s0, s1;
+    fp_mul(t0, op1.c0, op2.c0);
+    fp_mul(t1, op1.c1, op2.c1);
+    fp_add(s0, op1.c0, op1.c1);
+    fp_add(s1, op2.c0, op2.c1);
+    fp_mul(s0, s0, s1);
+    fp_sub(s0, s0, t0);
+    fp_sub(rop.c1, s0, t1);
+    fp_sub(rop.c0, t0, t1);
+}
+
+void fp2_mul_fp(Fp2& rop, const Fp2& op1, const Fp& op2) {
+    fp_mul(rop.c0, op1.c0, op2);
+    fp_mul(rop.c1, op1.c1, op2);
+}
+
+//(a + bi)^2 = (a + b)(a - b) + 2abi
+void fp2_square(Fp2& rop, const Fp2& op) {
+    Fp sum, diff, product;
+    fp_add(sum, op.c0, op.c1);
+    fp_sub(diff, op.c0, op.c1);
+    fp_mul(product, op.c0, op.c1);
+    fp_mul(rop.c0, sum, diff);
+    fp_double(rop.c1, product);
+}
+
+//(a + bi)(3 + i) = (3a - b) + (a + 3b)i
+void fp2_mulxi(Fp2& rop, const Fp2& op) {
+    Fp a3, b3, c0;
+    fp_double(a3, op.c0);
+    fp_add(a3, a3, op.c0);
+    fp_double(b3, op.c1);
+    fp_add(b3, b3, op.c1);
+    fp_sub(c0, a3, op.c1);
+    fp_add(rop.c1, op.c0, b3);
+    rop.c0 = c0;
+}
+
+void fp2_invert(Fp2& rop, const Fp2& op) {
+    Fp norm, t;
+    fp_square(norm, op.c0);
+    fp_square(t, op.c1);
+    fp_add(norm, norm, t);
+    fp_invert(norm, norm);
+    fp_mul(rop.c0, op.c0, norm);
+    fp_mul(t, op.c1, norm);
+    fp_neg(rop.c1, t);
+}
+
+/*---------------------------------------Fp6----------------------------------*/
+
+void fp6_setzero(Fp6& rop) {
+    fp2_setzero(rop.c0);
+    fp2_setzero(rop.c1);
+    fp2_setzero(rop.c2);
+}
+
+void fp6_setone(Fp6& rop) {
+    fp2_setone(rop.c0);
+    fp2_setzero(rop.c1);
+    fp2_setzero(rop.c2);
+}
+
+bool fp6_iseq(const Fp6& op1, const Fp6& op2) {
+    return fp2_iseq(op1.c0, op2.c0) && fp2_iseq(op1.c1, op2.c1) && fp2_iseq(op1.c2, op2.c2);
+}
+
+void fp6_add(Fp6& rop, const Fp6& op1, const Fp6& op2) {
+    fp2_add(rop.c0, op1.c0, op2.c0);
+    fp2_add(rop.c1, op1.c1, op2.c1);
+    fp2_add(rop.c2, op1.c2, op2.c2);
+}
+
+void fp6_sub(Fp6& rop, const Fp6& op1, const Fp6& op2) {
+    fp2_sub(rop.c0, op1.c0, op2.c0);
+    fp2_sub(rop.c1, op1.c1, op2.c1);
+    fp2_sub(rop.c2, op1.c2, op2.c2);
+}
+
+void fp6_neg(Fp6& rop, const Fp6& op) {
+    fp2_neg(rop.c0, op.c0);
+    fp2_neg(rop.c1, op.c1);
+    fp2_neg(rop.c2, op.c2);
+}
+
+//Karatsuba over the cubic extension: six Fp2 multiplications
+void fp6_mul(Fp6& rop, const Fp6& op1, const Fp6& op2) {
+    Fp2 v0, v1, v2, s, t, c0, c1, c2;
+    fp2_mul(v0, op1.c0, op2.c0);
+    fp2_mul(v1, op1.c1, op2.c1);
+    fp2_mul(v2, op1.c2, op2.c2);
+    //c0 = ((a1 + a2)(b1 + b2) - v1 - v2) * xi + v0
+    fp2_add(s, op1.c1, op1.c2);
+    fp2_add(t, op2.c1, op2.c2);
+    fp2_mul(c0, s, t);
+    fp2_sub(c0, c0, v1);
+    fp2_sub(c0, c0, v2);
+    fp2_mulxi(c0, c0);
+    fp2_add(c0, c0, v0);
+    //c1 = (a0 + a1)(b0 + b1) - v0 - v1 + xi * v2
+    fp2_add(s, op1.c0, op1.c1);
+    fp2_add(t, op2.c0, op2.c1);
+    fp2_mul(c1, s, t);
+    fp2_sub(c1, c1, v0);
+    fp2_sub(c1, c1, v1);
+    fp2_mulxi(t, v2);
+    fp2_add(c1, c1, t);
+    //c2 = (a0 + a2)(b0 + b2) - v0 - v2 + v1
+    fp2_add(s, op1.c0, op1.c2);
+    fp2_add(t, op2.c0, op2.c2);
+    fp2_mul(c2, s, t);
+    fp2_sub(c2, c2, v0);
+    fp2_sub(c2, c2, v2);
+    fp2_add(rop.c2, c2, v1);
+    rop.c0 = c0;
+    rop.c1 = c1;
+}
+
+//Chung-Hasan SQR2
+void fp6_square(Fp6& rop, const Fp6& op) {
+    Fp2 s0, s1, s2, s3, s4, t;
+    fp2_square(s0, op.c0);
+    fp2_mul(s1, op.c0, op.c1);
+    fp2_double(s1, s1);
+    fp2_sub(s2, op.c0, op.c1);
+    fp2_add(s2, s2, op.c2);
+    fp2_square(s2, s2);
+    fp2_mul(s3, op.c1, op.c2);
+    fp2_double(s3, s3);
+    fp2_square(s4, op.c2);
+    //c2 = s1 + s2 + s3 - s0 - s4
+    fp2_add(t, s1, s2);
+    fp2_add(t, t, s3);
+    fp2_sub(t, t, s0);
+    fp2_sub(rop.c2, t, s4);
+    //c0 = s0 + xi * s3, c1 = s1 + xi * s4
+    fp2_mulxi(s3, s3);
+    fp2_add(rop.c0, s0, s3);
+    fp2_mulxi(s4, s4);
+    fp2_add(rop.c1, s1, s4);
+}
+
+void fp6_mulv(Fp6& rop, const Fp6& op) {
+    Fp2 c0;
+    fp2_mulxi(c0, op.c2);
+    rop.c2 = op.c1;
+    rop.c1 = op.c0;
+    rop.c0 = c0;
+}
+
+void fp6_invert(Fp6& rop, const Fp6& op) {
+    Fp2 t0, t1, t2, s, d;
+    //t0 = a0^2 - xi*a1*a2, t1 = xi*a2^2 - a0*a1, t2 = a1^2 - a0*a2
+    fp2_square(t0, op.c0);
+    fp2_mul(s, op.c1, op.c2);
+    fp2_mulxi(s, s);
+    fp2_sub(t0, t0, s);
+    fp2_square(t1, op.c2);
+    fp2_mulxi(t1, t1);
+    fp2_mul(s, op.c0, op.c1);
+    fp2_sub(t1, t1, s);
+    fp2_square(t2, op.c1);
+    fp2_mul(s, op.c0, op.c2);
+    fp2_sub(t2, t2, s);
+    //d = a0*t0 + xi*(a2*t1 + a1*t2)
+    fp2_mul(d, op.c2, t1);
+    fp2_mul(s, op.c1, t2);
+    fp2_add(d, d, s);
+    fp2_mulxi(d, d);
+    fp2_mul(s, op.c0, t0);
+    fp2_add(d, d, s);
+    fp2_invert(d, d);
+    fp2_mul(rop.c0, t0, d);
+    fp2_mul(rop.c1, t1, d);
+    fp2_mul(rop.c2, t2, d);
+}
+
+bool fp6_iszero(const Fp6& op) {
+    return fp2_iszero(op.c0) && fp2_iszero(op.c1) && fp2_iszero(op.c2);
+}
+
+/*---------------------------------------Fp12---------------------------------*/
+
+namespace {
+
+//(x0 + x1*v + x2*v^2)(y0 + y1*v), five Fp2 multiplications
+void fp6_mul_sparse01(Fp6& rop, const Fp6& op, const Fp2& y0, const Fp2& y1) {
+    Fp2 a0b0, a1b1, c0, c1, c2, s, t;
+    fp2_mul(a0b0, op.c0, y0);
+    fp2_mul(a1b1, op.c1, y1);
+    //c0 = x0y0 + xi*x2y1
+    fp2_mul(c0, op.c2, y1);
+    fp2_mulxi(c0, c0);
+    fp2_add(c0, c0, a0b0);
+    //c1 = (x0 + x1)(y0 + y1) - x0y0 - x1y1
+    fp2_add(s, op.c0, op.c1);
+    fp2_add(t, y0, y1);
+    fp2_mul(c1, s, t);
+    fp2_sub(c1, c1, a0b0);
+    fp2_sub(c1, c1, a1b1);
+    //c2 = x1y1 + x2y0
+    fp2_mul(c2, op.c2, y0);
+    fp2_add(rop.c2, c2, a1b1);
+    rop.c0 = c0;
+    rop.c1 = c1;
+}
+
+void fp6_mul_fp2(Fp6& rop, const Fp6& op1, const Fp2& op2) {
+    fp2_mul(rop.c0, op1.c0, op2);
+    fp2_mul(rop.c1, op1.c1, op2);
+    fp2_mul(rop.c2, op1.c2, op2);
+}
+
+}  // anonymous namespace
+
+void fp12_setone(Fp12& rop) {
+    fp6_setone(rop.c0);
+    fp6_setzero(rop.c1);
+}
+
+bool fp12_isone(const Fp12& op) {
+    Fp12 one;
+    fp12_setone(one);
+    return fp12_iseq(op, one);
+}
+
+bool fp12_iseq(const Fp12& op1, const Fp12& op2) {
+    return fp6_iseq(op1.c0, op2.c0) && fp6_iseq(op1.c1, op2.c1);
+}
+
+void fp12_mul(Fp12& rop, const Fp12& op1, const Fp12& op2) {
+    Fp6 t0, t1, s, t;
+    fp6_mul(t0, op1.c0, op2.c0);
+    fp6_mul(t1, op1.c1, op2.c1);
+    fp6_add(s, op1.c0, op1.c1);
+    fp6_add(t, op2.c0, op2.c1);
+    fp6_mul(s, s, t);
+    fp6_sub(s, s, t0);
+    fp6_sub(rop.c1, s, t1);
+    fp6_mulv(t1, t1);
+    fp6_add(rop.c0, t0, t1);
+}
+
+void fp12_mul_line(Fp12& rop, const Fp12& op, const Fp2& l0, const Fp2& l1, const Fp2& l3) {
+    //The line is L0 + L1*w with L0 = l0 and L1 = l1 + l3*v
+    Fp6 t0, t1, s;
+    Fp2 y0;
+    fp6_mul_fp2(t0, op.c0, l0);
+    fp6_mul_sparse01(t1, op.c1, l1, l3);
+    fp6_add(s, op.c0, op.c1);
+    fp2_add(y0, l0, l1);
+    fp6_mul_sparse01(s, s, y0, l3);
+    fp6_sub(s, s, t0);
+    fp6_sub(rop.c1, s, t1);
+    fp6_mulv(t1, t1);
+    fp6_add(rop.c0, t0, t1);
+}
+
+//(a + bw)^2 = (a + b)(a + bv) - ab - abv + 2abw
+void fp12_square(Fp12& rop, const Fp12& op) {
+    Fp6 ab, s, t;
+    fp6_mul(ab, op.c0, op.c1);
+    fp6_add(s, op.c0, op.c1);
+    fp6_mulv(t, op.c1);
+    fp6_add(t, op.c0, t);
+    fp6_mul(s, s, t);
+    fp6_sub(s, s, ab);
+    fp6_mulv(t, ab);
+    fp6_sub(rop.c0, s, t);
+    fp6_add(rop.c1, ab, ab);
+}
+
+namespace {
+
+//(a + b*s)^2 in Fp4 = Fp2[s] / (s^2 - xi), returned as c0 + c1*s
+void fp4_square(Fp2& c0, Fp2& c1, const Fp2& a, const Fp2& b) {
+    Fp2 ab, s, t;
+    fp2_mul(ab, a, b);
+    fp2_add(s, a, b);
+    fp2_mulxi(t, b);
+    fp2_add(t, a, t);
+    fp2_mul(s, s, t);
+    fp2_sub(s, s, ab);
+    fp2_mulxi(t, ab);
+    fp2_sub(c0, s, t);
+    fp2_double(c1, ab);
+}
+
+}  // anonymous namespace
+
+//Granger-Scott: seen as Fp4^3, a cyclotomic element squares with three Fp4 squarings
+void fp12_cyclotomic_square(Fp12& rop, const Fp12& op) {
+    Fp2 z0 = op.c0.c0, z4 = op.c0.c1, z3 = op.c0.c2;
+    Fp2 z2 = op.c1.c0, z1 = op.c1.c1, z5 = op.c1.c2;
+    Fp2 t0, t1, t2, t3, t4, t5, tmp;
+    fp4_square(t0, t1, z0, z1);
+    fp4_square(t2, t3, z2, z3);
+    fp4_square(t4, t5, z4, z5);
+    //z0 = 3*t0 - 2*z0, z1 = 3*t1 + 2*z1
+    fp2_sub(z0, t0, z0);
+    fp2_double(z0, z0);
+    fp2_add(rop.c0.c0, z0, t0);
+    fp2_add(z1, t1, z1);
+    fp2_double(z1, z1);
+    fp2_add(rop.c1.c1, z1, t1);
+    //z2 = 3*xi*t5 + 2*z2, z3 = 3*t4 - 2*z3
+    fp2_mulxi(tmp, t5);
+    fp2_add(z2, tmp, z2);
+    fp2_double(z2, z2);
+    fp2_add(rop.c1.c0, z2, tmp);
+    fp2_sub(z3, t4, z3);
+    fp2_double(z3, z3);
+    fp2_add(rop.c0.c2, z3, t4);
+    //z4 = 3*t2 - 2*z4, z5 = 3*t3 + 2*z5
+    fp2_sub(z4, t2, z4);
+    fp2_double(z4, z4);
+    fp2_add(rop.c0.c1, z4, t2);
+    fp2_add(z5, t3, z5);
+    fp2_double(z5, z5);
+    fp2_add(rop.c1.c2, z5, t3);
+}
+
+void fp12_conjugate(Fp12& rop, const Fp12& op) {
+    rop.c0 = op.c0;
+    fp6_neg(rop.c1, op.c1);
+}
+
+void fp12_invert(Fp12& rop, const Fp12& op) {
+    //(a + bw)^-1 = (a - bw) / (a^2 - b^2 v)
+    Fp6 t0, t1;
+    fp6_square(t0, op.c0);
+    fp6_square(t1, op.c1);
+    fp6_mulv(t1, t1);
+    fp6_sub(t0, t0, t1);
+    fp6_invert(t0, t0);
+    fp6_mul(rop.c0, op.c0, t0);
+    fp6_mul(t1, op.c1, t0);
+    fp6_neg(rop.c1, t1);
+}
+
+//The coefficient of w^k is conjugated and picks up xi^(k(p-1)/6); in this
+//tower w^k is c0.c(k/2) for even k and c1.c(k/2) for odd k
+void fp12_frobenius_p(Fp12& rop, const Fp12& op) {
+    fp2_conjugate(rop.c0.c0, op.c0.c0);
+    fp2_conjugate(rop.c1.c0, op.c1.c0);
+    fp2_mul(rop.c1.c0, rop.c1.c0, FROBENIUS_GAMMA1[0]);
+    fp2_conjugate(rop.c0.c1, op.c0.c1);
+    fp2_mul(rop.c0.c1, rop.c0.c1, FROBENIUS_GAMMA1[1]);
+    fp2_conjugate(rop.c1.c1, op.c1.c1);
+    fp2_mul(rop.c1.c1, rop.c1.c1, FROBENIUS_GAMMA1[2]);
+    fp2_conjugate(rop.c0.c2, op.c0.c2);
+    fp2_mul(rop.c0.c2, rop.c0.c2, FROBENIUS_GAMMA1[3]);
+    fp2_conjugate(rop.c1.c2, op.c1.c2);
+    fp2_mul(rop.c1.c2, rop.c1.c2, FROBENIUS_GAMMA1[4]);
+}
+
+void fp12_frobenius_p2(Fp12& rop, const Fp12& op) {
+    rop.c0.c0 = op.c0.c0;
+    fp2_mul_fp(rop.c1.c0, op.c1.c0, FROBENIUS_GAMMA2[0]);
+    fp2_mul_fp(rop.c0.c1, op.c0.c1, FROBENIUS_GAMMA2[1]);
+    fp2_mul_fp(rop.c1.c1, op.c1.c1, FROBENIUS_GAMMA2[2]);
+    fp2_mul_fp(rop.c0.c2, op.c0.c2, FROBENIUS_GAMMA2[3]);
+    fp2_mul_fp(rop.c1.c2, op.c1.c2, FROBENIUS_GAMMA2[4]);
+}
+
+//In the cyclotomic subgroup f^(p^6 + 1) = 1, i.e. the conjugate c0 - c1*w is
+//the inverse, so f = (c + w)/(c - w) for the c below (Rubin-Silverberg's T2)
+bool fp12_compress(Fp6& rop, const Fp12& op) {
+    if(fp6_iszero(op.c1))
+        return false;
+    Fp6 numerator, inverse;
+    numerator = op.c0;
+    fp_add(numerator.c0.c0, numerator.c0.c0, ONE);
+    fp6_invert(inverse, op.c1);
+    fp6_mul(rop, numerator, inverse);
+    return true;
+}
+
+//(c + w)/(c - w) = (c + w)^2/(c^2 - v) = (c^2 + v)/(c^2 - v) + 2c/(c^2 - v) * w,
+//where c^2 - v is never zero as v has no square root in Fp6
+void fp12_decompress(Fp12& rop, const Fp6& op) {
+    Fp6 square, denominator, doubled;
+    fp6_square(square, op);
+    denominator = square;
+    fp_sub(denominator.c1.c0, denominator.c1.c0, ONE);
+    fp_add(square.c1.c0, square.c1.c0, ONE);
+    fp6_invert(denominator, denominator);
+    fp6_add(doubled, op, op);
+    fp6_mul(rop.c0, square, denominator);
+    fp6_mul(rop.c1, doubled, denominator);
+}
+
+}  // namespace Mont64
@@ -0,0 +1,329 @@
+/*
+ * Mont64Pairing.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+
+#include <bilinear/Mont64Curve.hpp>
+#include <bilinear/ScalarDecomposition.hpp>
+
+extern const scalar_t bn_n;
+
+namespace Mont64 {
+
+namespace {
+
+//3b' for the twist y^2 = x^3 + b', b' = 3/xi
+const Fp2 TWIST_B3 = {
+        {{0xfb35095662409d6eULL, 0xb406d934a346e0e1ULL, 0x12138807ec84376aULL, 0x3ae3914b1dfd434fULL}},
+        {{0x5f0d365ca942a853ULL, 0x13718fded47a46e9ULL, 0x32c976e57c558c3dULL, 0x1c45d032b98cc18eULL}}};
+
+//The NAF of 6u + 2, least significant digit first; the same as DCLXVI's bn_6uplus2_naf
+const signed char LOOP_NAF[] = {
+        0, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, -1, 0, 1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, -1, 0,
+        1, 0, 0, 0, 1, 0, -1, 0, 0, 0, -1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, -1, 0, -1, 0, 0, 0, 0, 1, 0, 0, 0, 1};
+const int LOOP_LENGTH = sizeof(LOOP_NAF) / sizeof(LOOP_NAF[0]);
+
+/*
+ * The Miller loop keeps T in homogeneous projective coordinates (X/Z, Y/Z) on
+ * the twist. Each step returns the line through the points it combines,
+ * evaluated at P = (xP, yP) and scaled by a factor in Fp2, which the final
+ * exponentiation removes. The line is l0 + l1*w + l3*w^3.
+ */
+struct Line {
+    Fp2 l0, l1, l3;
+};
+
+//Costello-Lange-Naehrig doubling, T = 2T
+void doublingStep(G2Point& t, Line& line, const Fp& xP, const Fp& yP) {
+    Fp2 a, b, c, e, f, g, h, t0;
+    //a = xy/2, b = y^2, c = z^2, e = 3b'c, f = 3e, g = (b + f)/2, h = (y + z)^2 - (b + c)
+    fp2_mul(a, t.x, t.y);
+    fp_half(a.c0, a.c0);
+    fp_half(a.c1, a.c1);
+    fp2_square(b, t.y);
+    fp2_square(c, t.z);
+    fp2_mul(e, c, TWIST_B3);
+    fp2_triple(f, e);
+    fp2_add(g, b, f);
+    fp_half(g.c0, g.c0);
+    fp_half(g.c1, g.c1);
+    fp2_add(h, t.y, t.z);
+    fp2_square(h, h);
+    fp2_add(t0, b, c);
+    fp2_sub(h, h, t0);
+    //l0 = -h*yP, l1 = 3x^2*xP, l3 = e - b
+    fp2_mul_fp(line.l0, h, yP);
+    fp2_neg(line.l0, line.l0);
+    fp2_square(t0, t.x);
+    fp2_triple(t0, t0);
+    fp2_mul_fp(line.l1, t0, xP);
+    fp2_sub(line.l3, e, b);
+    //x3 = a(b - f), y3 = g^2 - 3e^2, z3 = b*h
+    fp2_sub(t0, b, f);
+    fp2_mul(t.x, a, t0);
+    fp2_square(t0, e);
+    fp2_triple(t0, t0);
+    fp2_square(t.y, g);
+    fp2_sub(t.y, t.y, t0);
+    fp2_mul(t.z, b, h);
+}
+
+//Mixed addition T = T + Q with Q = (x2, y2) affine
+void additionStep(G2Point& t, Line& line, const Fp2& x2, const Fp2& y2, const Fp& xP, const Fp& yP) {
+    Fp2 theta, lambda, c, d, e, f, g, h, t0;
+    //theta = y1 - y2*z1, lambda = x1 - x2*z1
+    fp2_mul(t0, y2, t.z);
+    fp2_sub(theta, t.y, t0);
+    fp2_mul(t0, x2, t.z);
+    fp2_sub(lambda, t.x, t0);
+    //l0 = lambda*yP, l1 = -theta*xP, l3 = theta*x2 - lambda*y2
+    fp2_mul_fp(line.l0, lambda, yP);
+    fp2_mul_fp(line.l1, theta, xP);
+    fp2_neg(line.l1, line.l1);
+    fp2_mul(line.l3, theta, x2);
+    fp2_mul(t0, lambda, y2);
+    fp2_sub(line.l3, line.l3, t0);
+    //c = theta^2, d = lambda^2, e = lambda*d, f = z1*c, g = x1*d, h = e + f - 2g
+    fp2_square(c, theta);
+    fp2_square(d, lambda);
+    fp2_mul(e, lambda, d);
+    fp2_mul(f, t.z, c);
+    fp2_mul(g, t.x, d);
+    fp2_add(h, e, f);
+    fp2_double(t0, g);
+    fp2_sub(h, h, t0);
+    //x3 = lambda*h, y3 = theta(g - h) - y1*e, z3 = z1*e
+    fp2_mul(t.x, lambda, h);
+    fp2_sub(t0, g, h);
+    fp2_mul(t0, theta, t0);
+    fp2_mul(g, t.y, e);
+    fp2_sub(t.y, t0, g);
+    fp2_mul(t.z, t.z, e);
+}
+
+void millerLoop(Fp12& f, const G1Point& p, const G2Point& q) {
+    Line line;
+    G2Point t = q;
+    Fp2 negatedY;
+    fp2_neg(negatedY, q.y);
+    //The top digit is 1, which T = Q accounts for
+    fp12_setone(f);
+    for(int i = LOOP_LENGTH - 2; i >= 0; i--) {
+        fp12_square(f, f);
+        doublingStep(t, line, p.x, p.y);
+        fp12_mul_line(f, f, line.l0, line.l1, line.l3);
+        if(LOOP_NAF[i] != 0) {
+            additionStep(t, line, q.x, LOOP_NAF[i] > 0 ? q.y : negatedY, p.x, p.y);
+            fp12_mul_line(f, f, line.l0, line.l1, line.l3);
+        }
+    }
+    //Two more lines, through T and Q1 = pi(Q), then through T + Q1 and
+    //Q2 = (zeta*x, y), which is -pi^2(Q)
+    Fp2 x1, y1, x2;
+    fp2_conjugate(x1, q.x);
+    fp2_mul(x1, x1, FROBENIUS_GAMMA1[1]);
+    fp2_conjugate(y1, q.y);
+    fp2_mul(y1, y1, FROBENIUS_GAMMA1[2]);
+    additionStep(t, line, x1, y1, p.x, p.y);
+    fp12_mul_line(f, f, line.l0, line.l1, line.l3);
+    fp2_mul_fp(x2, q.x, FROBENIUS_GAMMA2[1]);
+    additionStep(t, line, x2, q.y, p.x, p.y);
+    fp12_mul_line(f, f, line.l0, line.l1, line.l3);
+}
+
+//rop = op^v for op in the cyclotomic subgroup, v = 1868033 = (57 * 2^7 + 1) * 2^8 + 1
+void powV(Fp12& rop, const Fp12& op) {
+    Fp12 t0, t1, t2;
+    fp12_cyclotomic_square(t0, op);
+    fp12_cyclotomic_square(t0, t0);
+    fp12_cyclotomic_square(t0, t0);  //op^8
+    fp12_cyclotomic_square(t1, t0);
+    fp12_cyclotomic_square(t1, t1);
+    fp12_cyclotomic_square(t1, t1);  //op^64
+    fp12_conjugate(t2, t0);
+    fp12_mul(t2, t2, op);
+    fp12_mul(t2, t2, t1);  //op^57
+    for(int i = 0; i < 7; i++) {
+        fp12_cyclotomic_square(t2, t2);
+    }
+    fp12_mul(t2, t2, op);  //op^7297
+    for(int i = 0; i < 8; i++) {
+        fp12_cyclotomic_square(t2, t2);
+    }
+    fp12_mul(rop, t2, op);
+}
+
+//rop = op^u, u = v^3
+void powU(Fp12& rop, const Fp12& op) {
+    powV(rop, op);
+    powV(rop, rop);
+    powV(rop, rop);
+}
+
+//The exponent (p^12 - 1)/n, with DCLXVI's addition chain for the hard part
+//so that the result matches DCLXVI's exactly (not just up to a fixed power)
+void finalExponentiation(Fp12& rop, const Fp12& op) {
+    Fp12 f, t0, t1;
+    //Easy part: f^((p^6 - 1)(p^2 + 1)), after which f is in the cyclotomic subgroup
+    fp12_conjugate(t0, op);
+    fp12_invert(t1, op);
+    fp12_mul(f, t0, t1);
+    fp12_frobenius_p2(t0, f);
+    fp12_mul(f, f, t0);
+    //Hard part: f^((p^4 - p^2 + 1)/n)
+    Fp12 fp, fp2, fp3, fu, fu2, fu3, fu2p, fu3p, y0, y1, y2, y3, y4, y5, y6;
+    fp12_frobenius_p(fp, f);
+    fp12_frobenius_p2(fp2, f);
+    fp12_frobenius_p(fp3, fp2);
+    powU(fu, f);
+    powU(fu2, fu);
+    powU(fu3, fu2);
+    fp12_frobenius_p(y3, fu);
+    fp12_frobenius_p(fu2p, fu2);
+    fp12_frobenius_p(fu3p, fu3);
+    fp12_frobenius_p2(y2, fu2);
+    fp12_mul(y0, fp, fp2);
+    fp12_mul(y0, y0, fp3);
+    fp12_conjugate(y1, f);
+    fp12_conjugate(y5, fu2);
+    fp12_conjugate(y3, y3);
+    fp12_mul(y4, fu, fu2p);
+    fp12_conjugate(y4, y4);
+    fp12_mul(y6, fu3, fu3p);
+    fp12_conjugate(y6, y6);
+    fp12_cyclotomic_square(t0, y6);
+    fp12_mul(t0, t0, y4);
+    fp12_mul(t0, t0, y5);
+    fp12_mul(t1, y3, y5);
+    fp12_mul(t1, t1, t0);
+    fp12_mul(t0, t0, y2);
+    fp12_cyclotomic_square(t1, t1);
+    fp12_mul(t1, t1, t0);
+    fp12_cyclotomic_square(t1, t1);
+    fp12_mul(t0, t1, y1);
+    fp12_mul(t1, t1, y0);
+    fp12_cyclotomic_square(t0, t0);
+    fp12_mul(rop, t0, t1);
+}
+
+const int GT_WINDOW = 4;
+const int GT_TABLE_SIZE = 1 << (GT_WINDOW - 2);
+
+}  // anonymous namespace
+
+void pairing(Fp12& rop, const G1Point& p, const G2Point& q) {
+    if(g1_isidentity(p) || g2_isidentity(q)) {
+        fp12_setone(rop);
+        return;
+    }
+    G1Point pAffine = p;
+    G2Point qAffine = q;
+    g1_makeaffine(pAffine);
+    g2_makeaffine(qAffine);
+    Fp12 f;
+    millerLoop(f, pAffine, qAffine);
+    finalExponentiation(rop, f);
+}
+
+//The same interleaved loop as GTDCLXVI::doPower. Elements of GT come out of the
+//final exponentiation in the cyclotomic subgroup, so the squarings can be Granger-Scott.
+void gt_pow(Fp12& rop, const Fp12& op, const scalar_t scalar) {
+    ScalarDecomposition::Recoding recoding;
+    ScalarDecomposition::recode(scalar, ScalarDecomposition::FROBENIUS, GT_WINDOW, recoding);
+    Fp12 table[ScalarDecomposition::MAX_DIMENSION][GT_TABLE_SIZE];
+    Fp12 squared;
+    table[0][0] = op;
+    fp12_cyclotomic_square(squared, op);
+    for(int i = 1; i < GT_TABLE_SIZE; i++) {
+        fp12_mul(table[0][i], table[0][i - 1], squared);
+    }
+    for(int part = 1; part < recoding.dimension; part++) {
+        for(int i = 0; i < GT_TABLE_SIZE; i++) {
+            fp12_frobenius_p(table[part][i], table[part - 1][i]);
+        }
+    }
+    Fp12 result, inverted;
+    fp12_setone(result);
+    bool started = false;
+    for(int bit = recoding.length - 1; bit >= 0; bit--) {
+        if(started)
+            fp12_cyclotomic_square(result, result);
+        for(int part = 0; part < recoding.dimension; part++) {
+            int digit = recoding.digits[part][bit];
+            if(digit == 0)
+                continue;
+            const Fp12* power = &table[part][(digit > 0 ? digit : -digit) / 2];
+            if(digit < 0) {
+                fp12_conjugate(inverted, *power);
+                power = &inverted;
+            }
+            if(started) {
+                fp12_mul(result, result, *power);
+            } else {
+                result = *power;
+                started = true;
+            }
+        }
+    }
+    rop = result;
+}
+
+bool gt_isvalid(const Fp12& op) {
+    const Fp* coefficients = &op.c0.c0.c0;
+    for(int i = 0; i < 12; i++) {
+        if(!fp_isreduced(coefficients[i]))
+            return false;
+    }
+    //Plain square-and-multiply, since gt_pow's decomposition and squarings assume op is in GT
+    Fp12 power;
+    fp12_setone(power);
+    for(int bit = scalar_scanb(bn_n); bit >= 0; bit--) {
+        fp12_square(power, power);
+        if(scalar_getbit(bn_n, bit))
+            fp12_mul(power, power, op);
+    }
+    return fp12_isone(power);
+}
+
+void gt_compress(unsigned char* rop, const Fp12& op) {
+    Fp6 compressed;
+    std::fill(rop, rop + GT_COMPRESSED_BYTES, 0);
+    if(!fp12_compress(compressed, op)) {
+        rop[0] = fp12_isone(op) ? 1 : 2;
+        return;
+    }
+    const Fp* coefficients = &compressed.c0.c0;
+    for(int i = 0; i < 6; i++) {
+        fp_to_bytes(rop + 1 + i * FP_BYTES, coefficients[i]);
+    }
+}
+
+bool gt_decompress(Fp12& rop, const unsigned char* op) {
+    if(op[0] != 0) {
+        //Only 1 is flagged; -1 has order 2, so it isn't in GT
+        if(op[0] != 1 || std::any_of(op + 1, op + GT_COMPRESSED_BYTES, [](unsigned char b) { return b != 0; }))
+            return false;
+        fp12_setone(rop);
+        return true;
+    }
+    Fp6 compressed;
+    Fp* coefficients = &compressed.c0.c0;
+    for(int i = 0; i < 6; i++) {
+        if(!fp_from_bytes(coefficients[i], op + 1 + i * FP_BYTES))
+            return false;
+    }
+    //fp12_compress never gives zero, which would decode to -1
+    if(fp6_iszero(compressed))
+        return false;
+    Fp12 element;
+    fp12_decompress(element, compressed);
+    if(!gt_isvalid(element))
+        return false;
+    rop = element;
+    return true;
+}
+
+}  // namespace Mont64
@@ -0,0 +1,174 @@
+/*
+ * PairingBackend.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <atomic>
+
+#include <bilinear/G1_DCLXVI.hpp>
+#include <bilinear/G1_Mont64.hpp>
+#include <bilinear/G2_DCLXVI.hpp>
+#include <bilinear/G2_Mont64.hpp>
+#include <bilinear/GT_DCLXVI.hpp>
+#include <bilinear/GT_Mont64.hpp>
+#include <bilinear/PairingBackend.hpp>
+#include <utils/Pointers.hpp>
+
+extern "C" {
+#include <optate.h>
+}
+
+namespace PairingBackend {
+
+namespace {
+
+#ifdef ACCUMULATOR_BACKEND_MONT64
+std::atomic<Type> defaultType(MONT64);
+#else
+std::atomic<Type> defaultType(DCLXVI);
+#endif
+
+}  // anonymous namespace
+
+Type getDefault() {
+    return defaultType.load();
+}
+
+void setDefault(Type type) {
+    defaultType.store(type);
+}
+
+const char* getName(Type type) {
+    return type == MONT64 ? "mont64" : "dclxvi";
+}
+
+bool fromName(const std::string& name, Type& type) {
+    if(name == "dclxvi") {
+        type = DCLXVI;
+    } else if(name == "mont64") {
+        type = MONT64;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Type typeOf(const G& element) {
+    if(dynamic_cast<const G1Mont64*>(&element) || dynamic_cast<const G2Mont64*>(&element))
+        return MONT64;
+    return DCLXVI;
+}
+
+bool isG2(const G& element) {
+    return dynamic_cast<const G2DCLXVI*>(&element) || dynamic_cast<const G2Mont64*>(&element);
+}
+
+std::unique_ptr<G> newG1(Type type) {
+    if(type == MONT64)
+        return std::make_unique<G1Mont64>();
+    return std::make_unique<G1DCLXVI>();
+}
+
+std::unique_ptr<G> newG2(Type type) {
+    if(type == MONT64)
+        return std::make_unique<G2Mont64>();
+    return std::make_unique<G2DCLXVI>();
+}
+
+std::unique_ptr<GT> newGT(Type type) {
+    if(type == MONT64)
+        return std::make_unique<GTMont64>();
+    return std::make_unique<GTDCLXVI>();
+}
+
+void pairing(GT& result, const G& g1Element, const G& g2Element) {
+    if(typeOf(g1Element) == MONT64) {
+        Mont64::Fp12 rop;
+        Mont64::pairing(rop, *ref_cast<G1Mont64>(g1Element).getUnderlyingObj(),
+                        *ref_cast<G2Mont64>(g2Element).getUnderlyingObj());
+        ref_cast<GTMont64>(result).importObject(&rop);
+    } else {
+        fp12e_t rop;
+        curvepoint_fp_t op1;
+        twistpoint_fp2_t op2;
+        ref_cast<G1DCLXVI>(g1Element).exportObject(op1);
+        ref_cast<G2DCLXVI>(g2Element).exportObject(op2);
+        //DCLXVI takes the G2 argument first
+        optate(rop, op2, op1);
+        ref_cast<GTDCLXVI>(result).importObject(rop);
+    }
+}
+
+namespace {
+
+typedef void (*EncodeFunction)(std::byte* out, const G& element);
+
+//G::encode for elements that batchNormalize has just normalized. Testing a
+//DCLXVI point for Z = 1 takes a reduction of Z, so encode's own check is skipped.
+EncodeFunction normalizedEncoder(const G& element) {
+    if(dynamic_cast<const G1DCLXVI*>(&element)) {
+        return [](std::byte* out, const G& point) {
+            G1DCLXVI::encode(out, ref_cast<G1DCLXVI>(point).getUnderlyingObj());
+        };
+    } else if(dynamic_cast<const G2DCLXVI*>(&element)) {
+        return [](std::byte* out, const G& point) {
+            G2DCLXVI::encode(out, ref_cast<G2DCLXVI>(point).getUnderlyingObj());
+        };
+    }
+    return [](std::byte* out, const G& point) { point.encode(out); };
+}
+
+}  // anonymous namespace
+
+void batchNormalize(const std::vector<std::unique_ptr<G>>& elements) {
+    if(elements.empty())
+        return;
+    const G* first = elements.front().get();
+    if(dynamic_cast<const G1DCLXVI*>(first)) {
+        G1DCLXVI::batchNormalize(elements);
+    } else if(dynamic_cast<const G2DCLXVI*>(first)) {
+        G2DCLXVI::batchNormalize(elements);
+    } else if(dynamic_cast<const G1Mont64*>(first)) {
+        G1Mont64::batchNormalize(elements);
+    } else {
+        G2Mont64::batchNormalize(elements);
+    }
+}
+
+void encodeAll(std::byte* out, const std::vector<std::unique_ptr<G>>& elements) {
+    if(elements.empty())
+        return;
+    batchNormalize(elements);
+    EncodeFunction encode = normalizedEncoder(*elements.front());
+    size_t size = elements.front()->getEncodedSize();
+    for(const std::unique_ptr<G>& element : elements) {
+        encode(out, *element);
+        out += size;
+    }
+}
+
+void writeAll(BufferedWriter& writer, const std::vector<std::unique_ptr<G>>& elements) {
+    if(elements.empty())
+        return;
+    batchNormalize(elements);
+    EncodeFunction encode = normalizedEncoder(*elements.front());
+    size_t size = elements.front()->getEncodedSize();
+    for(const std::unique_ptr<G>& element : elements) {
+        encode(writer.reserve(size), *element);
+    }
+}
+
+bool readAll(BufferedReader& reader, size_t count, std::unique_ptr<G> (*newElement)(Type), Type type,
+             std::vector<std::unique_ptr<G>>& elements) {
+    for(size_t i = 0; i < count; i++) {
+        std::unique_ptr<G> element = newElement(type);
+        const std::byte* in = reader.take(element->getEncodedSize());
+        if(in == NULL || !element->decode(in))
+            return false;
+        elements.push_back(std::move(element));
+    }
+    return true;
+}
+
+}  // namespace PairingBackend
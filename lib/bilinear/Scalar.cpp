@@ -4,9 +4,20 @@
  */
 
 #include <bilinear/Scalar.hpp>
+#include <utils/MemoryAccounting.hpp>
 
 Scalar::Scalar(){
 }
 
 Scalar::~Scalar(){
 }
+
+void* Scalar::operator new(size_t size){
+	MEMORY_RECORD_ALLOCATION(size);
+	return ::operator new(size);
+}
+
+void Scalar::operator delete(void* ptr, size_t size){
+	MEMORY_RECORD_FREE(size);
+	::operator delete(ptr);
+}
@@ -0,0 +1,173 @@
+/*
+ * ScalarDecomposition.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include <gmp.h>
+
+#include <bilinear/ScalarDecomposition.hpp>
+#include <utils/LibConversions.hpp>
+
+extern const scalar_t bn_n;
+
+namespace ScalarDecomposition {
+
+namespace {
+
+/*
+ * Reduced lattice bases, as polynomials in the BN parameter u = 1868033^3.
+ *
+ * GLV (G1): lambda is the root of x^2 + x + 1 mod n that matches
+ * (x, y) -> (bn_zeta2*x, y), and the basis is
+ *   (6u^2 + 2u, -(2u + 1)), (-(2u + 1), -(6u^2 + 4u + 1))
+ *
+ * Frobenius (G2, GT): lambda = p mod n = 6u^2, and the basis is
+ *   (2u + 1, 0, 2u, 1), (2u, u + 1, -u, u), (u + 1, u, u, -2u), (2u + 1, -u, -(u + 1), -u)
+ *
+ * The rounding constants are the first row of the inverse basis, scaled by n,
+ * so that the Babai coefficient for row j is round(k * rounding[j] / n).
+ */
+const char* const GLV_BASIS[] = {
+        "254952053719217182009119236802174855688", "-13037178982157583875",
+        "-13037178982157583875", "-254952053719217182022156415784332439563"};
+const char* const GLV_ROUNDING[] = {
+        "254952053719217182022156415784332439563", "-13037178982157583875"};
+
+const char* const FROBENIUS_BASIS[] = {
+        "13037178982157583875", "0", "13037178982157583874", "1",
+        "13037178982157583874", "6518589491078791938", "-6518589491078791937", "6518589491078791937",
+        "6518589491078791938", "6518589491078791937", "6518589491078791937", "-13037178982157583874",
+        "13037178982157583875", "-6518589491078791937", "-6518589491078791938", "-6518589491078791937"};
+const char* const FROBENIUS_ROUNDING[] = {
+        "1661927778103044753715912134891588971240935301695855419406",
+        "1661927778103044753460960081172371789225297475402601771781",
+        "13037178982157583875",
+        "1661927778103044753715912134891588971234416712204776627469"};
+
+class Lattice {
+public:
+    const int dimension;
+    mpz_t basis[MAX_DIMENSION][MAX_DIMENSION];
+    mpz_t rounding[MAX_DIMENSION];
+    mpz_t order;
+    mpz_t twiceOrder;
+
+    Lattice(int dimension, const char* const* basisStrings, const char* const* roundingStrings) :
+            dimension(dimension) {
+        for(int row = 0; row < dimension; row++) {
+            for(int col = 0; col < dimension; col++) {
+                mpz_init_set_str(basis[row][col], basisStrings[row * dimension + col], 10);
+            }
+            mpz_init_set_str(rounding[row], roundingStrings[row], 10);
+        }
+        mpz_init(order);
+        LibConversions::scalarToMpz(bn_n, order);
+        mpz_init(twiceOrder);
+        mpz_mul_2exp(twiceOrder, order, 1);
+    }
+    ~Lattice() {
+        for(int row = 0; row < dimension; row++) {
+            for(int col = 0; col < dimension; col++) {
+                mpz_clear(basis[row][col]);
+            }
+            mpz_clear(rounding[row]);
+        }
+        mpz_clear(order);
+        mpz_clear(twiceOrder);
+    }
+};
+
+const Lattice& getLattice(Endomorphism endomorphism) {
+    //Function-local statics are initialized once, even if several threads get here first
+    static const Lattice glv(2, GLV_BASIS, GLV_ROUNDING);
+    static const Lattice frobenius(4, FROBENIUS_BASIS, FROBENIUS_ROUNDING);
+    return endomorphism == GLV ? glv : frobenius;
+}
+
+//Sub-scalars fit in three limbs with room to spare for the wNAF carries
+const int LIMBS = 3;
+
+/**
+ * Width-w NAF of a non-negative number of at most MAX_DIGITS - 1 bits,
+ * negating every digit if negate is set.
+ * @return one past the index of the most significant non-zero digit
+ */
+int wnaf(const mpz_t value, int window, bool negate, signed char* digits) {
+    uint64_t limbs[LIMBS] = {0, 0, 0};
+    mpz_export(limbs, NULL, -1, sizeof(limbs[0]), 0, 0, value);
+    const int64_t full = int64_t(1) << window;
+    const int64_t half = full >> 1;
+    memset(digits, 0, MAX_DIGITS);
+    int length = 0;
+    for(int i = 0; (limbs[0] | limbs[1] | limbs[2]) != 0; i++) {
+        if(limbs[0] & 1) {
+            int64_t digit = int64_t(limbs[0] & (full - 1));
+            if(digit >= half)
+                digit -= full;
+            //Subtracting the digit clears the low w bits; a negative digit also adds 2^w,
+            //which can carry into the higher limbs
+            limbs[0] &= ~uint64_t(full - 1);
+            if(digit < 0) {
+                limbs[0] += uint64_t(full);
+                if(limbs[0] == 0 && ++limbs[1] == 0)
+                    ++limbs[2];
+            }
+            digits[i] = (signed char)(negate ? -digit : digit);
+            length = i + 1;
+        }
+        limbs[0] = (limbs[0] >> 1) | (limbs[1] << 63);
+        limbs[1] = (limbs[1] >> 1) | (limbs[2] << 63);
+        limbs[2] >>= 1;
+    }
+    return length;
+}
+
+}  // anonymous namespace
+
+void recode(const scalar_t scalar, Endomorphism endomorphism, int window, Recoding& result) {
+    const Lattice& lattice = getLattice(endomorphism);
+    const int dimension = lattice.dimension;
+    mpz_t k, coefficients[MAX_DIMENSION], part, temp;
+    mpz_init(k);
+    mpz_init(part);
+    mpz_init(temp);
+    LibConversions::scalarToMpz(scalar, k);
+    mpz_mod(k, k, lattice.order);
+    //Babai rounding: c_j = floor((2 * k * rounding[j] + n) / 2n)
+    for(int j = 0; j < dimension; j++) {
+        mpz_init(coefficients[j]);
+        mpz_mul(temp, k, lattice.rounding[j]);
+        mpz_mul_2exp(temp, temp, 1);
+        mpz_add(temp, temp, lattice.order);
+        mpz_fdiv_q(coefficients[j], temp, lattice.twiceOrder);
+    }
+    result.dimension = dimension;
+    result.length = 0;
+    //k_i = (k, 0, ..., 0)_i - sum_j c_j * basis[j][i]
+    for(int i = 0; i < dimension; i++) {
+        if(i == 0)
+            mpz_set(part, k);
+        else
+            mpz_set_ui(part, 0);
+        for(int j = 0; j < dimension; j++) {
+            mpz_submul(part, coefficients[j], lattice.basis[j][i]);
+        }
+        bool negative = mpz_sgn(part) < 0;
+        mpz_abs(part, part);
+        int length = wnaf(part, window, negative, result.digits[i]);
+        if(length > result.length)
+            result.length = length;
+    }
+    for(int j = 0; j < dimension; j++) {
+        mpz_clear(coefficients[j]);
+    }
+    mpz_clear(k);
+    mpz_clear(part);
+    mpz_clear(temp);
+}
+
+}  // namespace ScalarDecomposition
@@ -6,6 +6,7 @@
 #include <bilinear/Scalar_DCLXVI.hpp>
 #include <utils/LibConversions.hpp>
 
+#include <cstring>
 #include <mutex>
 
 using std::cout;
@@ -136,15 +137,26 @@ void ScalarDCLXVI::printPretty() const {
     cout << dec << "In decimal: " << zzp << ". Size: " << _size << " bits" << endl;
 }
 
-void ScalarDCLXVI::readFromFile(std::ifstream& inFile) {
-    for(int i = 0; i < 4; i++) {
-        inFile.read((char*)&_scalar[i], sizeof(unsigned long long));
-    }
-    _size = scalar_scanb(_scalar) + 1;
+void ScalarDCLXVI::readFromFile(std::istream& inFile) {
+    std::byte bytes[sizeof(scalar_t)];
+    if(inFile.read((char*)bytes, sizeof(bytes)))
+        decode(bytes);
 }
 
-void ScalarDCLXVI::writeToFile(std::ofstream& outFile) const {
-    for(int i = 0; i < 4; i++) {
-        outFile.write((char*)&_scalar[i], sizeof(unsigned long long));
-    }
+void ScalarDCLXVI::writeToFile(std::ostream& outFile) const {
+    outFile.write((const char*)_scalar, sizeof(scalar_t));
+}
+
+//The four limbs, least significant first, in host byte order
+size_t ScalarDCLXVI::getEncodedSize() const {
+    return sizeof(scalar_t);
+}
+
+void ScalarDCLXVI::encode(std::byte* out) const {
+    memcpy(out, _scalar, sizeof(scalar_t));
+}
+
+void ScalarDCLXVI::decode(const std::byte* in) {
+    memcpy(_scalar, in, sizeof(scalar_t));
+    _size = scalar_scanb(_scalar) + 1;
 }
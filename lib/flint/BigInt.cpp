@@ -177,14 +177,16 @@ bool BigInt::assign(const std::string& string) {
 std::string BigInt::toString() const {
     char* cString = fmpz_get_str(nullptr, 10, value);
     std::string str(cString);
-    delete[] cString;
+    //Allocated through FLINT's (or GMP's) memory functions, which may not be malloc
+    flint_free(cString);
     return str;
 }
 
 std::string BigInt::toHex() const {
     char* cString = fmpz_get_str(nullptr, 16, value);
     std::string str(cString);
-    delete[] cString;
+    //Allocated through FLINT's (or GMP's) memory functions, which may not be malloc
+    flint_free(cString);
     return str;
 }
 
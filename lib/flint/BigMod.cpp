@@ -10,51 +10,62 @@
 #include <flint/ArithmeticException.hpp>
 #include <flint/BigMod.hpp>
 
+#include <utils/Metrics.hpp>
+
 namespace flint {
 
+namespace {
+
+//The context a BigMod needs to reduce anything; a modulus of 0 has none
+const ModContext& require(const std::shared_ptr<const ModContext>& context) {
+    if(!context)
+        throw ArithmeticException("Cannot reduce by a modulus of 0.");
+    return *context;
+}
+
+bool sameModulus(const std::shared_ptr<const ModContext>& first, const std::shared_ptr<const ModContext>& second) {
+    if(!first || !second)
+        return first == second;
+    return first->sameModulus(*second);
+}
+
+}  // namespace
+
 BigMod::BigMod() {
     fmpz_init(value);
-    fmpz_init(modulus);
 }
 
-BigMod::BigMod(const BigMod& other) {
+BigMod::BigMod(const BigMod& other) : context(other.context) {
     fmpz_init_set(value, other.value);
-    fmpz_init_set(modulus, other.modulus);
 }
 
 BigMod::BigMod(BigMod&& other) {
     fmpz_init(value);
-    fmpz_init(modulus);
     //Steal other's values and leave it with initialized but useless ones
     swap(*this, other);
 }
 
-BigMod::BigMod(const BigInt& modulus) {
+BigMod::BigMod(const BigInt& modulus) : context(ModContext::forModulus(modulus)) {
     fmpz_init(value);
-    fmpz_init_set(this->modulus, modulus.getUnderlyingObject());
 }
 
-BigMod::BigMod(const fmpz_t& value, const fmpz_t& modulus) {
-    fmpz_init_set(this->value, value);
-    fmpz_init_set(this->modulus, modulus);
-    fmpz_mod(this->value, this->value, this->modulus);
+BigMod::BigMod(const fmpz_t& value, const fmpz_t& modulus) : BigMod(BigInt(value), BigInt(modulus)) {
 }
 
-BigMod::BigMod(const BigInt& value, const BigInt& modulus) {
-    fmpz_init_set(this->value, value.getUnderlyingObject());
-    fmpz_init_set(this->modulus, modulus.getUnderlyingObject());
-    fmpz_mod(this->value, this->value, this->modulus);
+BigMod::BigMod(const BigInt& value, const BigInt& modulus) : BigMod(value, ModContext::forModulus(modulus)) {
+}
+
+BigMod::BigMod(const unsigned long value, const unsigned long modulus)
+        : BigMod(BigInt(value), BigInt(modulus)) {
 }
 
-BigMod::BigMod(const unsigned long value, const unsigned long modulus) {
-    fmpz_init_set_ui(this->value, value);
-    fmpz_init_set_ui(this->modulus, modulus);
-    fmpz_mod(this->value, this->value, this->modulus);
+BigMod::BigMod(const BigInt& value, std::shared_ptr<const ModContext> context) : context(std::move(context)) {
+    fmpz_init_set(this->value, value.getUnderlyingObject());
+    require(this->context).reduce(this->value);
 }
 
 BigMod::~BigMod() {
     fmpz_clear(value);
-    fmpz_clear(modulus);
 }
 
 BigMod& BigMod::add(const BigMod& rhs) {
@@ -88,13 +99,12 @@ BigMod& BigMod::power(const BigInt& exponent) {
 }
 
 bool BigMod::equals(const BigMod& other) const {
-    return fmpz_equal(modulus, other.modulus)
-           && fmpz_equal(value, other.value);
+    return sameModulus(context, other.context) && fmpz_equal(value, other.value);
 }
 
 bool BigMod::assign(const char* string) {
     int success = fmpz_set_str(value, const_cast<char*>(string), 10);
-    fmpz_mod(value, value, modulus);
+    require(context).reduce(value);
     return (success == 0);
 }
 
@@ -114,7 +124,7 @@ BigMod& BigMod::operator=(const BigInt& rhs) {
 
 BigMod& BigMod::operator=(const long& rhs) {
     fmpz_set_si(value, rhs);
-    fmpz_mod(value, value, modulus);
+    require(context).reduce(value);
     return *this;
 }
 
@@ -162,13 +172,13 @@ bool BigMod::operator!=(const BigMod& rhs) const {
 }
 
 bool BigMod::operator<(const BigMod& rhs) const {
-    if(!fmpz_equal(modulus, rhs.modulus))
+    if(!sameModulus(context, rhs.context))
         throw ArithmeticException("Cannot compare operands with different moduli.");
     return fmpz_cmp(this->value, rhs.value) < 0;
 }
 
 bool BigMod::operator>(const BigMod& rhs) const {
-    if(!fmpz_equal(modulus, rhs.modulus))
+    if(!sameModulus(context, rhs.context))
         throw ArithmeticException("Cannot compare operands with different moduli.");
     return fmpz_cmp(this->value, rhs.value) > 0;
 }
@@ -182,7 +192,10 @@ bool BigMod::operator<=(const BigMod& rhs) const {
 }
 
 std::string BigMod::toString() const {
-    return std::string(fmpz_get_str(nullptr, 10, value));
+    char* cString = fmpz_get_str(nullptr, 10, value);
+    std::string str(cString);
+    flint_free(cString);
+    return str;
 }
 
 BigInt BigMod::getMantissa() const {
@@ -190,12 +203,17 @@ BigInt BigMod::getMantissa() const {
 }
 
 BigInt BigMod::getModulus() const {
-    return BigInt(modulus);
+    return context ? context->getModulus() : BigInt();
 }
 
 void BigMod::setModulus(const BigInt& modulus) {
-    fmpz_set(this->modulus, modulus.getUnderlyingObject());
-    fmpz_mod(value, value, this->modulus);
+    context = ModContext::forModulus(modulus);
+    require(context).reduce(value);
+}
+
+void BigMod::setContext(std::shared_ptr<const ModContext> context) {
+    this->context = std::move(context);
+    require(this->context).reduce(value);
 }
 
 //const fmpz* BigMod::getUnderlyingValue() const {
@@ -253,39 +271,38 @@ BigMod operator*(const BigInt& lhs, const BigMod& rhs) {
 }
 
 void swap(BigMod& first, BigMod& second) {
-    //Just swap both fmpz members using FLINT's swap
+    //Swap the value using FLINT's swap, and the pointers to the contexts
     fmpz_swap(first.value, second.value);
-    fmpz_swap(first.modulus, second.modulus);
+    first.context.swap(second.context);
 }
 
 void add(const BigMod& lhs, const BigMod& rhs, BigMod& result) {
-    if(!fmpz_equal(lhs.modulus, rhs.modulus))
+    if(!sameModulus(lhs.context, rhs.context))
         throw ArithmeticException("Addition error: operands have different moduli.");
     fmpz_add(result.value, lhs.value, rhs.value);
-    fmpz_mod(result.value, result.value, lhs.modulus);
-    fmpz_set(result.modulus, lhs.modulus);
+    require(lhs.context).reduce(result.value);
+    result.context = lhs.context;
 }
 
 void subtract(const BigMod& lhs, const BigMod& rhs, BigMod& result) {
-    if(!fmpz_equal(lhs.modulus, rhs.modulus))
+    if(!sameModulus(lhs.context, rhs.context))
         throw ArithmeticException("Subtraction error: operands have different moduli.");
     fmpz_sub(result.value, lhs.value, rhs.value);
-    fmpz_mod(result.value, result.value, lhs.modulus);
-    fmpz_set(result.modulus, lhs.modulus);
+    require(lhs.context).reduce(result.value);
+    result.context = lhs.context;
 }
 
 void multiply(const BigMod& lhs, const BigMod& rhs, BigMod& result) {
-    if(!fmpz_equal(lhs.modulus, rhs.modulus))
+    if(!sameModulus(lhs.context, rhs.context))
         throw ArithmeticException("Multiplication error: operands have different moduli.");
-    fmpz_mul(result.value, lhs.value, rhs.value);
-    fmpz_mod(result.value, result.value, lhs.modulus);
-    fmpz_set(result.modulus, lhs.modulus);
+    require(lhs.context).multiply(result.value, lhs.value, rhs.value);
+    result.context = lhs.context;
 }
 
 void add(const BigMod& lhs, const BigInt& rhs, BigMod& result) {
     fmpz_add(result.value, lhs.value, rhs.getUnderlyingObject());
-    fmpz_mod(result.value, result.value, lhs.modulus);
-    fmpz_set(result.modulus, lhs.modulus);
+    require(lhs.context).reduce(result.value);
+    result.context = lhs.context;
 }
 
 void add(const BigInt& lhs, const BigMod& rhs, BigMod& result) {
@@ -294,20 +311,19 @@ void add(const BigInt& lhs, const BigMod& rhs, BigMod& result) {
 
 void subtract(const BigMod& lhs, const BigInt& rhs, BigMod& result) {
     fmpz_sub(result.value, lhs.value, rhs.getUnderlyingObject());
-    fmpz_mod(result.value, result.value, lhs.modulus);
-    fmpz_set(result.modulus, lhs.modulus);
+    require(lhs.context).reduce(result.value);
+    result.context = lhs.context;
 }
 
 void subtract(const BigInt& lhs, const BigMod& rhs, BigMod& result) {
     fmpz_sub(result.value, lhs.getUnderlyingObject(), rhs.value);
-    fmpz_mod(result.value, result.value, rhs.modulus);
-    fmpz_set(result.modulus, rhs.modulus);
+    require(rhs.context).reduce(result.value);
+    result.context = rhs.context;
 }
 
 void multiply(const BigMod& lhs, const BigInt& rhs, BigMod& result) {
-    fmpz_mul(result.value, lhs.value, rhs.getUnderlyingObject());
-    fmpz_mod(result.value, result.value, lhs.modulus);
-    fmpz_set(result.modulus, lhs.modulus);
+    require(lhs.context).multiply(result.value, lhs.value, rhs.getUnderlyingObject());
+    result.context = lhs.context;
 }
 
 void multiply(const BigInt& lhs, const BigMod& rhs, BigMod& result) {
@@ -315,8 +331,9 @@ void multiply(const BigInt& lhs, const BigMod& rhs, BigMod& result) {
 }
 
 void power(const BigMod& base, const BigInt& exponent, BigMod& result) {
-    fmpz_powm(result.value, base.value, exponent.getUnderlyingObject(), base.modulus);
-    fmpz_set(result.modulus, base.modulus);
+    METRICS_COUNT(MODULAR_EXPONENTIATION);
+    require(base.context).power(result.value, base.value, exponent.getUnderlyingObject());
+    result.context = base.context;
 }
 
 }  //end namespace flint
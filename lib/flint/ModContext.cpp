@@ -0,0 +1,161 @@
+/*
+ * ModContext.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include <flint/ArithmeticException.hpp>
+#include <flint/ModContext.hpp>
+
+namespace flint {
+
+namespace {
+
+//Every context forModulus has handed out, keyed by the hash of its modulus, so that BigMods with equal moduli share one
+std::mutex registryMutex;
+std::unordered_multimap<size_t, std::weak_ptr<const ModContext>> registry;
+//Entries whose contexts have died are swept out once the registry grows to this size
+size_t sweepAt = 64;
+
+//Distinct moduli almost always differ in their lowest limb, and otherwise usually in their length
+size_t hashOf(const BigInt& modulus) {
+    const fmpz* value = modulus.getUnderlyingObject();
+    return std::hash<ulong>()(fmpz_get_ui(value)) ^ (std::hash<ulong>()(fmpz_bits(value)) << 1);
+}
+
+//The live context for modulus in the registry, or NULL; the caller holds registryMutex
+std::shared_ptr<const ModContext> findRegistered(size_t hash, const BigInt& modulus) {
+    auto range = registry.equal_range(hash);
+    for(auto entry = range.first; entry != range.second; ++entry) {
+        std::shared_ptr<const ModContext> existing = entry->second.lock();
+        if(existing && existing->getModulus() == modulus)
+            return existing;
+    }
+    return NULL;
+}
+
+//Quotients are as long as the modulus; reusing one per thread keeps reductions from allocating
+struct Scratch {
+    fmpz_t quotient;
+    Scratch() {
+        fmpz_init(quotient);
+    }
+    ~Scratch() {
+        fmpz_clear(quotient);
+    }
+};
+
+thread_local Scratch scratch;
+
+ModContext::PowerKernel preferredPowerKernel() {
+    for(int kernel = 0; kernel < ModContext::NUM_POWER_KERNELS; kernel++) {
+        if(ModContext::isSupported((ModContext::PowerKernel)kernel))
+            return (ModContext::PowerKernel)kernel;
+    }
+    return ModContext::POWER_GMP;
+}
+
+//-1 until the first exponentiation picks the preferred kernel; being constant-initialized, it can't be read
+//before it is set up by code that runs during static initialization
+std::atomic<int> powerKernel(-1);
+
+ModContext::PowerKernel selectedPowerKernel() {
+    int kernel = powerKernel.load(std::memory_order_relaxed);
+    if(kernel < 0) {
+        kernel = preferredPowerKernel();
+        powerKernel.store(kernel);
+    }
+    return (ModContext::PowerKernel)kernel;
+}
+
+}  // namespace
+
+std::shared_ptr<const ModContext> ModContext::forModulus(const BigInt& modulus) {
+    if(fmpz_is_zero(modulus.getUnderlyingObject()))
+        return NULL;
+    size_t hash = hashOf(modulus);
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::shared_ptr<const ModContext> existing = findRegistered(hash, modulus);
+        if(existing)
+            return existing;
+    }
+    //Precomputing is slow for a large modulus, so other threads may look up contexts meanwhile
+    std::shared_ptr<const ModContext> context = std::make_shared<const ModContext>(modulus);
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::shared_ptr<const ModContext> existing = findRegistered(hash, modulus);
+    if(existing)
+        return existing;
+    if(registry.size() >= sweepAt) {
+        for(auto entry = registry.begin(); entry != registry.end();) {
+            if(entry->second.expired())
+                entry = registry.erase(entry);
+            else
+                ++entry;
+        }
+        sweepAt = std::max<size_t>(64, 2 * registry.size());
+    }
+    registry.emplace(hash, context);
+    return context;
+}
+
+ModContext::ModContext(const BigInt& modulus) : modulus(modulus), fixedWidth(FixedWidthModulus::create(modulus)) {
+    if(fmpz_sgn(modulus.getUnderlyingObject()) <= 0)
+        throw ArithmeticException("A modulus must be positive.");
+    fmpz_preinvn_init(inverse, modulus.getUnderlyingObject());
+}
+
+ModContext::~ModContext() {
+    fmpz_preinvn_clear(inverse);
+}
+
+void ModContext::reduce(fmpz_t value) const {
+    if(fmpz_sgn(value) >= 0 && fmpz_cmp(value, modulus.getUnderlyingObject()) < 0)
+        return;
+    fmpz_fdiv_qr_preinvn(scratch.quotient, value, value, modulus.getUnderlyingObject(), inverse);
+}
+
+void ModContext::multiply(fmpz_t result, const fmpz_t lhs, const fmpz_t rhs) const {
+    fmpz_mul(result, lhs, rhs);
+    fmpz_fdiv_qr_preinvn(scratch.quotient, result, result, modulus.getUnderlyingObject(), inverse);
+}
+
+void ModContext::power(fmpz_t result, const fmpz_t base, const fmpz_t exponent) const {
+    PowerKernel kernel = selectedPowerKernel();
+    if(kernel == POWER_GMP || !fixedWidth || fmpz_sgn(exponent) < 0) {
+        fmpz_powm(result, base, exponent, modulus.getUnderlyingObject());
+        return;
+    }
+    fixedWidth->power(result, base, exponent,
+                      kernel == POWER_IFMA ? FixedWidthModulus::KERNEL_IFMA : FixedWidthModulus::KERNEL_PORTABLE);
+}
+
+const char* ModContext::getPowerKernelName(PowerKernel kernel) {
+    switch(kernel) {
+    case POWER_IFMA:
+        return "ifma";
+    case POWER_GMP:
+        return "gmp";
+    default:
+        return "portable";
+    }
+}
+
+bool ModContext::isSupported(PowerKernel kernel) {
+    return kernel != POWER_IFMA || FixedWidthModulus::isSupported(FixedWidthModulus::KERNEL_IFMA);
+}
+
+ModContext::PowerKernel ModContext::getPowerKernel() {
+    return selectedPowerKernel();
+}
+
+void ModContext::setPowerKernel(PowerKernel kernel) {
+    powerKernel.store(kernel);
+}
+
+}  //end namespace flint
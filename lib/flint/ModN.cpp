@@ -0,0 +1,407 @@
+/*
+ * ModN.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <flint/ArithmeticException.hpp>
+#include <flint/ModN.hpp>
+#include <utils/CpuDispatch.hpp>
+
+//The carry-chain and AVX-512 intrinsics; like Mont64, this code is for x86-64 only
+#include <immintrin.h>
+#include <x86intrin.h>
+
+namespace flint {
+
+namespace {
+
+typedef unsigned __int128 uint128_t;
+//The limb type the carry intrinsics take, which is not the same type as uint64_t
+typedef unsigned long long limb_t;
+
+const uint64_t LANE_MASK = (uint64_t(1) << 52) - 1;
+//The largest window, and so the largest table, slidingWindowPower uses
+const size_t MAX_WINDOW_BITS = 6;
+
+//-x^-1 mod 2^64 for odd x, by Newton's iteration: x is its own inverse mod 8, and each step doubles the bits
+uint64_t negatedInverse(uint64_t x) {
+    uint64_t inverse = x;
+    for(int i = 0; i < 5; i++) {
+        inverse *= 2 - x * inverse;
+    }
+    return -inverse;
+}
+
+//value, which must be nonnegative and below 2^(64 * count), as little-endian 64-bit limbs
+void toLimbs(uint64_t* limbs, size_t count, const fmpz_t value) {
+    fmpz_get_ui_array((ulong*)limbs, count, value);
+}
+
+void limbsToLanes(uint64_t* lanes, size_t laneCount, const uint64_t* limbs, size_t limbCount) {
+    for(size_t i = 0; i < laneCount; i++) {
+        size_t limb = 52 * i / 64, shift = 52 * i % 64;
+        uint64_t lane = 0;
+        if(limb < limbCount) {
+            lane = limbs[limb] >> shift;
+            //Lanes that start past bit 12 of a limb take the rest of their bits from the next one
+            if(shift > 12 && limb + 1 < limbCount)
+                lane |= limbs[limb + 1] << (64 - shift);
+        }
+        lanes[i] = lane & LANE_MASK;
+    }
+}
+
+void lanesToLimbs(uint64_t* limbs, size_t limbCount, const uint64_t* lanes, size_t laneCount) {
+    memset(limbs, 0, limbCount * sizeof(uint64_t));
+    for(size_t i = 0; i < laneCount; i++) {
+        size_t limb = 52 * i / 64, shift = 52 * i % 64;
+        if(limb < limbCount)
+            limbs[limb] |= lanes[i] << shift;
+        if(shift > 12 && limb + 1 < limbCount)
+            limbs[limb + 1] |= lanes[i] >> (64 - shift);
+    }
+}
+
+//Sets result to 2^exponent mod modulus
+void powerOfTwo(fmpz_t result, size_t exponent, const BigInt& modulus) {
+    fmpz_one(result);
+    fmpz_mul_2exp(result, result, exponent);
+    fmpz_mod(result, result, modulus.getUnderlyingObject());
+}
+
+/*
+ * An engine does Montgomery arithmetic on elements of SIZE words, which
+ * slidingWindowPower keeps in arrays on the stack. Every operation allows the
+ * result to alias an operand.
+ */
+
+/**
+ * CIOS Montgomery multiplication in 64-bit limbs: one round per limb of b,
+ * each adding a*b[i] and then the multiple of the modulus that zeroes the low
+ * limb, and shifting down a limb. Elements are kept fully reduced.
+ */
+template <size_t LIMBS>
+struct PortableEngine {
+    static const size_t SIZE = LIMBS;
+    const uint64_t* modulus;
+    uint64_t inverse;
+    const uint64_t* rSquared;
+
+    //result = t - modulus if top is set or t >= modulus, else t
+    void reduceOnce(uint64_t* result, const uint64_t* t, uint64_t top) const {
+        uint64_t difference[LIMBS];
+        unsigned char borrow = 0;
+        for(size_t j = 0; j < LIMBS; j++) {
+            borrow = _subborrow_u64(borrow, t[j], modulus[j], (limb_t*)&difference[j]);
+        }
+        bool keep = borrow & (top == 0);
+        for(size_t j = 0; j < LIMBS; j++) {
+            result[j] = keep ? t[j] : difference[j];
+        }
+    }
+
+    void multiply(uint64_t* result, const uint64_t* a, const uint64_t* b) const {
+        uint64_t t[LIMBS + 2] = {};
+        for(size_t i = 0; i < LIMBS; i++) {
+            uint128_t carry = 0;
+            for(size_t j = 0; j < LIMBS; j++) {
+                carry += (uint128_t)a[j] * b[i] + t[j];
+                t[j] = (uint64_t)carry;
+                carry >>= 64;
+            }
+            carry += t[LIMBS];
+            t[LIMBS] = (uint64_t)carry;
+            t[LIMBS + 1] = (uint64_t)(carry >> 64);
+            uint64_t m = t[0] * inverse;
+            carry = ((uint128_t)m * modulus[0] + t[0]) >> 64;
+            for(size_t j = 1; j < LIMBS; j++) {
+                carry += (uint128_t)m * modulus[j] + t[j];
+                t[j - 1] = (uint64_t)carry;
+                carry >>= 64;
+            }
+            carry += t[LIMBS];
+            t[LIMBS - 1] = (uint64_t)carry;
+            t[LIMBS] = t[LIMBS + 1] + (uint64_t)(carry >> 64);
+        }
+        reduceOnce(result, t, t[LIMBS]);
+    }
+
+    //Squares with each cross product computed once, then reduces the double-length square
+    void square(uint64_t* result, const uint64_t* a) const {
+        uint64_t t[2 * LIMBS] = {};
+        for(size_t i = 0; i < LIMBS; i++) {
+            uint128_t carry = 0;
+            for(size_t j = i + 1; j < LIMBS; j++) {
+                carry += (uint128_t)a[i] * a[j] + t[i + j];
+                t[i + j] = (uint64_t)carry;
+                carry >>= 64;
+            }
+            t[i + LIMBS] = (uint64_t)carry;
+        }
+        uint64_t shiftedOut = 0;
+        for(size_t k = 0; k < 2 * LIMBS; k++) {
+            uint64_t limb = t[k];
+            t[k] = (limb << 1) | shiftedOut;
+            shiftedOut = limb >> 63;
+        }
+        unsigned char carry = 0;
+        for(size_t i = 0; i < LIMBS; i++) {
+            uint128_t diagonal = (uint128_t)a[i] * a[i];
+            carry = _addcarry_u64(carry, t[2 * i], (uint64_t)diagonal, (limb_t*)&t[2 * i]);
+            carry = _addcarry_u64(carry, t[2 * i + 1], (uint64_t)(diagonal >> 64), (limb_t*)&t[2 * i + 1]);
+        }
+        uint64_t top = 0;
+        for(size_t i = 0; i < LIMBS; i++) {
+            uint64_t m = t[i] * inverse;
+            uint128_t sum = 0;
+            for(size_t j = 0; j < LIMBS; j++) {
+                sum += (uint128_t)m * modulus[j] + t[i + j];
+                t[i + j] = (uint64_t)sum;
+                sum >>= 64;
+            }
+            carry = _addcarry_u64(0, t[i + LIMBS], (uint64_t)sum, (limb_t*)&t[i + LIMBS]);
+            for(size_t k = i + LIMBS + 1; carry && k < 2 * LIMBS; k++) {
+                carry = _addcarry_u64(carry, t[k], 0, (limb_t*)&t[k]);
+            }
+            top += carry;
+        }
+        reduceOnce(result, t + LIMBS, top);
+    }
+
+    void toMontgomery(uint64_t* result, const fmpz_t value) const {
+        uint64_t limbs[LIMBS];
+        toLimbs(limbs, LIMBS, value);
+        multiply(result, limbs, rSquared);
+    }
+
+    void fromMontgomery(fmpz_t result, const uint64_t* value) const {
+        uint64_t one[LIMBS] = {1}, limbs[LIMBS];
+        multiply(limbs, value, one);
+        fmpz_set_ui_array(result, (const ulong*)limbs, LIMBS);
+    }
+};
+
+/**
+ * Almost-Montgomery multiplication in 52-bit limbs, eight to an AVX-512
+ * vector, with the IFMA instructions multiplying all the lanes by one limb of
+ * b at once. Each round adds the low halves of a*b[i] and m*y, shifts the
+ * whole accumulator down a lane, and adds the high halves, which belong one
+ * lane up. Lanes absorb carries until the end of the multiplication.
+ * Elements are only reduced below 2 * modulus, which R > 4 * modulus keeps
+ * bounded, until fromMontgomery.
+ */
+template <size_t LANES>
+struct IfmaEngine {
+    static const size_t SIZE = LANES;
+    static const size_t VECTORS = LANES / 8;
+    const uint64_t* modulus;
+    uint64_t inverse;
+    const uint64_t* rSquared;
+    const BigInt& modulusValue;
+
+    __attribute__((target("avx512f,avx512ifma"))) void multiply(uint64_t* result, const uint64_t* a,
+                                                                const uint64_t* b) const {
+        //The masked forms of the lane moves below take an explicit zero where the plain ones leave an operand
+        //undefined, which GCC reports as a read of an uninitialized vector
+        const __m512i zero = _mm512_setzero_si512();
+        const __m128i zero128 = _mm_setzero_si128();
+        __m512i t[VECTORS], aVectors[VECTORS], modulusVectors[VECTORS];
+        for(size_t k = 0; k < VECTORS; k++) {
+            t[k] = zero;
+            aVectors[k] = _mm512_loadu_si512(a + 8 * k);
+            modulusVectors[k] = _mm512_loadu_si512(modulus + 8 * k);
+        }
+        for(size_t i = 0; i < LANES; i++) {
+            __m512i bi = _mm512_set1_epi64(b[i]);
+            for(size_t k = 0; k < VECTORS; k++) {
+                t[k] = _mm512_madd52lo_epu64(t[k], aVectors[k], bi);
+            }
+            uint64_t y = (_mm_cvtsi128_si64(_mm512_mask_extracti32x4_epi32(zero128, 0xf, t[0], 0)) * inverse)
+                         & LANE_MASK;
+            __m512i yVector = _mm512_set1_epi64(y);
+            for(size_t k = 0; k < VECTORS; k++) {
+                t[k] = _mm512_madd52lo_epu64(t[k], modulusVectors[k], yVector);
+            }
+            //The low lane is now a multiple of 2^52; carry its high bits into the next one as it shifts out
+            uint64_t carry = (uint64_t)_mm_cvtsi128_si64(_mm512_mask_extracti32x4_epi32(zero128, 0xf, t[0], 0)) >> 52;
+            for(size_t k = 0; k + 1 < VECTORS; k++) {
+                t[k] = _mm512_mask_alignr_epi64(zero, 0xff, t[k + 1], t[k], 1);
+            }
+            t[VECTORS - 1] = _mm512_mask_alignr_epi64(zero, 0xff, zero, t[VECTORS - 1], 1);
+            t[0] = _mm512_mask_add_epi64(t[0], 1, t[0], _mm512_set1_epi64(carry));
+            for(size_t k = 0; k < VECTORS; k++) {
+                t[k] = _mm512_madd52hi_epu64(t[k], aVectors[k], bi);
+                t[k] = _mm512_madd52hi_epu64(t[k], modulusVectors[k], yVector);
+            }
+        }
+        alignas(64) uint64_t lanes[LANES];
+        for(size_t k = 0; k < VECTORS; k++) {
+            _mm512_store_si512(lanes + 8 * k, t[k]);
+        }
+        uint64_t carry = 0;
+        for(size_t j = 0; j < LANES; j++) {
+            uint64_t lane = lanes[j] + carry;
+            result[j] = lane & LANE_MASK;
+            carry = lane >> 52;
+        }
+    }
+
+    void square(uint64_t* result, const uint64_t* a) const {
+        multiply(result, a, a);
+    }
+
+    void toMontgomery(uint64_t* result, const fmpz_t value) const {
+        const size_t LIMBS = (52 * LANES + 63) / 64;
+        uint64_t limbs[LIMBS];
+        toLimbs(limbs, LIMBS, value);
+        alignas(64) uint64_t lanes[LANES];
+        limbsToLanes(lanes, LANES, limbs, LIMBS);
+        multiply(result, lanes, rSquared);
+    }
+
+    void fromMontgomery(fmpz_t result, const uint64_t* value) const {
+        const size_t LIMBS = (52 * LANES + 63) / 64;
+        alignas(64) uint64_t one[LANES] = {1}, lanes[LANES];
+        multiply(lanes, value, one);
+        uint64_t limbs[LIMBS];
+        lanesToLimbs(limbs, LIMBS, lanes, LANES);
+        fmpz_set_ui_array(result, (const ulong*)limbs, LIMBS);
+        //Multiplying by 1 leaves a value of at most modulus
+        if(fmpz_cmp(result, modulusValue.getUnderlyingObject()) >= 0)
+            fmpz_sub(result, result, modulusValue.getUnderlyingObject());
+    }
+};
+
+//The window size for an exponent of the given length, trading the table's cost against multiplications saved
+size_t windowBits(size_t exponentBits) {
+    if(exponentBits > 671)
+        return 6;
+    if(exponentBits > 239)
+        return 5;
+    if(exponentBits > 79)
+        return 4;
+    if(exponentBits > 23)
+        return 3;
+    return 1;
+}
+
+/**
+ * Left-to-right sliding-window exponentiation: the exponent is cut into odd
+ * windows of up to windowBits bits, each of which costs one multiplication by
+ * a precomputed odd power of the base.
+ */
+template <typename Engine>
+void slidingWindowPower(const Engine& engine, fmpz_t result, const fmpz_t base, const fmpz_t exponent) {
+    const size_t SIZE = Engine::SIZE;
+    long bit = (long)fmpz_bits(exponent) - 1;
+    if(bit < 0) {
+        fmpz_one(result);
+        return;
+    }
+    const size_t window = windowBits(bit + 1);
+    //Entry j of the table is base^(2j + 1)
+    alignas(64) uint64_t table[(size_t(1) << (MAX_WINDOW_BITS - 1)) * SIZE];
+    alignas(64) uint64_t square[SIZE], accumulator[SIZE];
+    engine.toMontgomery(table, base);
+    engine.square(square, table);
+    for(size_t j = 1; j < (size_t(1) << (window - 1)); j++) {
+        engine.multiply(table + j * SIZE, table + (j - 1) * SIZE, square);
+    }
+    bool started = false;
+    while(bit >= 0) {
+        if(!fmpz_tstbit(exponent, bit)) {
+            engine.square(accumulator, accumulator);
+            bit--;
+            continue;
+        }
+        long low = std::max(bit - (long)window + 1, 0L);
+        while(!fmpz_tstbit(exponent, low)) {
+            low++;
+        }
+        size_t digit = 0;
+        for(long b = bit; b >= low; b--) {
+            digit = (digit << 1) | fmpz_tstbit(exponent, b);
+        }
+        const uint64_t* entry = table + (digit >> 1) * SIZE;
+        if(started) {
+            for(long b = bit; b >= low; b--) {
+                engine.square(accumulator, accumulator);
+            }
+            engine.multiply(accumulator, accumulator, entry);
+        } else {
+            //The first window starts at the top bit, so nothing has been squared yet
+            memcpy(accumulator, entry, sizeof(accumulator));
+            started = true;
+        }
+        bit = low - 1;
+    }
+    engine.fromMontgomery(result, accumulator);
+}
+
+}  // namespace
+
+std::unique_ptr<FixedWidthModulus> FixedWidthModulus::create(const BigInt& modulus) {
+    if(ModN<16>::fits(modulus))
+        return std::unique_ptr<FixedWidthModulus>(new ModN<16>(modulus));
+    if(ModN<32>::fits(modulus))
+        return std::unique_ptr<FixedWidthModulus>(new ModN<32>(modulus));
+    if(ModN<48>::fits(modulus))
+        return std::unique_ptr<FixedWidthModulus>(new ModN<48>(modulus));
+    if(ModN<64>::fits(modulus))
+        return std::unique_ptr<FixedWidthModulus>(new ModN<64>(modulus));
+    return NULL;
+}
+
+bool FixedWidthModulus::isSupported(Kernel kernel) {
+    switch(kernel) {
+    case KERNEL_IFMA:
+        return CpuDispatch::getFeatures().avx512ifma;
+    default:
+        return true;
+    }
+}
+
+template <size_t LIMBS>
+bool ModN<LIMBS>::fits(const BigInt& modulus) {
+    const fmpz* value = modulus.getUnderlyingObject();
+    return fmpz_sgn(value) > 0 && fmpz_is_odd(value) && fmpz_size(value) == LIMBS;
+}
+
+template <size_t LIMBS>
+ModN<LIMBS>::ModN(const BigInt& modulus) : modulus(modulus) {
+    if(!fits(modulus))
+        throw ArithmeticException("Modulus does not fit this ModN.");
+    toLimbs(limbs, LIMBS, modulus.getUnderlyingObject());
+    inverse = negatedInverse(limbs[0]);
+    laneInverse = inverse & LANE_MASK;
+    limbsToLanes(lanes, LANES, limbs, LIMBS);
+    fmpz_t power;
+    fmpz_init(power);
+    powerOfTwo(power, 2 * 64 * LIMBS, modulus);
+    toLimbs(rSquared, LIMBS, power);
+    powerOfTwo(power, 2 * 52 * LANES, modulus);
+    uint64_t laneRSquaredLimbs[LIMBS];
+    toLimbs(laneRSquaredLimbs, LIMBS, power);
+    limbsToLanes(laneRSquared, LANES, laneRSquaredLimbs, LIMBS);
+    fmpz_clear(power);
+}
+
+template <size_t LIMBS>
+void ModN<LIMBS>::power(fmpz_t result, const fmpz_t base, const fmpz_t exponent, Kernel kernel) const {
+    if(kernel == KERNEL_IFMA) {
+        slidingWindowPower(IfmaEngine<LANES>{lanes, laneInverse, laneRSquared, modulus}, result, base, exponent);
+    } else {
+        slidingWindowPower(PortableEngine<LIMBS>{limbs, inverse, rSquared}, result, base, exponent);
+    }
+}
+
+template class ModN<16>;
+template class ModN<32>;
+template class ModN<48>;
+template class ModN<64>;
+
+}  //end namespace flint
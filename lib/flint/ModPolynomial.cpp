@@ -5,11 +5,63 @@
  *      Author: etremel
  */
 
+#include <atomic>
+
+#include <flint/fmpz_poly.h>
+#include <flint/fmpz_vec.h>
+
 #include <flint/ArithmeticException.hpp>
 #include <flint/ModPolynomial.hpp>
 
 namespace flint {
 
+namespace {
+
+std::atomic<ModPolynomial::MulKernel> mulKernel(ModPolynomial::MUL_FLINT);
+
+//FLINT's integer polynomial multiplications, which need len1 >= len2 > 0
+typedef void (*IntegerMulFunction)(fmpz* res, const fmpz* poly1, slong len1, const fmpz* poly2, slong len2);
+
+IntegerMulFunction integerMulFunction(ModPolynomial::MulKernel kernel) {
+    switch(kernel) {
+    case ModPolynomial::MUL_KS:
+        return _fmpz_poly_mul_KS;
+    case ModPolynomial::MUL_KARATSUBA:
+        return _fmpz_poly_mul_karatsuba;
+    default:
+        return _fmpz_poly_mul_classical;
+    }
+}
+
+/**
+ * Sets result to lhs * rhs by multiplying over the integers with the given
+ * kernel and reducing the coefficients afterwards, which is what
+ * fmpz_mod_poly_mul does with its own choice of algorithm. result may be lhs
+ * or rhs, since the product is built in a separate vector.
+ */
+void multiplyWith(ModPolynomial::MulKernel kernel, const fmpz_mod_poly_t lhs, const fmpz_mod_poly_t rhs,
+                  fmpz_mod_poly_t result) {
+    const fmpz_mod_poly_struct* longer = lhs->length >= rhs->length ? lhs : rhs;
+    const fmpz_mod_poly_struct* shorter = lhs->length >= rhs->length ? rhs : lhs;
+    if(shorter->length == 0) {
+        fmpz_mod_poly_zero(result);
+        return;
+    }
+    slong length = longer->length + shorter->length - 1;
+    fmpz* product = _fmpz_vec_init(length);
+    integerMulFunction(kernel)(product, longer->coeffs, longer->length, shorter->coeffs, shorter->length);
+    _fmpz_vec_scalar_mod_fmpz(product, product, length, fmpz_mod_poly_modulus(result));
+    fmpz_mod_poly_fit_length(result, length);
+    for(slong i = 0; i < length; i++) {
+        fmpz_swap(result->coeffs + i, product + i);
+    }
+    _fmpz_mod_poly_set_length(result, length);
+    _fmpz_mod_poly_normalise(result);
+    _fmpz_vec_clear(product, length);
+}
+
+}  // anonymous namespace
+
 //ModPolynomial::ModPolynomial() {
 //    fmpz_t modulus;
 //    fmpz_init_set_ui(modulus, 1);
@@ -86,8 +138,11 @@ BigInt ModPolynomial::getModulus() const {
 
 const BigMod ModPolynomial::at(long i) const {
     fmpz_t coeff;
+    fmpz_init(coeff);
     fmpz_mod_poly_get_coeff_fmpz(coeff, mod_poly, i);
-    return BigMod(coeff, fmpz_t{*fmpz_mod_poly_modulus(mod_poly)});
+    BigMod result(coeff, fmpz_t{*fmpz_mod_poly_modulus(mod_poly)});
+    fmpz_clear(coeff);
+    return result;
 }
 
 void ModPolynomial::set(long i, BigInt& value) {
@@ -138,6 +193,27 @@ void ModPolynomial::printPretty() const {
     fmpz_mod_poly_print_pretty(mod_poly, "x");
 }
 
+const char* ModPolynomial::getMulKernelName(MulKernel kernel) {
+    switch(kernel) {
+    case MUL_FLINT:
+        return "flint";
+    case MUL_KS:
+        return "ks";
+    case MUL_KARATSUBA:
+        return "karatsuba";
+    default:
+        return "classical";
+    }
+}
+
+ModPolynomial::MulKernel ModPolynomial::getMulKernel() {
+    return mulKernel.load();
+}
+
+void ModPolynomial::setMulKernel(MulKernel kernel) {
+    mulKernel.store(kernel);
+}
+
 /* ----------------------- End class ModPolynomial -------------------------- */
 
 void add(const ModPolynomial& lhs, const ModPolynomial& rhs, ModPolynomial& result) {
@@ -158,7 +234,12 @@ void multiply(const ModPolynomial& lhs, const ModPolynomial& rhs, ModPolynomial&
     if(!fmpz_equal(fmpz_mod_poly_modulus(lhs.mod_poly), fmpz_mod_poly_modulus(rhs.mod_poly)))
         throw ArithmeticException("Polynomial multiplication error: operands have different moduli.");
     fmpz_set(fmpz_mod_poly_modulus(result.mod_poly), fmpz_mod_poly_modulus(lhs.mod_poly));
-    fmpz_mod_poly_mul(result.mod_poly, lhs.mod_poly, rhs.mod_poly);
+    ModPolynomial::MulKernel kernel = mulKernel.load(std::memory_order_relaxed);
+    if(kernel == ModPolynomial::MUL_FLINT) {
+        fmpz_mod_poly_mul(result.mod_poly, lhs.mod_poly, rhs.mod_poly);
+    } else {
+        multiplyWith(kernel, lhs.mod_poly, rhs.mod_poly, result.mod_poly);
+    }
 }
 
 void power(const ModPolynomial& base, const unsigned long& exponent, ModPolynomial& result) {
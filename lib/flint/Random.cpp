@@ -19,18 +19,21 @@ Random::~Random() {
 
 BigInt Random::nextInt(unsigned long numBits) {
     fmpz_t random;
+    fmpz_init(random);
     fmpz_randbits(random, randomState, numBits);
     return BigInt(std::move(random));
 }
 
 BigInt Random::nextInt(BigInt& upperBound) {
     fmpz_t random;
+    fmpz_init(random);
     fmpz_randm(random, randomState, upperBound.getUnderlyingObject());
     return BigInt(std::move(random));
 }
 
 BigInt Random::nextUnsignedInt(unsigned long numBits) {
     fmpz_t random;
+    fmpz_init(random);
     fmpz_randtest_unsigned(random, randomState, numBits);
     return BigInt(std::move(random));
 }
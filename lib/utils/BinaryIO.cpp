@@ -0,0 +1,99 @@
+/*
+ * BinaryIO.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cstring>
+#include <fstream>
+
+#include <utils/BinaryIO.hpp>
+
+BufferedWriter::BufferedWriter(std::ostream& out, size_t capacity) : _out(out), _buffer(capacity), _used(0) {
+}
+
+BufferedWriter::BufferedWriter(const char* fileName, size_t capacity)
+        : _file(std::make_unique<std::ofstream>(fileName, std::ios::out | std::ios::binary | std::ios::trunc)),
+          _out(*_file),
+          _buffer(capacity),
+          _used(0) {
+}
+
+BufferedWriter::~BufferedWriter() {
+    flush();
+}
+
+std::byte* BufferedWriter::reserve(size_t size) {
+    if(_used + size > _buffer.size()) {
+        flush();
+        if(size > _buffer.size())
+            _buffer.resize(size);
+    }
+    std::byte* space = _buffer.data() + _used;
+    _used += size;
+    return space;
+}
+
+void BufferedWriter::write(const void* data, size_t size) {
+    memcpy(reserve(size), data, size);
+}
+
+void BufferedWriter::flush() {
+    if(_used > 0) {
+        _out.write((const char*)_buffer.data(), _used);
+        _used = 0;
+    }
+    _out.flush();
+}
+
+bool BufferedWriter::good() const {
+    return _out.good();
+}
+
+BufferedReader::BufferedReader(std::istream& in, size_t capacity)
+        : _in(in), _buffer(capacity), _begin(0), _end(0), _failed(false) {
+}
+
+BufferedReader::BufferedReader(const char* fileName, size_t capacity)
+        : _file(std::make_unique<std::ifstream>(fileName, std::ios::in | std::ios::binary)),
+          _in(*_file),
+          _buffer(capacity),
+          _begin(0),
+          _end(0),
+          _failed(!*_file) {
+}
+
+const std::byte* BufferedReader::take(size_t size) {
+    if(_end - _begin < size) {
+        //Move what's left to the front and refill the rest of the buffer
+        size_t left = _end - _begin;
+        memmove(_buffer.data(), _buffer.data() + _begin, left);
+        _begin = 0;
+        _end = left;
+        if(size > _buffer.size())
+            _buffer.resize(size);
+        if(_in) {
+            _in.read((char*)_buffer.data() + _end, _buffer.size() - _end);
+            _end += _in.gcount();
+        }
+        if(_end < size) {
+            _failed = true;
+            return NULL;
+        }
+    }
+    const std::byte* data = _buffer.data() + _begin;
+    _begin += size;
+    return data;
+}
+
+bool BufferedReader::read(void* data, size_t size) {
+    const std::byte* source = take(size);
+    if(source == NULL)
+        return false;
+    memcpy(data, source, size);
+    return true;
+}
+
+bool BufferedReader::good() const {
+    return !_failed;
+}
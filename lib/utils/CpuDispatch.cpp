@@ -0,0 +1,200 @@
+/*
+ * CpuDispatch.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <cpuid.h>
+
+#include <bilinear/Mont64Field.hpp>
+#include <flint/ModContext.hpp>
+#include <flint/ModPolynomial.hpp>
+#include <utils/CpuDispatch.hpp>
+#include <utils/SHA256.hpp>
+
+namespace CpuDispatch {
+
+namespace {
+
+//XCR0 reports which register states the OS saves on context switches
+unsigned long long readXcr0() {
+    unsigned int low, high;
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return ((unsigned long long)high << 32) | low;
+}
+
+Features detectFeatures() {
+    Features features = {};
+    unsigned int eax, ebx, ecx, edx;
+    if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return features;
+    features.sse41 = ecx & bit_SSE4_1;
+    //The vector extensions are only usable if the OS saves their registers
+    bool avxState = false, avx512State = false;
+    if(ecx & bit_OSXSAVE) {
+        unsigned long long xcr0 = readXcr0();
+        avxState = (xcr0 & 0x6) == 0x6;            //SSE and AVX state
+        avx512State = avxState && (xcr0 & 0xe0) == 0xe0;  //opmask and ZMM state
+    }
+    if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return features;
+    features.bmi2 = ebx & bit_BMI2;
+    features.adx = ebx & bit_ADX;
+    features.sha = ebx & bit_SHA;
+    features.avx2 = avxState && (ebx & bit_AVX2);
+    features.avx512f = avx512State && (ebx & bit_AVX512F);
+    features.avx512ifma = features.avx512f && (ebx & bit_AVX512IFMA);
+    return features;
+}
+
+/*
+ * Each kernel's implementations are an enum in the module that owns it; this
+ * adapts them to a common shape so the functions below can treat them alike.
+ * Variants are the enum values, which list implementations best first.
+ */
+struct KernelOps {
+    const char* name;
+    int numVariants;
+    const char* (*variantName)(int variant);
+    bool (*isSupported)(int variant);
+    int (*getSelected)();
+    void (*select)(int variant);
+};
+
+const KernelOps KERNEL_OPS[] = {
+        {"field.multiply", Mont64::NUM_MUL_KERNELS,
+         [](int variant) { return Mont64::getMulKernelName((Mont64::MulKernel)variant); },
+         [](int variant) { return Mont64::isSupported((Mont64::MulKernel)variant); },
+         []() { return (int)Mont64::getMulKernel(); },
+         [](int variant) { Mont64::setMulKernel((Mont64::MulKernel)variant); }},
+        {"sha256", ::SHA256::NUM_KERNELS,
+         [](int variant) { return ::SHA256::getKernelName((::SHA256::Kernel)variant); },
+         [](int variant) { return ::SHA256::isSupported((::SHA256::Kernel)variant); },
+         []() { return (int)::SHA256::getKernel(); },
+         [](int variant) { ::SHA256::setKernel((::SHA256::Kernel)variant); }},
+        {"sha256.batch", ::SHA256::NUM_BATCH_KERNELS,
+         [](int variant) { return ::SHA256::getBatchKernelName((::SHA256::BatchKernel)variant); },
+         [](int variant) { return ::SHA256::isSupported((::SHA256::BatchKernel)variant); },
+         []() { return (int)::SHA256::getBatchKernel(); },
+         [](int variant) { ::SHA256::setBatchKernel((::SHA256::BatchKernel)variant); }},
+        {"polynomial.multiply", flint::ModPolynomial::NUM_MUL_KERNELS,
+         [](int variant) { return flint::ModPolynomial::getMulKernelName((flint::ModPolynomial::MulKernel)variant); },
+         [](int) { return true; },
+         []() { return (int)flint::ModPolynomial::getMulKernel(); },
+         [](int variant) { flint::ModPolynomial::setMulKernel((flint::ModPolynomial::MulKernel)variant); }},
+        {"modular.power", flint::ModContext::NUM_POWER_KERNELS,
+         [](int variant) { return flint::ModContext::getPowerKernelName((flint::ModContext::PowerKernel)variant); },
+         [](int variant) { return flint::ModContext::isSupported((flint::ModContext::PowerKernel)variant); },
+         []() { return (int)flint::ModContext::getPowerKernel(); },
+         [](int variant) { flint::ModContext::setPowerKernel((flint::ModContext::PowerKernel)variant); }}};
+
+const KernelOps& opsFor(Kernel kernel) {
+    return KERNEL_OPS[kernel];
+}
+
+//The index of the named variant, or -1
+int findVariant(const KernelOps& ops, const std::string& variant) {
+    for(int i = 0; i < ops.numVariants; i++) {
+        if(variant == ops.variantName(i))
+            return i;
+    }
+    return -1;
+}
+
+}  // anonymous namespace
+
+const Features& getFeatures() {
+    static const Features features = detectFeatures();
+    return features;
+}
+
+std::string describeFeatures() {
+    const Features& features = getFeatures();
+    std::string description;
+    auto append = [&](bool present, const char* name) {
+        if(present) {
+            description += description.empty() ? "" : " ";
+            description += name;
+        }
+    };
+    append(features.bmi2, "bmi2");
+    append(features.adx, "adx");
+    append(features.sse41, "sse4.1");
+    append(features.avx2, "avx2");
+    append(features.avx512f, "avx512f");
+    append(features.avx512ifma, "avx512ifma");
+    append(features.sha, "sha");
+    return description;
+}
+
+const std::vector<Kernel>& getKernels() {
+    static const std::vector<Kernel> kernels = {FIELD_MULTIPLICATION, SHA256_DIGEST, SHA256_BATCH,
+                                                POLYNOMIAL_MULTIPLICATION, MODULAR_POWER};
+    return kernels;
+}
+
+const char* getName(Kernel kernel) {
+    return opsFor(kernel).name;
+}
+
+bool fromName(const std::string& name, Kernel& kernel) {
+    for(Kernel candidate : getKernels()) {
+        if(name == getName(candidate)) {
+            kernel = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> getVariants(Kernel kernel) {
+    const KernelOps& ops = opsFor(kernel);
+    std::vector<std::string> variants;
+    for(int i = 0; i < ops.numVariants; i++) {
+        variants.push_back(ops.variantName(i));
+    }
+    return variants;
+}
+
+bool isSupported(Kernel kernel, const std::string& variant) {
+    const KernelOps& ops = opsFor(kernel);
+    int index = findVariant(ops, variant);
+    return index >= 0 && ops.isSupported(index);
+}
+
+std::string getSelected(Kernel kernel) {
+    const KernelOps& ops = opsFor(kernel);
+    return ops.variantName(ops.getSelected());
+}
+
+bool select(Kernel kernel, const std::string& variant) {
+    const KernelOps& ops = opsFor(kernel);
+    int index = findVariant(ops, variant);
+    if(index < 0 || !ops.isSupported(index))
+        return false;
+    ops.select(index);
+    return true;
+}
+
+void selectDefaults() {
+    for(Kernel kernel : getKernels()) {
+        const KernelOps& ops = opsFor(kernel);
+        for(int i = 0; i < ops.numVariants; i++) {
+            if(ops.isSupported(i)) {
+                ops.select(i);
+                break;
+            }
+        }
+    }
+}
+
+std::string describeSelection() {
+    std::string description;
+    for(Kernel kernel : getKernels()) {
+        description += description.empty() ? "" : " ";
+        description += std::string(getName(kernel)) + "=" + getSelected(kernel);
+    }
+    return description;
+}
+
+}  // namespace CpuDispatch
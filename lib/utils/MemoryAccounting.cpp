@@ -0,0 +1,255 @@
+/*
+ * MemoryAccounting.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <gmp.h>
+
+#include <flint/BigMod.hpp>
+#include <utils/MemoryAccounting.hpp>
+
+namespace MemoryAccounting {
+
+namespace {
+
+std::atomic<uint64_t> current(0);
+std::atomic<uint64_t> peak(0);
+std::atomic<uint64_t> totalAllocated(0);
+//The peak since each active Scope started, in the slot it claimed; bit i of activeSlots marks slot i in use
+std::atomic<uint64_t> scopePeaks[MAX_SCOPES];
+std::atomic<uint64_t> activeSlots(0);
+
+std::mutex statsMutex;
+OperationStats operationStats[Metrics::NUM_TIMERS];
+
+void raiseTo(std::atomic<uint64_t>& maximum, uint64_t value) {
+    uint64_t previous = maximum.load(std::memory_order_relaxed);
+    while(previous < value && !maximum.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+}  // anonymous namespace
+
+void recordAllocation(size_t bytes) {
+    uint64_t now = current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    totalAllocated.fetch_add(bytes, std::memory_order_relaxed);
+    raiseTo(peak, now);
+    for(uint64_t slots = activeSlots.load(std::memory_order_acquire); slots; slots &= slots - 1) {
+        raiseTo(scopePeaks[__builtin_ctzll(slots)], now);
+    }
+}
+
+void recordFree(size_t bytes) {
+    current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+uint64_t currentBytes() {
+    return current.load();
+}
+
+uint64_t peakBytes() {
+    return peak.load();
+}
+
+void resetPeak() {
+    peak.store(current.load());
+}
+
+OperationStats getOperationStats(Operation op) {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return operationStats[op];
+}
+
+void resetOperationStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    for(OperationStats& stats : operationStats) {
+        stats = OperationStats();
+    }
+}
+
+uint64_t peakResidentBytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    //Linux reports ru_maxrss in kilobytes
+    return uint64_t(usage.ru_maxrss) * 1024;
+}
+
+uint64_t currentResidentBytes() {
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if(statm == NULL)
+        return 0;
+    unsigned long totalPages = 0, residentPages = 0;
+    int matched = fscanf(statm, "%lu %lu", &totalPages, &residentPages);
+    fclose(statm);
+    if(matched != 2)
+        return 0;
+    return uint64_t(residentPages) * sysconf(_SC_PAGESIZE);
+}
+
+namespace {
+
+//Bits in an element of the DCLXVI scalar field, and in a prime representative
+const size_t SCALAR_BITS = 256;
+//Covers the bookkeeping every call does regardless of n (small temporaries, ThreadPool futures)
+const size_t FIXED_OVERHEAD = 4096;
+
+//Footprint of a block handed out by MemoryPool, which rounds up to a power of two
+size_t poolBlockBytes(size_t bytes) {
+    size_t block = 32;
+    while(block < bytes)
+        block <<= 1;
+    return 16 + block;
+}
+
+//Footprint of an fmpz holding a value of the given size: the mpz_t struct plus its limbs
+size_t fmpzBytes(size_t bits) {
+    return poolBlockBytes(sizeof(__mpz_struct)) + poolBlockBytes((bits + 63) / 64 * 8);
+}
+
+}  // anonymous namespace
+
+size_t estimateMemory(Operation op, size_t n, size_t threads, size_t modulusBits) {
+    const size_t scalar = fmpzBytes(SCALAR_BITS);
+    const size_t residue = fmpzBytes(modulusBits);
+    //Every task in the pool may be working at once, but there are never more tasks than elements
+    const size_t concurrentTasks = std::max<size_t>(1, std::min(threads, n));
+    size_t bytes = 0;
+    //The per-element constants below were fitted to the peaks getOperationStats
+    //reports with MemoryPool installed, for n from 32 to 1024
+    switch(op) {
+    case Metrics::BILINEAR_GEN_KEY:
+    case Metrics::BILINEAR_ACCUMULATE_PRIVATE:
+    case Metrics::BILINEAR_ACCUMULATE_PUBLIC:
+    case Metrics::BILINEAR_WITNESSES_PRIVATE:
+    case Metrics::BILINEAR_WITNESSES_PUBLIC:
+    case Metrics::BILINEAR_VERIFY:
+        throw std::invalid_argument("Estimating a bilinear operation needs the sizes of its elements");
+    case Metrics::RSA_GEN_KEY:
+        //Dominated by the candidate primes tested while searching for p and q
+        bytes = 48 * residue;
+        break;
+    case Metrics::RSA_GEN_REPRESENTATIVES:
+        bytes = n * scalar + concurrentTasks * 2 * residue;
+        break;
+    case Metrics::RSA_ACCUMULATE_PRIVATE:
+        bytes = 6 * residue;
+        break;
+    case Metrics::RSA_ACCUMULATE_PUBLIC:
+        bytes = 2 * residue;
+        break;
+    case Metrics::RSA_WITNESSES_PRIVATE:
+        //The left and right exponent products, plus the exponentiation temporaries
+        bytes = n * (2 * sizeof(flint::BigMod) + 6 * residue);
+        break;
+    case Metrics::RSA_WITNESSES_PUBLIC:
+        bytes = n * 2 * residue;
+        break;
+    case Metrics::RSA_VERIFY:
+        bytes = 8 * residue;
+        break;
+    case Metrics::RSA_AGGREGATE_WITNESSES:
+    case Metrics::RSA_PROVE_BATCH:
+        //Two levels of the aggregation tree at once, whose products total twice the representatives' size
+        bytes = n * (2 * sizeof(flint::BigMod) + 2 * residue + 4 * scalar);
+        break;
+    case Metrics::RSA_VERIFY_BATCH:
+        bytes = n * scalar + concurrentTasks * 2 * residue + 8 * residue;
+        break;
+    case Metrics::RSA_VERIFY_RANDOMIZED:
+        //A copy of each witness and its randomized exponent, plus each task's window tables
+        bytes = n * (sizeof(flint::BigMod) + residue + 3 * scalar) + concurrentTasks * 128 * 9 * residue;
+        break;
+    case Metrics::RSA_ADD:
+    case Metrics::RSA_UPDATE:
+    case Metrics::RSA_UPDATE_WITNESS:
+        //The products of the changed representatives, and the exponentiation temporaries
+        bytes = 2 * n * scalar + 8 * residue;
+        break;
+    case Metrics::RSA_ACCUMULATE_PIPELINED:
+        //Only a few batches of 64 elements are in flight per thread, each held as elements, representatives
+        //and their product, however many elements there are
+        bytes = (2 * concurrentTasks + 1) * 64 * 3 * scalar + 8 * residue;
+        break;
+    default:
+        break;
+    }
+    //Leave a quarter of headroom, since the estimate is used to refuse work rather than to report it
+    return FIXED_OVERHEAD + bytes + bytes / 4;
+}
+
+size_t estimateMemory(Operation op, size_t n, const ElementSizes& elements, size_t threads) {
+    const size_t scalar = fmpzBytes(SCALAR_BITS);
+    const size_t concurrentTasks = std::max<size_t>(1, std::min(threads, n));
+    //The multi-exponentiation's point, exponent and pointer arrays, per term
+    const size_t term = elements.accumulatorPoint + elements.exponent + sizeof(void*);
+    size_t bytes = 0;
+    switch(op) {
+    case Metrics::BILINEAR_GEN_KEY:
+        //The key itself: one G1 and one G2 element per power of s
+        bytes = (n + 1) * (elements.g1Element + elements.g2Element);
+        break;
+    case Metrics::BILINEAR_ACCUMULATE_PRIVATE:
+        bytes = elements.g1Element + elements.g2Element + 2 * scalar;
+        break;
+    case Metrics::BILINEAR_ACCUMULATE_PUBLIC:
+        //The coefficient polynomial plus the multi-exponentiation's arrays
+        bytes = n * (term + scalar);
+        break;
+    case Metrics::BILINEAR_WITNESSES_PRIVATE:
+        bytes = n * (sizeof(flint::BigMod) + 3 * scalar);
+        break;
+    case Metrics::BILINEAR_WITNESSES_PUBLIC:
+        //Each task copies the set minus one element and builds its own coefficients
+        bytes = concurrentTasks * n * (term + 5 * scalar);
+        break;
+    case Metrics::BILINEAR_VERIFY:
+        break;
+    default:
+        return estimateMemory(op, n, threads);
+    }
+    return FIXED_OVERHEAD + bytes + bytes / 4;
+}
+
+Scope::Scope(Operation op) : op(op), startTotal(totalAllocated.load()), slot(MAX_SCOPES) {
+    uint64_t slots = activeSlots.load();
+    while(~slots) {
+        unsigned int free = __builtin_ctzll(~slots);
+        if(activeSlots.compare_exchange_weak(slots, slots | (1ULL << free))) {
+            slot = free;
+            break;
+        }
+    }
+    //Read after claiming the slot, so that every allocation after the start raises the slot's peak
+    startBytes = current.load();
+    if(slot < MAX_SCOPES)
+        scopePeaks[slot].store(startBytes);
+}
+
+Scope::~Scope() {
+    uint64_t peakAbove = 0;
+    if(slot < MAX_SCOPES) {
+        uint64_t reached = scopePeaks[slot].load();
+        peakAbove = reached > startBytes ? reached - startBytes : 0;
+        activeSlots.fetch_and(~(1ULL << slot));
+    }
+    uint64_t allocated = totalAllocated.load() - startTotal;
+    std::lock_guard<std::mutex> lock(statsMutex);
+    OperationStats& stats = operationStats[op];
+    stats.calls++;
+    stats.lastPeakBytes = peakAbove;
+    if(peakAbove > stats.maxPeakBytes)
+        stats.maxPeakBytes = peakAbove;
+    stats.totalAllocatedBytes += allocated;
+}
+
+}  // namespace MemoryAccounting
@@ -0,0 +1,354 @@
+/*
+ * MemoryPool.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <gmp.h>
+#include <flint/flint.h>
+
+#include <utils/MemoryAccounting.hpp>
+#include <utils/MemoryPool.hpp>
+
+namespace MemoryPool {
+
+namespace {
+
+//Size classes are 32, 64, ..., 8192 bytes. The largest comfortably holds a
+//3072-bit RSA modulus product, and a coefficient array of a few hundred
+//fmpz's; anything bigger is rare enough to send to malloc.
+const size_t MIN_CLASS_SHIFT = 5;
+const size_t NUM_CLASSES = 9;
+const uint32_t LARGE_CLASS = NUM_CLASSES;
+//Bounds how much memory each thread can hold on to between trims
+const size_t MAX_CACHED_PER_CLASS = 256;
+
+//Precedes every block handed out; 16 bytes so the user pointer keeps malloc's alignment
+struct Header {
+    uint32_t sizeClass;
+    uint32_t padding;
+    size_t size;  //Only meaningful for LARGE_CLASS blocks
+};
+static_assert(sizeof(Header) == 16, "Header must preserve 16-byte alignment");
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+//Exceptions can't propagate through GMP and FLINT, so fail the way GMP's own allocator does
+[[noreturn]] void outOfMemory() {
+    fprintf(stderr, "MemoryPool: cannot allocate memory\n");
+    abort();
+}
+
+size_t classSize(size_t sizeClass) {
+    return size_t(1) << (sizeClass + MIN_CLASS_SHIFT);
+}
+
+//The real footprint of a block, for MemoryAccounting
+[[maybe_unused]] size_t blockBytes(const Header* header) {
+    return sizeof(Header) + (header->sizeClass == LARGE_CLASS ? header->size : classSize(header->sizeClass));
+}
+
+uint32_t classFor(size_t size) {
+    for(uint32_t c = 0; c < NUM_CLASSES; c++) {
+        if(size <= classSize(c))
+            return c;
+    }
+    return LARGE_CLASS;
+}
+
+Header* headerOf(void* ptr) {
+    return static_cast<Header*>(ptr) - 1;
+}
+
+void* userPointer(Header* header) {
+    return header + 1;
+}
+
+std::atomic<bool> installed(false);
+std::atomic<uint64_t> trimGeneration(0);
+std::atomic<int> activeScopes(0);
+
+struct Counters {
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> systemAllocations;
+    std::atomic<uint64_t> systemFrees;
+    std::atomic<uint64_t> cachedBytes;
+    Counters() : allocations(0), systemAllocations(0), systemFrees(0), cachedBytes(0) {}
+};
+
+//Only the owning thread writes to its counters, so a load and a store is enough
+void bump(std::atomic<uint64_t>& counter, int64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+struct ThreadCache;
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCache*> caches;
+    //Stats of threads that have exited, and of allocations made with no thread cache
+    Counters retired;
+};
+
+//Never destroyed, since threads may still free memory during static destruction
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+void retire(std::atomic<uint64_t>& total, uint64_t amount) {
+    total.fetch_add(amount, std::memory_order_relaxed);
+}
+
+thread_local bool cacheAlive = false;
+
+struct ThreadCache {
+    FreeBlock* freeLists[NUM_CLASSES];
+    size_t numCached[NUM_CLASSES];
+    uint64_t generation;
+    Counters counters;
+
+    ThreadCache() : generation(trimGeneration.load()) {
+        for(size_t c = 0; c < NUM_CLASSES; c++) {
+            freeLists[c] = nullptr;
+            numCached[c] = 0;
+        }
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().caches.push_back(this);
+        cacheAlive = true;
+    }
+
+    ~ThreadCache() {
+        cacheAlive = false;
+        release();
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        retire(reg.retired.allocations, counters.allocations.load());
+        retire(reg.retired.systemAllocations, counters.systemAllocations.load());
+        retire(reg.retired.systemFrees, counters.systemFrees.load());
+        for(auto it = reg.caches.begin(); it != reg.caches.end(); ++it) {
+            if(*it == this) {
+                reg.caches.erase(it);
+                break;
+            }
+        }
+    }
+
+    //Returns every cached block to the system
+    void release() {
+        for(size_t c = 0; c < NUM_CLASSES; c++) {
+            while(freeLists[c] != nullptr) {
+                FreeBlock* block = freeLists[c];
+                freeLists[c] = block->next;
+                free(headerOf(block));
+                bump(counters.systemFrees);
+            }
+            numCached[c] = 0;
+        }
+        counters.cachedBytes.store(0, std::memory_order_relaxed);
+    }
+
+    void checkTrim() {
+        uint64_t current = trimGeneration.load(std::memory_order_relaxed);
+        if(generation != current) {
+            release();
+            generation = current;
+        }
+    }
+};
+
+//Returns nullptr once the calling thread's cache has been destroyed
+ThreadCache* localCache() {
+    thread_local ThreadCache cache;
+    return cacheAlive ? &cache : nullptr;
+}
+
+void* systemAllocate(uint32_t sizeClass, size_t size, ThreadCache* cache) {
+    size_t blockSize = (sizeClass == LARGE_CLASS ? size : classSize(sizeClass));
+    if(blockSize > SIZE_MAX - sizeof(Header))
+        outOfMemory();
+    Header* header = static_cast<Header*>(malloc(sizeof(Header) + blockSize));
+    if(header == nullptr)
+        outOfMemory();
+    header->sizeClass = sizeClass;
+    header->size = size;
+    if(cache) {
+        bump(cache->counters.systemAllocations);
+    } else {
+        retire(registry().retired.systemAllocations, 1);
+    }
+    return userPointer(header);
+}
+
+void systemFree(Header* header, ThreadCache* cache) {
+    free(header);
+    if(cache) {
+        bump(cache->counters.systemFrees);
+    } else {
+        retire(registry().retired.systemFrees, 1);
+    }
+}
+
+/* Adapters for the GMP and FLINT hook signatures */
+
+void* gmpAllocate(size_t size) {
+    return allocate(size);
+}
+
+void* gmpReallocate(void* ptr, size_t, size_t newSize) {
+    return reallocate(ptr, newSize);
+}
+
+void gmpFree(void* ptr, size_t) {
+    deallocate(ptr);
+}
+
+void* flintCallocate(size_t num, size_t size) {
+    //FLINT's own flint_calloc aborts when it can't allocate, and an overflowing num * size can't be allocated
+    if(num != 0 && size > SIZE_MAX / num)
+        outOfMemory();
+    void* ptr = allocate(num * size);
+    memset(ptr, 0, num * size);
+    return ptr;
+}
+
+}  // anonymous namespace
+
+void install() {
+    if(installed.exchange(true))
+        return;
+    mp_set_memory_functions(gmpAllocate, gmpReallocate, gmpFree);
+    __flint_set_memory_functions(allocate, flintCallocate, reallocate, deallocate);
+}
+
+bool isInstalled() {
+    return installed.load(std::memory_order_relaxed);
+}
+
+void* allocate(size_t size) {
+    uint32_t sizeClass = classFor(size);
+    ThreadCache* cache = localCache();
+    if(cache) {
+        cache->checkTrim();
+        bump(cache->counters.allocations);
+    } else {
+        retire(registry().retired.allocations, 1);
+    }
+    if(sizeClass != LARGE_CLASS && cache && cache->freeLists[sizeClass] != nullptr) {
+        FreeBlock* block = cache->freeLists[sizeClass];
+        cache->freeLists[sizeClass] = block->next;
+        cache->numCached[sizeClass]--;
+        bump(cache->counters.cachedBytes, -int64_t(classSize(sizeClass)));
+        MEMORY_RECORD_ALLOCATION(blockBytes(headerOf(block)));
+        return block;
+    }
+    void* ptr = systemAllocate(sizeClass, size, cache);
+    MEMORY_RECORD_ALLOCATION(blockBytes(headerOf(ptr)));
+    return ptr;
+}
+
+void* reallocate(void* ptr, size_t newSize) {
+    if(ptr == nullptr)
+        return allocate(newSize);
+    Header* header = headerOf(ptr);
+    size_t oldSize;
+    if(header->sizeClass == LARGE_CLASS) {
+        oldSize = header->size;
+        if(classFor(newSize) == LARGE_CLASS) {
+            //Both sizes are too big for the pool, so let the system resize in place if it can
+            MEMORY_RECORD_FREE(blockBytes(header));
+            Header* resized = static_cast<Header*>(realloc(header, sizeof(Header) + newSize));
+            if(resized == nullptr)
+                outOfMemory();
+            resized->size = newSize;
+            MEMORY_RECORD_ALLOCATION(blockBytes(resized));
+            return userPointer(resized);
+        }
+    } else {
+        oldSize = classSize(header->sizeClass);
+        if(newSize <= oldSize)
+            return ptr;
+    }
+    void* newPtr = allocate(newSize);
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    deallocate(ptr);
+    return newPtr;
+}
+
+void deallocate(void* ptr) {
+    if(ptr == nullptr)
+        return;
+    Header* header = headerOf(ptr);
+    MEMORY_RECORD_FREE(blockBytes(header));
+    ThreadCache* cache = localCache();
+    if(cache)
+        cache->checkTrim();
+    uint32_t sizeClass = header->sizeClass;
+    if(sizeClass == LARGE_CLASS || cache == nullptr || cache->numCached[sizeClass] >= MAX_CACHED_PER_CLASS) {
+        systemFree(header, cache);
+        return;
+    }
+    //Blocks freed by a thread go on that thread's list, whichever thread allocated them
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = cache->freeLists[sizeClass];
+    cache->freeLists[sizeClass] = block;
+    cache->numCached[sizeClass]++;
+    bump(cache->counters.cachedBytes, classSize(sizeClass));
+}
+
+void trim() {
+    trimGeneration.fetch_add(1);
+    ThreadCache* cache = localCache();
+    if(cache)
+        cache->checkTrim();
+}
+
+Stats getStats() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    Stats stats = {reg.retired.allocations.load(), reg.retired.systemAllocations.load(),
+                   reg.retired.systemFrees.load(), 0};
+    for(ThreadCache* cache : reg.caches) {
+        stats.allocations += cache->counters.allocations.load(std::memory_order_relaxed);
+        stats.systemAllocations += cache->counters.systemAllocations.load(std::memory_order_relaxed);
+        stats.systemFrees += cache->counters.systemFrees.load(std::memory_order_relaxed);
+        stats.cachedBytes += cache->counters.cachedBytes.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void resetStats() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired.allocations = 0;
+    reg.retired.systemAllocations = 0;
+    reg.retired.systemFrees = 0;
+    //Other threads' counters are single-writer, so they are reset by
+    //subtracting the current values out of the retired totals instead
+    for(ThreadCache* cache : reg.caches) {
+        retire(reg.retired.allocations, -cache->counters.allocations.load(std::memory_order_relaxed));
+        retire(reg.retired.systemAllocations, -cache->counters.systemAllocations.load(std::memory_order_relaxed));
+        retire(reg.retired.systemFrees, -cache->counters.systemFrees.load(std::memory_order_relaxed));
+    }
+}
+
+Scope::Scope() : active(isInstalled()) {
+    if(active)
+        activeScopes.fetch_add(1);
+}
+
+Scope::~Scope() {
+    if(active && activeScopes.fetch_sub(1) == 1)
+        trim();
+}
+
+}  // namespace MemoryPool
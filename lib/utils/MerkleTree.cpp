@@ -5,6 +5,9 @@
 
 #include <pthread.h>
 
+#include <algorithm>
+#include <set>
+
 #include <utils/MerkleTree.hpp>
 #include <utils/SHA256.hpp>
 
@@ -118,51 +121,68 @@ void MerkleTree::constructTree(const vector<vector<unsigned char> >& hashes) {
         _tree[offset] = *(new vector<unsigned char>(SHA256::DIGEST_LENGTH, 0));
     }
 
-    // Fill higher level hashes from leaves
-    int parentOffset;
-    char parentHash[2 * SHA256::DIGEST_LENGTH];
+    // Fill higher level hashes from leaves, hashing all of a level's parents in one batch
+    vector<int> leftChildren;
     for(int level = _height; level > 0; level--) {
         //cout<<"Filling level "<<level<<endl;
+        leftChildren.clear();
         for(offset = int(pow(2, level) - 1); offset < int(pow(2, level + 1) - 2); offset += 2) {
-            //cout<<"\toffset "<<offset<<endl;
-            getParentOffset(offset, level, parentOffset);
-            //cout<<"\t\tparentOffset "<<parentOffset<<endl;
-
-            for(int i = 0; i < SHA256::DIGEST_LENGTH; i++) {
-                parentHash[i] = char(_tree[offset][i]);
-                parentHash[i + SHA256::DIGEST_LENGTH] = char(_tree[offset + 1][i]);
-            }
-            SHA256::computeDigest(parentHash, 2 * SHA256::DIGEST_LENGTH, _tree[parentOffset]);
+            leftChildren.push_back(offset);
         }
+        hashParents(leftChildren, level);
     }
 
     _rootHash = _tree[0];
 }
 
 void MerkleTree::updateHash(int offset, const vector<unsigned char>& digest) {
-    int parentOffset;
-    char parentHash[2 * SHA256::DIGEST_LENGTH];
+    updateHashes(vector<int>(1, offset), vector<vector<unsigned char>>(1, digest));
+}
 
-    offset += int(pow(2, _height) - 1);
-    _tree[offset] = digest;
+void MerkleTree::updateHashes(const vector<int>& offsets, const vector<vector<unsigned char>>& digests) {
+    int startOffset = int(pow(2, _height) - 1);
 
-    if(offset % 2 == 0) {
-        offset -= 1;
+    // The left children of the nodes that need rehashing, one level at a time
+    set<int> dirty;
+    for(size_t i = 0; i < offsets.size(); i++) {
+        int offset = startOffset + offsets[i];
+        _tree[offset] = digests[i];
+        dirty.insert(offset % 2 ? offset : offset - 1);
     }
 
+    vector<int> leftChildren;
+    int parentOffset;
     for(int level = _height; level > 0; level--) {
-        getParentOffset(offset, level, parentOffset);
-
-        for(int i = 0; i < SHA256::DIGEST_LENGTH; i++) {
-            parentHash[i] = char(_tree[offset][i]);
-            parentHash[i + SHA256::DIGEST_LENGTH] = char(_tree[offset + 1][i]);
+        leftChildren.assign(dirty.begin(), dirty.end());
+        hashParents(leftChildren, level);
+        dirty.clear();
+        for(int offset : leftChildren) {
+            getParentOffset(offset, level, parentOffset);
+            dirty.insert(parentOffset % 2 ? parentOffset : parentOffset - 1);
         }
-        SHA256::computeDigest(parentHash, 2 * SHA256::DIGEST_LENGTH, _tree[parentOffset]);
     }
 
     _rootHash = _tree[0];
 }
 
+void MerkleTree::hashParents(const vector<int>& leftChildren, int level) {
+    // Each parent's hash input is its two children's hashes, one after the other
+    vector<unsigned char> children(leftChildren.size() * 2 * SHA256::DIGEST_LENGTH);
+    for(size_t i = 0; i < leftChildren.size(); i++) {
+        copy(_tree[leftChildren[i]].begin(), _tree[leftChildren[i]].end(), &children[2 * i * SHA256::DIGEST_LENGTH]);
+        copy(_tree[leftChildren[i] + 1].begin(), _tree[leftChildren[i] + 1].end(),
+             &children[(2 * i + 1) * SHA256::DIGEST_LENGTH]);
+    }
+    vector<unsigned char> parents(leftChildren.size() * SHA256::DIGEST_LENGTH);
+    SHA256::computeDigests(children.data(), 2 * SHA256::DIGEST_LENGTH, leftChildren.size(), parents.data());
+
+    int parentOffset;
+    for(size_t i = 0; i < leftChildren.size(); i++) {
+        getParentOffset(leftChildren[i], level, parentOffset);
+        _tree[parentOffset].assign(&parents[i * SHA256::DIGEST_LENGTH], &parents[(i + 1) * SHA256::DIGEST_LENGTH]);
+    }
+}
+
 void MerkleTree::getHashes(int index, vector<HashNode>& hashes) const {
     int startOffset, nodeOffset, siblingOffset, parentSiblingOffset;
     HashNode* hashNode;
@@ -235,6 +255,10 @@ int MerkleTree::getHeight() {
     return _height;
 }
 
+const vector<unsigned char>& MerkleTree::getRootHash() const {
+    return _rootHash;
+}
+
 void MerkleTree::getParentOffset(int offset, int level, int& parentOffset) const {
     int parentStartOffset = int(pow(2, level) - 1),
         childStartOffset = int(pow(2, level + 1) - 1);
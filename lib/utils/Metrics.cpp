@@ -0,0 +1,189 @@
+/*
+ * Metrics.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <atomic>
+#include <cmath>
+
+#include <utils/Metrics.hpp>
+
+namespace Metrics {
+
+namespace {
+
+struct Histogram {
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sumNanos;
+    std::atomic<uint64_t> buckets[NUM_BUCKETS];
+};
+
+//Zero-initialized because they have static storage duration
+std::atomic<uint64_t> counters[NUM_COUNTERS];
+Histogram histograms[NUM_TIMERS];
+
+const char* const COUNTER_NAMES[NUM_COUNTERS] = {
+        "g1_power",
+        "g1_multiplication",
+        "g2_power",
+        "g2_multiplication",
+        "pairing",
+        "msm_calls",
+        "msm_points",
+        "modular_exponentiation",
+        "prime_rep_generated",
+        "prime_rep_candidates",
+        "prime_rep_cache_hits",
+        "prime_rep_hints"};
+
+const char* const TIMER_NAMES[NUM_TIMERS] = {
+        "bilinear_gen_key",
+        "bilinear_accumulate_private",
+        "bilinear_accumulate_public",
+        "bilinear_witnesses_private",
+        "bilinear_witnesses_public",
+        "bilinear_verify",
+        "rsa_gen_key",
+        "rsa_gen_representatives",
+        "rsa_accumulate_private",
+        "rsa_accumulate_public",
+        "rsa_witnesses_private",
+        "rsa_witnesses_public",
+        "rsa_verify",
+        "rsa_aggregate_witnesses",
+        "rsa_prove_batch",
+        "rsa_verify_batch",
+        "rsa_verify_randomized",
+        "rsa_add",
+        "rsa_update",
+        "rsa_update_witness",
+        "rsa_accumulate_pipelined"};
+
+size_t bucketFor(uint64_t nanoseconds) {
+    uint64_t micros = nanoseconds / 1000;
+    if(micros == 0) {
+        return 0;
+    }
+    //Index of the highest set bit, plus one
+    size_t bucket = 64 - __builtin_clzll(micros);
+    return bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1;
+}
+
+}  // anonymous namespace
+
+void increment(Counter counter, uint64_t amount) {
+    counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void recordLatency(Timer timer, uint64_t nanoseconds) {
+    Histogram& histogram = histograms[timer];
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    histogram.sumNanos.fetch_add(nanoseconds, std::memory_order_relaxed);
+    histogram.buckets[bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t getCount(Counter counter) {
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+bool isEnabled() {
+#ifdef ACCUMULATOR_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void reset() {
+    for(auto& counter : counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for(Histogram& histogram : histograms) {
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.sumNanos.store(0, std::memory_order_relaxed);
+        for(auto& bucket : histogram.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+const char* counterName(Counter counter) {
+    return COUNTER_NAMES[counter];
+}
+
+const char* timerName(Timer timer) {
+    return TIMER_NAMES[timer];
+}
+
+double bucketUpperBound(size_t bucket) {
+    return std::ldexp(1e-6, bucket);
+}
+
+Snapshot takeSnapshot() {
+    Snapshot snapshot;
+    for(size_t c = 0; c < NUM_COUNTERS; c++) {
+        snapshot.counters[c] = counters[c].load(std::memory_order_relaxed);
+    }
+    for(size_t t = 0; t < NUM_TIMERS; t++) {
+        snapshot.latencies[t].count = histograms[t].count.load(std::memory_order_relaxed);
+        snapshot.latencies[t].sumNanos = histograms[t].sumNanos.load(std::memory_order_relaxed);
+        for(size_t b = 0; b < NUM_BUCKETS; b++) {
+            snapshot.latencies[t].buckets[b] = histograms[t].buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+    return snapshot;
+}
+
+void writeJson(std::ostream& out, const Snapshot& snapshot) {
+    out << "{\"counters\":{";
+    for(size_t c = 0; c < NUM_COUNTERS; c++) {
+        out << (c ? "," : "") << "\"" << COUNTER_NAMES[c] << "\":" << snapshot.counters[c];
+    }
+    out << "},\"latencies\":{";
+    for(size_t t = 0; t < NUM_TIMERS; t++) {
+        const HistogramSnapshot& histogram = snapshot.latencies[t];
+        out << (t ? "," : "") << "\"" << TIMER_NAMES[t] << "\":{"
+            << "\"count\":" << histogram.count
+            << ",\"sum_seconds\":" << histogram.sumNanos / 1e9
+            << ",\"buckets\":[";
+        //Only non-empty buckets are listed, as [upper bound in seconds, count] pairs
+        bool first = true;
+        for(size_t b = 0; b < NUM_BUCKETS; b++) {
+            if(histogram.buckets[b] == 0)
+                continue;
+            out << (first ? "" : ",") << "[" << bucketUpperBound(b) << "," << histogram.buckets[b] << "]";
+            first = false;
+        }
+        out << "]}";
+    }
+    out << "}}" << std::endl;
+}
+
+void writePrometheus(std::ostream& out, const Snapshot& snapshot) {
+    out << "# HELP accumulator_operations_total Primitive operations performed by the accumulator library." << std::endl;
+    out << "# TYPE accumulator_operations_total counter" << std::endl;
+    for(size_t c = 0; c < NUM_COUNTERS; c++) {
+        out << "accumulator_operations_total{op=\"" << COUNTER_NAMES[c] << "\"} " << snapshot.counters[c] << std::endl;
+    }
+    out << "# HELP accumulator_api_latency_seconds Latency of accumulator API calls." << std::endl;
+    out << "# TYPE accumulator_api_latency_seconds histogram" << std::endl;
+    for(size_t t = 0; t < NUM_TIMERS; t++) {
+        const HistogramSnapshot& histogram = snapshot.latencies[t];
+        //Prometheus buckets are cumulative
+        uint64_t cumulative = 0;
+        for(size_t b = 0; b < NUM_BUCKETS - 1; b++) {
+            cumulative += histogram.buckets[b];
+            out << "accumulator_api_latency_seconds_bucket{api=\"" << TIMER_NAMES[t]
+                << "\",le=\"" << bucketUpperBound(b) << "\"} " << cumulative << std::endl;
+        }
+        out << "accumulator_api_latency_seconds_bucket{api=\"" << TIMER_NAMES[t]
+            << "\",le=\"+Inf\"} " << histogram.count << std::endl;
+        out << "accumulator_api_latency_seconds_sum{api=\"" << TIMER_NAMES[t] << "\"} "
+            << histogram.sumNanos / 1e9 << std::endl;
+        out << "accumulator_api_latency_seconds_count{api=\"" << TIMER_NAMES[t] << "\"} "
+            << histogram.count << std::endl;
+    }
+}
+
+}  // namespace Metrics
@@ -4,14 +4,403 @@
  */
 
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <immintrin.h>
+
+#include <utils/CpuDispatch.hpp>
 #include <utils/SHA256.hpp>
 #include <cryptopp/sha.h>
 
 namespace SHA256 {
 
+namespace {
+
+const size_t BLOCK_LENGTH = 64;
+
+const uint32_t INITIAL_STATE[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                   0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+const uint32_t ROUND_CONSTANTS[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+//Runs the compression function over a whole number of 64-byte blocks
+typedef void (*CompressFunction)(uint32_t* state, const unsigned char* blocks, size_t numBlocks);
+
+inline uint32_t rotateRight(uint32_t x, int bits) {
+    return (x >> bits) | (x << (32 - bits));
+}
+
+inline uint32_t loadBigEndian(const unsigned char* bytes) {
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+}
+
+void compressPortable(uint32_t* state, const unsigned char* blocks, size_t numBlocks) {
+    uint32_t w[64];
+    for(size_t block = 0; block < numBlocks; block++) {
+        const unsigned char* data = blocks + block * BLOCK_LENGTH;
+        for(int t = 0; t < 16; t++) {
+            w[t] = loadBigEndian(data + 4 * t);
+        }
+        for(int t = 16; t < 64; t++) {
+            uint32_t s0 = rotateRight(w[t - 15], 7) ^ rotateRight(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            uint32_t s1 = rotateRight(w[t - 2], 17) ^ rotateRight(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for(int t = 0; t < 64; t++) {
+            uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+            uint32_t choice = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + s1 + choice + ROUND_CONSTANTS[t] + w[t];
+            uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+            uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = s0 + majority;
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+/*
+ * The SHA extensions keep the state as two vectors, ABEF and CDGH, and do two
+ * rounds per sha256rnds2. Message words are kept four to a vector, and each
+ * group of four rounds computes the next vector of the message schedule from
+ * the previous four with sha256msg1/sha256msg2.
+ */
+__attribute__((target("sha,sse4.1"))) void compressShaNi(uint32_t* state, const unsigned char* blocks,
+                                                         size_t numBlocks) {
+    //Reverses the bytes of each 32-bit word, since the message is big-endian
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i dcba = _mm_loadu_si128((const __m128i*)&state[0]);
+    __m128i hgfe = _mm_loadu_si128((const __m128i*)&state[4]);
+    __m128i cdab = _mm_shuffle_epi32(dcba, 0xb1);
+    __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+    __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for(size_t block = 0; block < numBlocks; block++) {
+        const unsigned char* data = blocks + block * BLOCK_LENGTH;
+        const __m128i abefSaved = abef;
+        const __m128i cdghSaved = cdgh;
+        __m128i schedule[4];
+        for(int group = 0; group < 16; group++) {
+            __m128i words;
+            if(group < 4) {
+                words = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16 * group)), byteSwap);
+            } else {
+                //W[t..t+3] from W[t-16..t-1], held in schedule[(group - 4..group - 1) % 4]
+                const __m128i& previous = schedule[(group - 1) % 4];
+                __m128i sum = _mm_sha256msg1_epu32(schedule[group % 4], schedule[(group - 3) % 4]);
+                sum = _mm_add_epi32(sum, _mm_alignr_epi8(previous, schedule[(group - 2) % 4], 4));
+                words = _mm_sha256msg2_epu32(sum, previous);
+            }
+            schedule[group % 4] = words;
+            __m128i roundInput = _mm_add_epi32(
+                    words, _mm_loadu_si128((const __m128i*)&ROUND_CONSTANTS[4 * group]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, roundInput);
+            roundInput = _mm_shuffle_epi32(roundInput, 0x0e);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, roundInput);
+        }
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(dchg, feba, 8));
+}
+
+/**
+ * Fills tail, which must hold two blocks, with the rest of the input after
+ * its last full block, a 1 bit, zeros, and the length in bits as a
+ * big-endian 64-bit number.
+ * @return the number of blocks this takes, one or two
+ */
+size_t padTail(const unsigned char* input, size_t length, unsigned char* tail) {
+    size_t fullBlocks = length / BLOCK_LENGTH;
+    size_t remaining = length - fullBlocks * BLOCK_LENGTH;
+    memset(tail, 0, 2 * BLOCK_LENGTH);
+    memcpy(tail, input + fullBlocks * BLOCK_LENGTH, remaining);
+    tail[remaining] = 0x80;
+    size_t tailBlocks = remaining + 9 > BLOCK_LENGTH ? 2 : 1;
+    uint64_t bitLength = (uint64_t)length * 8;
+    for(int i = 0; i < 8; i++) {
+        tail[tailBlocks * BLOCK_LENGTH - 1 - i] = (unsigned char)(bitLength >> (8 * i));
+    }
+    return tailBlocks;
+}
+
+inline void storeBigEndian(uint32_t word, unsigned char* bytes) {
+    bytes[0] = (unsigned char)(word >> 24);
+    bytes[1] = (unsigned char)(word >> 16);
+    bytes[2] = (unsigned char)(word >> 8);
+    bytes[3] = (unsigned char)word;
+}
+
+//Hashes input with the given compression function, doing the padding here
+void digestWith(CompressFunction compress, const unsigned char* input, size_t length, unsigned char* output) {
+    uint32_t state[8];
+    memcpy(state, INITIAL_STATE, sizeof(state));
+    size_t fullBlocks = length / BLOCK_LENGTH;
+    compress(state, input, fullBlocks);
+
+    unsigned char tail[2 * BLOCK_LENGTH];
+    compress(state, tail, padTail(input, length, tail));
+
+    for(int i = 0; i < 8; i++) {
+        storeBigEndian(state[i], output + 4 * i);
+    }
+}
+
+void digestShaNi(const unsigned char* input, size_t length, unsigned char* output) {
+    digestWith(compressShaNi, input, length, output);
+}
+
+void digestCryptopp(const unsigned char* input, size_t length, unsigned char* output) {
+    CryptoPP::SHA256().CalculateDigest(output, input, length);
+}
+
+void digestPortable(const unsigned char* input, size_t length, unsigned char* output) {
+    digestWith(compressPortable, input, length, output);
+}
+
+typedef void (*DigestFunction)(const unsigned char* input, size_t length, unsigned char* output);
+
+const DigestFunction DIGEST_FUNCTIONS[NUM_KERNELS] = {digestShaNi, digestCryptopp, digestPortable};
+
+//Installs the preferred supported kernel on first use
+void resolveDigest(const unsigned char* input, size_t length, unsigned char* output);
+
+std::atomic<DigestFunction> digestFunction(resolveDigest);
+std::atomic<Kernel> currentKernel(KERNEL_CRYPTOPP);
+
+void selectPreferredKernel() {
+    for(int kernel = 0; kernel < NUM_KERNELS; kernel++) {
+        if(isSupported((Kernel)kernel)) {
+            setKernel((Kernel)kernel);
+            break;
+        }
+    }
+}
+
+void resolveDigest(const unsigned char* input, size_t length, unsigned char* output) {
+    selectPreferredKernel();
+    digestFunction.load(std::memory_order_relaxed)(input, length, output);
+}
+
+/*
+ * Multi-buffer hashing: each 32-bit lane of a vector register holds the
+ * state of a different message, so one pass of the compression function
+ * advances as many messages as there are lanes. The lanes are written with
+ * GCC's generic vectors, and the functions that do so are always inlined
+ * into the per-instruction-set entry points below, so they're compiled for
+ * AVX2 or AVX-512 there. Rotations are macros, since passing vectors by value
+ * to a function compiled without AVX changes the calling convention.
+ */
+typedef uint32_t Lanes8 __attribute__((vector_size(32)));
+typedef uint32_t Lanes16 __attribute__((vector_size(64)));
+
+#define ROTATE_LANES(x, bits) (((x) >> (bits)) | ((x) << (32 - (bits))))
+
+//Compresses one block in every lane; w holds the lanes' first 16 message words and is overwritten
+template<typename Lanes>
+__attribute__((always_inline)) inline void compressLanes(Lanes* state, Lanes* w) {
+    Lanes a = state[0], b = state[1], c = state[2], d = state[3];
+    Lanes e = state[4], f = state[5], g = state[6], h = state[7];
+    for(int t = 0; t < 64; t++) {
+        //The message schedule is computed 16 words ahead, in place
+        if(t >= 16) {
+            const Lanes& w15 = w[(t - 15) & 15];
+            const Lanes& w2 = w[(t - 2) & 15];
+            Lanes s0 = ROTATE_LANES(w15, 7) ^ ROTATE_LANES(w15, 18) ^ (w15 >> 3);
+            Lanes s1 = ROTATE_LANES(w2, 17) ^ ROTATE_LANES(w2, 19) ^ (w2 >> 10);
+            w[t & 15] += s0 + w[(t - 7) & 15] + s1;
+        }
+        Lanes s1 = ROTATE_LANES(e, 6) ^ ROTATE_LANES(e, 11) ^ ROTATE_LANES(e, 25);
+        Lanes choice = (e & f) ^ (~e & g);
+        Lanes temp1 = h + s1 + choice + ROUND_CONSTANTS[t] + w[t & 15];
+        Lanes s0 = ROTATE_LANES(a, 2) ^ ROTATE_LANES(a, 13) ^ ROTATE_LANES(a, 22);
+        Lanes majority = (a & b) ^ (a & c) ^ (b & c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + s0 + majority;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+#undef ROTATE_LANES
+
+//The message a lane is working on
+struct LaneMessage {
+    const unsigned char* input;
+    size_t fullBlocks;
+    size_t blocks;
+    size_t block;
+    unsigned char* output;
+    unsigned char tail[2 * BLOCK_LENGTH];
+};
+
+/**
+ * Hashes the messages with LANES of them in flight at once. Each time
+ * through the loop every busy lane gets its next block, and a lane that has
+ * finished its message writes out the digest and starts on the next
+ * message, if there is one. Idle lanes compress zeros, which are ignored.
+ */
+template<typename Lanes, size_t LANES>
+__attribute__((always_inline)) inline void digestLanes(const unsigned char* const* inputs, const size_t* lengths,
+                                                       size_t count, unsigned char* outputs) {
+    Lanes state[8];
+    Lanes w[16];
+    LaneMessage messages[LANES];
+    bool busy[LANES];
+    size_t next = 0;
+    size_t busyLanes = 0;
+    auto start = [&](size_t lane) {
+        busy[lane] = next < count;
+        if(!busy[lane])
+            return;
+        LaneMessage& message = messages[lane];
+        message.input = inputs[next];
+        message.fullBlocks = lengths[next] / BLOCK_LENGTH;
+        message.blocks = message.fullBlocks + padTail(inputs[next], lengths[next], message.tail);
+        message.block = 0;
+        message.output = outputs + next * DIGEST_LENGTH;
+        for(int i = 0; i < 8; i++) {
+            state[i][lane] = INITIAL_STATE[i];
+        }
+        next++;
+        busyLanes++;
+    };
+    for(size_t lane = 0; lane < LANES; lane++) {
+        start(lane);
+    }
+    while(busyLanes > 0) {
+        for(size_t lane = 0; lane < LANES; lane++) {
+            const LaneMessage& message = messages[lane];
+            if(!busy[lane]) {
+                for(int t = 0; t < 16; t++) {
+                    w[t][lane] = 0;
+                }
+                continue;
+            }
+            const unsigned char* data = message.block < message.fullBlocks
+                                                ? message.input + message.block * BLOCK_LENGTH
+                                                : message.tail + (message.block - message.fullBlocks) * BLOCK_LENGTH;
+            for(int t = 0; t < 16; t++) {
+                w[t][lane] = loadBigEndian(data + 4 * t);
+            }
+        }
+        compressLanes(state, w);
+        for(size_t lane = 0; lane < LANES; lane++) {
+            LaneMessage& message = messages[lane];
+            if(!busy[lane] || ++message.block < message.blocks)
+                continue;
+            for(int i = 0; i < 8; i++) {
+                storeBigEndian(state[i][lane], message.output + 4 * i);
+            }
+            busyLanes--;
+            start(lane);
+        }
+    }
+}
+
+__attribute__((target("avx512f"))) void digestsAvx512(const unsigned char* const* inputs, const size_t* lengths,
+                                                      size_t count, unsigned char* outputs) {
+    digestLanes<Lanes16, 16>(inputs, lengths, count, outputs);
+}
+
+__attribute__((target("avx2"))) void digestsAvx2(const unsigned char* const* inputs, const size_t* lengths,
+                                                 size_t count, unsigned char* outputs) {
+    digestLanes<Lanes8, 8>(inputs, lengths, count, outputs);
+}
+
+void digestsSerial(const unsigned char* const* inputs, const size_t* lengths, size_t count,
+                   unsigned char* outputs) {
+    for(size_t i = 0; i < count; i++) {
+        computeDigest(inputs[i], lengths[i], outputs + i * DIGEST_LENGTH);
+    }
+}
+
+typedef void (*BatchFunction)(const unsigned char* const* inputs, const size_t* lengths, size_t count,
+                              unsigned char* outputs);
+
+const BatchFunction BATCH_FUNCTIONS[NUM_BATCH_KERNELS] = {digestsAvx512, digestsAvx2, digestsSerial};
+
+void resolveBatch(const unsigned char* const* inputs, const size_t* lengths, size_t count, unsigned char* outputs);
+
+std::atomic<BatchFunction> batchFunction(resolveBatch);
+std::atomic<BatchKernel> currentBatchKernel(BATCH_SERIAL);
+
+void resolveBatch(const unsigned char* const* inputs, const size_t* lengths, size_t count, unsigned char* outputs) {
+    for(int kernel = 0; kernel < NUM_BATCH_KERNELS; kernel++) {
+        if(isSupported((BatchKernel)kernel)) {
+            setBatchKernel((BatchKernel)kernel);
+            break;
+        }
+    }
+    batchFunction.load(std::memory_order_relaxed)(inputs, lengths, count, outputs);
+}
+
+}  // anonymous namespace
+
 void computeDigest(const char* input, int length, std::vector<unsigned char>& output) {
-	output.assign(CryptoPP::SHA256::DIGESTSIZE, 0);
-    CryptoPP::SHA256().CalculateDigest(output.data(), (const unsigned char*) input, length);
+	output.assign(DIGEST_LENGTH, 0);
+    computeDigest((const unsigned char*) input, length, output.data());
+}
+
+void computeDigest(const unsigned char* input, size_t length, unsigned char* output) {
+    digestFunction.load(std::memory_order_relaxed)(input, length, output);
+}
+
+void computeDigests(const unsigned char* const* inputs, const size_t* lengths, size_t count,
+                    unsigned char* outputs) {
+    batchFunction.load(std::memory_order_relaxed)(inputs, lengths, count, outputs);
+}
+
+void computeDigests(const unsigned char* input, size_t length, size_t count, unsigned char* outputs) {
+    std::vector<const unsigned char*> inputs(count);
+    for(size_t i = 0; i < count; i++) {
+        inputs[i] = input + i * length;
+    }
+    std::vector<size_t> lengths(count, length);
+    computeDigests(inputs.data(), lengths.data(), count, outputs);
 }
 
 void computeAccumulatorDigest(const G* acc, std::vector<unsigned char>& output) {
@@ -32,4 +421,70 @@ bool isHashesEqual(const std::vector<unsigned char>& hash1, const std::vector<un
     return true;
 }
 
+const char* getKernelName(Kernel kernel) {
+    switch(kernel) {
+    case KERNEL_SHA_NI:
+        return "sha-ni";
+    case KERNEL_CRYPTOPP:
+        return "cryptopp";
+    default:
+        return "portable";
+    }
+}
+
+bool isSupported(Kernel kernel) {
+    const CpuDispatch::Features& features = CpuDispatch::getFeatures();
+    return kernel != KERNEL_SHA_NI || (features.sha && features.sse41);
+}
+
+Kernel getKernel() {
+    //Make sure the resolver has run, so this reports the kernel actually in use
+    if(digestFunction.load() == resolveDigest)
+        selectPreferredKernel();
+    return currentKernel.load();
+}
+
+void setKernel(Kernel kernel) {
+    currentKernel.store(kernel);
+    digestFunction.store(DIGEST_FUNCTIONS[kernel]);
+}
+
+const char* getBatchKernelName(BatchKernel kernel) {
+    switch(kernel) {
+    case BATCH_AVX512:
+        return "avx512";
+    case BATCH_AVX2:
+        return "avx2";
+    default:
+        return "serial";
+    }
+}
+
+bool isSupported(BatchKernel kernel) {
+    const CpuDispatch::Features& features = CpuDispatch::getFeatures();
+    switch(kernel) {
+    case BATCH_AVX512:
+        return features.avx512f;
+    case BATCH_AVX2:
+        return features.avx2;
+    default:
+        return true;
+    }
+}
+
+BatchKernel getBatchKernel() {
+    if(batchFunction.load() == resolveBatch) {
+        unsigned char digest[DIGEST_LENGTH] = {0};
+        const unsigned char* input = digest;
+        size_t length = 0;
+        computeDigests(&input, &length, 1, digest);
+    }
+    return currentBatchKernel.load();
+}
+
+void setBatchKernel(BatchKernel kernel) {
+    currentBatchKernel.store(kernel);
+    batchFunction.store(BATCH_FUNCTIONS[kernel]);
+}
+
 }
@@ -0,0 +1,133 @@
+/*
+ * TaskTrace.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <chrono>
+#include <set>
+
+#include <utils/TaskTrace.hpp>
+
+namespace {
+
+thread_local size_t currentWorkerId = 0;
+
+uint64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//Chrome trace timestamps are in (fractional) microseconds
+double toMicros(uint64_t nanos) {
+    return nanos / 1000.0;
+}
+
+//Writes text as a JSON string, quotes included, so that labels can't break the trace
+void writeJsonString(std::ostream& out, const char* text) {
+    static const char* DIGITS = "0123456789abcdef";
+    out << '"';
+    for(const char* c = text; *c != '\0'; c++) {
+        unsigned char byte = (unsigned char)*c;
+        if(byte == '"' || byte == '\\') {
+            out << '\\' << *c;
+        } else if(byte < 0x20) {
+            out << "\\u00" << DIGITS[byte >> 4] << DIGITS[byte & 0xf];
+        } else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+}  // anonymous namespace
+
+TaskTrace::TaskTrace(size_t capacity) : ring(capacity > 0 ? capacity : 1), numRecorded(0), epoch(steadyNanos()) {
+}
+
+uint64_t TaskTrace::now() const {
+    return steadyNanos() - epoch;
+}
+
+void TaskTrace::record(const char* label, uint64_t enqueueTime, uint64_t startTime, uint64_t endTime) {
+    uint64_t index = numRecorded.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = ring[index % ring.size()];
+    //Claim the slot, unless another event is being written to it or a newer one already has been
+    uint64_t current = slot.sequence.load(std::memory_order_relaxed);
+    do {
+        if((current & 1) || current > 2 * index)
+            return;
+    } while(!slot.sequence.compare_exchange_weak(current, 2 * index + 1, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.label.store(label, std::memory_order_relaxed);
+    slot.workerId.store(currentWorkerId, std::memory_order_relaxed);
+    slot.enqueueTime.store(enqueueTime, std::memory_order_relaxed);
+    slot.startTime.store(startTime, std::memory_order_relaxed);
+    slot.endTime.store(endTime, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+void TaskTrace::clear() {
+    for(Slot& slot : ring) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+    numRecorded.store(0);
+}
+
+std::vector<TaskTrace::Event> TaskTrace::getEvents() const {
+    uint64_t recorded = numRecorded.load();
+    //Once the buffer has wrapped around, only the newest ring.size() events can still be in it
+    uint64_t oldest = recorded > ring.size() ? recorded - ring.size() : 0;
+    std::vector<Event> events;
+    events.reserve(recorded - oldest);
+    for(uint64_t index = oldest; index < recorded; index++) {
+        const Slot& slot = ring[index % ring.size()];
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        Event event{slot.label.load(std::memory_order_relaxed), slot.workerId.load(std::memory_order_relaxed),
+                    slot.enqueueTime.load(std::memory_order_relaxed), slot.startTime.load(std::memory_order_relaxed),
+                    slot.endTime.load(std::memory_order_relaxed)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if(before == 2 * index + 2 && slot.sequence.load(std::memory_order_relaxed) == before)
+            events.push_back(event);
+    }
+    return events;
+}
+
+void TaskTrace::writeChromeTrace(std::ostream& out) const {
+    std::vector<Event> events = getEvents();
+    std::set<size_t> workers;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for(size_t i = 0; i < events.size(); i++) {
+        const Event& event = events[i];
+        workers.insert(event.workerId);
+        //Execution on the worker's own track
+        out << (first ? "" : ",") << "\n{\"name\":";
+        writeJsonString(out, event.label);
+        out << ",\"cat\":\"task\",\"ph\":\"X\",\"pid\":1"
+            << ",\"tid\":" << event.workerId
+            << ",\"ts\":" << toMicros(event.startTime)
+            << ",\"dur\":" << toMicros(event.endTime - event.startTime)
+            << ",\"args\":{\"queued_us\":" << toMicros(event.startTime - event.enqueueTime) << "}}";
+        first = false;
+        //Time spent waiting in the queue, as an async span (these overlap, so they can't share a thread track)
+        out << ",\n{\"name\":";
+        writeJsonString(out, event.label);
+        out << ",\"cat\":\"queue\",\"ph\":\"b\",\"pid\":1,\"tid\":0"
+            << ",\"id\":" << i << ",\"ts\":" << toMicros(event.enqueueTime) << "}";
+        out << ",\n{\"name\":";
+        writeJsonString(out, event.label);
+        out << ",\"cat\":\"queue\",\"ph\":\"e\",\"pid\":1,\"tid\":0"
+            << ",\"id\":" << i << ",\"ts\":" << toMicros(event.startTime) << "}";
+    }
+    for(size_t worker : workers) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << worker
+            << ",\"args\":{\"name\":\"worker " << worker << "\"}}";
+        first = false;
+    }
+    out << "\n]}" << std::endl;
+}
+
+void TaskTrace::setCurrentWorkerId(size_t workerId) {
+    currentWorkerId = workerId;
+}
@@ -3,6 +3,7 @@
 
 void Worker::operator()()
 {
+    TaskTrace::setCurrentWorkerId(id);
     while(true)
     {
         std::unique_lock<std::mutex> lock(pool.queue_mutex);
@@ -22,10 +23,11 @@ ThreadPool::ThreadPool() : ThreadPool(1) {}
 
 // the constructor just launches some amount of workers
 ThreadPool::ThreadPool(size_t threads)
-    :   stop(false)
+    :   stop(false), tracing(false)
 {
+    // worker IDs start at 1, so that 0 can stand for "not a pool thread"
     for(size_t i = 0;i<threads;++i)
-        workers.push_back(std::thread(Worker(*this)));
+        workers.push_back(std::thread(Worker(*this, i + 1)));
 }
 
 // the destructor joins all threads
@@ -38,3 +40,23 @@ ThreadPool::~ThreadPool()
 }
 
 
+size_t ThreadPool::size() const
+{
+    return workers.size();
+}
+
+void ThreadPool::enableTracing(size_t traceCapacity)
+{
+    std::atomic_store(&trace, std::make_shared<TaskTrace>(traceCapacity));
+    tracing = true;
+}
+
+void ThreadPool::disableTracing()
+{
+    tracing = false;
+}
+
+const TaskTrace* ThreadPool::getTrace() const
+{
+    return std::atomic_load(&trace).get();
+}
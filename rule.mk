@@ -4,6 +4,12 @@ AR=ar
 CFLAGS=
 CFLAGS+=-g
 #CFLAGS+=-O3
+#Uncomment to count hot-path operations and time API calls (see utils/Metrics.hpp)
+#CFLAGS+=-DACCUMULATOR_METRICS
+#Uncomment to track allocated bytes per API call (see utils/MemoryAccounting.hpp)
+#CFLAGS+=-DACCUMULATOR_MEMORY_ACCOUNTING
+#Uncomment to generate new keys on the 64-bit Montgomery pairing backend (see bilinear/PairingBackend.hpp)
+#CFLAGS+=-DACCUMULATOR_BACKEND_MONT64
 CFLAGS+=-Wall
 CFLAGS+=-std=c++17
 CFLAGS+=-no-pie
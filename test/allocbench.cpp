@@ -0,0 +1,147 @@
+/*
+ * allocbench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Measures how many allocations the flint wrapper temporaries cost, and how
+ * many of them reach the system allocator, with and without MemoryPool.
+ * The workload mimics the two allocation-heavy loops in the library: the
+ * left/right exponent products of RSA private-key witness generation, and
+ * the polynomial product tree of bilinear-map public-key accumulation.
+ *
+ * Usage: allocbench <pool|malloc> [number of elements] [number of threads]
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gmp.h>
+#include <flint/flint.h>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+#include <flint/ModPolynomial.hpp>
+#include <flint/Random.hpp>
+
+#include <utils/LibConversions.hpp>
+#include <utils/MemoryPool.hpp>
+#include <utils/Profiler.hpp>
+#include <utils/ThreadPool.hpp>
+
+using namespace std;
+
+namespace allocbench {
+
+//Counting pass-through hooks, so the malloc baseline reports the same numbers
+atomic<uint64_t> systemAllocations(0);
+
+void* countingMalloc(size_t size) {
+    systemAllocations++;
+    return malloc(size);
+}
+void* countingCalloc(size_t num, size_t size) {
+    systemAllocations++;
+    return calloc(num, size);
+}
+void* countingRealloc(void* ptr, size_t size) {
+    systemAllocations++;
+    return realloc(ptr, size);
+}
+void* countingGmpRealloc(void* ptr, size_t, size_t size) {
+    return countingRealloc(ptr, size);
+}
+void countingGmpFree(void* ptr, size_t) {
+    free(ptr);
+}
+
+void installCountingHooks() {
+    mp_set_memory_functions(countingMalloc, countingGmpRealloc, countingGmpFree);
+    __flint_set_memory_functions(countingMalloc, countingCalloc, countingRealloc, free);
+}
+
+void exponentProducts(const vector<flint::BigInt>& elements, const flint::BigInt& modulus) {
+    vector<flint::BigMod> leftProducts(elements.size() + 1, flint::BigMod(1, modulus));
+    vector<flint::BigMod> rightProducts(elements.size() + 1, flint::BigMod(1, modulus));
+    for(size_t i = 1; i <= elements.size(); i++) {
+        leftProducts.at(i) = leftProducts.at(i - 1) * elements.at(i - 1);
+    }
+    for(size_t i = elements.size(); i > 0; i--) {
+        rightProducts.at(i - 1) = rightProducts.at(i) * elements.at(i - 1);
+    }
+    flint::BigMod exponent(modulus);
+    for(size_t i = 0; i < elements.size(); i++) {
+        exponent = leftProducts.at(i) * rightProducts.at(i + 1);
+    }
+}
+
+flint::ModPolynomial productTree(const vector<flint::BigInt>& roots, size_t low, size_t high, const flint::BigInt& modulus) {
+    if(high - low == 1) {
+        flint::ModPolynomial x(modulus);
+        x.set(1, 1);
+        x.set(0L, flint::BigInt(roots.at(low)));
+        return x;
+    }
+    size_t mid = low + (high - low) / 2;
+    return productTree(roots, low, mid, modulus) * productTree(roots, mid, high, modulus);
+}
+
+}  // namespace allocbench
+
+int main(int argc, char** argv) {
+    if(argc < 2 || (string(argv[1]) != "pool" && string(argv[1]) != "malloc")) {
+        cout << "Usage: allocbench <pool|malloc> [number of elements] [number of threads]" << endl;
+        return 1;
+    }
+    //Must happen before anything allocates a GMP or FLINT object
+    bool usePool = string(argv[1]) == "pool";
+    if(usePool) {
+        MemoryPool::install();
+    } else {
+        allocbench::installCountingHooks();
+    }
+    int setSize = argc > 2 ? atoi(argv[2]) : 1000;
+    int numThreads = argc > 3 ? atoi(argv[3]) : 4;
+
+    flint::Random random;
+    flint::BigInt rsaModulus = random.nextInt(3072);
+    flint::BigInt curveOrder;
+    LibConversions::getModulus(curveOrder);
+    vector<flint::BigInt> rsaElements, scalars;
+    for(int i = 0; i < setSize; i++) {
+        rsaElements.push_back(random.nextInt(256).nextPrime());
+        scalars.push_back(random.nextInt(curveOrder));
+    }
+
+    MemoryPool::resetStats();
+    allocbench::systemAllocations = 0;
+    ThreadPool threadPool(numThreads);
+    double start = Profiler::getCurrentTime();
+    vector<future<void>> futures;
+    for(int t = 0; t < numThreads; t++) {
+        futures.push_back(threadPool.enqueue<void>([&]() {
+            MemoryPool::Scope scope;
+            allocbench::exponentProducts(rsaElements, rsaModulus);
+            allocbench::productTree(scalars, 0, scalars.size(), curveOrder);
+        }));
+    }
+    for(auto& future : futures) {
+        future.get();
+    }
+    double end = Profiler::getCurrentTime();
+
+    cout << "Mode: " << argv[1] << ", " << setSize << " elements, " << numThreads << " threads" << endl;
+    cout << "Time: " << (end - start) << " seconds" << endl;
+    if(usePool) {
+        MemoryPool::Stats stats = MemoryPool::getStats();
+        cout << "Allocation requests: " << stats.allocations << endl;
+        cout << "System allocations: " << stats.systemAllocations << endl;
+    } else {
+        cout << "System allocations: " << allocbench::systemAllocations << endl;
+    }
+    return 0;
+}
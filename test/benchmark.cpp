@@ -0,0 +1,786 @@
+/*
+ * benchmark.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Times every primitive and API call of both accumulators over a sweep of
+ * set sizes and thread counts, repeating each measurement and reporting
+ * summary statistics. Unlike the speed tests, it generates its own random
+ * inputs, and its output is meant to be saved and compared between builds.
+ *
+ * Usage: benchmark [options]
+ *   --sizes 100,1000        set sizes to sweep
+ *   --threads 1,4,16        ThreadPool sizes to sweep (multithreaded benchmarks only)
+ *   --repetitions 5         timed runs per measurement
+ *   --warmup 1              untimed runs before each measurement
+ *   --modulus 3072          RSA modulus size in bits
+ *   --filter a,b            only run benchmarks whose names start with one of these prefixes
+ *   --format text|csv|json  output format
+ *   --output file           write results to a file instead of stdout
+ *   --pool                  install MemoryPool before running
+ *   --backend dclxvi|mont64 pairing backend for the bilinear-map benchmarks
+ *
+ * The kernel.* benchmarks time every implementation of the runtime-dispatched
+ * kernels (utils/CpuDispatch.hpp) that this CPU supports, so the defaults can
+ * be compared with the alternatives on the current host.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+#include <flint/ModPolynomial.hpp>
+#include <flint/Random.hpp>
+
+#include <bilinear/Mont64Field.hpp>
+#include <bilinear/PairingBackend.hpp>
+#include <bilinear/Scalar_DCLXVI.hpp>
+
+#include <algorithms/BilinearMapAccumulator.hpp>
+#include <algorithms/OraclePrimeRep.hpp>
+#include <algorithms/PrimeRepCache.hpp>
+#include <algorithms/RSAAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+#include <algorithms/TablePrimeRep.hpp>
+
+#include <utils/BinaryIO.hpp>
+#include <utils/CpuDispatch.hpp>
+#include <utils/LibConversions.hpp>
+#include <utils/MemoryPool.hpp>
+#include <utils/Profiler.hpp>
+#include <utils/SHA256.hpp>
+#include <utils/ThreadPool.hpp>
+
+using namespace std;
+
+namespace benchmark {
+
+struct Options {
+    vector<size_t> sizes = {100, 1000};
+    vector<size_t> threads = {1, 4, 16};
+    int repetitions = 5;
+    int warmup = 1;
+    unsigned int modulusBits = 3072;
+    vector<string> filters;
+    string format = "text";
+    string output;
+    bool usePool = false;
+    PairingBackend::Type backend = PairingBackend::getDefault();
+};
+
+struct Result {
+    string name;
+    size_t size;
+    //0 for benchmarks that don't use a ThreadPool
+    size_t threads;
+    //How many operations each sample timed, so that per-operation costs can be derived
+    size_t operations;
+    vector<double> samples;
+    double mean, stddev, min, median, max;
+};
+
+vector<size_t> parseList(const string& list) {
+    vector<size_t> values;
+    stringstream stream(list);
+    string item;
+    while(getline(stream, item, ',')) {
+        values.push_back(stoul(item));
+    }
+    return values;
+}
+
+vector<string> splitList(const string& list) {
+    vector<string> items;
+    stringstream stream(list);
+    string item;
+    while(getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+void usage() {
+    cerr << "Usage: benchmark [--sizes n,...] [--threads t,...] [--repetitions r] [--warmup w]" << endl
+         << "                 [--modulus bits] [--filter prefix,...] [--format text|csv|json]" << endl
+         << "                 [--output file] [--pool] [--backend dclxvi|mont64]" << endl;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for(int i = 1; i < argc; i++) {
+        string arg(argv[i]);
+        if(arg == "--pool") {
+            options.usePool = true;
+            continue;
+        }
+        if(i + 1 >= argc) {
+            return false;
+        }
+        string value(argv[++i]);
+        if(arg == "--sizes") {
+            options.sizes = parseList(value);
+        } else if(arg == "--threads") {
+            options.threads = parseList(value);
+        } else if(arg == "--repetitions") {
+            options.repetitions = max(1, atoi(value.c_str()));
+        } else if(arg == "--warmup") {
+            options.warmup = max(0, atoi(value.c_str()));
+        } else if(arg == "--modulus") {
+            options.modulusBits = atoi(value.c_str());
+        } else if(arg == "--filter") {
+            options.filters = splitList(value);
+        } else if(arg == "--format") {
+            options.format = value;
+        } else if(arg == "--output") {
+            options.output = value;
+        } else if(arg == "--backend") {
+            if(!PairingBackend::fromName(value, options.backend))
+                return false;
+        } else {
+            return false;
+        }
+    }
+    return (options.format == "text" || options.format == "csv" || options.format == "json")
+           && !options.sizes.empty() && !options.threads.empty();
+}
+
+void summarize(Result& result) {
+    vector<double> sorted(result.samples);
+    sort(sorted.begin(), sorted.end());
+    size_t count = sorted.size();
+    double sum = 0;
+    for(double sample : sorted) {
+        sum += sample;
+    }
+    result.mean = sum / count;
+    double squares = 0;
+    for(double sample : sorted) {
+        squares += (sample - result.mean) * (sample - result.mean);
+    }
+    //Sample standard deviation, since the repetitions are a sample of possible runs
+    result.stddev = count > 1 ? sqrt(squares / (count - 1)) : 0;
+    result.min = sorted.front();
+    result.max = sorted.back();
+    result.median = count % 2 ? sorted.at(count / 2) : (sorted.at(count / 2 - 1) + sorted.at(count / 2)) / 2;
+}
+
+class Runner {
+public:
+    Runner(const Options& options) : options(options) {}
+
+    bool selected(const string& name) const {
+        if(options.filters.empty())
+            return true;
+        for(const string& prefix : options.filters) {
+            if(name.compare(0, prefix.size(), prefix) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    /** Runs body warmup + repetitions times, timing the last repetitions runs. */
+    void measure(const string& name, size_t size, size_t threads, size_t operations, const function<void()>& body) {
+        if(!selected(name))
+            return;
+        cerr << "Running " << name << " (n=" << size << ", threads=" << threads << ")" << endl;
+        Result result;
+        result.name = name;
+        result.size = size;
+        result.threads = threads;
+        result.operations = operations;
+        for(int run = 0; run < options.warmup + options.repetitions; run++) {
+            double start = Profiler::getCurrentTime();
+            body();
+            double end = Profiler::getCurrentTime();
+            if(run >= options.warmup)
+                result.samples.push_back(end - start);
+        }
+        summarize(result);
+        results.push_back(result);
+    }
+
+    const vector<Result>& getResults() const {
+        return results;
+    }
+
+private:
+    const Options& options;
+    vector<Result> results;
+};
+
+/* Shared inputs, generated once at the largest size and reused as prefixes */
+
+struct BilinearInputs {
+    vector<unique_ptr<Scalar>> set;
+    vector<unique_ptr<Scalar>> exponents;
+    BilinearMapKey key;
+};
+
+struct RSAInputs {
+    vector<flint::BigInt> elements;
+    vector<flint::BigInt> representatives;
+    RSAKey key;
+};
+
+vector<reference_wrapper<Scalar>> view(const vector<unique_ptr<Scalar>>& scalars, size_t n) {
+    vector<reference_wrapper<Scalar>> setView;
+    for(size_t i = 0; i < n; i++) {
+        setView.push_back(*scalars.at(i));
+    }
+    return setView;
+}
+
+//Witnesses go in G2, or in G1 for accumulators in G2
+vector<unique_ptr<G>> makeWitnesses(size_t n, bool accumulatorInG2 = false) {
+    vector<unique_ptr<G>> witnesses;
+    for(size_t i = 0; i < n; i++) {
+        witnesses.push_back(accumulatorInG2 ? PairingBackend::newG1() : PairingBackend::newG2());
+    }
+    return witnesses;
+}
+
+void primitiveBenchmarks(Runner& runner, BilinearInputs& bilinear, RSAInputs& rsa, size_t n) {
+    flint::BigInt curveOrder;
+    LibConversions::getModulus(curveOrder);
+    vector<flint::BigMod> fieldElements;
+    for(size_t i = 0; i < n; i++) {
+        flint::BigMod element(curveOrder);
+        bilinear.set.at(i)->exportFlintObject(element);
+        fieldElements.push_back(element);
+    }
+    runner.measure("field.multiply", n, 0, n, [&]() {
+        flint::BigMod product(1, curveOrder);
+        for(const flint::BigMod& element : fieldElements) {
+            product = product * element;
+        }
+    });
+    runner.measure("field.add", n, 0, n, [&]() {
+        flint::BigMod sum(curveOrder);
+        for(const flint::BigMod& element : fieldElements) {
+            sum = sum + element;
+        }
+    });
+
+    const flint::BigMod& rsaBase = rsa.key.getPublicKey().base;
+    flint::BigMod rsaPower;
+    runner.measure("rsa.modexp", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            flint::power(rsaBase, rsa.representatives.at(i), rsaPower);
+        }
+    });
+    //Representatives of the IDs 0 to n - 1, searched for by OraclePrimeRep or looked up in a prime table
+    vector<flint::BigInt> ids;
+    for(size_t i = 0; i < n; i++) {
+        ids.push_back(flint::BigInt((long)i));
+    }
+    flint::BigInt idRep;
+    OraclePrimeRep oracle;
+    runner.measure("rsa.representative.oracle", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            oracle.genRepresentative(ids.at(i), idRep);
+        }
+    });
+    if(runner.selected("rsa.representative.table")) {
+        ThreadPool tablePool(1);
+        TablePrimeRep table(n, tablePool);
+        runner.measure("rsa.representative.table", n, 0, n, [&]() {
+            for(size_t i = 0; i < n; i++) {
+                table.genRepresentative(ids.at(i), idRep);
+            }
+        });
+    }
+
+    unique_ptr<G> g1BasePtr = PairingBackend::newG1();
+    unique_ptr<G> g1ResultPtr = PairingBackend::newG1();
+    G& g1Base = *g1BasePtr;
+    G& g1Result = *g1ResultPtr;
+    runner.measure("g1.power", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            g1Base.doPower(*bilinear.exponents.at(i), g1Result);
+        }
+    });
+    runner.measure("g1.multiply", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            g1Result.doMultiplication(g1Base, g1Result);
+        }
+    });
+    unique_ptr<G> g2BasePtr = PairingBackend::newG2();
+    unique_ptr<G> g2ResultPtr = PairingBackend::newG2();
+    G& g2Base = *g2BasePtr;
+    G& g2Result = *g2ResultPtr;
+    runner.measure("g2.power", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            g2Base.doPower(*bilinear.exponents.at(i), g2Result);
+        }
+    });
+    runner.measure("g2.multiply", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            g2Result.doMultiplication(g2Base, g2Result);
+        }
+    });
+    unique_ptr<GT> pairingResult = PairingBackend::newGT();
+    runner.measure("pairing", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            BilinearMapAccumulator::pairing(*pairingResult, g1Result, g2Result);
+        }
+    });
+    unique_ptr<GT> gtResult = PairingBackend::newGT();
+    runner.measure("gt.power", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            pairingResult->doPower(*bilinear.exponents.at(i), *gtResult);
+        }
+    });
+    runner.measure("gt.multiply", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            gtResult->multiplyBy(*pairingResult);
+        }
+    });
+    runner.measure("gt.square", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            gtResult->doSquare(*gtResult);
+        }
+    });
+
+    vector<reference_wrapper<Scalar>> setView = view(bilinear.set, n);
+    runner.measure("polynomial.build", n, 0, n, [&]() {
+        vector<unique_ptr<Scalar>> coeffs;
+        BilinearMapAccumulator::computeCoefficients(setView, coeffs);
+    });
+
+    OraclePrimeRep primeRep;
+    flint::BigInt representative;
+    runner.measure("primerep.oracle", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            primeRep.genRepresentative(rsa.elements.at(i), representative);
+        }
+    });
+}
+
+void kernelBenchmark(Runner& runner, CpuDispatch::Kernel kernel, size_t n, size_t operations,
+                     const function<void()>& body) {
+    for(const string& variant : CpuDispatch::getVariants(kernel)) {
+        if(CpuDispatch::select(kernel, variant))
+            runner.measure(string("kernel.") + CpuDispatch::getName(kernel) + "." + variant, n, 0, operations, body);
+    }
+    CpuDispatch::selectDefaults();
+}
+
+void kernelBenchmarks(Runner& runner, RSAInputs& rsa, size_t n) {
+    //1000 dependent Montgomery multiplications per element
+    Mont64::Fp product, factor;
+    Mont64::fp_setone(product);
+    Mont64::fp_setone(factor);
+    Mont64::fp_double(factor, factor);
+    kernelBenchmark(runner, CpuDispatch::FIELD_MULTIPLICATION, n, n * 1000, [&]() {
+        for(size_t i = 0; i < n * 1000; i++) {
+            Mont64::fp_mul(product, product, factor);
+        }
+    });
+
+    //Inputs the size of an OraclePrimeRep hash input: a 256-bit element plus its salt
+    vector<unsigned char> messages(n * 34);
+    for(size_t i = 0; i < messages.size(); i++) {
+        messages[i] = (unsigned char)(i * 131);
+    }
+    unsigned char digest[SHA256::DIGEST_LENGTH];
+    kernelBenchmark(runner, CpuDispatch::SHA256_DIGEST, n, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            SHA256::computeDigest(&messages[i * 34], 34, digest);
+        }
+    });
+    vector<unsigned char> digests(n * SHA256::DIGEST_LENGTH);
+    kernelBenchmark(runner, CpuDispatch::SHA256_BATCH, n, n, [&]() {
+        SHA256::computeDigests(messages.data(), 34, n, digests.data());
+    });
+
+    //One product of two degree-n polynomials, as at the top of the coefficient product tree
+    flint::BigInt curveOrder;
+    LibConversions::getModulus(curveOrder);
+    flint::Random random;
+    flint::ModPolynomial lhs(curveOrder), rhs(curveOrder);
+    for(size_t i = 0; i <= n; i++) {
+        lhs.set(i, random.nextInt(curveOrder));
+        rhs.set(i, random.nextInt(curveOrder));
+    }
+    kernelBenchmark(runner, CpuDispatch::POLYNOMIAL_MULTIPLICATION, n, 1, [&]() {
+        flint::ModPolynomial polynomialProduct = lhs * rhs;
+    });
+
+    //The exponentiations of public-key accumulation: the RSA base to each prime representative
+    const flint::BigMod& base = rsa.key.getPublicKey().base;
+    flint::BigMod power(rsa.key.getPublicKey().rsaModulus);
+    kernelBenchmark(runner, CpuDispatch::MODULAR_POWER, n, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            flint::power(base, rsa.representatives.at(i), power);
+        }
+    });
+}
+
+void threadedBenchmarks(Runner& runner, BilinearInputs& bilinear, RSAInputs& rsa, size_t n, size_t threads) {
+    ThreadPool threadPool(threads);
+    vector<reference_wrapper<Scalar>> setView = view(bilinear.set, n);
+    BilinearMapKey::PublicKey& publicKey = bilinear.key.getPublicKey();
+
+    runner.measure("bilinear.genKey", n, threads, 1, [&]() {
+        BilinearMapKey key;
+        BilinearMapAccumulator::genKey(vector<vector<reference_wrapper<Scalar>>>(), n, key, threadPool);
+    });
+    runner.measure("bilinear.genKey.verifier", n, threads, 1, [&]() {
+        BilinearMapKey key;
+        BilinearMapAccumulator::genKey(BilinearMapAccumulator::verifierKeySizes(), key, threadPool);
+    });
+
+    vector<unique_ptr<Scalar>> coeffs;
+    BilinearMapAccumulator::computeCoefficients(setView, coeffs);
+    unique_ptr<G> g1Acc = PairingBackend::newG1();
+    runner.measure("msm.g1", n, threads, n + 1, [&]() {
+        BilinearMapAccumulator::accumulateSetFromCoeffs(coeffs, publicKey, *g1Acc, false, threadPool);
+    });
+    unique_ptr<G> g2Acc = PairingBackend::newG2();
+    runner.measure("msm.g2", n, threads, n + 1, [&]() {
+        BilinearMapAccumulator::accumulateSetFromCoeffs(coeffs, publicKey, *g2Acc, true, threadPool);
+    });
+
+    unique_ptr<G> accPub = PairingBackend::newG1();
+    runner.measure("bilinear.accumulate.public", n, threads, n, [&]() {
+        BilinearMapAccumulator::accumulateSet(setView, publicKey, *accPub, threadPool);
+    });
+
+    unique_ptr<G> witnessBase = PairingBackend::newG2();
+    vector<unique_ptr<G>> witnesses = makeWitnesses(n);
+    runner.measure("bilinear.witnesses.private", n, threads, n, [&]() {
+        BilinearMapAccumulator::witnessesForSet(setView, bilinear.key.getSecretKey(), *witnessBase, witnesses, threadPool);
+    });
+    vector<unique_ptr<G>> witnessesPub = makeWitnesses(n);
+    runner.measure("bilinear.witnesses.public", n, threads, n, [&]() {
+        BilinearMapAccumulator::witnessesForSet(setView, publicKey, witnessesPub, threadPool);
+    });
+
+    //The same calls with accumulators in G2 and witnesses in G1
+    unique_ptr<G> swappedAccPub = PairingBackend::newG2();
+    runner.measure("bilinear.swapped.accumulate.public", n, threads, n, [&]() {
+        BilinearMapAccumulator::accumulateSet(setView, publicKey, *swappedAccPub, threadPool);
+    });
+    unique_ptr<G> swappedWitnessBase = PairingBackend::newG1();
+    vector<unique_ptr<G>> swappedWitnesses = makeWitnesses(n, true);
+    runner.measure("bilinear.swapped.witnesses.private", n, threads, n, [&]() {
+        BilinearMapAccumulator::witnessesForSet(setView, bilinear.key.getSecretKey(), *swappedWitnessBase,
+                                                swappedWitnesses, threadPool);
+    });
+    vector<unique_ptr<G>> swappedWitnessesPub = makeWitnesses(n, true);
+    runner.measure("bilinear.swapped.witnesses.public", n, threads, n, [&]() {
+        BilinearMapAccumulator::witnessesForSet(setView, publicKey, swappedWitnessesPub, threadPool);
+    });
+
+    vector<flint::BigInt> elements(rsa.elements.begin(), rsa.elements.begin() + n);
+    vector<flint::BigInt> reps(rsa.representatives.begin(), rsa.representatives.begin() + n);
+    vector<flint::BigInt> generatedReps(n);
+    runner.measure("rsa.primeTable.build", n, threads, n, [&]() {
+        TablePrimeRep table(n, threadPool);
+    });
+    runner.measure("rsa.genRepresentatives", n, threads, n, [&]() {
+        RSAAccumulator::genRepresentatives(elements, *(rsa.key.getPublicKey().primeRepGenerator), generatedReps, threadPool);
+    });
+    flint::BigMod rsaAcc;
+    runner.measure("rsa.accumulate.private", n, threads, n, [&]() {
+        RSAAccumulator::accumulateSet(reps, rsa.key, rsaAcc, threadPool);
+    });
+    //From raw elements, to compare with rsa.genRepresentatives plus rsa.accumulate.private
+    flint::BigMod pipelinedAcc;
+    runner.measure("rsa.accumulate.pipelined.private", n, threads, n, [&]() {
+        RSAAccumulator::accumulateElements(elements.begin(), elements.end(), rsa.key, pipelinedAcc, threadPool);
+    });
+    runner.measure("rsa.accumulate.pipelined.public", n, threads, n, [&]() {
+        RSAAccumulator::accumulateElements(elements.begin(), elements.end(), rsa.key.getPublicKey(), pipelinedAcc,
+                                           threadPool);
+    });
+    vector<flint::BigMod> rsaWitnesses(n);
+    runner.measure("rsa.witnesses.private", n, threads, n, [&]() {
+        RSAAccumulator::witnessesForSet(reps, rsa.key, rsaWitnesses, threadPool);
+    });
+    vector<flint::BigMod> rsaWitnessesPub(n);
+    runner.measure("rsa.witnesses.public", n, threads, n, [&]() {
+        RSAAccumulator::witnessesForSet(reps, rsa.key.getPublicKey(), rsaWitnessesPub, threadPool);
+    });
+
+    //Checking n witnesses at once, or one aggregated proof for all n elements, to compare with rsa.verify
+    if(runner.selected("rsa.verify.randomized") || runner.selected("rsa.batch") || runner.selected("rsa.dynamic")) {
+        RSAAccumulator::accumulateSet(reps, rsa.key, rsaAcc, threadPool);
+        RSAAccumulator::witnessesForSet(reps, rsa.key, rsaWitnesses, threadPool);
+    }
+    runner.measure("rsa.verify.randomized", n, threads, n, [&]() {
+        if(!RSAAccumulator::verifyBatch(elements, rsaWitnesses, rsaAcc, rsa.key.getPublicKey(), threadPool))
+            cerr << "RSA witnesses did not verify as a batch!" << endl;
+    });
+    if(runner.selected("rsa.batch")) {
+        runner.measure("rsa.batch.aggregate", n, threads, n, [&]() {
+            RSAAccumulator::aggregateWitnesses(reps, rsaWitnesses, threadPool);
+        });
+        RSAAccumulator::BatchWitness batch = RSAAccumulator::proveBatch(reps, rsaWitnesses, rsaAcc, threadPool);
+        runner.measure("rsa.batch.prove", n, threads, n, [&]() {
+            batch = RSAAccumulator::proveBatch(reps, rsaWitnesses, rsaAcc, threadPool);
+        });
+        runner.measure("rsa.batch.prove.private", n, threads, n, [&]() {
+            RSAAccumulator::proveBatch(reps, rsa.key, rsaAcc, threadPool);
+        });
+        runner.measure("rsa.batch.verify", n, threads, n, [&]() {
+            if(!RSAAccumulator::verifyBatch(elements, batch, rsaAcc, rsa.key.getPublicKey(), threadPool))
+                cerr << "RSA batch proof did not verify!" << endl;
+        });
+    }
+    //Changing n elements at once: the accumulator, and one witness brought up to date with the change
+    if(runner.selected("rsa.dynamic")) {
+        flint::BigMod changed;
+        runner.measure("rsa.dynamic.add", n, threads, n, [&]() {
+            changed = rsaAcc;
+            RSAAccumulator::add(reps, rsa.key.getPublicKey(), changed);
+        });
+        runner.measure("rsa.dynamic.remove", n, threads, n, [&]() {
+            changed = rsaAcc;
+            RSAAccumulator::remove(reps, rsa.key, changed);
+        });
+        vector<flint::BigInt> kept(reps.begin(), reps.begin() + 1), removed(reps.begin() + 1, reps.end());
+        changed = rsaAcc;
+        RSAAccumulator::remove(removed, rsa.key, changed);
+        runner.measure("rsa.dynamic.updateWitness", n, threads, n, [&]() {
+            flint::BigMod witness = rsaWitnesses.at(0);
+            if(!RSAAccumulator::updateWitness(kept.at(0), witness, {}, removed, changed))
+                cerr << "RSA witness could not be updated!" << endl;
+        });
+    }
+}
+
+void sequentialBenchmarks(Runner& runner, BilinearInputs& bilinear, RSAInputs& rsa, size_t n) {
+    vector<reference_wrapper<Scalar>> setView = view(bilinear.set, n);
+    BilinearMapKey::PublicKey& publicKey = bilinear.key.getPublicKey();
+    ThreadPool threadPool;
+
+    unique_ptr<G> acc = PairingBackend::newG1();
+    runner.measure("bilinear.accumulate.private", n, 0, n, [&]() {
+        //Private-key accumulation raises acc to a power, so it has to start from the generator every time
+        acc->becomeGenerator();
+        BilinearMapAccumulator::accumulateSet(setView, bilinear.key.getSecretKey(), *acc);
+    });
+    unique_ptr<G> witnessBase = PairingBackend::newG2();
+    vector<unique_ptr<G>> witnesses = makeWitnesses(n);
+    BilinearMapAccumulator::witnessesForSet(setView, bilinear.key.getSecretKey(), *witnessBase, witnesses, threadPool);
+    runner.measure("bilinear.verify", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            if(!BilinearMapAccumulator::verify(setView.at(i), *witnesses.at(i), *acc, publicKey))
+                cerr << "Bilinear witness for element " << i << " did not verify!" << endl;
+        }
+    });
+
+    //Writing witnesses one writeToFile call at a time, against the bulk path
+    runner.measure("io.witnesses.writeToFile", n, 0, n, [&]() {
+        ostringstream out;
+        for(size_t i = 0; i < n; i++) {
+            witnesses.at(i)->writeToFile(out);
+        }
+    });
+    string encodedWitnesses;
+    runner.measure("io.witnesses.writeAll", n, 0, n, [&]() {
+        ostringstream out;
+        {
+            BufferedWriter writer(out);
+            PairingBackend::writeAll(writer, witnesses);
+        }
+        encodedWitnesses = out.str();
+    });
+    runner.measure("io.witnesses.readAll", n, 0, n, [&]() {
+        istringstream in(encodedWitnesses);
+        BufferedReader reader(in);
+        vector<unique_ptr<G>> decoded;
+        PairingBackend::readAll(reader, n, PairingBackend::newG2, PairingBackend::getDefault(), decoded);
+    });
+
+    //With accumulators in G2, witnesses are in G1: cheaper to compute and half the size to ship
+    unique_ptr<G> swappedAcc = PairingBackend::newG2();
+    BilinearMapAccumulator::accumulateSet(setView, bilinear.key.getSecretKey(), *swappedAcc);
+    unique_ptr<G> swappedWitnessBase = PairingBackend::newG1();
+    vector<unique_ptr<G>> swappedWitnesses = makeWitnesses(n, true);
+    BilinearMapAccumulator::witnessesForSet(setView, bilinear.key.getSecretKey(), *swappedWitnessBase, swappedWitnesses,
+                                            threadPool);
+    runner.measure("bilinear.swapped.verify", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            if(!BilinearMapAccumulator::verify(setView.at(i), *swappedWitnesses.at(i), *swappedAcc, publicKey))
+                cerr << "Bilinear G1 witness for element " << i << " did not verify!" << endl;
+        }
+    });
+    runner.measure("io.swapped.witnesses.writeAll", n, 0, n, [&]() {
+        ostringstream out;
+        BufferedWriter writer(out);
+        PairingBackend::writeAll(writer, swappedWitnesses);
+    });
+
+    vector<flint::BigInt> reps(rsa.representatives.begin(), rsa.representatives.begin() + n);
+    flint::BigMod rsaAcc;
+    runner.measure("rsa.accumulate.public", n, 0, n, [&]() {
+        RSAAccumulator::accumulateSet(reps, rsa.key.getPublicKey(), rsaAcc);
+    });
+    //The measurements above are skipped when filtered out, so make sure there is an accumulator to verify against
+    if(runner.selected("rsa.verify"))
+        RSAAccumulator::accumulateSet(reps, rsa.key, rsaAcc, threadPool);
+    vector<flint::BigMod> rsaWitnesses(n);
+    RSAAccumulator::witnessesForSet(reps, rsa.key, rsaWitnesses, threadPool);
+    runner.measure("rsa.verify", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            if(!RSAAccumulator::verify(rsa.elements.at(i), rsaWitnesses.at(i), rsaAcc, rsa.key.getPublicKey()))
+                cerr << "RSA witness for element " << i << " did not verify!" << endl;
+        }
+    });
+    //Verifiers that recover each representative from its hint, or find it in a warm cache, instead of searching
+    vector<flint::BigInt> elements(rsa.elements.begin(), rsa.elements.begin() + n);
+    vector<flint::BigInt> cachedReps(n);
+    vector<uint32_t> hints;
+    RSAKey::PublicKey cachedKey{rsa.key.getPublicKey().rsaModulus, rsa.key.getPublicKey().base,
+                                std::make_unique<PrimeRepCache>(std::make_unique<OraclePrimeRep>(), 2 * n)};
+    RSAAccumulator::genRepresentatives(elements, *cachedKey.primeRepGenerator, cachedReps, hints, threadPool);
+    runner.measure("rsa.verify.hint", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            if(!RSAAccumulator::verify(elements.at(i), hints.at(i), rsaWitnesses.at(i), rsaAcc, rsa.key.getPublicKey()))
+                cerr << "RSA witness for element " << i << " did not verify with its hint!" << endl;
+        }
+    });
+    runner.measure("rsa.verify.cached", n, 0, n, [&]() {
+        for(size_t i = 0; i < n; i++) {
+            if(!RSAAccumulator::verify(elements.at(i), rsaWitnesses.at(i), rsaAcc, cachedKey))
+                cerr << "RSA witness for element " << i << " did not verify with a cached key!" << endl;
+        }
+    });
+}
+
+void writeText(ostream& out, const vector<Result>& results) {
+    out << left << setw(38) << "benchmark" << right << setw(8) << "n" << setw(8) << "threads"
+        << setw(14) << "mean (s)" << setw(14) << "stddev (s)" << setw(14) << "median (s)"
+        << setw(14) << "min (s)" << setw(14) << "max (s)" << setw(14) << "per op (us)" << endl;
+    for(const Result& result : results) {
+        out << left << setw(38) << result.name << right << setw(8) << result.size << setw(8) << result.threads
+            << setw(14) << result.mean << setw(14) << result.stddev << setw(14) << result.median
+            << setw(14) << result.min << setw(14) << result.max
+            << setw(14) << result.mean / result.operations * 1e6 << endl;
+    }
+}
+
+void writeCsv(ostream& out, const vector<Result>& results) {
+    out << "benchmark,size,threads,operations,repetitions,mean,stddev,median,min,max" << endl;
+    for(const Result& result : results) {
+        out << result.name << "," << result.size << "," << result.threads << "," << result.operations << ","
+            << result.samples.size() << "," << result.mean << "," << result.stddev << "," << result.median << ","
+            << result.min << "," << result.max << endl;
+    }
+}
+
+void writeJson(ostream& out, const vector<Result>& results, const Options& options) {
+    out << "{\"context\":{\"repetitions\":" << options.repetitions
+        << ",\"warmup\":" << options.warmup
+        << ",\"modulus_bits\":" << options.modulusBits
+        << ",\"memory_pool\":" << (options.usePool ? "true" : "false")
+        << ",\"backend\":\"" << PairingBackend::getName(options.backend) << "\""
+        << ",\"hardware_threads\":" << thread::hardware_concurrency()
+        << ",\"cpu_features\":\"" << CpuDispatch::describeFeatures() << "\""
+        << ",\"kernels\":\"" << CpuDispatch::describeSelection() << "\""
+        << "},\"results\":[";
+    for(size_t r = 0; r < results.size(); r++) {
+        const Result& result = results.at(r);
+        out << (r ? "," : "") << "{\"name\":\"" << result.name << "\""
+            << ",\"size\":" << result.size
+            << ",\"threads\":" << result.threads
+            << ",\"operations\":" << result.operations
+            << ",\"mean\":" << result.mean
+            << ",\"stddev\":" << result.stddev
+            << ",\"median\":" << result.median
+            << ",\"min\":" << result.min
+            << ",\"max\":" << result.max
+            << ",\"samples\":[";
+        for(size_t s = 0; s < result.samples.size(); s++) {
+            out << (s ? "," : "") << result.samples.at(s);
+        }
+        out << "]}";
+    }
+    out << "]}" << endl;
+}
+
+}  // namespace benchmark
+
+int main(int argc, char** argv) {
+    benchmark::Options options;
+    if(!benchmark::parseOptions(argc, argv, options)) {
+        benchmark::usage();
+        return 1;
+    }
+    //Must happen before anything allocates a GMP or FLINT object
+    if(options.usePool) {
+        MemoryPool::install();
+    }
+    PairingBackend::setDefault(options.backend);
+    size_t maxSize = *max_element(options.sizes.begin(), options.sizes.end());
+    size_t maxThreads = *max_element(options.threads.begin(), options.threads.end());
+
+    cerr << "Generating inputs for up to " << maxSize << " elements" << endl;
+    benchmark::BilinearInputs bilinear;
+    benchmark::RSAInputs rsa;
+    flint::Random random;
+    for(size_t i = 0; i < maxSize; i++) {
+        unique_ptr<Scalar> element = std::make_unique<ScalarDCLXVI>();
+        element->generateRandom();
+        bilinear.set.push_back(move(element));
+        unique_ptr<Scalar> exponent = std::make_unique<ScalarDCLXVI>();
+        exponent->generateRandom();
+        bilinear.exponents.push_back(move(exponent));
+        rsa.elements.push_back(random.nextInt(256));
+    }
+    {
+        ThreadPool setupPool(maxThreads);
+        BilinearMapAccumulator::genKey(vector<vector<reference_wrapper<Scalar>>>(), maxSize, bilinear.key, setupPool);
+        RSAAccumulator::genKey(0, options.modulusBits, rsa.key, setupPool);
+        rsa.representatives.resize(maxSize);
+        RSAAccumulator::genRepresentatives(rsa.elements, *(rsa.key.getPublicKey().primeRepGenerator),
+                                           rsa.representatives, setupPool);
+    }
+
+    benchmark::Runner runner(options);
+    runner.measure("rsa.genKey", 0, 0, 1, [&]() {
+        RSAKey key;
+        RSAAccumulator::genKey(0, options.modulusBits, key);
+    });
+    for(size_t threads : options.threads) {
+        ThreadPool threadPool(threads);
+        runner.measure("rsa.genKey.parallel", 0, threads, 1, [&]() {
+            RSAKey key;
+            RSAAccumulator::genKey(0, options.modulusBits, key, threadPool);
+        });
+    }
+    for(size_t n : options.sizes) {
+        benchmark::primitiveBenchmarks(runner, bilinear, rsa, n);
+        benchmark::kernelBenchmarks(runner, rsa, n);
+        benchmark::sequentialBenchmarks(runner, bilinear, rsa, n);
+        for(size_t threads : options.threads) {
+            benchmark::threadedBenchmarks(runner, bilinear, rsa, n, threads);
+        }
+    }
+
+    ofstream fileOut;
+    if(!options.output.empty()) {
+        fileOut.open(options.output);
+    }
+    ostream& out = options.output.empty() ? cout : fileOut;
+    if(options.format == "json") {
+        benchmark::writeJson(out, runner.getResults(), options);
+    } else if(options.format == "csv") {
+        benchmark::writeCsv(out, runner.getResults());
+    } else {
+        benchmark::writeText(out, runner.getResults());
+    }
+    return 0;
+}
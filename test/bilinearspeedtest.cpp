@@ -26,7 +26,7 @@ using namespace std;
 
 namespace speedtest {
 //Forward declarations
-void bilinearTest(int setSize);
+void bilinearTest(int setSize, const char* traceFile);
 void bilinearPublicPrivateTest();
 
 }  // namespace speedtest
@@ -41,7 +41,8 @@ int main(int argc, char** argv) {
 
     // speedtest::saveElements(SET_SIZE, "randomSet" + to_string(SET_SIZE));
     speedtest::bilinearPublicPrivateTest();
-    speedtest::bilinearTest(setSize);
+    //An optional second argument names a file to write a task timeline to
+    speedtest::bilinearTest(setSize, argc > 2 ? argv[2] : nullptr);
     // speedtest::saveBigints(SET_SIZE, "randomBigints" + to_string(SET_SIZE));
 
     return 0;
@@ -222,11 +223,14 @@ void bilinearPublicPrivateTest() {
     print_hex(gToSp1.getByteBuffer(), gToSp1.getSize());
 }
 
-void bilinearTest(int setSize) {
+void bilinearTest(int setSize, const char* traceFile) {
     // cout << "Bilinear-Map Accumulator test:" << endl;
     //Initialize the thread pool for multithreading
     const int THREAD_POOL_SIZE = 16;
     ThreadPool threadPool(THREAD_POOL_SIZE);
+    if(traceFile) {
+        threadPool.enableTracing();
+    }
 
     vector<unique_ptr<Scalar>> set;             //Holds the actual set
     vector<reference_wrapper<Scalar>> setView;  //A "view" of the set to pass to functions that observe it
@@ -328,6 +332,11 @@ void bilinearTest(int setSize) {
     //This actually doesn't need to get measured and logged, since the time will
     //be the same as for verification with the private-key witnesses. It only
     //needs to run to guarantee correctness.
+
+    if(traceFile) {
+        ofstream traceOut(traceFile);
+        threadPool.getTrace()->writeChromeTrace(traceOut);
+    }
 }
 
 }  // namespace speedtest
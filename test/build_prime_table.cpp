@@ -0,0 +1,49 @@
+/*
+ * build_prime_table.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Builds the prime table of a TablePrimeRep for the elements 0 to size - 1
+ * and saves it, for servers and verifiers to load instead of building.
+ *
+ * Usage: build_prime_table <size> <file> [threads]
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <algorithms/TablePrimeRep.hpp>
+
+#include <utils/ThreadPool.hpp>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        cout << "Usage: build_prime_table <size> <file> [threads]" << endl;
+        return 1;
+    }
+    uint64_t size = strtoull(argv[1], NULL, 10);
+    size_t threads = argc > 3 ? atoi(argv[3]) : max(1u, thread::hardware_concurrency());
+    ThreadPool threadPool(threads);
+    auto start = chrono::steady_clock::now();
+    try {
+        TablePrimeRep table(size, threadPool);
+        auto built = chrono::steady_clock::now();
+        if(!table.save(argv[2])) {
+            cerr << "Could not write " << argv[2] << endl;
+            return 1;
+        }
+        cout << "Built the table for " << size << " elements (" << table.getDomainBits() << "-bit domain) in "
+             << chrono::duration<double>(built - start).count() << " s on " << threads << " threads" << endl;
+        cout << "Representatives run from " << table.representative(0) << " to " << table.representative(size - 1)
+             << endl;
+    } catch(const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+/*
+ * dispatchtest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Checks that every implementation of each runtime-dispatched kernel (see
+ * utils/CpuDispatch.hpp) that this CPU supports gives the same results: SHA-256
+ * against known digests and Crypto++, batched SHA-256 against single
+ * digests, Montgomery multiplication and polynomial
+ * multiplication against each other on random inputs, and modular
+ * exponentiation against FLINT for moduli of every ModN width and a few that
+ * no ModN fits. Variants the CPU can't run are reported and skipped.
+ *
+ * Usage: dispatchtest [iterations]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gmp.h>
+
+#include <bilinear/Mont64Field.hpp>
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+#include <flint/ModPolynomial.hpp>
+#include <flint/Random.hpp>
+#include <utils/CpuDispatch.hpp>
+#include <utils/LibConversions.hpp>
+#include <utils/testutils.hpp>
+#include <utils/SHA256.hpp>
+
+using namespace std;
+
+namespace dispatchtest {
+
+using testutils::check;
+
+string toHex(const unsigned char* bytes, size_t length) {
+    static const char* DIGITS = "0123456789abcdef";
+    string hex;
+    for(size_t i = 0; i < length; i++) {
+        hex += DIGITS[bytes[i] >> 4];
+        hex += DIGITS[bytes[i] & 0xf];
+    }
+    return hex;
+}
+
+string digest(const string& input) {
+    unsigned char output[SHA256::DIGEST_LENGTH];
+    SHA256::computeDigest((const unsigned char*)input.data(), input.size(), output);
+    return toHex(output, SHA256::DIGEST_LENGTH);
+}
+
+void checkSha256(const string& variant, int iterations) {
+    check(digest("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855", variant + " empty digest");
+    check(digest("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", variant + " \"abc\"");
+    check(digest("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+                  == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+          variant + " two-block message");
+    //Every tail length, compared with Crypto++
+    for(int length = 0; length < iterations * 10; length++) {
+        string input;
+        for(int i = 0; i < length; i++) {
+            input += (char)(rand() & 0xff);
+        }
+        string result = digest(input);
+        CpuDispatch::select(CpuDispatch::SHA256_DIGEST, "cryptopp");
+        string expected = digest(input);
+        CpuDispatch::select(CpuDispatch::SHA256_DIGEST, variant);
+        check(result == expected, variant + " digest of " + to_string(length) + " bytes");
+    }
+}
+
+void checkSha256Batch(const string& variant, int iterations) {
+    //Messages of every length up to a few blocks, shuffled so lanes finish at different times, then a
+    //batch smaller than a register's lanes and an empty one
+    vector<string> messages;
+    for(int length = 0; length < iterations * 10; length++) {
+        string input;
+        for(int i = 0; i < length; i++) {
+            input += (char)(rand() & 0xff);
+        }
+        messages.push_back(input);
+    }
+    for(size_t i = messages.size(); i > 1; i--) {
+        swap(messages[i - 1], messages[rand() % i]);
+    }
+    for(size_t count : {messages.size(), (size_t)3, (size_t)0}) {
+        vector<const unsigned char*> inputs;
+        vector<size_t> lengths;
+        for(size_t i = 0; i < count; i++) {
+            inputs.push_back((const unsigned char*)messages[i].data());
+            lengths.push_back(messages[i].size());
+        }
+        vector<unsigned char> outputs(count * SHA256::DIGEST_LENGTH + 1, 0xee);
+        SHA256::computeDigests(inputs.data(), lengths.data(), count, outputs.data());
+        bool matches = outputs.back() == 0xee;
+        for(size_t i = 0; i < count; i++) {
+            matches &= toHex(&outputs[i * SHA256::DIGEST_LENGTH], SHA256::DIGEST_LENGTH) == digest(messages[i]);
+        }
+        check(matches, variant + " batch of " + to_string(count) + " messages");
+    }
+    //Equal-length messages stored back to back, like the two children of a Merkle tree node
+    string children;
+    for(int i = 0; i < 64 * 37; i++) {
+        children += (char)(rand() & 0xff);
+    }
+    vector<unsigned char> outputs(37 * SHA256::DIGEST_LENGTH);
+    SHA256::computeDigests((const unsigned char*)children.data(), 64, 37, outputs.data());
+    bool matches = true;
+    for(size_t i = 0; i < 37; i++) {
+        matches &= toHex(&outputs[i * SHA256::DIGEST_LENGTH], SHA256::DIGEST_LENGTH) == digest(children.substr(64 * i, 64));
+    }
+    check(matches, variant + " contiguous batch");
+}
+
+void randomFieldElement(Mont64::Fp& element, gmp_randstate_t state, const mpz_t modulus) {
+    mpz_t value;
+    mpz_init(value);
+    mpz_urandomm(value, state, modulus);
+    Mont64::fp_from_mpz(element, value);
+    mpz_clear(value);
+}
+
+void checkFieldMultiplication(const string& variant, int iterations) {
+    mpz_t modulus;
+    mpz_init(modulus);
+    Mont64::fp_modulus(modulus);
+    gmp_randstate_t state;
+    gmp_randinit_default(state);
+    for(int i = 0; i < iterations * 100; i++) {
+        Mont64::Fp a, b, product, square, expectedProduct, expectedSquare;
+        randomFieldElement(a, state, modulus);
+        randomFieldElement(b, state, modulus);
+        Mont64::fp_mul(product, a, b);
+        Mont64::fp_square(square, a);
+        CpuDispatch::select(CpuDispatch::FIELD_MULTIPLICATION, "portable");
+        Mont64::fp_mul(expectedProduct, a, b);
+        Mont64::fp_square(expectedSquare, a);
+        CpuDispatch::select(CpuDispatch::FIELD_MULTIPLICATION, variant);
+        check(Mont64::fp_iseq(product, expectedProduct), variant + " product");
+        check(Mont64::fp_iseq(square, expectedSquare), variant + " square");
+    }
+    gmp_randclear(state);
+    mpz_clear(modulus);
+}
+
+flint::ModPolynomial randomPolynomial(long degree, flint::BigInt& modulus, flint::Random& random) {
+    flint::ModPolynomial polynomial(modulus);
+    for(long i = 0; i <= degree; i++) {
+        polynomial.set(i, random.nextInt(modulus));
+    }
+    return polynomial;
+}
+
+void checkPolynomialMultiplication(const string& variant, int iterations) {
+    flint::BigInt modulus;
+    LibConversions::getModulus(modulus);
+    flint::Random random;
+    for(int i = 0; i < iterations * 2; i++) {
+        //Unequal degrees, in both orders, and the zero polynomial
+        flint::ModPolynomial lhs = randomPolynomial(i * 3, modulus, random);
+        flint::ModPolynomial rhs = i % 3 ? randomPolynomial(i, modulus, random) : flint::ModPolynomial(modulus);
+        flint::ModPolynomial product = lhs * rhs;
+        flint::ModPolynomial reversed = rhs * lhs;
+        flint::ModPolynomial inPlace(lhs);
+        inPlace *= rhs;
+        CpuDispatch::select(CpuDispatch::POLYNOMIAL_MULTIPLICATION, "flint");
+        flint::ModPolynomial expected = lhs * rhs;
+        CpuDispatch::select(CpuDispatch::POLYNOMIAL_MULTIPLICATION, variant);
+        check(product == expected, variant + " product of degree " + to_string(i * 3) + " and " + to_string(i));
+        check(reversed == expected, variant + " reversed product");
+        check(inPlace == expected, variant + " in-place product");
+    }
+}
+
+//An odd modulus of exactly the given number of bits, or an even one
+flint::BigInt randomModulus(unsigned long bits, bool odd, flint::Random& random) {
+    flint::BigInt modulus = random.nextInt(bits);
+    if(modulus < 0)
+        modulus = flint::BigInt(0) - modulus;
+    if((bool)fmpz_is_odd(modulus.getUnderlyingObject()) != odd)
+        modulus = modulus - 1;
+    return modulus;
+}
+
+void checkModularPower(const string& variant, int iterations) {
+    flint::Random random;
+    //The ModN widths at their largest and smallest, then moduli that go to GMP whatever the kernel
+    const unsigned long BITS[] = {1024, 961, 2048, 2047, 3072, 4096, 1100, 2048};
+    for(size_t m = 0; m < sizeof(BITS) / sizeof(BITS[0]); m++) {
+        bool odd = m + 1 < sizeof(BITS) / sizeof(BITS[0]);
+        flint::BigInt modulus = randomModulus(BITS[m], odd, random);
+        string name = variant + " " + to_string(BITS[m]) + "-bit " + (odd ? "" : "even ") + "modulus";
+        for(int i = 0; i < iterations / 10 + 1; i++) {
+            flint::BigInt modulusMinusOne = modulus - 1;
+            vector<flint::BigInt> bases = {random.nextInt(modulus), 0, 1, modulusMinusOne};
+            vector<flint::BigInt> exponents = {0, 1, 2, random.nextUnsignedInt(64), random.nextUnsignedInt(256),
+                                               random.nextUnsignedInt(BITS[m]), modulusMinusOne};
+            for(const flint::BigInt& base : bases) {
+                for(const flint::BigInt& exponent : exponents) {
+                    flint::BigMod result(modulus), inPlace(base, modulus);
+                    flint::power(flint::BigMod(base, modulus), exponent, result);
+                    inPlace ^= exponent;
+                    fmpz_t expected;
+                    fmpz_init(expected);
+                    fmpz_powm(expected, base.getUnderlyingObject(), exponent.getUnderlyingObject(),
+                              modulus.getUnderlyingObject());
+                    check(result.getMantissa() == flint::BigInt(expected) && inPlace == result,
+                          name + " power with a " + to_string(exponent.bitLength()) + "-bit exponent");
+                    fmpz_clear(expected);
+                }
+            }
+        }
+    }
+}
+
+}  // namespace dispatchtest
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    cout << "CPU features: " << CpuDispatch::describeFeatures() << endl;
+    cout << "Selected: " << CpuDispatch::describeSelection() << endl;
+    for(CpuDispatch::Kernel kernel : CpuDispatch::getKernels()) {
+        for(const string& variant : CpuDispatch::getVariants(kernel)) {
+            if(!CpuDispatch::select(kernel, variant)) {
+                cout << "Skipping " << CpuDispatch::getName(kernel) << " " << variant << ", which this CPU can't run"
+                     << endl;
+                continue;
+            }
+            if(kernel == CpuDispatch::SHA256_DIGEST) {
+                dispatchtest::checkSha256(variant, iterations);
+            } else if(kernel == CpuDispatch::SHA256_BATCH) {
+                dispatchtest::checkSha256Batch(variant, iterations);
+            } else if(kernel == CpuDispatch::FIELD_MULTIPLICATION) {
+                dispatchtest::checkFieldMultiplication(variant, iterations);
+            } else if(kernel == CpuDispatch::MODULAR_POWER) {
+                dispatchtest::checkModularPower(variant, iterations);
+            } else {
+                dispatchtest::checkPolynomialMultiplication(variant, iterations);
+            }
+            cout << "Checked " << CpuDispatch::getName(kernel) << " " << variant << endl;
+        }
+    }
+    CpuDispatch::selectDefaults();
+    return testutils::checkResults();
+}
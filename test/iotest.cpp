@@ -0,0 +1,448 @@
+/*
+ * iotest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Checks the bulk serialization paths against the per-element ones: encode
+ * must give exactly the bytes writeToFile writes, for every group, scalar and
+ * backend, so files written either way can be read either way. Then round
+ * trips vectors of elements through BufferedWriter and BufferedReader, with a
+ * buffer small enough that elements straddle refills, and a public key
+ * through BilinearMapKey's files, which must reject a file of the other
+ * backend or a truncated one. Also checks that the value types' decode
+ * rejects unreduced coordinates, points off the curve, twist points outside
+ * G2, elements of Fp12 outside GT and exponents above the group order.
+ *
+ * Usage: iotest [count]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gmp.h>
+
+#include <bilinear/Backends.hpp>
+#include <bilinear/GroupElement.hpp>
+#include <bilinear/Mont64Curve.hpp>
+#include <bilinear/PairingBackend.hpp>
+#include <bilinear/Scalar_DCLXVI.hpp>
+
+#include <algorithms/BilinearMapAccumulator.hpp>
+#include <algorithms/BilinearMapKey.hpp>
+
+#include <utils/BinaryIO.hpp>
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace iotest {
+
+using testutils::check;
+
+template <typename T>
+string writeToString(const T& element) {
+    ostringstream out;
+    element.writeToFile(out);
+    return out.str();
+}
+
+template <typename T>
+string encodeToString(const T& element) {
+    string bytes(element.getEncodedSize(), '\0');
+    element.encode((std::byte*)&bytes[0]);
+    return bytes;
+}
+
+//encode and writeToFile agree, and decode and readFromFile undo them
+void checkElement(G& element, G& decoded, const string& what) {
+    string written = writeToString(element);
+    check(written.size() == element.getEncodedSize(), what + " encoded size");
+    check(encodeToString(element) == written, what + " encode");
+    decoded.becomeIdentity();
+    check(decoded.decode((const std::byte*)written.data()) && decoded.isEqual(element), what + " decode");
+    decoded.becomeIdentity();
+    istringstream in(written);
+    decoded.readFromFile(in);
+    check(in && decoded.isEqual(element), what + " readFromFile");
+}
+
+void checkElements(PairingBackend::Type backend) {
+    string name = PairingBackend::getName(backend);
+    ScalarDCLXVI exponent, decodedExponent;
+    exponent.generateRandom();
+    string written = writeToString(exponent);
+    check(encodeToString(exponent) == written, "scalar encode");
+    decodedExponent.decode((const std::byte*)written.data());
+    check(decodedExponent.getSize() == exponent.getSize() && encodeToString(decodedExponent) == written,
+          "scalar decode");
+
+    unique_ptr<G> g1 = PairingBackend::newG1(backend), g1Power = PairingBackend::newG1(backend);
+    unique_ptr<G> g2 = PairingBackend::newG2(backend), g2Power = PairingBackend::newG2(backend);
+    g1->doPower(exponent, *g1Power);
+    g2->doPower(exponent, *g2Power);
+    checkElement(*g1Power, *g1, name + " G1");
+    checkElement(*g2Power, *g2, name + " G2");
+
+    unique_ptr<GT> gt = PairingBackend::newGT(backend), gtDecoded = PairingBackend::newGT(backend);
+    PairingBackend::pairing(*gt, *g1Power, *g2Power);
+    written = writeToString(*gt);
+    check(encodeToString(*gt) == written, name + " GT encode");
+    check(gtDecoded->decode((const std::byte*)written.data()) && gtDecoded->isEqual(*gt), name + " GT decode");
+}
+
+//The virtual-interface bulk path, with elements straddling buffer refills
+void checkWriteAll(PairingBackend::Type backend, size_t count) {
+    string name = PairingBackend::getName(backend);
+    vector<unique_ptr<G>> elements;
+    string expected;
+    for(size_t i = 0; i < count; i++) {
+        ScalarDCLXVI exponent;
+        exponent.generateRandom();
+        elements.push_back(PairingBackend::newG2(backend));
+        unique_ptr<G> base = PairingBackend::newG2(backend);
+        base->doPower(exponent, *elements.back());
+    }
+    for(const unique_ptr<G>& element : elements) {
+        expected += writeToString(*element);
+    }
+
+    ostringstream out;
+    {
+        BufferedWriter writer(out, 1000);
+        PairingBackend::writeAll(writer, elements);
+    }
+    check(out.str() == expected, name + " writeAll");
+    string encoded(expected.size(), '\0');
+    PairingBackend::encodeAll((std::byte*)&encoded[0], elements);
+    check(encoded == expected, name + " encodeAll");
+
+    istringstream in(expected);
+    BufferedReader reader(in, 1000);
+    vector<unique_ptr<G>> decoded;
+    check(PairingBackend::readAll(reader, count, PairingBackend::newG2, backend, decoded), name + " readAll");
+    for(size_t i = 0; i < decoded.size(); i++) {
+        check(decoded.at(i)->isEqual(*elements.at(i)), name + " readAll element " + to_string(i));
+    }
+    check(!PairingBackend::readAll(reader, 1, PairingBackend::newG2, backend, decoded) && !reader.good(),
+          name + " readAll past the end");
+}
+
+//The value types, which must write the same bytes as the virtual classes
+template <typename Backend>
+void checkValueTypes(size_t count) {
+    string name = PairingBackend::getName(Backend::TYPE);
+    vector<Fr<Backend>> exponents(count);
+    vector<G1<Backend>> points;
+    for(Fr<Backend>& exponent : exponents) {
+        exponent.generateRandom();
+        points.push_back(G1<Backend>().pow(exponent));
+    }
+    vector<GTElement<Backend>> pairings;
+    for(size_t i = 0; i < count; i++) {
+        pairings.push_back(pairing(points.at(i), G2<Backend>()));
+    }
+    string expected;
+    for(const G1<Backend>& point : points) {
+        unique_ptr<G> element = PairingBackend::newG1(Backend::TYPE);
+        point.exportTo(*element);
+        expected += writeToString(*element);
+    }
+
+    ostringstream out;
+    {
+        BufferedWriter writer(out, 1000);
+        writeElements(writer, exponents);
+        writeElements(writer, points);
+        writeElements(writer, pairings);
+    }
+    string written = out.str();
+    check(written.substr(count * Fr<Backend>::ENCODED_SIZE, expected.size()) == expected,
+          name + " writeElements matches writeToFile");
+
+    istringstream in(written);
+    BufferedReader reader(in, 1000);
+    vector<Fr<Backend>> readExponents;
+    vector<G1<Backend>> readPoints;
+    vector<GTElement<Backend>> readPairings;
+    check(readElements(reader, count, readExponents) && readElements(reader, count, readPoints)
+                  && readElements(reader, count, readPairings),
+          name + " readElements");
+    for(size_t i = 0; i < count; i++) {
+        check(readPoints.at(i) == points.at(i) && readPairings.at(i) == pairings.at(i)
+                      && readPoints.at(i) == G1<Backend>().pow(readExponents.at(i)),
+              name + " readElements element " + to_string(i));
+    }
+}
+
+//Square root mod p, which is 3 mod 4; returns false if op isn't a square
+bool sqrtModP(mpz_t rop, const mpz_t op, const mpz_t p) {
+    mpz_t exponent, square;
+    mpz_init(exponent);
+    mpz_init(square);
+    mpz_add_ui(exponent, p, 1);
+    mpz_fdiv_q_2exp(exponent, exponent, 2);
+    mpz_powm(rop, op, exponent, p);
+    mpz_powm_ui(square, rop, 2, p);
+    bool isSquare = mpz_cmp(square, op) == 0;
+    mpz_clear(exponent);
+    mpz_clear(square);
+    return isSquare;
+}
+
+/**
+ * A point on the twist y^2 = x^3 + 3/xi that isn't in G2. The twist has
+ * n(2p - n) points, so almost none of them are in G2, and this takes the first
+ * x = k + i whose right-hand side has a square root in Fp2.
+ */
+Mont64::G2Point twistPointOutsideG2() {
+    Mont64::Fp2 one, b, xi;
+    Mont64::fp2_setone(one);
+    Mont64::fp2_triple(b, one);
+    xi = b;
+    Mont64::fp_setone(xi.c1);
+    Mont64::fp2_invert(xi, xi);
+    Mont64::fp2_mul(b, b, xi);
+    mpz_t p, a0, a1, norm, root, half, x0, x1;
+    for(mpz_t* value : {&p, &a0, &a1, &norm, &root, &half, &x0, &x1}) {
+        mpz_init(*value);
+    }
+    Mont64::fp_modulus(p);
+    Mont64::G2Point point;
+    Mont64::fp2_setone(point.z);
+    point.x = one;
+    for(bool found = false; !found;) {
+        Mont64::fp2_add(point.x, point.x, one);
+        Mont64::fp_setone(point.x.c1);
+        Mont64::Fp2 rhs;
+        Mont64::fp2_square(rhs, point.x);
+        Mont64::fp2_mul(rhs, rhs, point.x);
+        Mont64::fp2_add(rhs, rhs, b);
+        //sqrt(a0 + a1 i) = x0 + x1 i, with x0^2 = (a0 +- sqrt(a0^2 + a1^2))/2 and x1 = a1/(2 x0)
+        Mont64::fp_to_mpz(a0, rhs.c0);
+        Mont64::fp_to_mpz(a1, rhs.c1);
+        mpz_mul(norm, a0, a0);
+        mpz_addmul(norm, a1, a1);
+        mpz_mod(norm, norm, p);
+        if(!sqrtModP(root, norm, p))
+            continue;
+        for(int sign : {1, -1}) {
+            if(sign > 0)
+                mpz_add(half, a0, root);
+            else
+                mpz_sub(half, a0, root);
+            if(mpz_odd_p(half))
+                mpz_add(half, half, p);
+            mpz_fdiv_q_2exp(half, half, 1);
+            mpz_mod(half, half, p);
+            if(mpz_sgn(half) == 0 || !sqrtModP(x0, half, p))
+                continue;
+            mpz_mul_ui(x1, x0, 2);
+            mpz_invert(x1, x1, p);
+            mpz_mul(x1, x1, a1);
+            mpz_mod(x1, x1, p);
+            Mont64::fp_from_mpz(point.y.c0, x0);
+            Mont64::fp_from_mpz(point.y.c1, x1);
+            Mont64::Fp2 lhs;
+            Mont64::fp2_square(lhs, point.y);
+            found = Mont64::fp2_iseq(lhs, rhs);
+            break;
+        }
+    }
+    for(mpz_t* value : {&p, &a0, &a1, &norm, &root, &half, &x0, &x1}) {
+        mpz_clear(*value);
+    }
+    return point;
+}
+
+//Sets a backend's point or element to a Mont64 one
+void fromMont64(Mont64::G1Point& rop, const Mont64::G1Point& op) {
+    rop = op;
+}
+void fromMont64(curvepoint_fp_struct_t& rop, const Mont64::G1Point& op) {
+    Mont64::g1_to_dclxvi(&rop, op);
+}
+void fromMont64(Mont64::G2Point& rop, const Mont64::G2Point& op) {
+    rop = op;
+}
+void fromMont64(twistpoint_fp2_struct_t& rop, const Mont64::G2Point& op) {
+    Mont64::g2_to_dclxvi(&rop, op);
+}
+void fromMont64(Mont64::Fp12& rop, const Mont64::Fp12& op) {
+    rop = op;
+}
+void fromMont64(fp12e_struct_t& rop, const Mont64::Fp12& op) {
+    Mont64::fp12_to_dclxvi(&rop, op);
+}
+
+template <typename T>
+string encodeValue(T value) {
+    string bytes(T::ENCODED_SIZE, '\0');
+    T::encode((std::byte*)&bytes[0], &value, 1);
+    return bytes;
+}
+
+template <typename T>
+bool decodes(const string& bytes) {
+    T value;
+    return T::decode(&value, (const std::byte*)bytes.data(), 1);
+}
+
+//decode must reject anything that isn't an element of its group
+template <typename Backend>
+void checkInvalidEncodings() {
+    string name = PairingBackend::getName(Backend::TYPE);
+    Fr<Backend> exponent;
+    exponent.generateRandom();
+    string g1 = encodeValue(G1<Backend>().pow(exponent));
+    string g2 = encodeValue(G2<Backend>().pow(exponent));
+    string gt = encodeValue(pairing(G1<Backend>(), G2<Backend>()).pow(exponent));
+    check(decodes<Fr<Backend>>(encodeValue(exponent)) && decodes<G1<Backend>>(g1) && decodes<G2<Backend>>(g2)
+                  && decodes<GTElement<Backend>>(gt) && decodes<G1<Backend>>(encodeValue(G1<Backend>::identity()))
+                  && decodes<G2<Backend>>(encodeValue(G2<Backend>::identity())),
+          name + " valid encodings decode");
+
+    check(!decodes<Fr<Backend>>(string(Fr<Backend>::ENCODED_SIZE, '\xff')), name + " exponent above n rejected");
+
+    //The top limb of X on Mont64, past p; a coefficient of T on DCLXVI, which becomes a NaN
+    for(string* encoding : {&g1, &g2, &gt}) {
+        encoding->replace(24, 8, 8, '\xff');
+    }
+    check(!decodes<G1<Backend>>(g1) && !decodes<G2<Backend>>(g2) && !decodes<GTElement<Backend>>(gt),
+          name + " unreduced encodings rejected");
+
+    Mont64::G1Point offCurve;
+    Mont64::g1_setgenerator(offCurve);
+    Mont64::fp_add(offCurve.y, offCurve.y, offCurve.z);
+    G1<Backend> g1OffCurve;
+    fromMont64(g1OffCurve.getPoint(), offCurve);
+    check(!decodes<G1<Backend>>(encodeValue(g1OffCurve)), name + " point off the curve rejected");
+
+    G2<Backend> outsideG2;
+    fromMont64(outsideG2.getPoint(), twistPointOutsideG2());
+    check(!decodes<G2<Backend>>(encodeValue(outsideG2)), name + " twist point outside G2 rejected");
+
+    Mont64::Fp12 two;
+    Mont64::fp12_setone(two);
+    Mont64::fp_add(two.c0.c0.c0, two.c0.c0.c0, two.c0.c0.c0);
+    GTElement<Backend> outsideGT;
+    fromMont64(outsideGT.getElement(), two);
+    check(!decodes<GTElement<Backend>>(encodeValue(outsideGT)), name + " element outside GT rejected");
+
+    //The virtual interface makes the same checks, and so do readFromFile and readAll, which use it
+    string offCurveBytes = encodeValue(g1OffCurve);
+    unique_ptr<G> g1Element = PairingBackend::newG1(Backend::TYPE), g2Element = PairingBackend::newG2(Backend::TYPE);
+    unique_ptr<GT> gtElement = PairingBackend::newGT(Backend::TYPE);
+    check(!g1Element->decode((const std::byte*)offCurveBytes.data())
+                  && g1Element->isEqual(*PairingBackend::newG1(Backend::TYPE))
+                  && !g2Element->decode((const std::byte*)encodeValue(outsideG2).data())
+                  && g2Element->isEqual(*PairingBackend::newG2(Backend::TYPE))
+                  && !gtElement->decode((const std::byte*)encodeValue(outsideGT).data()),
+          name + " virtual decode rejects invalid encodings");
+    istringstream offCurveBytesIn(offCurveBytes);
+    g1Element->readFromFile(offCurveBytesIn);
+    check(offCurveBytesIn.fail(), name + " readFromFile fails on a point off the curve");
+    istringstream bulkIn(encodeValue(G1<Backend>()) + offCurveBytes + encodeValue(G1<Backend>()));
+    BufferedReader reader(bulkIn);
+    vector<unique_ptr<G>> read;
+    check(!PairingBackend::readAll(reader, 3, PairingBackend::newG1, Backend::TYPE, read) && read.size() == 1,
+          name + " readAll stops at a point off the curve");
+    istringstream valueIn(encodeValue(G1<Backend>()) + offCurveBytes + encodeValue(G1<Backend>()));
+    BufferedReader valueReader(valueIn);
+    vector<G1<Backend>> values;
+    check(!readElements(valueReader, 3, values) && values.size() == 1 && values.front() == G1<Backend>(),
+          name + " readElements keeps only the valid elements before a point off the curve");
+}
+
+void checkKeyFiles(PairingBackend::Type backend) {
+    static const size_t KEY_SIZE = 20;
+    PairingBackend::setDefault(backend);
+    ThreadPool threadPool(4);
+    BilinearMapKey key, readKey;
+    BilinearMapAccumulator::genKey(vector<vector<reference_wrapper<Scalar>>>(), KEY_SIZE, key, threadPool);
+    string fileName = string("iotest.") + PairingBackend::getName(backend) + ".pk";
+    key.writePkToFile(fileName.c_str());
+    check(readKey.readPkFromFile(fileName.c_str()), string(PairingBackend::getName(backend)) + " public key file read");
+    remove(fileName.c_str());
+    BilinearMapKey::PublicKey& expected = key.getPublicKey();
+    BilinearMapKey::PublicKey& actual = readKey.getPublicKey();
+    bool equal = actual.first.size() == expected.first.size() && actual.second.size() == expected.second.size();
+    for(size_t i = 0; equal && i < expected.first.size(); i++) {
+        equal = actual.first.at(i)->isEqual(*expected.first.at(i)) && actual.second.at(i)->isEqual(*expected.second.at(i));
+    }
+    check(equal, string(PairingBackend::getName(backend)) + " public key file round trip");
+
+    //The same file read as the other backend's key, or cut short, is rejected
+    //and leaves the key as it was
+    key.writePkToFile(fileName.c_str());
+    PairingBackend::setDefault(backend == PairingBackend::MONT64 ? PairingBackend::DCLXVI : PairingBackend::MONT64);
+    bool otherBackendRejected = !readKey.readPkFromFile(fileName.c_str());
+    PairingBackend::setDefault(backend);
+    check(otherBackendRejected && readKey.getPublicKey().first.size() == expected.first.size(),
+          string(PairingBackend::getName(backend)) + " public key file of the other backend rejected");
+    string contents;
+    {
+        std::ifstream in(fileName, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    bool truncatedRejected = true;
+    for(size_t length : {contents.size() - 1, contents.size() / 2, sizeof(size_t) + 3, size_t(0)}) {
+        std::ofstream(fileName, std::ios::binary).write(contents.data(), length);
+        truncatedRejected = truncatedRejected && !readKey.readPkFromFile(fileName.c_str());
+    }
+    remove(fileName.c_str());
+    check(truncatedRejected && readKey.getPublicKey().first.size() == expected.first.size(),
+          string(PairingBackend::getName(backend)) + " truncated public key file rejected");
+
+    if(backend == PairingBackend::DCLXVI) {
+        //The original layout: a single count and no backend
+        BilinearMapKey legacyKey;
+        {
+            BufferedWriter out(fileName.c_str());
+            size_t pkSize = expected.first.size();
+            out.write(&pkSize, sizeof(pkSize));
+            PairingBackend::writeAll(out, expected.first);
+            PairingBackend::writeAll(out, expected.second);
+        }
+        bool legacyRead = legacyKey.readPkFromFile(fileName.c_str());
+        remove(fileName.c_str());
+        check(legacyRead && legacyKey.getPublicKey().second.size() == expected.second.size()
+                      && legacyKey.getPublicKey().second.back()->isEqual(*expected.second.back()),
+              "public key file in the original layout read as DCLXVI");
+    }
+
+    //A key whose halves have different lengths
+    BilinearMapKey verifierKey;
+    key.trimPublicKey(BilinearMapAccumulator::verifierKeySizes());
+    key.writePkToFile(fileName.c_str());
+    verifierKey.readPkFromFile(fileName.c_str());
+    remove(fileName.c_str());
+    BilinearMapKey::Sizes sizes = verifierKey.getPublicKeySizes();
+    BilinearMapKey::PublicKey& read = verifierKey.getPublicKey();
+    check(sizes.g1Powers == 1 && sizes.g2Powers == 0 && read.first.at(1)->isEqual(*expected.first.at(1))
+                  && read.second.at(0)->isEqual(*expected.second.at(0)),
+          string(PairingBackend::getName(backend)) + " verifier key file round trip");
+}
+
+}  // namespace iotest
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? atoi(argv[1]) : 50;
+    for(PairingBackend::Type backend : {PairingBackend::DCLXVI, PairingBackend::MONT64}) {
+        iotest::checkElements(backend);
+        iotest::checkWriteAll(backend, count);
+        iotest::checkKeyFiles(backend);
+    }
+    iotest::checkValueTypes<DCLXVIBackend>(count);
+    iotest::checkValueTypes<Mont64Backend>(count);
+    iotest::checkInvalidEncodings<DCLXVIBackend>();
+    iotest::checkInvalidEncodings<Mont64Backend>();
+    return testutils::checkResults();
+}
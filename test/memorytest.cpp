@@ -0,0 +1,110 @@
+/*
+ * memorytest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ * Checks that the memory estimates of the bilinear operations follow the
+ * sizes of the backend's elements and of the accumulators' group, and that
+ * a call nested in another, or running alongside it, is measured from its
+ * own start.
+ *
+ * Usage: memorytest
+ */
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <algorithms/BilinearMapAccumulator.hpp>
+
+#include <bilinear/G1_DCLXVI.hpp>
+#include <bilinear/G1_Mont64.hpp>
+#include <bilinear/G2_DCLXVI.hpp>
+#include <bilinear/G2_Mont64.hpp>
+#include <bilinear/PairingBackend.hpp>
+
+#include <utils/MemoryAccounting.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace memorytest {
+
+using testutils::check;
+
+void checkEstimates() {
+    const size_t n = 1000;
+    for(PairingBackend::Type backend : {PairingBackend::DCLXVI, PairingBackend::MONT64}) {
+        string name = PairingBackend::getName(backend);
+        MemoryAccounting::ElementSizes inG1 = BilinearMapAccumulator::elementSizes(backend, false);
+        MemoryAccounting::ElementSizes inG2 = BilinearMapAccumulator::elementSizes(backend, true);
+        bool mont64 = backend == PairingBackend::MONT64;
+        check(inG1.g1Element == (mont64 ? sizeof(G1Mont64) : sizeof(G1DCLXVI))
+                      && inG1.g2Element == (mont64 ? sizeof(G2Mont64) : sizeof(G2DCLXVI)),
+              name + " element sizes");
+        check(inG2.accumulatorPoint > inG1.accumulatorPoint, name + " G2 accumulators have larger points");
+        for(Metrics::Timer op : {Metrics::BILINEAR_ACCUMULATE_PUBLIC, Metrics::BILINEAR_WITNESSES_PUBLIC}) {
+            size_t g1Estimate = MemoryAccounting::estimateMemory(op, n, inG1, 4);
+            size_t g2Estimate = MemoryAccounting::estimateMemory(op, n, inG2, 4);
+            check(g1Estimate >= n * inG1.accumulatorPoint && g2Estimate >= n * inG2.accumulatorPoint
+                          && g2Estimate > g1Estimate,
+                  name + " " + Metrics::timerName(op) + " estimate follows the accumulators' group");
+        }
+        check(MemoryAccounting::estimateMemory(Metrics::BILINEAR_GEN_KEY, n, inG1)
+                      >= (n + 1) * (inG1.g1Element + inG1.g2Element),
+              name + " key estimate");
+    }
+    check(MemoryAccounting::estimateMemory(Metrics::RSA_VERIFY, 1, BilinearMapAccumulator::elementSizes(
+                                                                          PairingBackend::DCLXVI))
+                  == MemoryAccounting::estimateMemory(Metrics::RSA_VERIFY, 1),
+          "RSA estimates ignore element sizes");
+    bool threw = false;
+    try {
+        MemoryAccounting::estimateMemory(Metrics::BILINEAR_ACCUMULATE_PUBLIC, n);
+    } catch(const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "bilinear estimate without element sizes rejected");
+}
+
+void checkScopes() {
+    MemoryAccounting::resetOperationStats();
+    {
+        MemoryAccounting::Scope outer(Metrics::RSA_ACCUMULATE_PIPELINED);
+        MemoryAccounting::recordAllocation(1000);
+        MemoryAccounting::recordFree(1000);
+        {
+            MemoryAccounting::Scope inner(Metrics::RSA_ACCUMULATE_PUBLIC);
+            MemoryAccounting::recordAllocation(10);
+            MemoryAccounting::recordFree(10);
+        }
+    }
+    check(MemoryAccounting::getOperationStats(Metrics::RSA_ACCUMULATE_PUBLIC).lastPeakBytes == 10,
+          "nested call measured from its own start");
+    check(MemoryAccounting::getOperationStats(Metrics::RSA_ACCUMULATE_PIPELINED).lastPeakBytes == 1000,
+          "outer call keeps its own peak");
+
+    //A call that starts on another thread after this one's peak doesn't inherit it
+    {
+        MemoryAccounting::Scope first(Metrics::RSA_VERIFY);
+        MemoryAccounting::recordAllocation(500);
+        MemoryAccounting::recordFree(500);
+        thread([]() {
+            MemoryAccounting::Scope second(Metrics::RSA_UPDATE);
+            MemoryAccounting::recordAllocation(20);
+            MemoryAccounting::recordFree(20);
+        }).join();
+    }
+    check(MemoryAccounting::getOperationStats(Metrics::RSA_UPDATE).lastPeakBytes == 20
+                  && MemoryAccounting::getOperationStats(Metrics::RSA_VERIFY).lastPeakBytes == 500,
+          "concurrent calls measured from their own starts");
+}
+
+}  // namespace memorytest
+
+int main(int argc, char** argv) {
+    memorytest::checkEstimates();
+    memorytest::checkScopes();
+    return testutils::checkResults();
+}
@@ -0,0 +1,163 @@
+/*
+ * merkletest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ * Checks MerkleTree against a tree built with one serial SHA-256 digest per
+ * node, for sizes that aren't powers of two, with every batch SHA-256 kernel
+ * the CPU supports. Both updateHash and the batched updateHashes must leave
+ * the same root as rebuilding the tree from the updated leaves, and every
+ * leaf's path must still check out afterwards.
+ *
+ * Usage: merkletest [seed]
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <utils/MerkleTree.hpp>
+#include <utils/SHA256.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace merkletest {
+
+using testutils::check;
+
+typedef vector<unsigned char> Digest;
+
+Digest randomDigest(mt19937& rng) {
+    Digest digest(SHA256::DIGEST_LENGTH);
+    for(unsigned char& byte : digest) {
+        byte = (unsigned char)rng();
+    }
+    return digest;
+}
+
+/** The root of the tree over leaves, padded to a power of two with zero digests, hashed one node at a time */
+Digest referenceRoot(vector<Digest> level) {
+    size_t width = 1;
+    while(width < level.size()) {
+        width *= 2;
+    }
+    level.resize(width, Digest(SHA256::DIGEST_LENGTH, 0));
+    char children[2 * SHA256::DIGEST_LENGTH];
+    while(level.size() > 1) {
+        vector<Digest> parents(level.size() / 2);
+        for(size_t i = 0; i < parents.size(); i++) {
+            memcpy(children, level[2 * i].data(), SHA256::DIGEST_LENGTH);
+            memcpy(children + SHA256::DIGEST_LENGTH, level[2 * i + 1].data(), SHA256::DIGEST_LENGTH);
+            SHA256::computeDigest(children, 2 * SHA256::DIGEST_LENGTH, parents[i]);
+        }
+        level.swap(parents);
+    }
+    return level[0];
+}
+
+/** Checks tree's root against the reference and a rebuild, and every leaf's path */
+void checkTree(const MerkleTree& tree, const vector<Digest>& leaves, const string& what) {
+    MerkleTree rebuilt;
+    rebuilt.constructTree(leaves);
+    check(tree.getRootHash() == referenceRoot(leaves), what + ": root matches serial digests");
+    check(tree.getRootHash() == rebuilt.getRootHash(), what + ": root matches a full rebuild");
+    //A single leaf is its own root and has no path
+    if(leaves.size() < 2) {
+        return;
+    }
+    bool pathsVerify = true;
+    bool pathsMatch = true;
+    vector<HashNode> path, rebuiltPath;
+    for(size_t i = 0; i < leaves.size(); i++) {
+        tree.getHashes(i, path);
+        rebuilt.getHashes(i, rebuiltPath);
+        pathsVerify &= tree.checkHashes(path) && path[0]._hash == leaves[i];
+        for(size_t node = 0; node < path.size(); node++) {
+            pathsMatch &= path[node]._offset == rebuiltPath[node]._offset && path[node]._hash == rebuiltPath[node]._hash;
+        }
+    }
+    check(pathsVerify, what + ": every leaf's path verifies");
+    check(pathsMatch, what + ": every leaf's path matches a full rebuild");
+    tree.getHashes(leaves.size() - 1, path);
+    path[0]._hash[0] ^= 1;
+    check(!tree.checkHashes(path), what + ": tampered path rejected");
+}
+
+void checkSize(size_t size, mt19937& rng, const string& kernelName) {
+    string what = kernelName + " size " + to_string(size);
+    vector<Digest> leaves;
+    for(size_t i = 0; i < size; i++) {
+        leaves.push_back(randomDigest(rng));
+    }
+    MerkleTree tree;
+    tree.constructTree(leaves);
+    int expectedHeight = 0;
+    while((size_t(1) << expectedHeight) < size) {
+        expectedHeight++;
+    }
+    check(tree.getHeight() == expectedHeight, what + ": height");
+    checkTree(tree, leaves, what + " constructed");
+
+    //Single updates: the first and last leaves, then a few in between
+    vector<int> offsets = {0, int(size - 1)};
+    for(int i = 0; i < 3; i++) {
+        offsets.push_back(rng() % size);
+    }
+    for(int offset : offsets) {
+        leaves[offset] = randomDigest(rng);
+        tree.updateHash(offset, leaves[offset]);
+    }
+    checkTree(tree, leaves, what + " after updateHash");
+
+    //Batched updates: siblings, repeats (the last digest wins), and an arbitrary spread
+    offsets.clear();
+    vector<Digest> digests;
+    for(size_t i = 0; i < size; i += 1 + rng() % 4) {
+        offsets.push_back(i);
+        if(i + 1 < size && rng() % 2) {
+            offsets.push_back(i + 1);
+        }
+    }
+    offsets.push_back(offsets.front());
+    for(int offset : offsets) {
+        digests.push_back(randomDigest(rng));
+        leaves[offset] = digests.back();
+    }
+    tree.updateHashes(offsets, digests);
+    checkTree(tree, leaves, what + " after updateHashes");
+
+    //Every leaf at once
+    offsets.clear();
+    digests.clear();
+    for(size_t i = 0; i < size; i++) {
+        offsets.push_back(i);
+        digests.push_back(randomDigest(rng));
+        leaves[i] = digests.back();
+    }
+    tree.updateHashes(offsets, digests);
+    checkTree(tree, leaves, what + " after updating every leaf");
+}
+
+}  // namespace merkletest
+
+int main(int argc, char** argv) {
+    unsigned long seed = argc > 1 ? strtoul(argv[1], NULL, 10) : 1;
+    mt19937 rng(seed);
+    const size_t sizes[] = {1, 2, 3, 5, 8, 17, 37, 100, 129};
+    SHA256::BatchKernel preferred = SHA256::getBatchKernel();
+    for(int kernel = 0; kernel < SHA256::NUM_BATCH_KERNELS; kernel++) {
+        SHA256::BatchKernel batchKernel = SHA256::BatchKernel(kernel);
+        if(!SHA256::isSupported(batchKernel)) {
+            continue;
+        }
+        SHA256::setBatchKernel(batchKernel);
+        for(size_t size : sizes) {
+            merkletest::checkSize(size, rng, SHA256::getBatchKernelName(batchKernel));
+        }
+    }
+    SHA256::setBatchKernel(preferred);
+    return testutils::checkResults();
+}
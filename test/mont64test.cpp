@@ -0,0 +1,311 @@
+/*
+ * mont64test.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Cross-checks the Mont64 pairing backend against DCLXVI. Both implement the
+ * same curve with the same generators, so every power, product and pairing
+ * must come out as the same group element, which is checked by converting the
+ * DCLXVI result into the Mont64 representation, and GT's compressed encoding
+ * must be the same bytes on both. Then runs the bilinear-map
+ * accumulator end to end on each backend, through both the G/Scalar API and
+ * the typed value API.
+ *
+ * Usage: mont64test [iterations]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include <bilinear/Backends.hpp>
+#include <bilinear/G1_DCLXVI.hpp>
+#include <bilinear/G1_Mont64.hpp>
+#include <bilinear/G2_DCLXVI.hpp>
+#include <bilinear/G2_Mont64.hpp>
+#include <bilinear/GT_DCLXVI.hpp>
+#include <bilinear/GT_Mont64.hpp>
+#include <bilinear/GroupElement.hpp>
+#include <bilinear/Mont64Curve.hpp>
+#include <bilinear/PairingBackend.hpp>
+#include <bilinear/Scalar_DCLXVI.hpp>
+
+#include <algorithms/BilinearMapAccumulator.hpp>
+#include <algorithms/BilinearMapKey.hpp>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+
+#include <utils/LibConversions.hpp>
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace mont64test {
+
+void check(bool condition, const char* what, int iteration) {
+    testutils::check(condition, string(what) + " (iteration " + to_string(iteration) + ")");
+}
+
+void crossCheck(int iteration) {
+    ScalarDCLXVI a, b, c;
+    a.generateRandom();
+    b.generateRandom();
+    c.generateRandom();
+
+    //Powers of the generators
+    G1DCLXVI g1Dclxvi, p1Dclxvi;
+    G1Mont64 g1Mont, p1Mont;
+    g1Dclxvi.doPower(a, p1Dclxvi);
+    g1Mont.doPower(a, p1Mont);
+    G1Mont64 p1Converted(p1Dclxvi);
+    check(p1Mont.isEqual(p1Converted), "G1 power", iteration);
+
+    G2DCLXVI g2Dclxvi, p2Dclxvi;
+    G2Mont64 g2Mont, p2Mont;
+    g2Dclxvi.doPower(b, p2Dclxvi);
+    g2Mont.doPower(b, p2Mont);
+    G2Mont64 p2Converted(p2Dclxvi);
+    check(p2Mont.isEqual(p2Converted), "G2 power", iteration);
+
+    //Products, including a point with itself and with the identity
+    G1DCLXVI q1Dclxvi;
+    G1Mont64 q1Mont;
+    p1Dclxvi.doMultiplication(g1Dclxvi, q1Dclxvi);
+    p1Mont.doMultiplication(g1Mont, q1Mont);
+    check(q1Mont.isEqual(G1Mont64(q1Dclxvi)), "G1 product", iteration);
+    p1Mont.doMultiplication(p1Mont, q1Mont);
+    p1Dclxvi.doMultiplication(p1Dclxvi, q1Dclxvi);
+    check(q1Mont.isEqual(G1Mont64(q1Dclxvi)), "G1 square", iteration);
+    G1Mont64 identity;
+    identity.becomeIdentity();
+    identity.doMultiplication(p1Mont, q1Mont);
+    check(q1Mont.isEqual(p1Mont), "G1 identity", iteration);
+
+    G2DCLXVI q2Dclxvi;
+    G2Mont64 q2Mont;
+    p2Dclxvi.doMultiplication(g2Dclxvi, q2Dclxvi);
+    p2Mont.doMultiplication(g2Mont, q2Mont);
+    check(q2Mont.isEqual(G2Mont64(q2Dclxvi)), "G2 product", iteration);
+    p2Mont.doMultiplication(p2Mont, q2Mont);
+    p2Dclxvi.doMultiplication(p2Dclxvi, q2Dclxvi);
+    check(q2Mont.isEqual(G2Mont64(q2Dclxvi)), "G2 square", iteration);
+
+    //Pairings and powers in GT
+    GTDCLXVI eDclxvi, ePowDclxvi;
+    GTMont64 eMont, ePowMont;
+    PairingBackend::pairing(eDclxvi, p1Dclxvi, p2Dclxvi);
+    PairingBackend::pairing(eMont, p1Mont, p2Mont);
+    check(eMont.isEqual(GTMont64(eDclxvi)), "pairing", iteration);
+    eDclxvi.doPower(c, ePowDclxvi);
+    eMont.doPower(c, ePowMont);
+    check(ePowMont.isEqual(GTMont64(ePowDclxvi)), "GT power", iteration);
+
+    //Bilinearity: e(g1^a, g2^b) = e(g1, g2)^(ab)
+    flint::BigInt order;
+    LibConversions::getModulus(order);
+    flint::BigMod aMod(order), bMod(order);
+    a.exportFlintObject(aMod);
+    b.exportFlintObject(bMod);
+    ScalarDCLXVI ab;
+    ab.importFlintObject(aMod * bMod);
+    GTMont64 eGenerators, eExpected;
+    PairingBackend::pairing(eGenerators, g1Mont, g2Mont);
+    eGenerators.doPower(ab, eExpected);
+    PairingBackend::pairing(eMont, p1Mont, p2Mont);
+    check(eMont.isEqual(eExpected), "bilinearity", iteration);
+
+    //Serialization
+    G1Mont64 p1Copy;
+    p1Copy.importObject(p1Mont.getUnderlyingObj());
+    check(p1Copy.isEqual(p1Mont), "G1 import/export", iteration);
+}
+
+//Squaring, in-place products and the compressed encoding of GT, which must be
+//byte for byte the same on both backends
+void gtCheck(int iteration) {
+    ScalarDCLXVI a, b;
+    a.generateRandom();
+    b.generateRandom();
+    G1DCLXVI g1Dclxvi, p1Dclxvi;
+    G2DCLXVI g2Dclxvi, p2Dclxvi;
+    g1Dclxvi.doPower(a, p1Dclxvi);
+    g2Dclxvi.doPower(b, p2Dclxvi);
+    GTDCLXVI eDclxvi, fDclxvi, squareDclxvi, productDclxvi;
+    PairingBackend::pairing(eDclxvi, p1Dclxvi, p2Dclxvi);
+    PairingBackend::pairing(fDclxvi, g1Dclxvi, p2Dclxvi);
+    GTMont64 eMont(eDclxvi), fMont(fDclxvi), squareMont, productMont;
+
+    eDclxvi.doSquare(squareDclxvi);
+    eDclxvi.doMultiplication(eDclxvi, productDclxvi);
+    check(squareDclxvi.isEqual(productDclxvi), "DCLXVI GT square", iteration);
+    eMont.doSquare(squareMont);
+    eMont.doMultiplication(eMont, productMont);
+    check(squareMont.isEqual(productMont), "Mont64 GT square", iteration);
+    check(squareMont.isEqual(GTMont64(squareDclxvi)), "GT square", iteration);
+
+    eDclxvi.doMultiplication(fDclxvi, productDclxvi);
+    eMont.doMultiplication(fMont, productMont);
+    eDclxvi.multiplyBy(fDclxvi);
+    eMont.multiplyBy(fMont);
+    check(eDclxvi.isEqual(productDclxvi), "DCLXVI GT in-place product", iteration);
+    check(eMont.isEqual(productMont), "Mont64 GT in-place product", iteration);
+
+    stringstream dclxviStream, montStream;
+    eDclxvi.writeCompressedToFile(dclxviStream);
+    eMont.writeCompressedToFile(montStream);
+    check(dclxviStream.str().size() == GT::COMPRESSED_SIZE, "GT compressed size", iteration);
+    check(dclxviStream.str() == montStream.str(), "GT compressed encoding", iteration);
+    GTDCLXVI readDclxvi;
+    GTMont64 readMont;
+    check(readDclxvi.readCompressedFromFile(montStream), "GT decompression", iteration);
+    check(readMont.readCompressedFromFile(dclxviStream), "GT decompression", iteration);
+    check(readDclxvi.isEqual(eDclxvi), "DCLXVI GT compression round trip", iteration);
+    check(readMont.isEqual(eMont), "Mont64 GT compression round trip", iteration);
+
+    //1 has no torus coordinate and is flagged instead; so is -1, which isn't in GT
+    unsigned char bytes[GT::COMPRESSED_SIZE];
+    GTElement<Mont64Backend> one, decoded;
+    one.compress(bytes);
+    check(bytes[0] == 1 && decoded.decompress(bytes) && decoded == one, "GT compression of 1", iteration);
+    GTElement<Mont64Backend> minusOne;
+    Mont64::fp_neg(minusOne.getElement().c0.c0.c0, one.getElement().c0.c0.c0);
+    minusOne.compress(bytes);
+    check(bytes[0] == 2 && !decoded.decompress(bytes) && decoded == one, "GT compression of -1 rejected", iteration);
+
+    GTElement<DCLXVIBackend> typed(eDclxvi);
+    check(typed.square() == typed * typed, "typed GT square", iteration);
+
+    //Malformed encodings are rejected
+    typed.compress(bytes);
+    bytes[0] = 3;
+    check(!typed.decompress(bytes), "GT compression flag", iteration);
+    bytes[0] = 0;
+    fill(bytes + 1, bytes + 1 + Mont64::FP_BYTES, 0xff);
+    check(!typed.decompress(bytes), "GT compression coefficient range", iteration);
+    //Any torus coordinate gives an element of the cyclotomic subgroup, but almost none of them are in GT
+    typed.compress(bytes);
+    bytes[GT::COMPRESSED_SIZE - 1] ^= 1;
+    check(!typed.decompress(bytes), "GT compression outside GT", iteration);
+    check(typed == GTElement<DCLXVIBackend>(eDclxvi), "GT failed decompression", iteration);
+}
+
+//With accumulatorInG2 the accumulators are in G2 and the witnesses in G1
+void accumulatorCheck(PairingBackend::Type backend, bool accumulatorInG2) {
+    static const size_t SET_SIZE = 20;
+    auto newAccumulator = accumulatorInG2 ? PairingBackend::newG2 : PairingBackend::newG1;
+    auto newWitness = accumulatorInG2 ? PairingBackend::newG1 : PairingBackend::newG2;
+    PairingBackend::setDefault(backend);
+    ThreadPool threadPool(4);
+
+    vector<unique_ptr<Scalar>> elements;
+    vector<reference_wrapper<Scalar>> set;
+    for(size_t i = 0; i < SET_SIZE; i++) {
+        elements.push_back(make_unique<ScalarDCLXVI>());
+        elements.back()->generateRandom();
+        set.push_back(*elements.back());
+    }
+    BilinearMapKey key;
+    BilinearMapAccumulator::genKey(vector<vector<reference_wrapper<Scalar>>>(), SET_SIZE, key, threadPool);
+
+    unique_ptr<G> privateAcc = newAccumulator(backend);
+    BilinearMapAccumulator::accumulateSet(set, key.getSecretKey(), *privateAcc);
+    unique_ptr<G> publicAcc = newAccumulator(backend);
+    BilinearMapAccumulator::accumulateSet(set, key.getPublicKey(), *publicAcc, threadPool);
+    check(privateAcc->isEqual(*publicAcc), PairingBackend::getName(backend), 0);
+
+    unique_ptr<G> witnessBase = newWitness(backend);
+    vector<unique_ptr<G>> witnesses, publicWitnesses;
+    for(size_t i = 0; i < SET_SIZE; i++) {
+        witnesses.push_back(newWitness(backend));
+        publicWitnesses.push_back(newWitness(backend));
+    }
+    BilinearMapAccumulator::witnessesForSet(set, key.getSecretKey(), *witnessBase, witnesses, threadPool);
+    BilinearMapAccumulator::witnessesForSet(set, key.getPublicKey(), publicWitnesses, threadPool);
+    for(size_t i = 0; i < SET_SIZE; i++) {
+        check(BilinearMapAccumulator::verify(set.at(i), *witnesses.at(i), *privateAcc, key.getPublicKey())
+                      && witnesses.at(i)->isEqual(*publicWitnesses.at(i)),
+              "witness verification", i);
+    }
+    ScalarDCLXVI nonMember;
+    nonMember.generateRandom();
+    check(!BilinearMapAccumulator::verify(nonMember, *witnesses.at(0), *privateAcc, key.getPublicKey()),
+          "non-member rejection", 0);
+}
+
+template <typename Backend, typename Placement>
+void typedAccumulatorCheck() {
+    typedef typename Placement::Accumulator Accumulator;
+    typedef typename Placement::Witness Witness;
+    static const size_t SET_SIZE = 20;
+    ThreadPool threadPool(4);
+
+    vector<Fr<Backend>> set(SET_SIZE);
+    for(Fr<Backend>& element : set) {
+        element.generateRandom();
+    }
+    Fr<Backend> secretKey;
+    BilinearMapAccumulator::PublicKeyValues<Backend> publicKey;
+    BilinearMapAccumulator::genKey(SET_SIZE, secretKey, publicKey, threadPool);
+
+    Accumulator privateAcc = BilinearMapAccumulator::accumulateSet(set, secretKey, Accumulator());
+    Accumulator publicAcc = BilinearMapAccumulator::accumulateSet<Backend, Placement>(set, publicKey, threadPool);
+    check(privateAcc == publicAcc, "typed accumulation", 0);
+
+    vector<Witness> witnesses = BilinearMapAccumulator::witnessesForSet(set, secretKey, Witness(), threadPool);
+    vector<Witness> publicWitnesses = BilinearMapAccumulator::witnessesForSet<Backend, Placement>(set, publicKey,
+                                                                                               threadPool);
+    for(size_t i = 0; i < SET_SIZE; i++) {
+        check(BilinearMapAccumulator::verify(set.at(i), witnesses.at(i), privateAcc, publicKey)
+                      && witnesses.at(i) == publicWitnesses.at(i),
+              "typed witness verification", i);
+    }
+    Fr<Backend> nonMember;
+    nonMember.generateRandom();
+    check(!BilinearMapAccumulator::verify(nonMember, witnesses.at(0), privateAcc, publicKey),
+          "typed non-member rejection", 0);
+
+    //Keys trimmed to a profile still do that profile's job
+    BilinearMapAccumulator::PublicKeyValues<Backend> proverKey = publicKey, verifierKey = publicKey;
+    BilinearMapAccumulator::trimKey(proverKey,
+                                    BilinearMapAccumulator::proverKeySizes(SET_SIZE, Placement::ACCUMULATOR_IN_G2));
+    BilinearMapAccumulator::trimKey(verifierKey, BilinearMapAccumulator::verifierKeySizes(Placement::ACCUMULATOR_IN_G2));
+    check(Placement::accumulatorPowers(proverKey).size() == SET_SIZE + 1
+                  && Placement::witnessPowers(proverKey).size() == SET_SIZE
+                  && Placement::accumulatorPowers(verifierKey).size() == 2
+                  && Placement::witnessPowers(verifierKey).size() == 1,
+          "trimmed key sizes", 0);
+    check(BilinearMapAccumulator::accumulateSet<Backend, Placement>(set, proverKey, threadPool) == privateAcc
+                  && BilinearMapAccumulator::witnessesForSet<Backend, Placement>(set, proverKey, threadPool)
+                             == witnesses,
+          "prover key", 0);
+    for(size_t i = 0; i < SET_SIZE; i++) {
+        check(BilinearMapAccumulator::verify(set.at(i), witnesses.at(i), privateAcc, verifierKey), "verifier key", i);
+    }
+}
+
+}  // namespace mont64test
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    for(int i = 0; i < iterations; i++) {
+        mont64test::crossCheck(i);
+        mont64test::gtCheck(i);
+    }
+    cout << "Cross-checked " << iterations << " random inputs against DCLXVI" << endl;
+    for(bool accumulatorInG2 : {false, true}) {
+        mont64test::accumulatorCheck(PairingBackend::DCLXVI, accumulatorInG2);
+        mont64test::accumulatorCheck(PairingBackend::MONT64, accumulatorInG2);
+    }
+    mont64test::typedAccumulatorCheck<DCLXVIBackend, BilinearMapAccumulator::AccumulatorInG1<DCLXVIBackend>>();
+    mont64test::typedAccumulatorCheck<Mont64Backend, BilinearMapAccumulator::AccumulatorInG1<Mont64Backend>>();
+    mont64test::typedAccumulatorCheck<DCLXVIBackend, BilinearMapAccumulator::AccumulatorInG2<DCLXVIBackend>>();
+    mont64test::typedAccumulatorCheck<Mont64Backend, BilinearMapAccumulator::AccumulatorInG2<Mont64Backend>>();
+    cout << "Accumulated and verified on both backends, with accumulators in G1 and in G2" << endl;
+    return testutils::checkResults();
+}
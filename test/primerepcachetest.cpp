@@ -0,0 +1,237 @@
+/*
+ * primerepcachetest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Checks that a PrimeRepCache gives the same representatives as the
+ * generator it wraps, from memory and from a saved table file, that hints
+ * recover representatives and bad hints are rejected, and that RSA
+ * verification works with a cached key and with hints. Tampered table
+ * entries must be ignored, and a file mapped while other threads look
+ * elements up must give them either nothing or the right representative.
+ *
+ * Usage: primerepcachetest [count]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <algorithms/OraclePrimeRep.hpp>
+#include <algorithms/PrimeRepCache.hpp>
+#include <algorithms/RSAAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace primerepcachetest {
+
+using testutils::check;
+
+//Rewrites every non-empty slot of a table file with change(hint, length, representative)
+void tamper(const char* fileName, const function<void(unsigned char*, unsigned char*, unsigned char*)>& change) {
+    string contents;
+    {
+        ifstream in(fileName, ios::binary);
+        contents.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    }
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(&contents[0]);
+    for(size_t offset = PrimeRepCache::FILE_HEADER_SIZE; offset < contents.size();
+        offset += PrimeRepCache::FILE_SLOT_SIZE) {
+        unsigned char* slot = bytes + offset + PrimeRepCache::KEY_BYTES;
+        if(slot[4] | slot[5] | slot[6] | slot[7])
+            change(slot, slot + 4, slot + 8);
+    }
+    ofstream(fileName, ios::binary | ios::trunc).write(contents.data(), contents.size());
+}
+
+//Every element is missing from a cache that maps the file, and is generated again correctly
+bool tamperedEntriesIgnored(const char* fileName, const vector<flint::BigInt>& elements,
+                            const vector<flint::BigInt>& expected) {
+    PrimeRepCache cache(std::make_unique<OraclePrimeRep>());
+    if(!cache.open(fileName))
+        return false;
+    bool ignored = true;
+    for(size_t i = 0; i < elements.size(); i++) {
+        flint::BigInt representative;
+        ignored &= !cache.lookup(elements.at(i), representative);
+        cache.genRepresentative(elements.at(i), representative);
+        ignored &= representative == expected.at(i);
+    }
+    return ignored;
+}
+
+void checkCache(const vector<flint::BigInt>& elements, ThreadPool& threadPool) {
+    OraclePrimeRep oracle;
+    vector<flint::BigInt> expected(elements.size());
+    vector<uint32_t> hints;
+    RSAAccumulator::genRepresentatives(elements, oracle, expected, hints, threadPool);
+
+    PrimeRepCache cache(std::make_unique<OraclePrimeRep>());
+    vector<flint::BigInt> reps(elements.size());
+    RSAAccumulator::genRepresentatives(elements, cache, reps, threadPool);
+    check(reps == expected, "cached representatives match the generator's");
+    check(cache.size() == elements.size(), "every representative cached");
+    bool hits = true;
+    for(size_t i = 0; i < elements.size(); i++) {
+        flint::BigInt cached;
+        uint32_t hint;
+        hits &= cache.lookup(elements.at(i), cached, &hint) && cached == expected.at(i) && hint == hints.at(i);
+    }
+    check(hits, "lookups find the representatives and hints");
+    flint::BigInt missing;
+    check(!cache.lookup(flint::BigInt(-1), missing), "lookup of an element never cached");
+
+    bool recovered = true, rejected = true;
+    for(size_t i = 0; i < elements.size(); i++) {
+        flint::BigInt fromHint;
+        recovered &= hints.at(i) != PrimeRepGenerator::NO_HINT
+                     && oracle.representativeFromHint(elements.at(i), hints.at(i), fromHint)
+                     && fromHint == expected.at(i);
+        //Hints that lead to an even number, or past the padding, are refused
+        rejected &= !oracle.representativeFromHint(elements.at(i), hints.at(i) + 1, fromHint);
+        rejected &= !oracle.representativeFromHint(elements.at(i), 1 << 12, fromHint);
+    }
+    check(recovered, "hints recover the representatives");
+    check(rejected, "bad hints rejected");
+
+    const char* fileName = "primerepcachetest.table";
+    check(cache.save(fileName), "table saved");
+    PrimeRepCache loaded(std::make_unique<OraclePrimeRep>());
+    check(loaded.open(fileName), "table opened");
+    bool fromFile = true;
+    for(size_t i = 0; i < elements.size(); i++) {
+        flint::BigInt cached;
+        uint32_t hint;
+        fromFile &= loaded.lookup(elements.at(i), cached, &hint) && cached == expected.at(i) && hint == hints.at(i);
+    }
+    check(fromFile, "lookups read the mapped table");
+    check(loaded.size() == elements.size(), "checked entries copied to memory");
+    check(!loaded.open(fileName), "second table rejected");
+    //Saving again merges the mapped table with new entries
+    PrimeRepCache fresh(std::make_unique<OraclePrimeRep>());
+    check(fresh.open(fileName), "table opened by a fresh cache");
+    flint::BigInt extra;
+    fresh.genRepresentative(flint::BigInt(12345), extra);
+    PrimeRepCache merged(std::make_unique<OraclePrimeRep>());
+    check(fresh.save(fileName) && merged.open(fileName), "merged table saved and reopened");
+    flint::BigInt cached;
+    check(merged.lookup(elements.front(), cached) && merged.lookup(flint::BigInt(12345), cached) && cached == extra,
+          "merged table has both");
+
+    //Lookups racing with open see the whole table or nothing
+    check(cache.save(fileName), "table saved again");
+    PrimeRepCache shared(std::make_unique<OraclePrimeRep>());
+    vector<char> consistent(4, true);
+    vector<thread> readers;
+    for(size_t t = 0; t < consistent.size(); t++) {
+        readers.emplace_back([&, t]() {
+            for(size_t round = 0; round < 20; round++) {
+                for(size_t i = 0; i < elements.size(); i++) {
+                    flint::BigInt representative;
+                    if(shared.lookup(elements.at(i), representative) && representative != expected.at(i))
+                        consistent[t] = false;
+                }
+            }
+        });
+    }
+    bool opened = shared.open(fileName);
+    for(thread& reader : readers) {
+        reader.join();
+    }
+    check(opened && consistent == vector<char>(consistent.size(), true), "lookups during open");
+
+    //An entry must be what the generator recovers from its hint: a different
+    //representative, one that isn't prime, or one without a hint is ignored
+    tamper(fileName, [](unsigned char* hint, unsigned char* length, unsigned char* representative) {
+        representative[length[0] - 1] ^= 2;
+    });
+    check(tamperedEntriesIgnored(fileName, elements, expected), "tampered representatives ignored");
+    check(cache.save(fileName), "table saved again");
+    tamper(fileName, [](unsigned char* hint, unsigned char* length, unsigned char* representative) {
+        //Moves both the hint and the representative one past the prime, to an even number
+        for(unsigned carry = 1, i = 0; carry && i < 4; i++, carry >>= 8) {
+            carry += hint[i];
+            hint[i] = carry;
+        }
+        for(unsigned carry = 1, i = length[0]; carry && i-- > 0; carry >>= 8) {
+            carry += representative[i];
+            representative[i] = carry;
+        }
+    });
+    check(tamperedEntriesIgnored(fileName, elements, expected), "composite representatives ignored");
+    check(cache.save(fileName), "table saved again");
+    tamper(fileName, [](unsigned char* hint, unsigned char* length, unsigned char* representative) {
+        hint[0] = hint[1] = hint[2] = hint[3] = 0xFF;
+    });
+    check(tamperedEntriesIgnored(fileName, elements, expected), "entries without a hint ignored");
+
+    {
+        ofstream corrupt(fileName, ios::binary | ios::trunc);
+        corrupt << "PREP but not a table";
+    }
+    PrimeRepCache corrupted(std::make_unique<OraclePrimeRep>());
+    check(!corrupted.open(fileName) && !corrupted.lookup(elements.front(), cached), "corrupt table rejected");
+    check(!corrupted.open("/nonexistent/primerepcachetest.table"), "missing table rejected");
+    remove(fileName);
+}
+
+void checkVerify(const vector<flint::BigInt>& elements, ThreadPool& threadPool) {
+    RSAKey key;
+    RSAAccumulator::genKey(0, 1024, key);
+    PrimeRepCache& cache = PrimeRepCache::attach(key.getPublicKey());
+    check(&PrimeRepCache::attach(key.getPublicKey()) == &cache, "attaching twice keeps one cache");
+    const RSAKey::PublicKey& publicKey = key.getPublicKey();
+    vector<flint::BigInt> reps(elements.size());
+    vector<uint32_t> hints;
+    RSAAccumulator::genRepresentatives(elements, *publicKey.primeRepGenerator, reps, hints, threadPool);
+    flint::BigMod accumulator;
+    RSAAccumulator::accumulateSet(reps, key, accumulator, threadPool);
+    vector<flint::BigMod> witnesses(elements.size(), flint::BigMod(publicKey.rsaModulus));
+    RSAAccumulator::witnessesForSet(reps, key, witnesses, threadPool);
+
+    //A verifier without the cache, using the hints
+    RSAKey verifierKey;
+    verifierKey.getPublicKey().rsaModulus = publicKey.rsaModulus;
+    verifierKey.getPublicKey().base = publicKey.base;
+    verifierKey.getPublicKey().primeRepGenerator = std::make_unique<OraclePrimeRep>();
+    bool cachedValid = true, hintValid = true, wrongHintValid = true;
+    for(size_t i = 0; i < elements.size(); i++) {
+        cachedValid &= RSAAccumulator::verify(elements.at(i), witnesses.at(i), accumulator, publicKey);
+        hintValid &= RSAAccumulator::verify(elements.at(i), hints.at(i), witnesses.at(i), accumulator,
+                                            verifierKey.getPublicKey());
+        //The representative is the first prime after the padded hash, so this hint leads to a composite
+        wrongHintValid &= RSAAccumulator::verify(elements.at(i), hints.at(i) - 2, witnesses.at(i), accumulator,
+                                                 verifierKey.getPublicKey());
+    }
+    check(cachedValid, "RSA verify with a cached key");
+    check(hintValid, "RSA verify with hints");
+    check(wrongHintValid, "RSA verify falls back when a hint is wrong");
+}
+
+}  // namespace primerepcachetest
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? atoi(argv[1]) : 50;
+    vector<flint::BigInt> elements;
+    for(size_t i = 0; i < count; i++) {
+        elements.push_back(flint::BigInt(rand()) + flint::BigInt(i << 32));
+    }
+    ThreadPool threadPool(4);
+    primerepcachetest::checkCache(elements, threadPool);
+    primerepcachetest::checkVerify(elements, threadPool);
+    return testutils::checkResults();
+}
@@ -0,0 +1,165 @@
+/*
+ * primetabletest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Checks that TablePrimeRep gives each element of its domain the first
+ * prime after the element's start, that a saved table loads back with the
+ * same representatives, that a loaded entry which isn't a prime is refused
+ * when it is used, and that RSA witnesses verify with it.
+ *
+ * Usage: primetabletest [size]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <algorithms/RSAAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+#include <algorithms/TablePrimeRep.hpp>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+#include <flint/fmpz.h>
+
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace primetabletest {
+
+using testutils::check;
+
+void checkTable(uint64_t size, ThreadPool& threadPool) {
+    TablePrimeRep table(size, threadPool);
+    check(table.getSize() == size && (1ULL << table.getDomainBits()) >= size
+          && (1ULL << table.getDomainBits()) < 2 * size, "domain size");
+    bool nextPrimes = true, increasing = true;
+    for(uint64_t element = 0; element < size; element++) {
+        flint::BigInt representative;
+        table.genRepresentative(flint::BigInt((long)element), representative);
+        //Checking every element against nextPrime is slow, so check a sample and the ends
+        if(element % 97 == 0 || element == size - 1) {
+            flint::BigInt start = flint::BigInt((long)((1ULL << table.getDomainBits()) + element))
+                                  << TablePrimeRep::PADDING_BITS;
+            nextPrimes &= representative == start.nextPrime();
+        }
+        if(element > 0)
+            increasing &= table.representative(element) > table.representative(element - 1);
+        nextPrimes &= fmpz_is_probabprime(representative.getUnderlyingObject());
+    }
+    check(nextPrimes, "representatives are the first primes after the starts");
+    check(increasing, "representatives are distinct");
+
+    bool threw = false;
+    flint::BigInt representative;
+    try {
+        table.genRepresentative(flint::BigInt((long)size), representative);
+    } catch(const std::out_of_range&) {
+        threw = true;
+    }
+    check(threw, "element past the domain rejected");
+    threw = false;
+    try {
+        table.genRepresentative(flint::BigInt(-1), representative);
+    } catch(const std::out_of_range&) {
+        threw = true;
+    }
+    check(threw, "negative element rejected");
+
+    const char* fileName = "primetabletest.table";
+    check(table.save(fileName), "table saved");
+    unique_ptr<TablePrimeRep> loaded = TablePrimeRep::load(fileName);
+    bool same = loaded && loaded->getSize() == size && loaded->getDomainBits() == table.getDomainBits();
+    for(uint64_t element = 0; same && element < size; element++) {
+        same = loaded->representative(element) == table.representative(element);
+    }
+    check(same, "loaded table matches");
+    loaded.reset();
+
+    //Entries that aren't primes: an even distance, and an odd one that leads to a composite
+    uint64_t bad = size / 2;
+    uint64_t start = ((1ULL << table.getDomainBits()) + bad) << TablePrimeRep::PADDING_BITS;
+    uint16_t composite = table.representative(bad) - start + 2;
+    while(fmpz_is_probabprime(flint::BigInt((long)(start + composite)).getUnderlyingObject()))
+        composite += 2;
+    for(uint16_t distance : {uint16_t(table.representative(bad) - start + 1), composite}) {
+        {
+            fstream file(fileName, ios::in | ios::out | ios::binary);
+            file.seekp(TablePrimeRep::HEADER_SIZE + 2 * bad);
+            file.put(distance & 0xFF);
+            file.put(distance >> 8);
+        }
+        unique_ptr<TablePrimeRep> corrupted = TablePrimeRep::load(fileName);
+        size_t refused = 0;
+        for(int attempt = 0; corrupted && attempt < 2; attempt++) {
+            try {
+                corrupted->genRepresentative(flint::BigInt((long)bad), representative);
+            } catch(const std::runtime_error&) {
+                refused++;
+            }
+        }
+        bool othersUsable = corrupted && (bad == 0 || corrupted->representative(bad - 1) == table.representative(bad - 1))
+                            && (bad + 1 == size || corrupted->representative(bad + 1) == table.representative(bad + 1));
+        check(refused == 2 && othersUsable,
+              string("loaded entry with ") + (distance & 1 ? "a composite" : "an even distance") + " refused");
+    }
+    {
+        fstream file(fileName, ios::in | ios::out | ios::binary);
+        file.seekp(4);
+        file.put(9);
+    }
+    check(!TablePrimeRep::load(fileName), "table of another version rejected");
+    check(!TablePrimeRep::load("/nonexistent/primetabletest.table"), "missing table rejected");
+    remove(fileName);
+
+    threw = false;
+    try {
+        TablePrimeRep empty(0, threadPool);
+    } catch(const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "empty domain rejected");
+}
+
+void checkVerify(ThreadPool& threadPool) {
+    RSAKey key;
+    RSAAccumulator::genKey(0, 1024, key);
+    RSAKey::PublicKey& publicKey = key.getPublicKey();
+    publicKey.primeRepGenerator = std::make_unique<TablePrimeRep>(1000, threadPool);
+    vector<flint::BigInt> elements;
+    for(long element = 0; element < 1000; element += 37) {
+        elements.push_back(flint::BigInt(element));
+    }
+    vector<flint::BigInt> reps(elements.size());
+    RSAAccumulator::genRepresentatives(elements, *publicKey.primeRepGenerator, reps, threadPool);
+    flint::BigMod accumulator;
+    RSAAccumulator::accumulateSet(reps, key, accumulator, threadPool);
+    vector<flint::BigMod> witnesses(elements.size(), flint::BigMod(publicKey.rsaModulus));
+    RSAAccumulator::witnessesForSet(reps, key, witnesses, threadPool);
+    bool verified = true;
+    for(size_t i = 0; i < elements.size(); i++) {
+        verified &= RSAAccumulator::verify(elements.at(i), witnesses.at(i), accumulator, publicKey);
+    }
+    check(verified, "RSA witnesses verify with a prime table");
+    check(!RSAAccumulator::verify(flint::BigInt(1), witnesses.at(0), accumulator, publicKey),
+          "RSA witness of another element rejected");
+}
+
+}  // namespace primetabletest
+
+int main(int argc, char** argv) {
+    uint64_t size = argc > 1 ? strtoull(argv[1], NULL, 10) : 100000;
+    ThreadPool threadPool(4);
+    primetabletest::checkTable(size, threadPool);
+    primetabletest::checkTable(1, threadPool);
+    primetabletest::checkVerify(threadPool);
+    return testutils::checkResults();
+}
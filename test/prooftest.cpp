@@ -0,0 +1,336 @@
+/*
+ * prooftest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Round trips membership proofs for both kinds of accumulator, with bilinear-map
+ * accumulators in either group, through ProofBundle: streams a bundle out
+ * through a BufferedWriter, verifies it in place from the bytes written, and
+ * checks that damaged, truncated or mismatched bundles are rejected, as are
+ * bundles whose records are consistent with an accumulator other than the
+ * verifier's. Also checks aggregated RSA batch proofs.
+ *
+ * Usage: prooftest [count]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <algorithms/BilinearMapAccumulator.hpp>
+#include <algorithms/ProofBundle.hpp>
+#include <algorithms/RSAAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+
+#include <bilinear/Backends.hpp>
+#include <bilinear/GroupElement.hpp>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+
+#include <utils/BinaryIO.hpp>
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+using BilinearMapAccumulator::AccumulatorInG1;
+using BilinearMapAccumulator::AccumulatorInG2;
+
+namespace prooftest {
+
+using testutils::check;
+
+const std::byte* bytesOf(const string& bundle) {
+    return (const std::byte*)bundle.data();
+}
+
+//Checks the parts of parsing that don't depend on the scheme
+void checkParsing(const string& bundle, const string& name) {
+    ProofBundle::View view;
+    check(view.parse(bytesOf(bundle), bundle.size()) && view.getBundleSize() == bundle.size(), name + " parse");
+    check(!view.parse(bytesOf(bundle), bundle.size() - 1), name + " truncated bundle rejected");
+    string badVersion = bundle;
+    badVersion[4] = 2;
+    check(!view.parse(bytesOf(badVersion), badVersion.size()), name + " unknown version rejected");
+    string badCount = bundle;
+    badCount[16] += 1;
+    check(!view.parse(bytesOf(badCount), badCount.size()), name + " inconsistent count rejected");
+    //Bundles can be sent back to back on one stream
+    string twoBundles = bundle + bundle;
+    check(view.parse(bytesOf(twoBundles), twoBundles.size()) && view.getBundleSize() == bundle.size()
+                  && view.parse(bytesOf(twoBundles) + view.getBundleSize(), twoBundles.size() - view.getBundleSize()),
+          name + " consecutive bundles");
+}
+
+template <typename Backend, typename OtherBackend, typename Placement>
+void checkBilinear(size_t count, ThreadPool& threadPool) {
+    typedef typename Placement::Accumulator Accumulator;
+    typedef typename Placement::Witness Witness;
+    string name = string(PairingBackend::getName(Backend::TYPE)) + (Placement::ACCUMULATOR_IN_G2 ? " G2" : " G1");
+    Fr<Backend> secretKey;
+    BilinearMapAccumulator::PublicKeyValues<Backend> publicKey;
+    BilinearMapAccumulator::genKey(count, secretKey, publicKey, threadPool);
+    vector<Fr<Backend>> set(count);
+    for(Fr<Backend>& element : set) {
+        element.generateRandom();
+    }
+    Accumulator accumulator = BilinearMapAccumulator::accumulateSet(set, secretKey, Accumulator());
+    vector<Witness> witnesses = BilinearMapAccumulator::witnessesForSet(set, secretKey, Witness(), threadPool);
+
+    ostringstream out;
+    {
+        BufferedWriter writer(out, 1000);
+        ProofBundle::Writer bundleWriter(writer, accumulator, count);
+        //One proof by itself and the rest as a batch
+        bundleWriter.add(set.at(0), witnesses.at(0));
+        bundleWriter.add(set.data() + 1, witnesses.data() + 1, count - 1);
+        check(bundleWriter.finish(), name + " writer finish");
+    }
+    string bundle = out.str();
+    check(bundle.size() == ProofBundle::bilinearLayout<Backend, Placement>(count).bundleSize(), name + " bundle size");
+    checkParsing(bundle, name);
+
+    ProofBundle::View view;
+    view.parse(bytesOf(bundle), bundle.size());
+    check(view.getScheme() == ProofBundle::bilinearScheme<Backend, Placement>() && view.getCount() == count,
+          name + " header");
+    check(ProofBundle::verifyAll(view, accumulator, publicKey), name + " verifyAll");
+    for(size_t i = 0; i < count; i++) {
+        check(ProofBundle::verify(view, i, accumulator, publicKey), name + " verify " + to_string(i));
+    }
+    check(!ProofBundle::verify(view, count, accumulator, publicKey), name + " index out of range");
+    Accumulator otherAccumulator = accumulator * Accumulator();
+    check(!ProofBundle::verifyAll(view, otherAccumulator, publicKey)
+                  && !ProofBundle::verify(view, 0, otherAccumulator, publicKey),
+          name + " bundle for another accumulator rejected");
+
+    //A proof for the wrong element
+    string damaged = bundle;
+    damaged[view.element(count - 1) - bytesOf(bundle)] ^= 1;
+    view.parse(bytesOf(damaged), damaged.size());
+    check(!ProofBundle::verifyAll(view, accumulator, publicKey)
+                  && !ProofBundle::verify(view, count - 1, accumulator, publicKey)
+                  && ProofBundle::verify(view, 0, accumulator, publicKey),
+          name + " damaged element rejected");
+
+    //Malformed group elements
+    view.parse(bytesOf(bundle), bundle.size());
+    size_t witnessOffset = view.witness(0) - bytesOf(bundle);
+    size_t accumulatorOffset = view.accumulator() - bytesOf(bundle);
+    damaged = bundle;
+    damaged[witnessOffset] ^= 1;
+    view.parse(bytesOf(damaged), damaged.size());
+    check(!ProofBundle::verify(view, 0, accumulator, publicKey) && ProofBundle::verify(view, 1, accumulator, publicKey),
+          name + " malformed witness rejected");
+    damaged = bundle;
+    damaged[accumulatorOffset] ^= 1;
+    view.parse(bytesOf(damaged), damaged.size());
+    check(!ProofBundle::verifyAll(view, accumulator, publicKey), name + " malformed accumulator rejected");
+
+    //Anyone with the public key can make a proof of any element against an accumulator of their choosing:
+    //(g^e * g^s)^r with the witness g^r, which must not pass against the verifier's own accumulator
+    Fr<Backend> r;
+    r.generateRandom();
+    Accumulator forgedAccumulator = (Accumulator().pow(set.at(0)) * Placement::accumulatorPowers(publicKey).at(1)).pow(r);
+    ostringstream forgedOut;
+    {
+        BufferedWriter writer(forgedOut, 1000);
+        ProofBundle::Writer bundleWriter(writer, forgedAccumulator, 1);
+        bundleWriter.add(set.at(0), Witness().pow(r));
+        check(bundleWriter.finish(), name + " forged writer finish");
+    }
+    string forged = forgedOut.str();
+    view.parse(bytesOf(forged), forged.size());
+    check(ProofBundle::verifyAll(view, forgedAccumulator, publicKey), name + " forged bundle is self-consistent");
+    check(!ProofBundle::verifyAll(view, accumulator, publicKey) && !ProofBundle::verify(view, 0, accumulator, publicKey),
+          name + " forged bundle rejected");
+
+    //A bundle for the other backend
+    typedef typename std::conditional<Placement::ACCUMULATOR_IN_G2, G2<OtherBackend>, G1<OtherBackend>>::type
+            OtherAccumulator;
+    BilinearMapAccumulator::PublicKeyValues<OtherBackend> otherKey;
+    Fr<OtherBackend> otherSecretKey;
+    BilinearMapAccumulator::genKey(2, otherSecretKey, otherKey, threadPool);
+    view.parse(bytesOf(bundle), bundle.size());
+    check(!ProofBundle::verifyAll(view, OtherAccumulator(), otherKey), name + " bundle rejected by the other backend");
+}
+
+void checkRSA(size_t count, ThreadPool& threadPool) {
+    RSAKey key;
+    RSAAccumulator::genKey(0, 1024, key);
+    RSAKey::PublicKey& publicKey = key.getPublicKey();
+    vector<flint::BigInt> set;
+    for(size_t i = 0; i < count; i++) {
+        set.push_back(flint::BigInt(rand()));
+    }
+    vector<flint::BigInt> reps(count);
+    RSAAccumulator::genRepresentatives(set, *publicKey.primeRepGenerator, reps, threadPool);
+    flint::BigMod accumulator;
+    RSAAccumulator::accumulateSet(reps, key, accumulator, threadPool);
+    vector<flint::BigMod> witnesses(count, flint::BigMod(publicKey.rsaModulus));
+    RSAAccumulator::witnessesForSet(reps, key, witnesses, threadPool);
+
+    const size_t ELEMENT_SIZE = 12;
+    ostringstream out;
+    {
+        BufferedWriter writer(out, 1000);
+        ProofBundle::Writer bundleWriter(writer, accumulator, ELEMENT_SIZE, count);
+        for(size_t i = 0; i < count; i++) {
+            bundleWriter.add(set.at(i), witnesses.at(i));
+        }
+        check(bundleWriter.finish(), "RSA writer finish");
+    }
+    string bundle = out.str();
+    check(bundle.size() == ProofBundle::rsaLayout(publicKey.rsaModulus, ELEMENT_SIZE, count).bundleSize(),
+          "RSA bundle size");
+    checkParsing(bundle, "RSA");
+
+    ProofBundle::View view;
+    view.parse(bytesOf(bundle), bundle.size());
+    check(view.getScheme() == ProofBundle::RSA_ACCUMULATOR, "RSA header");
+    bool elementsMatch = true;
+    for(size_t i = 0; i < count; i++) {
+        elementsMatch = elementsMatch && ProofBundle::rsaElement(view, i) == set.at(i);
+    }
+    check(elementsMatch, "RSA elements");
+    check(ProofBundle::verifyAll(view, accumulator, publicKey) && ProofBundle::verify(view, 0, accumulator, publicKey),
+          "RSA verify");
+    flint::BigMod otherAccumulator = accumulator * flint::BigInt(2);
+    check(!ProofBundle::verifyAll(view, otherAccumulator, publicKey)
+                  && !ProofBundle::verify(view, 0, otherAccumulator, publicKey),
+          "RSA bundle for another accumulator rejected");
+
+    size_t accumulatorEnd = view.accumulator() - bytesOf(bundle) + view.getLayout().accumulatorSize;
+    string damaged = bundle;
+    damaged[view.witness(0) - bytesOf(bundle) + view.getLayout().witnessSize - 1] ^= 1;
+    view.parse(bytesOf(damaged), damaged.size());
+    check(!ProofBundle::verify(view, 0, accumulator, publicKey), "RSA damaged witness rejected");
+
+    //The accumulator in the bundle is only a copy of the verifier's, and must match it
+    damaged = bundle;
+    damaged[accumulatorEnd - 1] ^= 1;
+    view.parse(bytesOf(damaged), damaged.size());
+    check(!ProofBundle::verifyAll(view, accumulator, publicKey) && !ProofBundle::verify(view, 0, accumulator, publicKey),
+          "RSA bundle with a different accumulator rejected");
+
+    ostringstream unused;
+    BufferedWriter writer(unused);
+    ProofBundle::Writer bundleWriter(writer, accumulator, 1, 1);
+    bool threw = false;
+    try {
+        bundleWriter.add(flint::BigInt(1 << 20), witnesses.at(0));
+    } catch(const std::length_error&) {
+        threw = true;
+    }
+    check(threw && !bundleWriter.finish(), "RSA element too long for the bundle");
+}
+
+void checkRSABatch(size_t count, ThreadPool& threadPool) {
+    RSAKey key;
+    RSAAccumulator::genKey(0, 1024, key);
+    RSAKey::PublicKey& publicKey = key.getPublicKey();
+    vector<flint::BigInt> set;
+    for(size_t i = 0; i < count; i++) {
+        set.push_back(flint::BigInt(rand()));
+    }
+    vector<flint::BigInt> reps(count);
+    RSAAccumulator::genRepresentatives(set, *publicKey.primeRepGenerator, reps, threadPool);
+    flint::BigMod accumulator;
+    RSAAccumulator::accumulateSet(reps, key, accumulator, threadPool);
+    vector<flint::BigMod> witnesses(count, flint::BigMod(publicKey.rsaModulus));
+    RSAAccumulator::witnessesForSet(reps, key, witnesses, threadPool);
+
+    //A proof for every other element, whose aggregate witness is the accumulator of the rest
+    vector<flint::BigInt> subset, subsetReps, rest;
+    vector<flint::BigMod> subsetWitnesses;
+    for(size_t i = 0; i < count; i++) {
+        if(i % 2 == 0) {
+            subset.push_back(set.at(i));
+            subsetReps.push_back(reps.at(i));
+            subsetWitnesses.push_back(witnesses.at(i));
+        } else {
+            rest.push_back(reps.at(i));
+        }
+    }
+    flint::BigMod restAccumulator;
+    RSAAccumulator::accumulateSet(rest, key, restAccumulator, threadPool);
+    check(RSAAccumulator::aggregateWitnesses(subsetReps, subsetWitnesses, threadPool) == restAccumulator,
+          "RSA aggregate witness");
+    RSAAccumulator::BatchWitness batch = RSAAccumulator::proveBatch(subsetReps, subsetWitnesses, accumulator,
+                                                                    threadPool);
+    check(RSAAccumulator::verifyBatch(subset, batch, accumulator, publicKey, threadPool), "RSA batch verify");
+    RSAAccumulator::BatchWitness fromKey = RSAAccumulator::proveBatch(subsetReps, key, accumulator, threadPool);
+    check(fromKey.witness == batch.witness && fromKey.proof == batch.proof, "RSA batch proof with the secret key");
+    RSAAccumulator::BatchWitness single = RSAAccumulator::proveBatch({reps.at(1)}, {witnesses.at(1)}, accumulator,
+                                                                     threadPool);
+    check(RSAAccumulator::verifyBatch({set.at(1)}, single, accumulator, publicKey, threadPool),
+          "RSA batch of one verify");
+
+    vector<flint::BigInt> extra = subset;
+    extra.push_back(flint::BigInt(rand()) + flint::BigInt(1L << 40));
+    vector<flint::BigInt> fewer(subset.begin(), subset.end() - 1);
+    RSAAccumulator::BatchWitness damaged = batch;
+    damaged.proof *= flint::BigInt(2);
+    check(!RSAAccumulator::verifyBatch(extra, batch, accumulator, publicKey, threadPool)
+                  && !RSAAccumulator::verifyBatch(fewer, batch, accumulator, publicKey, threadPool)
+                  && !RSAAccumulator::verifyBatch(subset, damaged, accumulator, publicKey, threadPool),
+          "RSA wrong batch rejected");
+
+    //Independent witnesses checked together, with the bad ones found by bisection
+    vector<size_t> failures;
+    check(RSAAccumulator::verifyBatch(set, witnesses, accumulator, publicKey, threadPool, &failures)
+                  && failures.empty(),
+          "RSA randomized batch verify");
+    vector<flint::BigMod> wrongWitnesses = witnesses;
+    wrongWitnesses.at(1) *= flint::BigInt(2);
+    wrongWitnesses.at(count - 2) = accumulator;
+    wrongWitnesses.at(count - 1) = flint::BigMod(flint::BigInt(1), flint::BigInt(7));
+    vector<size_t> expectedFailures = {1, count - 2, count - 1};
+    bool rejected = !RSAAccumulator::verifyBatch(set, wrongWitnesses, accumulator, publicKey, threadPool);
+    check(rejected && !RSAAccumulator::verifyBatch(set, wrongWitnesses, accumulator, publicKey, threadPool, &failures)
+                  && failures == expectedFailures,
+          "RSA randomized batch finds the bad witnesses");
+
+    //Witnesses multiplied by -1 (of order 2) can't cancel each other out: verify and
+    //verifyBatch accept the same ones, however the randomizers fall
+    vector<flint::BigMod> negated = witnesses;
+    negated.at(0) *= publicKey.rsaModulus - flint::BigInt(1);
+    negated.at(count - 1) *= publicKey.rsaModulus - flint::BigInt(1);
+    bool agree = true;
+    for(size_t i = 0; i < count; i++) {
+        agree &= RSAAccumulator::verify(set.at(i), negated.at(i), accumulator, publicKey);
+    }
+    vector<flint::BigMod> negatedAndWrong = negated;
+    negatedAndWrong.at(1) *= flint::BigInt(2);
+    for(int round = 0; round < 20; round++) {
+        agree &= RSAAccumulator::verifyBatch(set, negated, accumulator, publicKey, threadPool, &failures)
+                 && failures.empty();
+        agree &= !RSAAccumulator::verifyBatch(set, negatedAndWrong, accumulator, publicKey, threadPool, &failures)
+                 && failures == vector<size_t>{1};
+    }
+    check(agree, "RSA randomized batch agrees with verify on negated witnesses");
+
+    bool threw = false;
+    try {
+        RSAAccumulator::aggregateWitnesses({reps.at(0), reps.at(0)}, {witnesses.at(0), witnesses.at(0)}, threadPool);
+    } catch(const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "RSA repeated representative rejected");
+}
+
+}  // namespace prooftest
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? atoi(argv[1]) : 20;
+    ThreadPool threadPool(4);
+    prooftest::checkBilinear<DCLXVIBackend, Mont64Backend, AccumulatorInG1<DCLXVIBackend>>(count, threadPool);
+    prooftest::checkBilinear<Mont64Backend, DCLXVIBackend, AccumulatorInG1<Mont64Backend>>(count, threadPool);
+    prooftest::checkBilinear<DCLXVIBackend, Mont64Backend, AccumulatorInG2<DCLXVIBackend>>(count, threadPool);
+    prooftest::checkBilinear<Mont64Backend, DCLXVIBackend, AccumulatorInG2<Mont64Backend>>(count, threadPool);
+    prooftest::checkRSA(count, threadPool);
+    prooftest::checkRSABatch(count, threadPool);
+    return testutils::checkResults();
+}
@@ -0,0 +1,115 @@
+/*
+ * rsadynamictest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Checks adding and deleting elements of an RSA accumulator against
+ * accumulating the changed set from scratch, and that witnesses updated for
+ * the changes verify against the new accumulator.
+ *
+ * Usage: rsadynamictest [count]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <algorithms/RSAAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace rsadynamictest {
+
+using testutils::check;
+
+void checkDynamic(size_t count, ThreadPool& threadPool) {
+    RSAKey key;
+    RSAAccumulator::genKey(0, 1024, key);
+    RSAKey::PublicKey& publicKey = key.getPublicKey();
+    //Elements [0, count) start in the set, and [count, 2 * count) are added later
+    vector<flint::BigInt> elements;
+    for(size_t i = 0; i < 2 * count; i++) {
+        elements.push_back(flint::BigInt(rand()) + flint::BigInt(i << 32));
+    }
+    vector<flint::BigInt> reps(2 * count);
+    RSAAccumulator::genRepresentatives(elements, *publicKey.primeRepGenerator, reps, threadPool);
+    vector<flint::BigInt> initial(reps.begin(), reps.begin() + count), added(reps.begin() + count, reps.end());
+    flint::BigMod accumulator;
+    RSAAccumulator::accumulateSet(initial, key, accumulator, threadPool);
+    vector<flint::BigMod> witnesses(count, flint::BigMod(publicKey.rsaModulus));
+    RSAAccumulator::witnessesForSet(initial, key, witnesses, threadPool);
+
+    flint::BigMod expected, afterAdd = accumulator;
+    RSAAccumulator::accumulateSet(reps, key, expected, threadPool);
+    RSAAccumulator::add(added, publicKey, afterAdd);
+    check(afterAdd == expected, "RSA add");
+    vector<flint::BigMod> addWitnesses = witnesses;
+    bool updated = true, verified = true;
+    for(size_t i = 0; i < count; i++) {
+        updated &= RSAAccumulator::updateWitness(initial.at(i), addWitnesses.at(i), added, {}, afterAdd);
+        verified &= RSAAccumulator::verify(elements.at(i), addWitnesses.at(i), afterAdd, publicKey);
+    }
+    check(updated && verified, "RSA witnesses updated for additions");
+
+    //Delete the first half of the initial set and add the new elements in one update
+    size_t deletedCount = count / 2;
+    vector<flint::BigInt> deleted(initial.begin(), initial.begin() + deletedCount);
+    vector<flint::BigInt> remaining(initial.begin() + deletedCount, initial.end());
+    flint::BigMod afterRemove = accumulator;
+    RSAAccumulator::accumulateSet(remaining, key, expected, threadPool);
+    RSAAccumulator::remove(deleted, key, afterRemove);
+    check(afterRemove == expected, "RSA remove");
+
+    vector<flint::BigInt> updatedSet = remaining;
+    updatedSet.insert(updatedSet.end(), added.begin(), added.end());
+    flint::BigMod afterUpdate = accumulator;
+    RSAAccumulator::accumulateSet(updatedSet, key, expected, threadPool);
+    RSAAccumulator::update(added, deleted, key, afterUpdate);
+    check(afterUpdate == expected, "RSA update");
+    bool kept = true, dropped = true;
+    verified = true;
+    for(size_t i = 0; i < count; i++) {
+        flint::BigMod witness = witnesses.at(i);
+        bool result = RSAAccumulator::updateWitness(initial.at(i), witness, added, deleted, afterUpdate);
+        if(i < deletedCount) {
+            dropped &= !result && witness == witnesses.at(i);
+        } else {
+            kept &= result;
+            verified &= RSAAccumulator::verify(elements.at(i), witness, afterUpdate, publicKey);
+        }
+    }
+    check(kept && verified, "RSA witnesses updated for additions and deletions");
+    check(dropped, "RSA witnesses of deleted elements not updated");
+
+    //Deleting every element leaves the generator
+    flint::BigMod empty = accumulator;
+    RSAAccumulator::remove(initial, key, empty);
+    check(empty == publicKey.base, "RSA remove everything");
+
+    bool threw = false;
+    try {
+        flint::BigMod accumulatorCopy = accumulator;
+        RSAAccumulator::remove({flint::BigInt(2)}, key, accumulatorCopy);
+    } catch(const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "RSA remove of a representative sharing a factor with phi(N) rejected");
+}
+
+}  // namespace rsadynamictest
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? atoi(argv[1]) : 20;
+    ThreadPool threadPool(4);
+    rsadynamictest::checkDynamic(count, threadPool);
+    return testutils::checkResults();
+}
@@ -0,0 +1,106 @@
+/*
+ * rsakeytest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Checks that generated RSA keys have moduli of exactly the requested size
+ * made of two distinct primes, that the safe-prime option gives safe primes,
+ * and that an accumulator built with a key from the parallel search verifies.
+ *
+ * Usage: rsakeytest [modulusBits]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <algorithms/RSAAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+#include <flint/fmpz.h>
+
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace rsakeytest {
+
+using testutils::check;
+
+bool isPrime(const flint::BigInt& value) {
+    return fmpz_is_probabprime(value.getUnderlyingObject());
+}
+
+void checkKey(const RSAKey& key, unsigned int modulusBits, bool safe, const string& what) {
+    const flint::BigInt& p = key.getSecretKey().p;
+    const flint::BigInt& q = key.getSecretKey().q;
+    check(key.getPublicKey().rsaModulus == p * q, what + ": modulus is pq");
+    check(key.getPublicKey().rsaModulus.bitLength() == modulusBits, what + ": modulus size");
+    check(p != q && isPrime(p) && isPrime(q), what + ": distinct prime factors");
+    if(safe) {
+        check(isPrime((p - 1) / 2) && isPrime((q - 1) / 2), what + ": safe primes");
+    }
+}
+
+void checkAccumulator(const RSAKey& key, ThreadPool& threadPool) {
+    const RSAKey::PublicKey& publicKey = key.getPublicKey();
+    vector<flint::BigInt> elements;
+    for(size_t i = 0; i < 10; i++) {
+        elements.push_back(flint::BigInt(rand()));
+    }
+    vector<flint::BigInt> reps(elements.size());
+    RSAAccumulator::genRepresentatives(elements, *publicKey.primeRepGenerator, reps, threadPool);
+    flint::BigMod accumulator;
+    RSAAccumulator::accumulateSet(reps, key, accumulator, threadPool);
+    vector<flint::BigMod> witnesses(elements.size(), flint::BigMod(publicKey.rsaModulus));
+    RSAAccumulator::witnessesForSet(reps, key, witnesses, threadPool);
+    bool verified = true;
+    for(size_t i = 0; i < elements.size(); i++) {
+        verified &= RSAAccumulator::verify(elements.at(i), witnesses.at(i), accumulator, publicKey);
+    }
+    check(verified, "RSA witnesses verify with a generated key");
+}
+
+void checkKeys(unsigned int modulusBits) {
+    RSAKey serialKey;
+    RSAAccumulator::genKey(0, modulusBits, serialKey);
+    checkKey(serialKey, modulusBits, false, "single-threaded key");
+    //An odd size gives p one more bit than q
+    RSAKey oddKey;
+    RSAAccumulator::genKey(0, modulusBits + 1, oddKey);
+    checkKey(oddKey, modulusBits + 1, false, "odd-sized key");
+
+    ThreadPool threadPool(4);
+    RSAKey parallelKey;
+    RSAAccumulator::genKey(0, modulusBits, parallelKey, threadPool);
+    checkKey(parallelKey, modulusBits, false, "parallel key");
+    check(parallelKey.getSecretKey().p != serialKey.getSecretKey().p, "keys differ");
+    checkAccumulator(parallelKey, threadPool);
+
+    //Safe primes are much rarer, so keep them small enough to find quickly
+    RSAKey safeKey;
+    RSAAccumulator::genKey(0, 256, safeKey, threadPool, true);
+    checkKey(safeKey, 256, true, "safe-prime key");
+
+    bool threw = false;
+    try {
+        RSAKey tinyKey;
+        RSAAccumulator::genKey(0, 32, tinyKey, threadPool);
+    } catch(const std::invalid_argument&) {
+        threw = true;
+    }
+    check(threw, "moduli below 64 bits rejected");
+}
+
+}  // namespace rsakeytest
+
+int main(int argc, char** argv) {
+    unsigned int modulusBits = argc > 1 ? atoi(argv[1]) : 1024;
+    rsakeytest::checkKeys(modulusBits);
+    return testutils::checkResults();
+}
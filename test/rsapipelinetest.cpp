@@ -0,0 +1,109 @@
+/*
+ * rsapipelinetest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ *
+ * Checks that accumulating raw elements through the pipeline gives the same
+ * accumulator as generating every representative and then accumulating
+ * them, with both keys, for sets that fill some batches exactly and some
+ * not at all, and that an element the generator rejects stops it with the
+ * generator's exception.
+ *
+ * Usage: rsapipelinetest [modulusBits]
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <algorithms/RSAAccumulator.hpp>
+#include <algorithms/RSAKey.hpp>
+#include <algorithms/TablePrimeRep.hpp>
+
+#include <flint/BigInt.hpp>
+#include <flint/BigMod.hpp>
+
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace rsapipelinetest {
+
+using testutils::check;
+
+void checkSize(const RSAKey& key, size_t size, ThreadPool& threadPool) {
+    const RSAKey::PublicKey& publicKey = key.getPublicKey();
+    vector<flint::BigInt> elements;
+    for(size_t i = 0; i < size; i++) {
+        elements.push_back(flint::BigInt(rand()));
+    }
+    vector<flint::BigInt> reps(elements.size());
+    RSAAccumulator::genRepresentatives(elements, *publicKey.primeRepGenerator, reps, threadPool);
+    flint::BigMod expected;
+    RSAAccumulator::accumulateSet(reps, key, expected, threadPool);
+
+    string what = to_string(size) + " elements";
+    size_t position = 0;
+    RSAAccumulator::ElementSource next = [&](flint::BigInt& element) {
+        if(position == elements.size())
+            return false;
+        element = elements.at(position++);
+        return true;
+    };
+    flint::BigMod privateAccumulator;
+    size_t count = RSAAccumulator::accumulateElements(next, key, privateAccumulator, threadPool);
+    check(count == size, what + ": private key count");
+    check(privateAccumulator == expected, what + ": private key accumulator");
+
+    flint::BigMod publicAccumulator;
+    count = RSAAccumulator::accumulateElements(elements.begin(), elements.end(), publicKey, publicAccumulator,
+                                               threadPool);
+    check(count == size, what + ": public key count");
+    check(publicAccumulator == expected, what + ": public key accumulator");
+}
+
+void checkRejectedElement(RSAKey& key, ThreadPool& threadPool) {
+    key.getPublicKey().primeRepGenerator = std::make_unique<TablePrimeRep>(1000, threadPool);
+    vector<flint::BigInt> elements;
+    for(size_t i = 0; i < 500; i++) {
+        elements.push_back(flint::BigInt(i));
+    }
+    flint::BigMod accumulator;
+    size_t count = RSAAccumulator::accumulateElements(elements.begin(), elements.end(), key, accumulator, threadPool);
+    vector<flint::BigInt> reps(elements.size());
+    RSAAccumulator::genRepresentatives(elements, *key.getPublicKey().primeRepGenerator, reps, threadPool);
+    flint::BigMod expected;
+    RSAAccumulator::accumulateSet(reps, key, expected, threadPool);
+    check(count == elements.size() && accumulator == expected, "table representatives");
+
+    elements.at(300) = flint::BigInt(1000);
+    bool threw = false;
+    try {
+        RSAAccumulator::accumulateElements(elements.begin(), elements.end(), key, accumulator, threadPool);
+    } catch(const std::out_of_range&) {
+        threw = true;
+    }
+    check(threw, "generator's exception propagates");
+}
+
+void checkPipeline(unsigned int modulusBits) {
+    ThreadPool threadPool(4);
+    RSAKey key;
+    RSAAccumulator::genKey(0, modulusBits, key, threadPool);
+    for(size_t size : {0, 1, 63, 64, 65, 200, 1000}) {
+        checkSize(key, size, threadPool);
+    }
+    checkRejectedElement(key, threadPool);
+}
+
+}  // namespace rsapipelinetest
+
+int main(int argc, char** argv) {
+    unsigned int modulusBits = argc > 1 ? atoi(argv[1]) : 1024;
+    rsapipelinetest::checkPipeline(modulusBits);
+    return testutils::checkResults();
+}
@@ -14,6 +14,7 @@
 #include <algorithms/RSAAccumulator.hpp>
 #include <algorithms/RSAKey.hpp>
 
+#include <utils/CpuDispatch.hpp>
 #include <utils/Pointers.hpp>
 #include <utils/Profiler.hpp>
 #include <utils/ThreadPool.hpp>
@@ -25,7 +26,7 @@
 using namespace std;
 
 namespace speedtest {
-void rsaTest(int setSize);
+void rsaTest(int setSize, const char* traceFile);
 vector<flint::BigInt> readBigInts(string filename);
 }  // namespace speedtest
 
@@ -36,7 +37,8 @@ int main(int argc, char** argv) {
     } else {
         setSize = 1000;
     }
-    speedtest::rsaTest(setSize);
+    //An optional second argument names a file to write a task timeline to
+    speedtest::rsaTest(setSize, argc > 2 ? argv[2] : nullptr);
     return 0;
 }
 
@@ -54,10 +56,13 @@ vector<flint::BigInt> readBigInts(string filename) {
     return elements;
 }
 
-void rsaTest(int setSize) {
+void rsaTest(int setSize, const char* traceFile) {
     // cout << "RSA Accumulator test:" << endl;
     static const int THREAD_POOL_SIZE = 16;
     ThreadPool threadPool(THREAD_POOL_SIZE);
+    if(traceFile) {
+        threadPool.enableTracing();
+    }
 
     vector<flint::BigInt> elements;
     //Read a random set from a file
@@ -148,6 +153,27 @@ void rsaTest(int setSize) {
     //This actually doesn't need to get measured and logged, since the time will
     //be the same as for verification with the private-key witnesses. It only
     //needs to run to guarantee correctness.
+
+    //Public-key accumulation is nothing but exponentiations, so it shows what each modular.power kernel gains
+    string selectedKernel = CpuDispatch::getSelected(CpuDispatch::MODULAR_POWER);
+    for(const string& kernel : CpuDispatch::getVariants(CpuDispatch::MODULAR_POWER)) {
+        if(!CpuDispatch::select(CpuDispatch::MODULAR_POWER, kernel))
+            continue;
+        flint::BigMod kernelAcc;
+        double kernelStart = Profiler::getCurrentTime();
+        RSAAccumulator::accumulateSet(representatives, rsaKey.getPublicKey(), kernelAcc);
+        double kernelEnd = Profiler::getCurrentTime();
+        cout << kernel << " " << (kernelEnd - kernelStart) << endl;
+        if(kernelAcc != accPub) {
+            cout << "Error! Accumulation with the " << kernel << " kernel does not match!" << endl;
+        }
+    }
+    CpuDispatch::select(CpuDispatch::MODULAR_POWER, selectedKernel);
+
+    if(traceFile) {
+        ofstream traceOut(traceFile);
+        threadPool.getTrace()->writeChromeTrace(traceOut);
+    }
 }
 
 }  // namespace speedtest
@@ -0,0 +1,174 @@
+/*
+ * tasktracetest.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *
+ * Checks that a ThreadPool with tracing enabled has recorded a task's event
+ * by the time the task's future is ready, including for tasks that throw,
+ * that the trace ring keeps only its most recent events, that reading the
+ * trace while workers record never returns a torn event, that labels are
+ * escaped in the Chrome trace, and that re-enabling tracing while tasks are
+ * queued is safe.
+ *
+ * Usage: tasktracetest [numTasks]
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <utils/TaskTrace.hpp>
+#include <utils/ThreadPool.hpp>
+#include <utils/testutils.hpp>
+
+using namespace std;
+
+namespace tasktracetest {
+
+using testutils::check;
+
+const char* EVEN_LABEL = "trace.even";
+const char* ODD_LABEL = "trace.odd";
+
+long busyWork(long seed) {
+    long value = seed;
+    for(int i = 0; i < 1000; i++) {
+        value = value * 6364136223846793005L + 1442695040888963407L;
+    }
+    return value;
+}
+
+void checkRecordedOnCompletion(size_t numTasks, ThreadPool& threadPool) {
+    threadPool.enableTracing(numTasks);
+    vector<future<long>> results;
+    for(size_t i = 0; i < numTasks; i++) {
+        results.push_back(threadPool.enqueue<long>([i]() { return busyWork(i); }, i % 2 == 0 ? EVEN_LABEL : ODD_LABEL));
+    }
+    for(auto& result : results) {
+        result.get();
+    }
+    //No waiting on the pool: every event must already be in the trace
+    vector<TaskTrace::Event> events = threadPool.getTrace()->getEvents();
+    check(events.size() == numTasks, "every task recorded by the time its future is ready");
+    size_t even = 0;
+    bool ordered = true;
+    bool onWorker = true;
+    for(const TaskTrace::Event& event : events) {
+        even += strcmp(event.label, EVEN_LABEL) == 0;
+        ordered &= event.enqueueTime <= event.startTime && event.startTime <= event.endTime;
+        onWorker &= event.workerId >= 1 && event.workerId <= threadPool.size();
+    }
+    check(even == (numTasks + 1) / 2, "events carry their task's label");
+    check(ordered, "events are enqueued before they start and start before they end");
+    check(onWorker, "events are attributed to a pool worker");
+
+    ostringstream json;
+    threadPool.getTrace()->writeChromeTrace(json);
+    check(json.str().find(EVEN_LABEL) != string::npos && json.str().find(ODD_LABEL) != string::npos,
+          "Chrome trace contains the recorded labels");
+}
+
+void checkThrowingTask(ThreadPool& threadPool) {
+    threadPool.enableTracing(16);
+    future<long> result = threadPool.enqueue<long>([]() -> long { throw std::runtime_error("task failed"); }, "trace.throw");
+    bool threw = false;
+    try {
+        result.get();
+    } catch(const std::runtime_error&) {
+        threw = true;
+    }
+    check(threw, "task exception reaches its future");
+    vector<TaskTrace::Event> events = threadPool.getTrace()->getEvents();
+    check(events.size() == 1 && strcmp(events.at(0).label, "trace.throw") == 0,
+          "task that throws is recorded before its future is ready");
+}
+
+void checkWraparound(ThreadPool& threadPool) {
+    const size_t capacity = 8;
+    threadPool.enableTracing(capacity);
+    vector<future<void>> results;
+    for(size_t i = 0; i < 3 * capacity; i++) {
+        results.push_back(threadPool.enqueue<void>([]() { busyWork(1); }, "trace.wrap"));
+    }
+    for(auto& result : results) {
+        result.get();
+    }
+    check(threadPool.getTrace()->getEvents().size() == capacity, "full trace keeps only its capacity");
+}
+
+void checkConcurrentReads() {
+    //A small ring wraps constantly, so readers keep meeting slots that are being overwritten
+    TaskTrace trace(4);
+    const uint64_t perThread = 20000;
+    vector<thread> writers;
+    for(size_t t = 0; t < 4; t++) {
+        writers.emplace_back([&trace, t, perThread]() {
+            TaskTrace::setCurrentWorkerId(t + 1);
+            for(uint64_t i = 0; i < perThread; i++) {
+                //Every field of an event follows from its enqueue time, so a torn one is easy to spot
+                uint64_t time = (i * 4 + t) * 4;
+                trace.record(time % 8 == 0 ? EVEN_LABEL : ODD_LABEL, time, time + 1, time + t + 2);
+            }
+        });
+    }
+    bool whole = true;
+    for(int round = 0; round < 2000; round++) {
+        for(const TaskTrace::Event& event : trace.getEvents()) {
+            size_t worker = event.enqueueTime / 4 % 4 + 1;
+            whole &= event.label == (event.enqueueTime % 8 == 0 ? EVEN_LABEL : ODD_LABEL)
+                     && event.workerId == worker && event.startTime == event.enqueueTime + 1
+                     && event.endTime == event.enqueueTime + worker + 1;
+        }
+    }
+    for(auto& writer : writers) {
+        writer.join();
+    }
+    check(whole, "events read while workers record are never torn");
+    check(trace.getEvents().size() <= 4, "concurrent trace keeps at most its capacity");
+}
+
+void checkEscapedLabels(ThreadPool& threadPool) {
+    threadPool.enableTracing(4);
+    threadPool.enqueue<long>([]() { return busyWork(0); }, "trace \"quoted\" C:\\path\n").get();
+    ostringstream json;
+    threadPool.getTrace()->writeChromeTrace(json);
+    check(json.str().find("\"trace \\\"quoted\\\" C:\\\\path\\u000a\"") != string::npos,
+          "Chrome trace escapes quotes, backslashes and control characters in labels");
+}
+
+void checkReenable(size_t numTasks, ThreadPool& threadPool) {
+    //Tasks queued before each re-enable keep recording into the trace they were enqueued with
+    vector<future<long>> results;
+    for(int round = 0; round < 4; round++) {
+        threadPool.enableTracing(numTasks);
+        for(size_t i = 0; i < numTasks; i++) {
+            results.push_back(threadPool.enqueue<long>([i]() { return busyWork(i); }, "trace.reenable"));
+        }
+    }
+    for(auto& result : results) {
+        result.get();
+    }
+    check(threadPool.getTrace()->getEvents().size() == numTasks, "latest trace holds only its own tasks");
+    threadPool.disableTracing();
+    threadPool.enqueue<long>([]() { return busyWork(0); }).get();
+    check(threadPool.getTrace()->getEvents().size() == numTasks, "disabled tracing records nothing");
+}
+
+}  // namespace tasktracetest
+
+int main(int argc, char** argv) {
+    size_t numTasks = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000;
+    ThreadPool threadPool(4);
+    tasktracetest::checkRecordedOnCompletion(numTasks, threadPool);
+    tasktracetest::checkThrowingTask(threadPool);
+    tasktracetest::checkWraparound(threadPool);
+    tasktracetest::checkConcurrentReads();
+    tasktracetest::checkEscapedLabels(threadPool);
+    tasktracetest::checkReenable(numTasks, threadPool);
+    return testutils::checkResults();
+}